@@ -225,6 +225,20 @@ public:
                      lldb::DynamicValueType use_dynamic,
                      bool can_create_synthetic);
 
+    //------------------------------------------------------------------
+    /// Get the children in [idx, idx + count) of a value.
+    ///
+    /// This is the same as calling GetChildAtIndex() for each index,
+    /// but children whose data is adjacent in memory, and children
+    /// of containers like std::list and std::map, are fetched
+    /// together. Use it to page through values with many children.
+    ///
+    /// @return
+    ///     A list with the children that exist in the range.
+    //------------------------------------------------------------------
+    lldb::SBValueList
+    GetChildrenAtIndexRange (uint32_t idx, uint32_t count);
+
     // Matches children of this object only and will match base classes and
     // member names if this is a clang typed object.
     uint32_t
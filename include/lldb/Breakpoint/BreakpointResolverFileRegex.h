@@ -12,9 +12,12 @@
 
 // C Includes
 // C++ Includes
+#include <vector>
+
 // Other libraries and framework includes
 // Project includes
 #include "lldb/Breakpoint/BreakpointResolver.h"
+#include "lldb/Symbol/SymbolContext.h"
 
 namespace lldb_private {
 
@@ -34,6 +37,13 @@ public:
     virtual
     ~BreakpointResolverFileRegex ();
 
+    virtual void
+    ResolveBreakpoint (SearchFilter &filter);
+
+    virtual void
+    ResolveBreakpointInModules (SearchFilter &filter,
+                                ModuleList &modules);
+
     virtual Searcher::CallbackReturn
     SearchCallback (SearchFilter &filter,
                     SymbolContext &context,
@@ -57,7 +67,20 @@ public:
 
 protected:
     friend class Breakpoint;
+
+    // Search the source files of all compile units gathered by the last
+    // filter search in one go, then add their locations.
+    void
+    ResolvePendingCompUnits (SearchFilter &filter);
+
+    void
+    AddLocationsForLines (SearchFilter &filter,
+                          CompileUnit *cu,
+                          const std::vector<uint32_t> &line_matches);
+
     RegularExpression m_regex; // This is the line expression that we are looking for.
+    bool m_gather_comp_units;  // True while a search should only record compile units
+    std::vector<SymbolContext> m_pending_comp_units;
 
 private:
     DISALLOW_COPY_AND_ASSIGN(BreakpointResolverFileRegex);
@@ -12,6 +12,8 @@
 
 // C Includes
 // C++ Includes
+#include <list>
+#include <map>
 #include <vector>
 #include <string>
 
@@ -23,6 +25,7 @@
 #include "lldb/Core/EmulateInstruction.h"
 #include "lldb/Core/Opcode.h"
 #include "lldb/Core/PluginInterface.h"
+#include "lldb/Host/Mutex.h"
 #include "lldb/Interpreter/OptionValue.h"
 
 namespace lldb_private {
@@ -195,6 +198,124 @@ private:
     collection m_instructions;
 };
 
+//----------------------------------------------------------------------
+// Decoded instructions of a module, by file address and by the triple of
+// the disassembler that decoded them.
+//
+// The code sections of a module don't change, so what a disassembler
+// worked out about an instruction in them (its opcode, whether it
+// branches, its mnemonic, operands and comment) is kept here and reused
+// whenever the same instruction is disassembled again, no matter which
+// disassembler, stop or process that is. The triple keeps apart what
+// different instruction sets, like ARM and Thumb, or a disassembler for
+// another architecture made of the same bytes. Everything is handed out
+// only for the same opcode bytes it was stored with, so an instruction
+// whose memory did change is simply decoded again. Once the cache is full
+// the least recently used instruction makes room for a new one.
+//----------------------------------------------------------------------
+class DecodedInstructionCache
+{
+public:
+    DecodedInstructionCache ();
+    
+    ~DecodedInstructionCache ();
+    
+    // Get the opcode that was decoded at file_addr if it is made up of
+    // the bytes at the start of [bytes, bytes + bytes_len)
+    bool
+    GetOpcode (lldb::addr_t file_addr,
+               const ConstString &triple,
+               const uint8_t *bytes,
+               size_t bytes_len,
+               Opcode &opcode);
+    
+    void
+    SetOpcode (lldb::addr_t file_addr,
+               const ConstString &triple,
+               const Opcode &opcode);
+    
+    // Returns eLazyBoolCalculate if it isn't known
+    LazyBool
+    GetDoesBranch (lldb::addr_t file_addr,
+                   const ConstString &triple,
+                   const Opcode &opcode);
+    
+    void
+    SetDoesBranch (lldb::addr_t file_addr,
+                   const ConstString &triple,
+                   const Opcode &opcode,
+                   bool does_branch);
+    
+    // The strings depend on the address the instruction was printed for
+    // (PC relative operands and symbol comments) and on the flavor
+    bool
+    GetStrings (lldb::addr_t file_addr,
+                const ConstString &triple,
+                const Opcode &opcode,
+                lldb::addr_t pc,
+                const char *flavor,
+                std::string &mnemonic,
+                std::string &operands,
+                std::string &comment);
+    
+    void
+    SetStrings (lldb::addr_t file_addr,
+                const ConstString &triple,
+                const Opcode &opcode,
+                lldb::addr_t pc,
+                const char *flavor,
+                const std::string &mnemonic,
+                const std::string &operands,
+                const std::string &comment);
+    
+    void
+    Clear ();
+    
+protected:
+    struct Entry
+    {
+        Entry (lldb::addr_t file_addr, const ConstString &triple) :
+            m_file_addr (file_addr),
+            m_triple (triple),
+            m_opcode (),
+            m_does_branch (eLazyBoolCalculate),
+            m_strings_pc (LLDB_INVALID_ADDRESS),
+            m_flavor (),
+            m_mnemonic (),
+            m_operands (),
+            m_comment ()
+        {
+        }
+        
+        lldb::addr_t m_file_addr;
+        ConstString m_triple;
+        Opcode m_opcode;
+        LazyBool m_does_branch;
+        lldb::addr_t m_strings_pc;  // LLDB_INVALID_ADDRESS if the strings below aren't valid
+        ConstString m_flavor;
+        std::string m_mnemonic;
+        std::string m_operands;
+        std::string m_comment;
+    };
+    
+    typedef std::pair<lldb::addr_t, const char *> EntryKey;    // File address and triple
+    typedef std::list<Entry> EntryList;                         // Most recently used first
+    typedef std::map<EntryKey, EntryList::iterator> EntryMap;
+    
+    // Get the entry for file_addr and triple and make it the most recently
+    // used one, but only if it holds opcode. If create is true the entry is
+    // made to hold opcode instead.
+    Entry *
+    FindEntry (lldb::addr_t file_addr, const ConstString &triple, const Opcode &opcode, bool create);
+    
+    Mutex m_mutex;
+    EntryList m_entry_list;
+    EntryMap m_entries;
+    
+private:
+    DISALLOW_COPY_AND_ASSIGN (DecodedInstructionCache);
+};
+
 class PseudoInstruction : 
     public Instruction
 {
@@ -420,8 +420,24 @@ public:
     virtual bool
     CreateFunctionEntryUnwind (UnwindPlan &unwind_plan);    
 
+    // The most delay slot instructions a branch of this architecture has,
+    // zero if every branch takes effect right away.
+    virtual uint32_t
+    GetMaxBranchDelaySlots ()
+    {
+        return 0;
+    }
+
     static const char *
     TranslateRegister (uint32_t reg_kind, uint32_t reg_num, std::string &reg_name);
+
+    // Evaluates the branch at the pc and then its delay slots with
+    // eEmulateInstructionOptionAutoAdvancePC. Returns true and the address
+    // the pc ends up at if the branch is taken only after its delay slots;
+    // returns false for architectures without delayed branches, branches
+    // that aren't taken and branches that take effect right away.
+    bool
+    EvaluateDelayedBranch (lldb::addr_t &branch_target);
     
     //----------------------------------------------------------------------
     // RegisterInfo variants
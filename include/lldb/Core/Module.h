@@ -690,6 +690,15 @@ public:
     const lldb_private::UUID &
     GetUUID ();
 
+    //------------------------------------------------------------------
+    /// Get the cache of instructions decoded from this module.
+    ///
+    /// Disassemblers keep what they decode from the module's code here
+    /// so that disassembling the same code again is cheap.
+    //------------------------------------------------------------------
+    DecodedInstructionCache &
+    GetDecodedInstructionCache ();
+
     //------------------------------------------------------------------
     /// A debugging function that will cause everything in a module to
     /// be parsed.
@@ -984,6 +993,7 @@ protected:
     TimeValue                   m_object_mod_time;
     lldb::ObjectFileSP          m_objfile_sp;   ///< A shared pointer to the object file parser for this module as it may or may not be shared with the SymbolFile
     std::unique_ptr<SymbolVendor> m_symfile_ap;   ///< A pointer to the symbol vendor for this module.
+    std::unique_ptr<DecodedInstructionCache> m_decoded_instructions_ap; ///< Instructions disassemblers decoded from this module, created on demand
     ClangASTContext             m_ast;          ///< The AST context for this module.
     PathMappingList             m_source_mappings; ///< Module specific source remappings for when you have debug info for a module that doesn't match where the sources currently are
 
@@ -25,6 +25,33 @@ public:
     static void
     Terminate ();
 
+    //------------------------------------------------------------------
+    // Deferred initialization
+    //
+    // Plug-ins with expensive setup register it from their Initialize()
+    // function and run it with RunDeferredInitializer() right before they
+    // first need it, so debug sessions that never use the plug-in don't
+    // pay for it at startup.
+    //------------------------------------------------------------------
+    static bool
+    RegisterDeferredInitializer (const ConstString &name,
+                                 DeferredInitializeCallback init_callback);
+
+    static bool
+    UnregisterDeferredInitializer (DeferredInitializeCallback init_callback);
+
+    static void
+    RunDeferredInitializer (const ConstString &name);
+
+    //------------------------------------------------------------------
+    // The deferred initializer that registers all LLVM targets, target
+    // MCs, asm parsers and disassemblers. Anything that uses the LLVM
+    // target registry (LLVM MC, LLVMCreateDisasm, the JIT) must run it
+    // first.
+    //------------------------------------------------------------------
+    static const ConstString &
+    GetLLVMTargetsInitializerName ();
+
     //------------------------------------------------------------------
     // ABI
     //------------------------------------------------------------------
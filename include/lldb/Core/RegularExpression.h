@@ -206,6 +206,36 @@ public:
     {
         return m_compile_flags;
     }
+    
+    //------------------------------------------------------------------
+    /// Get the number of parenthesized subexpressions.
+    ///
+    /// @return
+    ///     The number of subexpressions in the compiled regular
+    ///     expression, or zero if it isn't valid.
+    //------------------------------------------------------------------
+    size_t
+    GetNumberOfSubexpressions () const
+    {
+        return (m_comp_err == 0) ? m_preg.re_nsub : 0;
+    }
+
+    //------------------------------------------------------------------
+    /// Get a literal string that every match must contain.
+    ///
+    /// Searches of large texts can look for this string first and only
+    /// execute the regular expression where it occurs. Only extended,
+    /// case sensitive expressions without alternation are analyzed.
+    ///
+    /// @param[out] literal
+    ///     The longest literal found in the top level of the
+    ///     expression.
+    ///
+    /// @return
+    ///     \b true if a non-empty literal was found, \b false otherwise.
+    //------------------------------------------------------------------
+    bool
+    GetRequiredLiteral (std::string &literal) const;
 
     //------------------------------------------------------------------
     /// Test if valid.
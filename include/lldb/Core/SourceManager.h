@@ -12,6 +12,7 @@
 
 // C Includes
 // C++ Includes
+#include <list>
 #include <map>
 #include <vector>
 
@@ -19,6 +20,7 @@
 // Project includes
 #include "lldb/lldb-private.h"
 #include "lldb/Host/FileSpec.h"
+#include "lldb/Host/Mutex.h"
 
 namespace lldb_private {
 
@@ -63,6 +65,12 @@ public:
         {
             return m_file_spec;
         }
+
+        const FileSpec &
+        GetOriginalFileSpec () const
+        {
+            return m_file_spec_orig;
+        }
         
         uint32_t
         GetSourceMapModificationID() const
@@ -72,16 +80,44 @@ public:
         
     protected:
 
+        // Reload the file if it changed on disk since it was loaded.
+        void
+        UpdateIfNeeded ();
+
+        // The accessors above without the locking and the update check, for
+        // use while m_mutex is already held.
+        bool
+        GetLineInternal (uint32_t line_no, std::string &buffer);
+
+        uint32_t
+        GetLineOffsetInternal (uint32_t line);
+
+        bool
+        LineIsValidInternal (uint32_t line);
+
         bool
         CalculateLineOffsets (uint32_t line = UINT32_MAX);
 
+        // Files smaller than this are read into memory. A mapped file that is
+        // truncated behind our back raises SIGBUS when a page past its new end
+        // is touched, so only map files big enough for it to pay off.
+        enum { kMemoryMapThreshold = 1024 * 1024 };
+
+        // Load the file contents and forget any line offsets computed for
+        // the previous contents.
+        void
+        LoadFileContents ();
+
         FileSpec m_file_spec_orig;  // The original file spec that was used (can be different from m_file_spec)
         FileSpec m_file_spec;       // The actualy file spec being used (if the target has source mappings, this might be different from m_file_spec_orig)
         TimeValue m_mod_time;       // Keep the modification time that this file data is valid for
         uint32_t m_source_map_mod_id; // If the target uses path remappings, be sure to clear our notion of a source file if the path modification ID changes
         lldb::DataBufferSP m_data_sp;
         typedef std::vector<uint32_t> LineOffsets;
-        LineOffsets m_offsets;
+        LineOffsets m_offsets;      // Start offset of each line indexed so far, m_offsets[0] is line 1
+        size_t m_offsets_scan_pos;  // Offset in m_data_sp where indexing of line offsets will resume
+        bool m_offsets_complete;    // True once the whole file has been indexed
+        Mutex m_mutex;              // Files are shared between source managers and searched from several threads
     };
 
 #endif // SWIG
@@ -92,18 +128,31 @@ public:
 
    // The SourceFileCache class separates the source manager from the cache of source files, so the 
    // cache can be stored in the Debugger, but the source managers can be per target.     
+    // The cache holds at most a fixed number of files and evicts the least
+    // recently used one when it is full.
     class SourceFileCache
     {
     public:
-        SourceFileCache () {}
+        SourceFileCache () :
+            m_file_cache (),
+            m_lru_list (),
+            m_max_files (64),
+            m_mutex (Mutex::eMutexTypeNormal)
+        {
+        }
+
         ~SourceFileCache() {}
         
         void AddSourceFile (const FileSP &file_sp);
-        FileSP FindSourceFile (const FileSpec &file_spec) const;
+        FileSP FindSourceFile (const FileSpec &file_spec);
         
     protected:
-        typedef std::map <FileSpec, FileSP> FileCache;
+        typedef std::list <FileSpec> LRUList;
+        typedef std::map <FileSpec, std::pair<FileSP, LRUList::iterator> > FileCache;
         FileCache m_file_cache;
+        LRUList m_lru_list;         // Most recently used file first
+        size_t m_max_files;
+        Mutex m_mutex;              // Source managers on several threads share the debugger's cache
     };
 #endif
 
@@ -168,6 +217,13 @@ public:
                             uint32_t end_line, 
                             std::vector<uint32_t> &match_lines);
 
+    // Search all lines of several files at once, the files are searched
+    // in parallel. "match_lines" receives one vector per file spec.
+    void
+    FindLinesMatchingRegex (const std::vector<FileSpec> &file_specs,
+                            RegularExpression& regex,
+                            std::vector< std::vector<uint32_t> > &match_lines);
+
 protected:
 
     FileSP
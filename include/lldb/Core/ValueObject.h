@@ -759,6 +759,20 @@ public:
     virtual lldb::ValueObjectSP
     GetChildAtIndex (size_t idx, bool can_create);
 
+    // Get the children in [idx, idx + count) and append them to children.
+    // Children that live next to each other in target memory get their
+    // bytes with a single read for the whole range instead of one read
+    // each. Returns the number of children that were appended.
+    virtual size_t
+    GetChildrenAtIndexRange (size_t idx, size_t count, bool can_create,
+                             std::vector<lldb::ValueObjectSP> &children);
+
+    // Fill the process memory cache with the start of the strings that
+    // the character pointers among values point to, so reading their
+    // summaries one at a time doesn't cost a round trip each.
+    static void
+    PrefetchPointedStrings (const std::vector<lldb::ValueObjectSP> &values);
+
     // this will always create the children if necessary
     lldb::ValueObjectSP
     GetChildAtIndexPath (const std::initializer_list<size_t> &idxs,
@@ -829,6 +843,15 @@ public:
     bool
     GetValueDidChange ();
 
+    // Get a hash of our bytes as of our last update. Anything computed
+    // from our bytes alone is still good as long as the hash is the same.
+    bool
+    GetDataHash (uint64_t &hash) const
+    {
+        hash = m_data_hash;
+        return m_data_hash_valid;
+    }
+
     bool
     UpdateValueIfNeeded (bool update_format = true);
     
@@ -1125,31 +1148,49 @@ public:
 protected:
     typedef ClusterManager<ValueObject> ValueObjectManager;
     
+    // Children are kept in a vector indexed by child index, which is what
+    // arrays and structs fill in from index 0 upward. Indexes past
+    // k_max_dense_children (e.g. a single element far into a huge array)
+    // go into a map so that they don't force a giant vector.
     class ChildrenManager
     {
     public:
         ChildrenManager() :
             m_mutex(Mutex::eMutexTypeRecursive),
-            m_children(),
+            m_dense_children(),
+            m_dense_children_set(),
+            m_sparse_children(),
             m_children_count(0)
         {}
         
+        // True once a child was stored at idx, even if making it failed and
+        // NULL was stored, so that a failed child isn't made again
         bool
         HasChildAtIndex (size_t idx)
         {
             Mutex::Locker locker(m_mutex);
-            ChildrenIterator iter = m_children.find(idx);
-            ChildrenIterator end = m_children.end();
-            return (iter != end);
+            if (idx < k_max_dense_children)
+                return idx < m_dense_children_set.size() && m_dense_children_set[idx];
+            return m_sparse_children.find(idx) != m_sparse_children.end();
+        }
+        
+        // True if there is an actual child object at idx
+        bool
+        HasMaterializedChildAtIndex (size_t idx)
+        {
+            return GetChildAtIndex(idx) != NULL;
         }
         
         ValueObject*
         GetChildAtIndex (size_t idx)
         {
             Mutex::Locker locker(m_mutex);
-            ChildrenIterator iter = m_children.find(idx);
-            ChildrenIterator end = m_children.end();
-            if (iter == end)
+            if (idx < m_dense_children.size())
+                return m_dense_children[idx];
+            if (idx < k_max_dense_children)
+                return NULL;
+            ChildrenIterator iter = m_sparse_children.find(idx);
+            if (iter == m_sparse_children.end())
                 return NULL;
             else
                 return iter->second;
@@ -1158,9 +1199,30 @@ protected:
         void
         SetChildAtIndex (size_t idx, ValueObject* valobj)
         {
-            ChildrenPair pair(idx,valobj); // we do not need to be mutex-protected to make a pair
             Mutex::Locker locker(m_mutex);
-            m_children.insert(pair);
+            if (idx < k_max_dense_children)
+            {
+                if (idx >= m_dense_children.size())
+                {
+                    // Size the vector for all the children we know of up front
+                    // so filling it in doesn't keep reallocating
+                    size_t new_size = idx + 1;
+                    if (m_children_count > new_size && m_children_count <= k_max_dense_children)
+                        new_size = m_children_count;
+                    m_dense_children.resize(new_size, NULL);
+                    m_dense_children_set.resize(new_size, false);
+                }
+                if (!m_dense_children_set[idx])
+                {
+                    m_dense_children[idx] = valobj;
+                    m_dense_children_set[idx] = true;
+                }
+            }
+            else
+            {
+                ChildrenPair pair(idx,valobj);
+                m_sparse_children.insert(pair);
+            }
         }
         
         void
@@ -1175,20 +1237,35 @@ protected:
             return m_children_count;
         }
         
+        // One past the highest index a child was created at among the
+        // first k_max_dense_children indexes
+        size_t
+        GetDenseChildrenEnd ()
+        {
+            Mutex::Locker locker(m_mutex);
+            return m_dense_children.size();
+        }
+        
         void
         Clear()
         {
             m_children_count = 0;
             Mutex::Locker locker(m_mutex);
-            m_children.clear();
+            m_dense_children.clear();
+            m_dense_children_set.clear();
+            m_sparse_children.clear();
         }
         
     private:
+        static const size_t k_max_dense_children = 64 * 1024;
+        typedef std::vector<ValueObject*> ChildrenVector;
         typedef std::map<size_t, ValueObject*> ChildrenMap;
         typedef ChildrenMap::iterator ChildrenIterator;
         typedef ChildrenMap::value_type ChildrenPair;
         Mutex m_mutex;
-        ChildrenMap m_children;
+        ChildrenVector m_dense_children;
+        std::vector<bool> m_dense_children_set;   // Which indexes of m_dense_children were stored
+        ChildrenMap m_sparse_children;
         size_t m_children_count;
     };
 
@@ -1237,6 +1314,9 @@ protected:
     lldb::SyntheticChildrenSP   m_synthetic_children_sp;
     ProcessModID                m_user_id_of_forced_summary;
     AddressType                 m_address_type_of_ptr_or_ref_children;
+    lldb::DataBufferSP          m_children_data_sp;     // Bytes of our children read by PrefetchChildrenData()
+    lldb::addr_t                m_children_data_addr;   // Load address of the first byte in m_children_data_sp
+    uint64_t                    m_data_hash;            // Hash of m_data as of the last successful update
     
     bool                m_value_is_valid:1,
                         m_value_did_change:1,
@@ -1247,12 +1327,15 @@ protected:
                         m_is_bitfield_for_scalar:1,
                         m_is_child_at_offset:1,
                         m_is_getting_summary:1,
-                        m_did_calculate_complete_objc_class_type:1;
+                        m_did_calculate_complete_objc_class_type:1,
+                        m_data_hash_valid:1,
+                        m_data_is_unchanged:1;
     
     friend class ClangExpressionDeclMap;  // For GetValue
     friend class ClangExpressionVariable; // For SetName
     friend class Target;                  // For SetName
     friend class ValueObjectConstResultImpl;
+    friend class ValueObjectChild;        // For GetPrefetchedChildData
 
     //------------------------------------------------------------------
     // Constructors and Destructors
@@ -1331,6 +1414,22 @@ protected:
     void
     ClearDynamicTypeInformation ();
     
+    // Read the bytes of the children in [idx, idx + count) with one memory
+    // access so that the children can take their data from it.
+    void
+    PrefetchChildrenData (size_t idx, size_t count);
+    
+    // Should only be called by ValueObjectChild::UpdateValue(). Fills in
+    // data from the bytes read by PrefetchChildrenData() if they cover
+    // [addr, addr + byte_size).
+    bool
+    GetPrefetchedChildData (lldb::addr_t addr, size_t byte_size, DataExtractor &data);
+    
+    // Hash our bytes and compare them with the ones we had before this
+    // update, setting m_data_is_unchanged accordingly.
+    void
+    UpdateDataHash (bool success);
+    
     //------------------------------------------------------------------
     // Sublasses must implement the functions below.
     //------------------------------------------------------------------
@@ -54,6 +54,10 @@ public:
     virtual lldb::ValueObjectSP
     GetChildAtIndex (size_t idx, bool can_create);
     
+    virtual size_t
+    GetChildrenAtIndexRange (size_t idx, size_t count, bool can_create,
+                             std::vector<lldb::ValueObjectSP> &children);
+    
     virtual lldb::ValueObjectSP
     GetChildMemberWithName (const ConstString &name, bool can_create);
     
@@ -164,6 +168,8 @@ protected:
     uint32_t        m_synthetic_children_count; // FIXME use the ValueObject's ChildrenManager instead of a special purpose solution
     
     ConstString     m_parent_type_name;
+    uint64_t        m_parent_data_hash;         // The hash of our parent's bytes at our last update
+    bool            m_parent_data_hash_valid;
 
     LazyBool        m_might_have_children;
     
@@ -51,6 +51,15 @@ namespace lldb_private {
         size_t
         ExtractIndexFromString (const char* item_name);
         
+        // make a frozen copy of the object of the given type at address. the
+        // read goes through the process memory cache, so front-ends that make
+        // many children out of nearby nodes don't pay for a round-trip each
+        lldb::ValueObjectSP
+        CreateValueObjectCopyFromMemory (const char* name,
+                                         lldb::addr_t address,
+                                         const ExecutionContext& exe_ctx,
+                                         ClangASTType type);
+        
         time_t
         GetOSXEpoch ();
         
@@ -626,10 +635,16 @@ namespace lldb_private {
             virtual
             ~LibstdcppVectorBoolSyntheticFrontEnd ();
         private:
+            bool
+            ReadStorageByte (size_t byte_idx, uint8_t &byte);
+            
             ExecutionContextRef m_exe_ctx_ref;
             uint64_t m_count;
             lldb::addr_t m_base_data_address;
             EvaluateExpressionOptions m_options;
+            std::map<size_t,lldb::ValueObjectSP> m_children;
+            std::vector<uint8_t> m_page;        // a window of the bit storage
+            size_t m_page_byte_idx;             // index of the first byte of m_page in the storage
         };
         
         SyntheticChildrenFrontEnd* LibstdcppVectorBoolSyntheticFrontEndCreator (CXXSyntheticChildren*, lldb::ValueObjectSP);
@@ -815,7 +830,13 @@ namespace lldb_private {
             ~LibcxxStdListSyntheticFrontEnd ();
         private:
             bool
-            HasLoop();
+            GetNodeLayout ();
+            
+            lldb::addr_t
+            GetNodeAtIndex (size_t idx);
+            
+            void
+            DropRepeatedNodes (size_t period);
             
             size_t m_list_capping_size;
             static const bool g_use_loop_detect = true;
@@ -825,6 +846,10 @@ namespace lldb_private {
             ClangASTType m_element_type;
             size_t m_count;
             std::map<size_t,lldb::ValueObjectSP> m_children;
+            std::vector<lldb::addr_t> m_nodes;  // the node of every child we walked to so far, in order
+            uint32_t m_next_offset;             // offset of __next_ in a node
+            uint32_t m_value_offset;            // offset of __value_ in a node
+            bool m_walk_done;                   // reached the end of the list (or found a loop)
         };
         
         SyntheticChildrenFrontEnd* LibcxxStdListSyntheticFrontEndCreator (CXXSyntheticChildren*, lldb::ValueObjectSP);
@@ -858,12 +883,25 @@ namespace lldb_private {
             void
             GetValueOffset (const lldb::ValueObjectSP& node);
             
+            bool
+            GetNodeLayout ();
+            
+            lldb::addr_t
+            GetNextNode (Process &process, lldb::addr_t node);
+            
+            lldb::addr_t
+            GetNodeAtIndex (size_t idx);
+            
             ValueObject* m_tree;
             ValueObject* m_root_node;
             ClangASTType m_element_type;
             uint32_t m_skip_size;
             size_t m_count;
             std::map<size_t,lldb::ValueObjectSP> m_children;
+            std::vector<lldb::addr_t> m_nodes;  // the node of every child we walked to so far, in order
+            uint32_t m_left_offset;             // offsets of the links in a node
+            uint32_t m_right_offset;
+            uint32_t m_parent_offset;
         };
         
         SyntheticChildrenFrontEnd* LibcxxStdMapSyntheticFrontEndCreator (CXXSyntheticChildren*, lldb::ValueObjectSP);
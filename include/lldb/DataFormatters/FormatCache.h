@@ -12,15 +12,32 @@
 
 // C Includes
 // C++ Includes
-#include <map>
 
 // Other libraries and framework includes
+#include "llvm/ADT/DenseMap.h"
+
 // Project includes
 #include "lldb/lldb-public.h"
 #include "lldb/Core/ConstString.h"
 #include "lldb/DataFormatters/FormatClasses.h"
+#include "lldb/DataFormatters/TypeCategoryMap.h"
+#include "lldb/Host/Mutex.h"
 
 namespace lldb_private {
+
+//----------------------------------------------------------------------
+// Caches the summary and synthetic children lookups of FormatManager by
+// type name. A NULL formatter is cached like any other result so types
+// without formatters don't make us scan the categories again.
+//
+// Entries remember the TypeCategoryMap::Revision they were looked up in,
+// i.e. the revisions of the categories the lookup consulted. A change to a
+// category only makes the entries that depended on it stale, and those are
+// dropped the next time they are looked up. The cache is split in shards,
+// each with its own lock, keyed by the ConstString pointer. The shard locks
+// are only held around the map accesses and never while the categories
+// are consulted.
+//----------------------------------------------------------------------
 class FormatCache
 {
 private:
@@ -30,19 +47,37 @@ private:
         bool m_summary_cached : 1;
         bool m_synthetic_cached : 1;
         
+        TypeCategoryMap::Revision m_summary_revision;
+        TypeCategoryMap::Revision m_synthetic_revision;
+        
         lldb::TypeSummaryImplSP m_summary_sp;
         lldb::SyntheticChildrenSP m_synthetic_sp;
     public:
         Entry ();
-        Entry (lldb::TypeSummaryImplSP);
-        Entry (lldb::SyntheticChildrenSP);
-        Entry (lldb::TypeSummaryImplSP,lldb::SyntheticChildrenSP);
 
         bool
-        IsSummaryCached ();
+        IsSummaryCached () const
+        {
+            return m_summary_cached;
+        }
         
         bool
-        IsSyntheticCached ();
+        IsSyntheticCached () const
+        {
+            return m_synthetic_cached;
+        }
+        
+        const TypeCategoryMap::Revision&
+        GetSummaryRevision () const
+        {
+            return m_summary_revision;
+        }
+        
+        const TypeCategoryMap::Revision&
+        GetSyntheticRevision () const
+        {
+            return m_synthetic_revision;
+        }
         
         lldb::TypeSummaryImplSP
         GetSummary ();
@@ -51,40 +86,66 @@ private:
         GetSynthetic ();
         
         void
-        SetSummary (lldb::TypeSummaryImplSP);
+        SetSummary (lldb::TypeSummaryImplSP, const TypeCategoryMap::Revision& revision);
         
         void
-        SetSynthetic (lldb::SyntheticChildrenSP);
+        SetSynthetic (lldb::SyntheticChildrenSP, const TypeCategoryMap::Revision& revision);
+        
+        void
+        ClearSummary ();
+        
+        void
+        ClearSynthetic ();
     };
-    typedef std::map<ConstString,Entry> CacheMap;
-    CacheMap m_map;
-    Mutex m_mutex;
+    
+    enum { kNumShards = 16 };
+    
+    typedef llvm::DenseMap<const char *, Entry> CacheMap;
+    
+    struct Shard
+    {
+        Shard () :
+            m_map (),
+            m_mutex (Mutex::eMutexTypeNormal)
+        {
+        }
+        
+        CacheMap m_map;
+        Mutex m_mutex;
+    };
+    
+    Shard m_shards[kNumShards];
     
 #ifdef LLDB_CONFIGURATION_DEBUG
     uint64_t m_cache_hits;
     uint64_t m_cache_misses;
 #endif
     
-    Entry&
-    GetEntry (const ConstString& type);
+    Shard&
+    GetShard (const ConstString& type);
+    
+    void
+    DropSummary (const ConstString& type, const TypeCategoryMap::Revision& revision);
+    
+    void
+    DropSynthetic (const ConstString& type, const TypeCategoryMap::Revision& revision);
     
 public:
     FormatCache ();
     
+    // Returns true and fills in the formatter if a lookup for "type" is
+    // cached and still current for "categories". A stale entry is dropped.
     bool
-    GetSummary (const ConstString& type,lldb::TypeSummaryImplSP& summary_sp);
+    GetSummary (const ConstString& type,TypeCategoryMap& categories,lldb::TypeSummaryImplSP& summary_sp);
 
     bool
-    GetSynthetic (const ConstString& type,lldb::SyntheticChildrenSP& synthetic_sp);
-    
-    void
-    SetSummary (const ConstString& type,lldb::TypeSummaryImplSP& summary_sp);
+    GetSynthetic (const ConstString& type,TypeCategoryMap& categories,lldb::SyntheticChildrenSP& synthetic_sp);
     
     void
-    SetSynthetic (const ConstString& type,lldb::SyntheticChildrenSP& synthetic_sp);
+    SetSummary (const ConstString& type,lldb::TypeSummaryImplSP& summary_sp,const TypeCategoryMap::Revision& revision);
     
     void
-    Clear ();
+    SetSynthetic (const ConstString& type,lldb::SyntheticChildrenSP& synthetic_sp,const TypeCategoryMap::Revision& revision);
     
 #ifdef LLDB_CONFIGURATION_DEBUG
     uint64_t
@@ -192,7 +192,6 @@ public:
     Changed ()
     {
         __sync_add_and_fetch(&m_last_revision, +1);
-        m_format_cache.Clear ();
     }
     
     uint32_t
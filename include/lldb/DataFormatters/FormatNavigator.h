@@ -12,6 +12,8 @@
 
 // C Includes
 // C++ Includes
+#include <string>
+#include <vector>
 
 // Other libraries and framework includes
 #include "clang/AST/DeclCXX.h"
@@ -99,6 +101,124 @@ GetValidTypeName_Impl (const ConstString& type)
     return ConstString(type_cstr);
 }
     
+//----------------------------------------------------------------------
+// Matches a type name against all the regular expressions of a regex
+// FormatNavigator at once. The expressions are joined into a single
+// alternation "(re0)|(re1)|..." and the group that took part in a match
+// tells which alternative matched. POSIX picks the longest match rather
+// than the first alternative, so the alternatives before that one still
+// have to be tried in order to keep first-match-wins, but names that
+// match nothing - by far the common case - cost one regexec().
+//----------------------------------------------------------------------
+class FormatRegexMatcher
+{
+public:
+    typedef std::vector<const RegularExpression *> RegexList;
+    
+    FormatRegexMatcher () :
+        m_combined (),
+        m_group_indexes (),
+        m_num_groups (0),
+        m_generation (UINT32_MAX),
+        m_valid (false)
+    {
+    }
+    
+    bool
+    IsValid () const
+    {
+        return m_valid;
+    }
+    
+    uint32_t
+    GetGeneration () const
+    {
+        return m_generation;
+    }
+    
+    // Rebuild the matcher from regexes, in the order they are tried. If
+    // they can't be combined the matcher stays invalid and the caller has
+    // to try the expressions one by one.
+    bool
+    Build (const RegexList &regexes, uint32_t generation)
+    {
+        m_generation = generation;
+        m_valid = false;
+        m_group_indexes.clear();
+        m_num_groups = 0;
+        m_combined.Clear();
+        
+        if (regexes.empty())
+            return false;
+        
+        std::string combined_text;
+        
+        for (RegexList::const_iterator pos = regexes.begin(), end = regexes.end(); pos != end; ++pos)
+        {
+            const RegularExpression *regex = *pos;
+            
+            if (!regex->IsValid() || regex->GetCompileFlags() != REG_EXTENDED)
+                return false;
+            
+            const char *text = regex->GetText();
+            
+            // Back references would refer to the wrong groups once the
+            // expressions are wrapped
+            for (const char *p = text; *p; ++p)
+            {
+                if (p[0] == '\\' && p[1] >= '1' && p[1] <= '9')
+                    return false;
+            }
+            
+            if (!combined_text.empty())
+                combined_text.push_back('|');
+            combined_text.push_back('(');
+            combined_text.append(text);
+            combined_text.push_back(')');
+            
+            m_group_indexes.push_back(m_num_groups + 1);
+            m_num_groups += 1 + regex->GetNumberOfSubexpressions();
+        }
+        
+        if (!m_combined.Compile(combined_text.c_str(), REG_EXTENDED))
+            return false;
+        
+        if (m_combined.GetNumberOfSubexpressions() != m_num_groups)
+            return false;
+        
+        m_valid = true;
+        return true;
+    }
+    
+    // Returns the index of an expression that matches name, which is not
+    // necessarily the first one, or UINT32_MAX if none does.
+    uint32_t
+    Match (const char *name) const
+    {
+        RegularExpression::Match match(m_num_groups);
+        
+        if (!m_combined.Execute(name, &match))
+            return UINT32_MAX;
+        
+        const regmatch_t *groups = match.GetData();
+        
+        for (size_t i = 0, e = m_group_indexes.size(); i < e; ++i)
+        {
+            if (groups[m_group_indexes[i]].rm_so != -1)
+                return i;
+        }
+        
+        return UINT32_MAX;
+    }
+    
+private:
+    RegularExpression m_combined;
+    std::vector<uint32_t> m_group_indexes;  // The group of each expression in m_combined
+    uint32_t m_num_groups;
+    uint32_t m_generation;                  // The FormatMap generation the matcher was built for
+    bool m_valid;
+};
+    
 template<typename KeyType, typename ValueType>
 class FormatNavigator;
 
@@ -115,7 +235,8 @@ public:
     FormatMap(IFormatChangeListener* lst) :
     m_map(),
     m_map_mutex(Mutex::eMutexTypeRecursive),
-    listener(lst)
+    listener(lst),
+    m_generation(0)
     {
     }
     
@@ -130,6 +251,7 @@ public:
 
         Mutex::Locker locker(m_map_mutex);
         m_map[name] = entry;
+        m_generation++;
         if (listener)
             listener->Changed();
     }
@@ -142,6 +264,7 @@ public:
         if (iter == m_map.end())
             return false;
         m_map.erase(name);
+        m_generation++;
         if (listener)
             listener->Changed();
         return true;
@@ -152,6 +275,7 @@ public:
     {
         Mutex::Locker locker(m_map_mutex);
         m_map.clear();
+        m_generation++;
         if (listener)
             listener->Changed();
     }
@@ -226,6 +350,7 @@ protected:
     MapType m_map;    
     Mutex m_map_mutex;
     IFormatChangeListener* listener;
+    uint32_t m_generation;  ///< Bumped whenever m_map changes
     
     MapType&
     map ()
@@ -346,6 +471,8 @@ protected:
     
     std::string m_name;
     
+    FormatRegexMatcher m_regex_matcher;     ///< Only used by navigators keyed by regular expressions
+    
     DISALLOW_COPY_AND_ASSIGN(FormatNavigator);
     
     ConstString m_id_cs;
@@ -379,6 +506,7 @@ protected:
            if ( ::strcmp(type.AsCString(),regex->GetText()) == 0)
            {
                m_format_map.map().erase(pos);
+               m_format_map.m_generation++;
                if (m_format_map.listener)
                    m_format_map.listener->Changed();
                return true;
@@ -429,10 +557,18 @@ protected:
        Mutex& x_mutex = m_format_map.mutex();
        lldb_private::Mutex::Locker locker(x_mutex);
        MapIterator pos, end = m_format_map.map().end();
-       for (pos = m_format_map.map().begin(); pos != end; pos++)
+       uint32_t known_match = UINT32_MAX;
+       if (UpdateRegexMatcher())
+       {
+           known_match = m_regex_matcher.Match(key_cstr);
+           if (known_match == UINT32_MAX)
+               return false;
+       }
+       uint32_t index = 0;
+       for (pos = m_format_map.map().begin(); pos != end; pos++, index++)
        {
            lldb::RegularExpressionSP regex = pos->first;
-           if (regex->Execute(key_cstr))
+           if (index == known_match || regex->Execute(key_cstr))
            {
                value = pos->second;
                return true;
@@ -441,6 +577,23 @@ protected:
        return false;
     }
     
+    // Bring m_regex_matcher up to date with the expressions in the map;
+    // the map's mutex must be held. Returns false if the matcher can't be
+    // used for them.
+    bool
+    UpdateRegexMatcher ()
+    {
+        if (m_regex_matcher.GetGeneration() != m_format_map.m_generation)
+        {
+            FormatRegexMatcher::RegexList regexes;
+            MapIterator pos, end = m_format_map.map().end();
+            for (pos = m_format_map.map().begin(); pos != end; pos++)
+                regexes.push_back(pos->first.get());
+            m_regex_matcher.Build(regexes, m_format_map.m_generation);
+        }
+        return m_regex_matcher.IsValid();
+    }
+    
     bool
     GetExact_Impl (ConstString key, MapValueType& value, lldb::RegularExpressionSP *dummy)
     {
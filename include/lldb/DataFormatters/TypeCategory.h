@@ -21,7 +21,7 @@
 #include "lldb/DataFormatters/FormatNavigator.h"
 
 namespace lldb_private {    
-    class TypeCategoryImpl
+    class TypeCategoryImpl : public IFormatChangeListener
     {
     private:
         
@@ -173,6 +173,24 @@ namespace lldb_private {
             return m_name.GetCString();
         }
         
+        // The navigators of this category report their changes here; the
+        // category bumps its own revision and passes them on.
+        virtual void
+        Changed ();
+        
+        virtual uint32_t
+        GetCurrentRevision ();
+        
+        // Bumped whenever a formatter of this category is added or removed,
+        // or the category is enabled or disabled. Lookups cached by
+        // FormatCache only depend on the revisions of the categories they
+        // consulted.
+        uint32_t
+        GetRevision () const
+        {
+            return m_revision;
+        }
+        
         bool
         AnyMatches (ConstString type_name,
                     FormatCategoryItems items = ALL_ITEM_TYPES,
@@ -200,6 +218,8 @@ namespace lldb_private {
         
         ConstString m_name;
         
+        uint32_t m_revision;
+        
         uint32_t m_enabled_position;
         
         void
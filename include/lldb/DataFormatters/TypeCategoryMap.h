@@ -41,6 +41,32 @@ namespace lldb_private {
         static const Position Default = 1;
         static const Position Last = UINT32_MAX;
         
+        // What a summary or synthetic children lookup depended on: the
+        // enabled categories and their order, and the revisions of the
+        // categories consulted until one of them had a match. Categories
+        // after the matching one can change without affecting the result.
+        struct Revision
+        {
+            Revision () :
+                m_map_revision (0),
+                m_depth (0),
+                m_categories_revision (0)
+            {
+            }
+            
+            bool
+            operator == (const Revision& rhs) const
+            {
+                return m_map_revision == rhs.m_map_revision &&
+                       m_depth == rhs.m_depth &&
+                       m_categories_revision == rhs.m_categories_revision;
+            }
+            
+            uint32_t m_map_revision;
+            uint32_t m_depth;
+            uint32_t m_categories_revision;
+        };
+        
         TypeCategoryMap (IFormatChangeListener* lst);
         
         void
@@ -96,14 +122,21 @@ namespace lldb_private {
         
         lldb::TypeSummaryImplSP
         GetSummaryFormat (ValueObject& valobj,
-                          lldb::DynamicValueType use_dynamic);
+                          lldb::DynamicValueType use_dynamic,
+                          Revision* revision = NULL);
         
 #ifndef LLDB_DISABLE_PYTHON
         lldb::SyntheticChildrenSP
         GetSyntheticChildren (ValueObject& valobj,
-                              lldb::DynamicValueType use_dynamic);
+                              lldb::DynamicValueType use_dynamic,
+                              Revision* revision = NULL);
 #endif
         
+        // Returns true if a lookup made at "revision" would still give the
+        // same result.
+        bool
+        IsCurrent (const Revision& revision);
+        
     private:
         
         class delete_matching_categories
@@ -121,6 +154,7 @@ namespace lldb_private {
         
         Mutex m_map_mutex;
         IFormatChangeListener* listener;
+        uint32_t m_revision;
         
         MapType m_map;
         ActiveCategoriesList m_active_categories;
@@ -53,6 +53,18 @@ namespace lldb_private {
         virtual size_t
         GetIndexOfChildWithName (const ConstString &name) = 0;
         
+        // append one entry per index in [idx, idx + count) to children, an empty
+        // shared pointer for any child that could not be made. front-ends that
+        // walk a linked structure should override this so that a page of children
+        // costs one walk instead of one walk per child
+        virtual size_t
+        GetChildrenAtIndexRange (size_t idx, size_t count, std::vector<lldb::ValueObjectSP> &children)
+        {
+            for (size_t i = idx; i < idx + count; ++i)
+                children.push_back(GetChildAtIndex(i));
+            return count;
+        }
+        
         // this function is assumed to always succeed and it if fails, the front-end should know to deal
         // with it in the correct way (most probably, by refusing to return any children)
         // the return value of Update() should actually be interpreted as "ValueObjectSyntheticFilter cache is good/bad"
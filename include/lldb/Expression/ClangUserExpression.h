@@ -26,7 +26,9 @@
 #include "lldb/Expression/ClangExpression.h"
 #include "lldb/Expression/ClangExpressionVariable.h"
 #include "lldb/Expression/IRForTarget.h"
+#include "lldb/Expression/IRInterpreter.h"
 #include "lldb/Expression/Materializer.h"
+#include "lldb/Host/Mutex.h"
 #include "lldb/Symbol/TaggedASTType.h"
 #include "lldb/Target/ExecutionContext.h"
 
@@ -116,6 +118,21 @@ public:
     bool
     MatchesContext (ExecutionContext &exe_ctx);
     
+    //------------------------------------------------------------------
+    /// Re-point an already parsed expression at the frame in exe_ctx.
+    ///
+    /// The caller must make sure the frame is stopped in the same
+    /// lexical scope the expression was parsed in, so the declarations
+    /// the parser found and the layout of the materialized struct are
+    /// still valid.
+    ///
+    /// @return
+    ///     True if the expression can be executed in exe_ctx without
+    ///     being parsed again; false otherwise.
+    //------------------------------------------------------------------
+    bool
+    RebindContext (ExecutionContext &exe_ctx);
+    
     //------------------------------------------------------------------
     /// Execute the parsed expression
     ///
@@ -411,6 +428,7 @@ private:
     
     std::unique_ptr<ClangExpressionDeclMap>      m_expr_decl_map;        ///< The map to use when parsing the expression.
     std::unique_ptr<IRExecutionUnit>             m_execution_unit_ap;    ///< The execution unit the expression is stored in.
+    IRInterpreter::DecodedFunctionSP            m_interpreter_function_sp; ///< The expression's function as decoded by the IRInterpreter, kept for the next time it is interpreted.
     std::unique_ptr<Materializer>                m_materializer_ap;      ///< The materializer to use when running the expression.
     std::unique_ptr<ASTResultSynthesizer>        m_result_synthesizer;   ///< The result synthesizer, if one is needed.
     
@@ -426,6 +444,67 @@ private:
     lldb::addr_t                                m_materialized_address; ///< The address at which the arguments to the expression have been materialized.
     Materializer::DematerializerSP              m_dematerializer_sp;    ///< The dematerializer.
 };
+
+//----------------------------------------------------------------------
+/// @class ClangUserExpressionCache ClangUserExpression.h "lldb/Expression/ClangUserExpression.h"
+/// @brief Parsed and JIT compiled user expressions kept by a Target
+///
+/// Expressions that are evaluated over and over in the same scope, like
+/// stop-hook and display expressions, are kept here after they ran so
+/// the next evaluation can skip the parser and the JIT.  An expression
+/// is handed out to a single user at a time; Take removes it from the
+/// cache and Give puts it back once it has finished executing.
+//----------------------------------------------------------------------
+class ClangUserExpressionCache
+{
+public:
+    ClangUserExpressionCache ();
+    
+    ~ClangUserExpressionCache ();
+    
+    //------------------------------------------------------------------
+    /// Make the key under which an expression evaluated in exe_ctx is
+    /// cached.
+    ///
+    /// @return
+    ///     False if the expression must not be cached, e.g. because it
+    ///     refers to or declares persistent variables.
+    //------------------------------------------------------------------
+    static bool
+    MakeKey (ExecutionContext &exe_ctx,
+             lldb_private::ExecutionPolicy execution_policy,
+             lldb::LanguageType language,
+             ClangUserExpression::ResultType desired_type,
+             const char *expr_cstr,
+             const char *expr_prefix,
+             std::string &key);
+    
+    ClangUserExpression::ClangUserExpressionSP
+    Take (const std::string &key, ExecutionContext &exe_ctx);
+    
+    void
+    Give (const std::string &key, const ClangUserExpression::ClangUserExpressionSP &expr_sp);
+    
+    void
+    Clear ();
+    
+private:
+    enum { kMaxEntries = 64 };
+    
+    struct Entry
+    {
+        ClangUserExpression::ClangUserExpressionSP expr_sp;
+        uint32_t last_use;
+    };
+    
+    typedef std::map<std::string, Entry> EntryMap;
+    
+    Mutex       m_mutex;
+    EntryMap    m_entries;
+    uint32_t    m_use_counter;
+    
+    DISALLOW_COPY_AND_ASSIGN (ClangUserExpressionCache);
+};
     
 } // namespace lldb_private
 
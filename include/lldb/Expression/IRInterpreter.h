@@ -41,6 +41,14 @@ class IRMemoryMap;
 class IRInterpreter
 {
 public:
+    //------------------------------------------------------------------
+    /// The decoded form of a function.  Callers that interpret the same
+    /// function more than once keep one of these between calls to
+    /// Interpret() so that the function is only decoded the first time.
+    //------------------------------------------------------------------
+    class DecodedFunction;
+    typedef std::shared_ptr<DecodedFunction> DecodedFunctionSP;
+    
     static bool
     CanInterpret (llvm::Module &module,
                   llvm::Function &function,
@@ -53,7 +61,8 @@ public:
                lldb_private::IRMemoryMap &memory_map,
                lldb_private::Error &error,
                lldb::addr_t stack_frame_bottom,
-               lldb::addr_t stack_frame_top);
+               lldb::addr_t stack_frame_top,
+               DecodedFunctionSP *decoded_function_sp = NULL);
     
 private:   
     static bool
@@ -15,6 +15,7 @@
 #include "lldb/Core/UserID.h"
 
 #include <map>
+#include <vector>
 
 namespace lldb_private
 {
@@ -33,6 +34,13 @@ namespace lldb_private
 /// address in the tar at which they reside.  If the inferior does not
 /// exist, allocations still get made-up addresses.  If an inferior appears
 /// at some point, then those addresses need to be re-mapped.
+///
+/// Small allocations are carved out of larger regions (arenas) that are
+/// reserved once per map and released as a whole when the map goes away,
+/// so materializing an expression doesn't cost a round trip to the
+/// process (or a probe for free address space) per variable.  Memory that
+/// must outlive the map is allocated with MallocLeaked() and never comes
+/// from an arena.
 //----------------------------------------------------------------------
 class IRMemoryMap
 {
@@ -50,6 +58,7 @@ public:
     };
 
     lldb::addr_t Malloc (size_t size, uint8_t alignment, uint32_t permissions, AllocationPolicy policy, Error &error);
+    lldb::addr_t MallocLeaked (size_t size, uint8_t alignment, uint32_t permissions, AllocationPolicy policy, Error &error);
     void Leak (lldb::addr_t process_address, Error &error);
     void Free (lldb::addr_t process_address, Error &error);
     
@@ -77,6 +86,12 @@ protected:
     }
     
 private:
+    enum
+    {
+        kArenaMaxAllocationSize = 1024,         ///< Larger allocations get a region of their own
+        kArenaRegionSize        = 16 * 1024     ///< The size of the regions arenas reserve
+    };
+    
     struct Allocation
     {
         lldb::addr_t    m_process_alloc;    ///< The (unaligned) base for the remote allocation
@@ -89,13 +104,15 @@ private:
         ///< Flags
         AllocationPolicy    m_policy;
         bool                m_leak;
+        uint32_t            m_arena_index;      ///< The arena the allocation was carved from, or UINT32_MAX if it has its own region
     public:
         Allocation (lldb::addr_t process_alloc,
                     lldb::addr_t process_start,
                     size_t size,
                     uint32_t permissions,
                     uint8_t alignment,
-                    AllocationPolicy m_policy);
+                    AllocationPolicy m_policy,
+                    uint32_t arena_index = UINT32_MAX);
 
         Allocation () :
             m_process_alloc (LLDB_INVALID_ADDRESS),
@@ -105,17 +122,39 @@ private:
             m_alignment (0),
             m_data (),
             m_policy (eAllocationPolicyInvalid),
-            m_leak (false)
+            m_leak (false),
+            m_arena_index (UINT32_MAX)
         {
         }
     };
     
+    typedef std::multimap<size_t, lldb::addr_t> FreeBlockMap;
+    
+    struct Arena
+    {
+        lldb::addr_t        m_process_alloc;    ///< The base of the region in the process
+        size_t              m_size;             ///< The size of the region
+        size_t              m_used;             ///< The number of bytes handed out from the start of the region
+        uint32_t            m_permissions;
+        AllocationPolicy    m_policy;
+        uint32_t            m_num_live;         ///< The number of allocations carved from the region that are still alive
+        FreeBlockMap        m_free_blocks;      ///< Freed allocations by size, reused before the region grows
+    };
+    
+    typedef std::vector<Arena> ArenaVector;
+    
     lldb::ProcessWP                             m_process_wp;
     lldb::TargetWP                              m_target_wp;
     typedef std::map<lldb::addr_t, Allocation>  AllocationMap;
     AllocationMap                               m_allocations;
+    ArenaVector                                 m_arenas;
         
+    lldb::addr_t DoMalloc (size_t size, uint8_t alignment, uint32_t permissions, AllocationPolicy policy, bool use_arena, Error &error);
     lldb::addr_t FindSpace (size_t size);
+    lldb::addr_t AllocateRegion (size_t size, uint32_t permissions, AllocationPolicy policy, Error &error);
+    void FreeRegion (lldb::addr_t process_alloc, AllocationPolicy policy);
+    lldb::addr_t MallocFromArena (size_t size, uint8_t alignment, uint32_t permissions, AllocationPolicy policy);
+    void FreeToArena (Allocation &allocation);
     bool ContainsHostOnlyAllocations ();
     AllocationMap::iterator FindAllocation (lldb::addr_t addr, size_t size);
     bool IntersectsAllocation (lldb::addr_t addr, size_t size);
@@ -107,6 +107,33 @@ public:
     void
     InsertSequence (LineSequence* sequence);
 
+    //------------------------------------------------------------------
+    /// Pack the line entries into a compact representation.
+    ///
+    /// Line tables are one of the largest consumers of memory for
+    /// debug information, so once a line table has been fully
+    /// populated the rows are re-encoded as a byte stream of deltas
+    /// from the previous row: a flags byte followed by LEB128 address
+    /// and line deltas, with the column and file index only present
+    /// when they change. Every kNumEntriesPerCheckpoint rows a fully
+    /// decoded row is kept so that address lookups are a binary search
+    /// of the checkpoints followed by a short linear decode, and the
+    /// start and end address of each sequence are kept in a separate
+    /// table.
+    ///
+    /// Any later call to InsertLineEntry() or InsertSequence() unpacks
+    /// the table again.
+    //------------------------------------------------------------------
+    void
+    Compact ();
+
+    //------------------------------------------------------------------
+    /// Dump the number of rows and sequences in this line table along
+    /// with how many bytes they take up to the stream \a s.
+    //------------------------------------------------------------------
+    void
+    DumpStatistics (Stream *s) const;
+
     //------------------------------------------------------------------
     /// Dump all line entries in this line table to the stream \a s.
     ///
@@ -379,16 +406,95 @@ protected:
         Entry *a_entry;
     };
 
+    enum
+    {
+        kNumEntriesPerCheckpoint = 16
+    };
+
+    //------------------------------------------------------------------
+    // A fully decoded copy of every kNumEntriesPerCheckpoint'th row of
+    // a packed line table along with the offset in the packed data of
+    // the row that follows it.
+    //------------------------------------------------------------------
+    struct Checkpoint
+    {
+        Entry entry;
+        uint32_t data_offset;
+
+        static bool FileAddressLessThan (const Checkpoint& lhs, lldb::addr_t file_addr)
+        {
+            return lhs.entry.file_addr < file_addr;
+        }
+    };
+
+    //------------------------------------------------------------------
+    // The address range and rows of one sequence of a packed line
+    // table. A sequence is a run of rows that ends with a terminal
+    // entry.
+    //------------------------------------------------------------------
+    struct Sequence
+    {
+        lldb::addr_t base_addr;
+        lldb::addr_t end_addr;
+        uint32_t first_entry_idx;
+        uint32_t num_entries;
+    };
+
+    //------------------------------------------------------------------
+    // Walks the rows of a line table in order, whether or not the line
+    // table has been packed. Advancing to the next row is O(1).
+    //------------------------------------------------------------------
+    class EntryIterator
+    {
+    public:
+        EntryIterator (const LineTable &line_table, uint32_t idx = 0);
+
+        bool
+        IsValid () const
+        {
+            return m_idx < m_line_table.GetSize();
+        }
+
+        uint32_t
+        GetIndex () const
+        {
+            return m_idx;
+        }
+
+        const Entry &
+        GetEntry () const
+        {
+            return m_entry;
+        }
+
+        void
+        Next ();
+
+    protected:
+        const LineTable &m_line_table;
+        uint32_t m_idx;
+        uint32_t m_data_offset;
+        Entry m_entry;
+    };
+
+    friend class EntryIterator;
+
     //------------------------------------------------------------------
     // Types
     //------------------------------------------------------------------
     typedef std::vector<lldb_private::Section*> section_collection; ///< The collection type for the sections.
     typedef std::vector<Entry>                  entry_collection;   ///< The collection type for the line entries.
+    typedef std::vector<Checkpoint>             checkpoint_collection;
+    typedef std::vector<Sequence>               sequence_collection;
     //------------------------------------------------------------------
     // Member variables.
     //------------------------------------------------------------------
     CompileUnit* m_comp_unit;   ///< The compile unit that this line table belongs to.
-    entry_collection m_entries; ///< The collection of line entries in this line table.
+    entry_collection m_entries; ///< The collection of line entries in this line table if it isn't packed.
+    uint32_t m_num_packed_entries;              ///< The number of line entries if this line table is packed.
+    std::vector<uint8_t> m_packed_data;         ///< The delta encoded line entries if this line table is packed.
+    checkpoint_collection m_checkpoints;        ///< Decoded line entries for fast random access into m_packed_data.
+    sequence_collection m_sequences;            ///< The sequences in m_packed_data.
 
     //------------------------------------------------------------------
     // Helper class
@@ -410,9 +516,27 @@ protected:
         entry_collection m_entries; ///< The collection of line entries in this sequence.
     };
 
+    bool
+    IsPacked () const
+    {
+        return m_num_packed_entries > 0;
+    }
+
+    void
+    Unpack ();
+
+    bool
+    GetEntryAtIndex (uint32_t idx, Entry &entry) const;
+
+    uint32_t
+    LowerBoundFileAddress (lldb::addr_t file_addr) const;
+
     bool
     ConvertEntryAtIndexToLineEntry (uint32_t idx, LineEntry &line_entry);
 
+    bool
+    ConvertEntryToLineEntry (const Entry &entry, const Entry *next_entry, LineEntry &line_entry);
+
 private:
     DISALLOW_COPY_AND_ASSIGN (LineTable);
 };
@@ -257,6 +257,12 @@ public:
         void
         SetRegisterInfo (uint32_t reg_num, const RegisterLocation register_location);
     
+        // Get the lowest and highest CFA relative offsets at which this
+        // row says registers were saved. Returns false if no register is
+        // saved at a CFA relative address.
+        bool
+        GetSavedRegisterOffsetRange (int32_t &min_offset, int32_t &max_offset) const;
+
         lldb::addr_t
         GetOffset() const
         {
@@ -97,6 +97,9 @@ public:
     
     void
     SetDetachKeepsStopped (bool keep_stopped);
+
+    uint64_t
+    GetStackPrefetchSize () const;
 };
 
 typedef std::shared_ptr<ProcessProperties> ProcessPropertiesSP;
@@ -2763,6 +2766,45 @@ public:
                            std::string &out_str,
                            Error &error);
 
+    //------------------------------------------------------------------
+    /// Fill the process memory cache with the start of many strings.
+    ///
+    /// The cache lines holding the first \a max_bytes bytes of every
+    /// string (at most one line's worth) are fetched, with lines that are
+    /// close to each other merged into a single read.  Clients that read
+    /// the strings one at a time later on, like the string summary
+    /// formatters, then get them from the memory cache.
+    ///
+    /// @param[in] addrs
+    ///     The virtual load addresses of the strings.
+    ///
+    /// @param[in] max_bytes
+    ///     The maximum number of bytes that will be read for each string.
+    ///
+    /// @return
+    ///     The number of bytes that were added to the memory cache.
+    //------------------------------------------------------------------
+    size_t
+    PrefetchStringsFromMemory (const std::vector<lldb::addr_t> &addrs,
+                               size_t max_bytes);
+
+    //------------------------------------------------------------------
+    /// Fill the process memory cache for a range of memory.
+    ///
+    /// All cache lines that overlap [vm_addr, vm_addr + size) and that
+    /// are not already cached are read from the process using a single
+    /// memory read. This lets clients that know they will soon make
+    /// many small reads from one region (like the unwinder walking the
+    /// stack) avoid a round trip to the process per read.
+    ///
+    /// @return
+    ///     The number of bytes that were added to the memory cache.
+    //------------------------------------------------------------------
+    size_t
+    PrefetchMemory (lldb::addr_t vm_addr,
+                    size_t size,
+                    Error &error);
+
     size_t
     ReadMemoryFromInferior (lldb::addr_t vm_addr, 
                             void *buf, 
@@ -161,6 +161,9 @@ public:
     LoadScriptFromSymFile
     GetLoadScriptFromSymbolFile() const;
     
+    bool
+    GetIncrementalValueUpdates() const;
+    
 };
 
 typedef std::shared_ptr<TargetProperties> TargetPropertiesSP;
@@ -969,6 +972,17 @@ public:
         return m_persistent_variables;
     }
 
+    //------------------------------------------------------------------
+    /// Get the parsed expressions kept for reuse by EvaluateExpression.
+    /// The cache is flushed whenever the set of modules changes or the
+    /// process goes away.
+    //------------------------------------------------------------------
+    ClangUserExpressionCache &
+    GetUserExpressionCache ();
+
+    void
+    ClearUserExpressionCache ();
+
     //------------------------------------------------------------------
     // Target Stop Hooks
     //------------------------------------------------------------------
@@ -1185,6 +1199,7 @@ protected:
     std::unique_ptr<ClangASTSource> m_scratch_ast_source_ap;
     std::unique_ptr<ClangASTImporter> m_ast_importer_ap;
     ClangPersistentVariables m_persistent_variables;      ///< These are the persistent variables associated with this process for the expression parser.
+    std::unique_ptr<ClangUserExpressionCache> m_user_expression_cache_ap; ///< Parsed and JIT'ed expressions kept for reuse.
 
     std::unique_ptr<SourceManager> m_source_manager_ap;
 
@@ -69,6 +69,12 @@ protected:
     
     void
     ClearNextBranchBreakpoint();
+
+    // Emulates the branch at the pc together with its delay slots to find out where the thread will end up.
+    // Returns true only if the architecture has delayed branches and this one is taken after its delay slots,
+    // i.e. running to branch_target saves single stepping through the delay slots.
+    bool
+    GetBranchTargetByEmulation (lldb::addr_t &branch_target);
     
     bool
     NextRangeBreakpointExplainsStop (lldb::StopInfoSP stop_info_sp);
@@ -82,6 +88,7 @@ protected:
     bool                      m_first_run_event; // We want to broadcast only one running event, our first.
     lldb::BreakpointSP        m_next_branch_bp_sp;
     bool                      m_use_fast_step;
+    LazyBool                  m_has_delayed_branches; // Whether the target's emulator reports delayed branches
 
 private:
     std::vector<lldb::DisassemblerSP> m_instruction_ranges;
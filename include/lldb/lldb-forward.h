@@ -60,6 +60,7 @@ class   ClangExpressionVariables;
 class   ClangFunction;
 class   ClangPersistentVariables;
 class   ClangUserExpression;
+class   ClangUserExpressionCache;
 class   ClangUtilityFunction;
 class   CommandInterpreter;
 class   CommandObject;
@@ -78,6 +79,7 @@ class   DataEncoder;
 class   DataExtractor;
 class   Debugger;
 class   Declaration;
+class   DecodedInstructionCache;
 class   Disassembler;
 class   DynamicLibrary;
 class   DynamicLoader;
@@ -38,6 +38,7 @@ namespace lldb_private
     typedef int (*ComparisonFunction)(const void *, const void *);
     typedef bool (*CommandOverrideCallback)(void *baton, const char **argv);
     typedef void (*DebuggerInitializeCallback)(Debugger &debugger);
+    typedef void (*DeferredInitializeCallback)();
 
 } // namespace lldb_private
 
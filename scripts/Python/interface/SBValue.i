@@ -229,6 +229,19 @@ public:
                      lldb::DynamicValueType use_dynamic,
                      bool can_create_synthetic);
     
+    %feature("docstring", "
+    //------------------------------------------------------------------
+    /// Get the children in [idx, idx + count) of a value.
+    ///
+    /// This is the same as calling GetChildAtIndex() for each index,
+    /// but children whose data is adjacent in memory, and children
+    /// of containers like std::list and std::map, are fetched
+    /// together. Use it to page through values with many children.
+    //------------------------------------------------------------------
+    ") GetChildrenAtIndexRange;
+    lldb::SBValueList
+    GetChildrenAtIndexRange (uint32_t idx, uint32_t count);
+    
     lldb::SBValue
     CreateChildAtOffset (const char *name, uint32_t offset, lldb::SBType type);
     
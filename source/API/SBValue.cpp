@@ -17,6 +17,7 @@
 #include "lldb/API/SBTypeFormat.h"
 #include "lldb/API/SBTypeSummary.h"
 #include "lldb/API/SBTypeSynthetic.h"
+#include "lldb/API/SBValueList.h"
 
 #include "lldb/Breakpoint/Watchpoint.h"
 #include "lldb/Core/DataExtractor.h"
@@ -878,6 +879,44 @@ SBValue::GetChildAtIndex (uint32_t idx, lldb::DynamicValueType use_dynamic, bool
     return sb_value;
 }
 
+SBValueList
+SBValue::GetChildrenAtIndexRange (uint32_t idx, uint32_t count)
+{
+    SBValueList sb_children;
+    lldb::DynamicValueType use_dynamic = eNoDynamicValues;
+    TargetSP target_sp;
+    if (m_opaque_sp)
+        target_sp = m_opaque_sp->GetTargetSP();
+    
+    if (target_sp)
+        use_dynamic = target_sp->GetPreferDynamicValue();
+
+    ValueLocker locker;
+    lldb::ValueObjectSP value_sp(GetSP(locker));
+    size_t num_children = 0;
+    if (value_sp)
+    {
+        const bool can_create = true;
+        std::vector<lldb::ValueObjectSP> children;
+        num_children = value_sp->GetChildrenAtIndexRange (idx, count, can_create, children);
+        // Callers of the range API usually show the summaries of all the
+        // children next
+        ValueObject::PrefetchPointedStrings (children);
+        for (size_t i = 0; i < children.size(); ++i)
+        {
+            SBValue sb_value;
+            sb_value.SetSP (children[i], use_dynamic, GetPreferSyntheticValue());
+            sb_children.Append (sb_value);
+        }
+    }
+
+    Log *log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_API));
+    if (log)
+        log->Printf ("SBValue(%p)::GetChildrenAtIndexRange (%u, %u) => %" PRIu64 " children", value_sp.get(), idx, count, (uint64_t)num_children);
+
+    return sb_children;
+}
+
 uint32_t
 SBValue::GetIndexOfChildWithName (const char *name)
 {
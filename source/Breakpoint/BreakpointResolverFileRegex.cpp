@@ -33,7 +33,9 @@ BreakpointResolverFileRegex::BreakpointResolverFileRegex
     RegularExpression &regex
 ) :
     BreakpointResolver (bkpt, BreakpointResolver::FileLineResolver),
-    m_regex (regex)
+    m_regex (regex),
+    m_gather_comp_units (false),
+    m_pending_comp_units ()
 {
 }
 
@@ -41,6 +43,43 @@ BreakpointResolverFileRegex::~BreakpointResolverFileRegex ()
 {
 }
 
+void
+BreakpointResolverFileRegex::ResolveBreakpoint (SearchFilter &filter)
+{
+    m_gather_comp_units = true;
+    BreakpointResolver::ResolveBreakpoint (filter);
+    m_gather_comp_units = false;
+    ResolvePendingCompUnits (filter);
+}
+
+void
+BreakpointResolverFileRegex::ResolveBreakpointInModules (SearchFilter &filter, ModuleList &modules)
+{
+    m_gather_comp_units = true;
+    BreakpointResolver::ResolveBreakpointInModules (filter, modules);
+    m_gather_comp_units = false;
+    ResolvePendingCompUnits (filter);
+}
+
+void
+BreakpointResolverFileRegex::ResolvePendingCompUnits (SearchFilter &filter)
+{
+    if (m_pending_comp_units.empty())
+        return;
+
+    std::vector<FileSpec> file_specs;
+    const size_t num_comp_units = m_pending_comp_units.size();
+    for (size_t i = 0; i < num_comp_units; ++i)
+        file_specs.push_back (*static_cast<FileSpec *>(m_pending_comp_units[i].comp_unit));
+
+    std::vector< std::vector<uint32_t> > line_matches;
+    m_pending_comp_units[0].target_sp->GetSourceManager().FindLinesMatchingRegex (file_specs, m_regex, line_matches);
+
+    for (size_t i = 0; i < num_comp_units; ++i)
+        AddLocationsForLines (filter, m_pending_comp_units[i].comp_unit, line_matches[i]);
+    m_pending_comp_units.clear();
+}
+
 Searcher::CallbackReturn
 BreakpointResolverFileRegex::SearchCallback
 (
@@ -54,13 +93,32 @@ BreakpointResolverFileRegex::SearchCallback
     assert (m_breakpoint != NULL);
     if (!context.target_sp)
         return eCallbackReturnContinue;
-        
-    Log *log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_BREAKPOINTS));
 
     CompileUnit *cu = context.comp_unit;
+    if (m_gather_comp_units)
+    {
+        // The files are searched together once the filter is done
+        m_pending_comp_units.push_back (context);
+        return Searcher::eCallbackReturnContinue;
+    }
+
     FileSpec cu_file_spec = *(static_cast<FileSpec *>(cu));
     std::vector<uint32_t> line_matches;
     context.target_sp->GetSourceManager().FindLinesMatchingRegex(cu_file_spec, m_regex, 1, UINT32_MAX, line_matches); 
+    AddLocationsForLines (filter, cu, line_matches);
+    assert (m_breakpoint != NULL);        
+
+    return Searcher::eCallbackReturnContinue;
+}
+
+void
+BreakpointResolverFileRegex::AddLocationsForLines (SearchFilter &filter,
+                                                   CompileUnit *cu,
+                                                   const std::vector<uint32_t> &line_matches)
+{
+    Log *log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_BREAKPOINTS));
+
+    FileSpec cu_file_spec = *(static_cast<FileSpec *>(cu));
     uint32_t num_matches = line_matches.size();
     for (int i = 0; i < num_matches; i++)
     {
@@ -109,9 +167,6 @@ BreakpointResolverFileRegex::SearchCallback
 
         }
     }
-    assert (m_breakpoint != NULL);        
-
-    return Searcher::eCallbackReturnContinue;
 }
 
 Searcher::Depth
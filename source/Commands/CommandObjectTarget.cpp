@@ -1367,9 +1367,13 @@ DumpCompileUnitLineTable (CommandInterpreter &interpreter,
                 << module->GetFileSpec().GetFilename() << "\n";
                 LineTable *line_table = sc.comp_unit->GetLineTable();
                 if (line_table)
+                {
                     line_table->GetDescription (&strm, 
                                                 interpreter.GetExecutionContext().GetTargetPtr(), 
                                                 lldb::eDescriptionLevelBrief);
+                    strm << "Line table statistics: ";
+                    line_table->DumpStatistics (&strm);
+                }
                 else
                     strm << "No line table";
             }
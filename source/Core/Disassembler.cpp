@@ -1182,6 +1182,176 @@ Disassembler::GetInstructionList () const
     return m_instruction_list;
 }
 
+//----------------------------------------------------------------------
+// DecodedInstructionCache
+//----------------------------------------------------------------------
+
+// A module's code can be decoded many times over but it is finite, this
+// just keeps a module that is disassembled from end to end in check
+static const size_t k_max_decoded_instructions = 256 * 1024;
+
+static bool
+OpcodesMatch (const Opcode &a, const Opcode &b)
+{
+    if (a.GetType() != b.GetType())
+        return false;
+    DataExtractor a_data;
+    DataExtractor b_data;
+    const uint32_t byte_size = a.GetData (a_data);
+    if (byte_size == 0 || b.GetData (b_data) != byte_size)
+        return false;
+    return memcmp (a_data.GetDataStart(), b_data.GetDataStart(), byte_size) == 0;
+}
+
+DecodedInstructionCache::DecodedInstructionCache () :
+    m_mutex (Mutex::eMutexTypeNormal),
+    m_entry_list (),
+    m_entries ()
+{
+}
+
+DecodedInstructionCache::~DecodedInstructionCache ()
+{
+}
+
+DecodedInstructionCache::Entry *
+DecodedInstructionCache::FindEntry (lldb::addr_t file_addr, const ConstString &triple, const Opcode &opcode, bool create)
+{
+    const EntryKey key (file_addr, triple.GetCString());
+    EntryMap::iterator pos = m_entries.find (key);
+    if (pos != m_entries.end())
+    {
+        m_entry_list.splice (m_entry_list.begin(), m_entry_list, pos->second);
+        Entry &entry = *pos->second;
+        if (OpcodesMatch (entry.m_opcode, opcode))
+            return &entry;
+        if (!create)
+            return NULL;
+        // Whatever we knew was about other bytes
+        entry = Entry (file_addr, triple);
+        entry.m_opcode = opcode;
+        return &entry;
+    }
+    if (!create || opcode.GetByteSize() == 0)
+        return NULL;
+    if (m_entries.size() >= k_max_decoded_instructions)
+    {
+        const Entry &oldest = m_entry_list.back();
+        m_entries.erase (EntryKey (oldest.m_file_addr, oldest.m_triple.GetCString()));
+        m_entry_list.pop_back();
+    }
+    m_entry_list.push_front (Entry (file_addr, triple));
+    m_entries[key] = m_entry_list.begin();
+    Entry &entry = m_entry_list.front();
+    entry.m_opcode = opcode;
+    return &entry;
+}
+
+bool
+DecodedInstructionCache::GetOpcode (lldb::addr_t file_addr,
+                                    const ConstString &triple,
+                                    const uint8_t *bytes,
+                                    size_t bytes_len,
+                                    Opcode &opcode)
+{
+    if (bytes == NULL)
+        return false;
+    Mutex::Locker locker (m_mutex);
+    EntryMap::iterator pos = m_entries.find (EntryKey (file_addr, triple.GetCString()));
+    if (pos == m_entries.end())
+        return false;
+    const Opcode &cached_opcode = pos->second->m_opcode;
+    const void *cached_bytes = cached_opcode.GetOpcodeBytes();
+    const size_t byte_size = cached_opcode.GetByteSize();
+    if (cached_bytes == NULL || byte_size == 0 || byte_size > bytes_len)
+        return false;
+    if (memcmp (cached_bytes, bytes, byte_size) != 0)
+        return false;
+    m_entry_list.splice (m_entry_list.begin(), m_entry_list, pos->second);
+    opcode = cached_opcode;
+    return true;
+}
+
+void
+DecodedInstructionCache::SetOpcode (lldb::addr_t file_addr, const ConstString &triple, const Opcode &opcode)
+{
+    Mutex::Locker locker (m_mutex);
+    FindEntry (file_addr, triple, opcode, true);
+}
+
+LazyBool
+DecodedInstructionCache::GetDoesBranch (lldb::addr_t file_addr, const ConstString &triple, const Opcode &opcode)
+{
+    Mutex::Locker locker (m_mutex);
+    Entry *entry = FindEntry (file_addr, triple, opcode, false);
+    if (entry)
+        return entry->m_does_branch;
+    return eLazyBoolCalculate;
+}
+
+void
+DecodedInstructionCache::SetDoesBranch (lldb::addr_t file_addr, const ConstString &triple, const Opcode &opcode, bool does_branch)
+{
+    Mutex::Locker locker (m_mutex);
+    Entry *entry = FindEntry (file_addr, triple, opcode, true);
+    if (entry)
+        entry->m_does_branch = does_branch ? eLazyBoolYes : eLazyBoolNo;
+}
+
+bool
+DecodedInstructionCache::GetStrings (lldb::addr_t file_addr,
+                                     const ConstString &triple,
+                                     const Opcode &opcode,
+                                     lldb::addr_t pc,
+                                     const char *flavor,
+                                     std::string &mnemonic,
+                                     std::string &operands,
+                                     std::string &comment)
+{
+    Mutex::Locker locker (m_mutex);
+    Entry *entry = FindEntry (file_addr, triple, opcode, false);
+    if (entry == NULL || entry->m_strings_pc == LLDB_INVALID_ADDRESS)
+        return false;
+    if (entry->m_strings_pc != pc || entry->m_flavor != ConstString(flavor))
+        return false;
+    mnemonic = entry->m_mnemonic;
+    operands = entry->m_operands;
+    comment = entry->m_comment;
+    return true;
+}
+
+void
+DecodedInstructionCache::SetStrings (lldb::addr_t file_addr,
+                                     const ConstString &triple,
+                                     const Opcode &opcode,
+                                     lldb::addr_t pc,
+                                     const char *flavor,
+                                     const std::string &mnemonic,
+                                     const std::string &operands,
+                                     const std::string &comment)
+{
+    if (pc == LLDB_INVALID_ADDRESS)
+        return;
+    Mutex::Locker locker (m_mutex);
+    Entry *entry = FindEntry (file_addr, triple, opcode, true);
+    if (entry)
+    {
+        entry->m_strings_pc = pc;
+        entry->m_flavor.SetCString (flavor);
+        entry->m_mnemonic = mnemonic;
+        entry->m_operands = operands;
+        entry->m_comment = comment;
+    }
+}
+
+void
+DecodedInstructionCache::Clear ()
+{
+    Mutex::Locker locker (m_mutex);
+    m_entries.clear();
+    m_entry_list.clear();
+}
+
 //----------------------------------------------------------------------
 // Class PseudoInstruction
 //----------------------------------------------------------------------
@@ -230,6 +230,43 @@ EmulateInstruction::WriteMemory (const Context &context,
 }
 
 
+bool
+EmulateInstruction::EvaluateDelayedBranch (lldb::addr_t &branch_target)
+{
+    const uint32_t max_delay_slots = GetMaxBranchDelaySlots ();
+    if (max_delay_slots == 0)
+        return false;
+
+    bool success = false;
+    lldb::addr_t pc = ReadRegisterUnsigned (eRegisterKindGeneric, LLDB_REGNUM_GENERIC_PC, LLDB_INVALID_ADDRESS, &success);
+    if (!success)
+        return false;
+
+    // The branch itself, then at most max_delay_slots instructions until
+    // the pc leaves the straight line
+    for (uint32_t num_insns = 1; num_insns <= max_delay_slots + 1; ++num_insns)
+    {
+        if (!ReadInstruction ())
+            return false;
+        const lldb::addr_t insn_size = m_opcode.GetByteSize();
+        if (!EvaluateInstruction (eEmulateInstructionOptionAutoAdvancePC))
+            return false;
+
+        const lldb::addr_t next_pc = ReadRegisterUnsigned (eRegisterKindGeneric, LLDB_REGNUM_GENERIC_PC, LLDB_INVALID_ADDRESS, &success);
+        if (!success)
+            return false;
+        if (next_pc != pc + insn_size)
+        {
+            if (num_insns == 1)
+                return false;
+            branch_target = next_pc;
+            return true;
+        }
+        pc = next_pc;
+    }
+    return false;
+}
+
 void
 EmulateInstruction::SetBaton (void *baton)
 {
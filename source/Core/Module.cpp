@@ -13,6 +13,7 @@
 #include "lldb/Core/Module.h"
 #include "lldb/Core/DataBuffer.h"
 #include "lldb/Core/DataBufferHeap.h"
+#include "lldb/Core/Disassembler.h"
 #include "lldb/Core/Log.h"
 #include "lldb/Core/ModuleList.h"
 #include "lldb/Core/ModuleSpec.h"
@@ -139,6 +140,7 @@ Module::Module (const ModuleSpec &module_spec) :
     m_object_mod_time (module_spec.GetObjectModificationTime()),
     m_objfile_sp (),
     m_symfile_ap (),
+    m_decoded_instructions_ap (),
     m_ast (),
     m_source_mappings (),
     m_did_load_objfile (false),
@@ -183,6 +185,7 @@ Module::Module(const FileSpec& file_spec,
     m_object_mod_time (),
     m_objfile_sp (),
     m_symfile_ap (),
+    m_decoded_instructions_ap (),
     m_ast (),
     m_source_mappings (),
     m_did_load_objfile (false),
@@ -318,6 +321,15 @@ Module::GetUUID()
     return m_uuid;
 }
 
+DecodedInstructionCache &
+Module::GetDecodedInstructionCache ()
+{
+    Mutex::Locker locker (m_mutex);
+    if (m_decoded_instructions_ap.get() == NULL)
+        m_decoded_instructions_ap.reset (new DecodedInstructionCache());
+    return *m_decoded_instructions_ap;
+}
+
 ClangASTContext &
 Module::GetClangASTContext ()
 {
@@ -1265,40 +1277,40 @@ Module::LoadScriptingResourceInTarget (Target *target, Error& error, Stream* fee
                                                                                    *this);
         
         
+        // Only bring up the script interpreter once we know there is a
+        // script to load, starting it is expensive.
+        ScriptInterpreter *script_interpreter = NULL;
         const uint32_t num_specs = file_specs.GetSize();
-        if (num_specs)
+        for (uint32_t i=0; i<num_specs; ++i)
         {
-            ScriptInterpreter *script_interpreter = debugger.GetCommandInterpreter().GetScriptInterpreter();
-            if (script_interpreter)
+            FileSpec scripting_fspec (file_specs.GetFileSpecAtIndex(i));
+            if (scripting_fspec && scripting_fspec.Exists())
             {
-                for (uint32_t i=0; i<num_specs; ++i)
+                if (shoud_load == eLoadScriptFromSymFileFalse)
+                    return false;
+                if (shoud_load == eLoadScriptFromSymFileWarn)
                 {
-                    FileSpec scripting_fspec (file_specs.GetFileSpecAtIndex(i));
-                    if (scripting_fspec && scripting_fspec.Exists())
+                    if (feedback_stream)
+                        feedback_stream->Printf("warning: '%s' contains a debug script. To run this script in this debug session:\n\n    command script import \"%s\"\n\nTo run all discovered debug scripts in this session:\n\n    settings set target.load-script-from-symbol-file true\n"
+                                                ,GetFileSpec().GetFileNameStrippingExtension().GetCString(),scripting_fspec.GetPath().c_str());
+                    return false;
+                }
+                if (script_interpreter == NULL)
+                {
+                    script_interpreter = debugger.GetCommandInterpreter().GetScriptInterpreter();
+                    if (script_interpreter == NULL)
                     {
-                        if (shoud_load == eLoadScriptFromSymFileFalse)
-                            return false;
-                        if (shoud_load == eLoadScriptFromSymFileWarn)
-                        {
-                            if (feedback_stream)
-                                feedback_stream->Printf("warning: '%s' contains a debug script. To run this script in this debug session:\n\n    command script import \"%s\"\n\nTo run all discovered debug scripts in this session:\n\n    settings set target.load-script-from-symbol-file true\n"
-                                                        ,GetFileSpec().GetFileNameStrippingExtension().GetCString(),scripting_fspec.GetPath().c_str());
-                            return false;
-                        }
-                        StreamString scripting_stream;
-                        scripting_fspec.Dump(&scripting_stream);
-                        const bool can_reload = true;
-                        const bool init_lldb_globals = false;
-                        bool did_load = script_interpreter->LoadScriptingModule(scripting_stream.GetData(), can_reload, init_lldb_globals, error);
-                        if (!did_load)
-                            return false;
+                        error.SetErrorString("invalid ScriptInterpreter");
+                        return false;
                     }
                 }
-            }
-            else
-            {
-                error.SetErrorString("invalid ScriptInterpreter");
-                return false;
+                StreamString scripting_stream;
+                scripting_fspec.Dump(&scripting_stream);
+                const bool can_reload = true;
+                const bool init_lldb_globals = false;
+                bool did_load = script_interpreter->LoadScriptingModule(scripting_stream.GetData(), can_reload, init_lldb_globals, error);
+                if (!did_load)
+                    return false;
             }
         }
     }
@@ -18,6 +18,7 @@
 
 #include "lldb/Core/Debugger.h"
 #include "lldb/Core/Error.h"
+#include "lldb/Core/Timer.h"
 #include "lldb/Host/FileSpec.h"
 #include "lldb/Host/Host.h"
 #include "lldb/Host/Mutex.h"
@@ -221,6 +222,116 @@ PluginManager::Terminate ()
 }
 
 
+#pragma mark DeferredInitializer
+
+
+struct DeferredInitializerInstance
+{
+    DeferredInitializerInstance() :
+        name(),
+        init_callback(NULL),
+        initialized(false)
+    {
+    }
+
+    ConstString name;
+    DeferredInitializeCallback init_callback;
+    bool initialized;
+};
+
+typedef std::vector<DeferredInitializerInstance> DeferredInitializerInstances;
+
+static Mutex &
+GetDeferredInitializerInstancesMutex ()
+{
+    static Mutex g_instances_mutex (Mutex::eMutexTypeRecursive);
+    return g_instances_mutex;
+}
+
+static DeferredInitializerInstances &
+GetDeferredInitializerInstances ()
+{
+    static DeferredInitializerInstances g_instances;
+    return g_instances;
+}
+
+bool
+PluginManager::RegisterDeferredInitializer
+(
+    const ConstString &name,
+    DeferredInitializeCallback init_callback
+)
+{
+    if (init_callback)
+    {
+        DeferredInitializerInstance instance;
+        assert ((bool)name);
+        instance.name = name;
+        instance.init_callback = init_callback;
+        Mutex::Locker locker (GetDeferredInitializerInstancesMutex ());
+        GetDeferredInitializerInstances ().push_back (instance);
+        return true;
+    }
+    return false;
+}
+
+bool
+PluginManager::UnregisterDeferredInitializer (DeferredInitializeCallback init_callback)
+{
+    if (init_callback)
+    {
+        Mutex::Locker locker (GetDeferredInitializerInstancesMutex ());
+        DeferredInitializerInstances &instances = GetDeferredInitializerInstances ();
+
+        DeferredInitializerInstances::iterator pos, end = instances.end();
+        for (pos = instances.begin(); pos != end; ++ pos)
+        {
+            if (pos->init_callback == init_callback)
+            {
+                instances.erase(pos);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void
+PluginManager::RunDeferredInitializer (const ConstString &name)
+{
+    if (name)
+    {
+        // Keep the lock while the callback runs so a second thread asking
+        // for the same plug-in waits until it is ready.
+        Mutex::Locker locker (GetDeferredInitializerInstancesMutex ());
+        DeferredInitializerInstances &instances = GetDeferredInitializerInstances ();
+
+        DeferredInitializerInstances::iterator pos, end = instances.end();
+        for (pos = instances.begin(); pos != end; ++ pos)
+        {
+            if (name == pos->name)
+            {
+                if (!pos->initialized)
+                {
+                    Timer scoped_timer (__PRETTY_FUNCTION__, "PluginManager::RunDeferredInitializer (%s)", name.GetCString());
+                    DeferredInitializeCallback init_callback = pos->init_callback;
+                    pos->initialized = true;
+                    init_callback ();
+                }
+                return;
+            }
+        }
+    }
+}
+
+const ConstString &
+PluginManager::GetLLVMTargetsInitializerName ()
+{
+    static ConstString g_name ("llvm-targets");
+    return g_name;
+}
+
+
 #pragma mark ABI
 
 
@@ -9,6 +9,7 @@
 
 #include "lldb/Core/RegularExpression.h"
 #include "llvm/ADT/StringRef.h"
+#include <ctype.h>
 #include <string.h>
 
 using namespace lldb_private;
@@ -117,6 +118,122 @@ RegularExpression::Compile(const char* re, int flags)
     return m_comp_err == 0;
 }
 
+//----------------------------------------------------------------------
+// Find the longest run of literal characters at the top level of the
+// expression. Characters inside groups or followed by a quantifier that
+// allows zero repetitions are not required and end the current run.
+//----------------------------------------------------------------------
+bool
+RegularExpression::GetRequiredLiteral (std::string &literal) const
+{
+    literal.clear();
+    if (!IsValid() || (m_compile_flags & REG_EXTENDED) == 0 || (m_compile_flags & REG_ICASE))
+        return false;
+
+    const char *re = m_re.c_str();
+    std::string run;
+    bool last_was_literal = false;
+    uint32_t depth = 0;
+    size_t i = 0;
+    while (re[i])
+    {
+        const char ch = re[i];
+        bool is_literal = false;
+        char literal_ch = ch;
+        switch (ch)
+        {
+        case '|':
+            // Any branch may match, so nothing is required
+            literal.clear();
+            return false;
+
+        case '\\':
+            if (re[i + 1] == '\0')
+                return false;
+            literal_ch = re[i + 1];
+            is_literal = ::ispunct (literal_ch) != 0;
+            i += 2;
+            break;
+
+        case '[':
+            // Skip the bracket expression, a leading ']' is part of the set
+            ++i;
+            if (re[i] == '^')
+                ++i;
+            if (re[i] == ']')
+                ++i;
+            while (re[i] && re[i] != ']')
+            {
+                if (re[i] == '[' && (re[i + 1] == ':' || re[i + 1] == '.' || re[i + 1] == '='))
+                {
+                    const char *class_end = ::strchr (re + i + 2, ']');
+                    if (class_end == NULL)
+                        return false;
+                    i = class_end - re;
+                }
+                ++i;
+            }
+            if (re[i])
+                ++i;
+            break;
+
+        case '(':
+            ++depth;
+            ++i;
+            break;
+
+        case ')':
+            if (depth > 0)
+                --depth;
+            ++i;
+            break;
+
+        case '*':
+        case '?':
+        case '{':
+            // The previous atom may be repeated zero times
+            if (last_was_literal && !run.empty())
+                run.erase (run.size() - 1);
+            if (ch == '{')
+            {
+                const char *brace_end = ::strchr (re + i, '}');
+                i = brace_end ? brace_end - re + 1 : m_re.size();
+            }
+            else
+                ++i;
+            break;
+
+        case '.':
+        case '^':
+        case '$':
+        case '+':
+            ++i;
+            break;
+
+        default:
+            is_literal = true;
+            ++i;
+            break;
+        }
+
+        if (is_literal && depth == 0 && literal_ch != '\n' && literal_ch != '\r')
+        {
+            run.push_back (literal_ch);
+            last_was_literal = true;
+            continue;
+        }
+
+        // Anything else ends the current run
+        if (run.size() > literal.size())
+            literal = run;
+        run.clear();
+        last_was_literal = false;
+    }
+    if (run.size() > literal.size())
+        literal = run;
+    return !literal.empty();
+}
+
 //----------------------------------------------------------------------
 // Execute a regular expression match using the compiled regular
 // expression that is already in this object against the match
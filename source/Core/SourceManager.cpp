@@ -12,13 +12,18 @@
 #include "lldb/Core/SourceManager.h"
 
 // C Includes
+#include <string.h>
+
 // C++ Includes
+#include <algorithm>
 // Other libraries and framework includes
 // Project includes
 #include "lldb/Core/DataBuffer.h"
 #include "lldb/Core/Debugger.h"
 #include "lldb/Core/Module.h"
 #include "lldb/Core/Stream.h"
+#include "lldb/Core/Timer.h"
+#include "lldb/Host/Host.h"
 #include "lldb/Symbol/ClangNamespaceDecl.h"
 #include "lldb/Symbol/CompileUnit.h"
 #include "lldb/Symbol/Function.h"
@@ -34,6 +39,62 @@ static inline bool is_newline_char(char ch)
     return ch == '\n' || ch == '\r';
 }
 
+// Return a pointer to the first '\n' or '\r' in [s, end), or end if there
+// is none. Whole words are tested at a time so the long runs of ordinary
+// characters between newlines are skipped quickly.
+static const char *
+find_newline_char (const char *s, const char *end)
+{
+    static const uint64_t k_ones = 0x0101010101010101ull;
+    static const uint64_t k_highs = 0x8080808080808080ull;
+    static const uint64_t k_lf = k_ones * '\n';
+    static const uint64_t k_cr = k_ones * '\r';
+
+    while (s < end && ((uintptr_t)s & (sizeof(uint64_t) - 1)))
+    {
+        if (is_newline_char (*s))
+            return s;
+        ++s;
+    }
+    while (end - s >= (ptrdiff_t)sizeof(uint64_t))
+    {
+        uint64_t word;
+        ::memcpy (&word, s, sizeof(word));
+        const uint64_t lf = word ^ k_lf;
+        const uint64_t cr = word ^ k_cr;
+        // Non-zero if any byte of "lf" or "cr" is zero
+        if (((lf - k_ones) & ~lf & k_highs) | ((cr - k_ones) & ~cr & k_highs))
+            break;
+        s += sizeof(uint64_t);
+    }
+    while (s < end)
+    {
+        if (is_newline_char (*s))
+            return s;
+        ++s;
+    }
+    return end;
+}
+
+// Return a pointer to the first occurrence of "literal" in [s, end), or
+// end if there is none.
+static const char *
+find_literal (const char *s, const char *end, const std::string &literal)
+{
+    const size_t literal_len = literal.size();
+    const char first_ch = literal[0];
+    while ((size_t)(end - s) >= literal_len)
+    {
+        s = (const char *)::memchr (s, first_ch, end - s - literal_len + 1);
+        if (s == NULL)
+            break;
+        if (::memcmp (s, literal.data(), literal_len) == 0)
+            return s;
+        ++s;
+    }
+    return end;
+}
+
 
 //----------------------------------------------------------------------
 // SourceManager constructor
@@ -332,13 +393,113 @@ SourceManager::FindLinesMatchingRegex (FileSpec &file_spec,
     return file_sp->FindLinesMatchingRegex (regex, start_line, end_line, match_lines);
 }
 
+namespace {
+
+    // Work shared by the threads of a multi-file regex search. Each file
+    // is searched by exactly one thread.
+    struct RegexSearchWork
+    {
+        RegexSearchWork (std::vector<SourceManager::FileSP> &files,
+                         RegularExpression &regex,
+                         std::vector< std::vector<uint32_t> > &match_lines) :
+            mutex (),
+            files (files),
+            regex (regex),
+            match_lines (match_lines),
+            next_idx (0)
+        {
+        }
+
+        Mutex mutex;
+        std::vector<SourceManager::FileSP> &files;
+        RegularExpression &regex;
+        std::vector< std::vector<uint32_t> > &match_lines;
+        size_t next_idx;
+    };
+
+}
+
+static lldb::thread_result_t
+RegexSearchThread (lldb::thread_arg_t arg)
+{
+    RegexSearchWork *work = static_cast<RegexSearchWork *>(arg);
+    // A compiled regex_t may not be executed from several threads at once,
+    // so each thread searches with its own copy.
+    RegularExpression regex (work->regex);
+    while (1)
+    {
+        size_t idx;
+        {
+            Mutex::Locker locker (work->mutex);
+            idx = work->next_idx++;
+        }
+        if (idx >= work->files.size())
+            break;
+        if (work->files[idx])
+            work->files[idx]->FindLinesMatchingRegex (regex, 1, UINT32_MAX, work->match_lines[idx]);
+    }
+    return NULL;
+}
+
+void
+SourceManager::FindLinesMatchingRegex (const std::vector<FileSpec> &file_specs,
+                                       RegularExpression& regex,
+                                       std::vector< std::vector<uint32_t> > &match_lines)
+{
+    Timer scoped_timer(__PRETTY_FUNCTION__, "SourceManager::FindLinesMatchingRegex (%zu files)", file_specs.size());
+
+    const size_t num_specs = file_specs.size();
+    match_lines.clear();
+    match_lines.resize (num_specs);
+
+    // Look the files up on this thread since the source manager itself isn't
+    // thread safe, and search each distinct file only once.
+    std::vector<FileSP> files;
+    std::vector<size_t> file_indexes (num_specs);
+    std::map<File *, size_t> unique_files;
+    for (size_t i = 0; i < num_specs; ++i)
+    {
+        FileSP file_sp (GetFile (file_specs[i]));
+        std::map<File *, size_t>::iterator pos = unique_files.find (file_sp.get());
+        if (pos == unique_files.end())
+        {
+            pos = unique_files.insert (std::make_pair (file_sp.get(), files.size())).first;
+            files.push_back (file_sp);
+        }
+        file_indexes[i] = pos->second;
+    }
+
+    std::vector< std::vector<uint32_t> > file_match_lines (files.size());
+    RegexSearchWork work (files, regex, file_match_lines);
+
+    const size_t max_threads = 8;
+    const size_t num_threads = std::min<size_t> (files.size(), max_threads);
+    std::vector<lldb::thread_t> threads;
+    for (size_t i = 1; i < num_threads; ++i)
+    {
+        lldb::thread_t thread = Host::ThreadCreate ("<lldb.source.regex-search>", RegexSearchThread, &work, NULL);
+        if (IS_VALID_LLDB_HOST_THREAD(thread))
+            threads.push_back (thread);
+    }
+    // This thread takes its share of the files too
+    RegexSearchThread (&work);
+    for (size_t i = 0; i < threads.size(); ++i)
+        Host::ThreadJoin (threads[i], NULL, NULL);
+
+    for (size_t i = 0; i < num_specs; ++i)
+        match_lines[i] = file_match_lines[file_indexes[i]];
+}
+
 SourceManager::File::File(const FileSpec &file_spec, Target *target) :
     m_file_spec_orig (file_spec),
     m_file_spec(file_spec),
     m_mod_time (file_spec.GetModificationTime()),
     m_source_map_mod_id (0),
     m_data_sp(),
-    m_offsets()
+    m_offsets(),
+    m_offsets_scan_pos (0),
+    m_offsets_complete (false),
+    m_mutex (Mutex::eMutexTypeRecursive)
 {
     if (!m_mod_time.IsValid())
     {
@@ -408,15 +569,55 @@ SourceManager::File::File(const FileSpec &file_spec, Target *target) :
     }
     
     if (m_mod_time.IsValid())
-        m_data_sp = m_file_spec.ReadFileContents ();
+        LoadFileContents ();
 }
 
 SourceManager::File::~File()
 {
 }
 
+void
+SourceManager::File::LoadFileContents ()
+{
+    // Map large files rather than reading them so big generated sources
+    // only cost the pages we actually display or search.
+    m_data_sp.reset();
+    if (m_file_spec.GetByteSize() >= kMemoryMapThreshold)
+        m_data_sp = m_file_spec.MemoryMapFileContents ();
+    if (!m_data_sp)
+        m_data_sp = m_file_spec.ReadFileContents ();
+    m_offsets.clear();
+    m_offsets_scan_pos = 0;
+    m_offsets_complete = false;
+}
+
+void
+SourceManager::File::UpdateIfNeeded ()
+{
+    // TODO: use host API to sign up for file modifications to anything in our
+    // source cache and only update when we determine a file has been updated.
+    // For now we check each time we want to get at the contents of the file.
+    // Checking matters more now that the contents are mapped: touching a page
+    // of a mapped file that has since been truncated raises SIGBUS.
+    TimeValue curr_mod_time (m_file_spec.GetModificationTime());
+
+    if (curr_mod_time.IsValid() && m_mod_time != curr_mod_time)
+    {
+        m_mod_time = curr_mod_time;
+        LoadFileContents ();
+    }
+}
+
 uint32_t
 SourceManager::File::GetLineOffset (uint32_t line)
+{
+    Mutex::Locker locker (m_mutex);
+    UpdateIfNeeded ();
+    return GetLineOffsetInternal (line);
+}
+
+uint32_t
+SourceManager::File::GetLineOffsetInternal (uint32_t line)
 {
     if (line == 0)
         return UINT32_MAX;
@@ -434,6 +635,14 @@ SourceManager::File::GetLineOffset (uint32_t line)
 
 bool
 SourceManager::File::LineIsValid (uint32_t line)
+{
+    Mutex::Locker locker (m_mutex);
+    UpdateIfNeeded ();
+    return LineIsValidInternal (line);
+}
+
+bool
+SourceManager::File::LineIsValidInternal (uint32_t line)
 {
     if (line == 0)
         return false;
@@ -446,28 +655,19 @@ SourceManager::File::LineIsValid (uint32_t line)
 size_t
 SourceManager::File::DisplaySourceLines (uint32_t line, uint32_t context_before, uint32_t context_after, Stream *s)
 {
-    // TODO: use host API to sign up for file modifications to anything in our
-    // source cache and only update when we determine a file has been updated.
-    // For now we check each time we want to display info for the file.
-    TimeValue curr_mod_time (m_file_spec.GetModificationTime());
-
-    if (curr_mod_time.IsValid() && m_mod_time != curr_mod_time)
-    {
-        m_mod_time = curr_mod_time;
-        m_data_sp = m_file_spec.ReadFileContents ();
-        m_offsets.clear();
-    }
+    Mutex::Locker locker (m_mutex);
+    UpdateIfNeeded ();
 
     // Sanity check m_data_sp before proceeding.
     if (!m_data_sp)
         return 0;
 
     const uint32_t start_line = line <= context_before ? 1 : line - context_before;
-    const uint32_t start_line_offset = GetLineOffset (start_line);
+    const uint32_t start_line_offset = GetLineOffsetInternal (start_line);
     if (start_line_offset != UINT32_MAX)
     {
         const uint32_t end_line = line + context_after;
-        uint32_t end_line_offset = GetLineOffset (end_line + 1);
+        uint32_t end_line_offset = GetLineOffsetInternal (end_line + 1);
         if (end_line_offset == UINT32_MAX)
             end_line_offset = m_data_sp->GetByteSize();
 
@@ -489,25 +689,51 @@ SourceManager::File::DisplaySourceLines (uint32_t line, uint32_t context_before,
 void
 SourceManager::File::FindLinesMatchingRegex (RegularExpression& regex, uint32_t start_line, uint32_t end_line, std::vector<uint32_t> &match_lines)
 {
-    TimeValue curr_mod_time (m_file_spec.GetModificationTime());
-    if (m_mod_time != curr_mod_time)
-    {
-        m_mod_time = curr_mod_time;
-        m_data_sp = m_file_spec.ReadFileContents ();
-        m_offsets.clear();
-    }
+    Mutex::Locker locker (m_mutex);
+    UpdateIfNeeded ();
     
     match_lines.clear();
     
-    if (!LineIsValid(start_line) || (end_line != UINT32_MAX && !LineIsValid(end_line)))
+    if (!LineIsValidInternal(start_line) || (end_line != UINT32_MAX && !LineIsValidInternal(end_line)))
         return;
     if (start_line > end_line)
         return;
-        
+
+    // If every match must contain some literal text, find that text with a
+    // plain memory search and only run the regular expression on the lines
+    // that contain it.
+    std::string literal;
+    if (regex.GetRequiredLiteral (literal) && CalculateLineOffsets ())
+    {
+        const char *start = (const char *)m_data_sp->GetBytes();
+        const char *end = start + m_data_sp->GetByteSize();
+        const char *s = start + GetLineOffsetInternal (start_line);
+        while (s < end)
+        {
+            s = find_literal (s, end, literal);
+            if (s == end)
+                break;
+            // m_offsets[i] is the start of line i + 1
+            const uint32_t line_no = std::upper_bound (m_offsets.begin(), m_offsets.end(), (uint32_t)(s - start)) - m_offsets.begin();
+            if (line_no >= end_line)
+                break;
+            std::string buffer;
+            if (!GetLineInternal (line_no, buffer))
+                break;
+            if (regex.Execute(buffer.c_str()))
+                match_lines.push_back(line_no);
+            const uint32_t next_line_offset = GetLineOffsetInternal (line_no + 1);
+            if (next_line_offset == UINT32_MAX)
+                break;
+            s = start + next_line_offset;
+        }
+        return;
+    }
+
     for (uint32_t line_no = start_line; line_no < end_line; line_no++)
     {
         std::string buffer;
-        if (!GetLine (line_no, buffer))
+        if (!GetLineInternal (line_no, buffer))
             break;
         if (regex.Execute(buffer.c_str()))
         {
@@ -546,76 +772,71 @@ lldb_private::operator== (const SourceManager::File &lhs, const SourceManager::F
 bool
 SourceManager::File::CalculateLineOffsets (uint32_t line)
 {
-    line = UINT32_MAX;  // TODO: take this line out when we support partial indexing
-    if (line == UINT32_MAX)
-    {
-        // Already done?
-        if (!m_offsets.empty() && m_offsets[0] == UINT32_MAX)
-            return true;
+    // Index lines lazily: only scan as far as needed to know where "line"
+    // ends, and resume from there on the next request.
+    if (m_offsets_complete || (line != UINT32_MAX && line < m_offsets.size()))
+        return true;
 
-        if (m_offsets.empty())
-        {
-            if (m_data_sp.get() == NULL)
-                return false;
+    if (m_data_sp.get() == NULL)
+        return false;
 
-            const char *start = (char *)m_data_sp->GetBytes();
-            if (start)
-            {
-                const char *end = start + m_data_sp->GetByteSize();
+    const char *start = (const char *)m_data_sp->GetBytes();
+    if (start == NULL)
+        return false;
 
-                // Calculate all line offsets from scratch
+    const char *end = start + m_data_sp->GetByteSize();
 
-                // Push a 1 at index zero to indicate the file has been completely indexed.
-                m_offsets.push_back(UINT32_MAX);
-                register const char *s;
-                for (s = start; s < end; ++s)
-                {
-                    register char curr_ch = *s;
-                    if (is_newline_char (curr_ch))
-                    {
-                        if (s + 1 < end)
-                        {
-                            register char next_ch = s[1];
-                            if (is_newline_char (next_ch))
-                            {
-                                if (curr_ch != next_ch)
-                                    ++s;
-                            }
-                        }
-                        m_offsets.push_back(s + 1 - start);
-                    }
-                }
-                if (!m_offsets.empty())
-                {
-                    if (m_offsets.back() < end - start)
-                        m_offsets.push_back(end - start);
-                }
-                return true;
-            }
-        }
-        else
+    // Line 1 always starts at offset zero
+    if (m_offsets.empty())
+        m_offsets.push_back(0);
+
+    const char *s = start + m_offsets_scan_pos;
+    while (line == UINT32_MAX || line >= m_offsets.size())
+    {
+        s = find_newline_char (s, end);
+        if (s == end)
+            break;
+        const char curr_ch = *s;
+        if (s + 1 < end)
         {
-            // Some lines have been populated, start where we last left off
-            assert("Not implemented yet" == NULL);
+            const char next_ch = s[1];
+            if (is_newline_char (next_ch))
+            {
+                if (curr_ch != next_ch)
+                    ++s;
+            }
         }
-
+        ++s;
+        m_offsets.push_back(s - start);
     }
-    else
+    m_offsets_scan_pos = s - start;
+
+    if (s == end)
     {
-        // Calculate all line offsets up to "line"
-        assert("Not implemented yet" == NULL);
+        // The last line may not be terminated by a newline
+        if (m_offsets.back() < end - start)
+            m_offsets.push_back(end - start);
+        m_offsets_complete = true;
     }
-    return false;
+    return true;
 }
 
 bool
 SourceManager::File::GetLine (uint32_t line_no, std::string &buffer)
 {
-    if (!LineIsValid(line_no))
+    Mutex::Locker locker (m_mutex);
+    UpdateIfNeeded ();
+    return GetLineInternal (line_no, buffer);
+}
+
+bool
+SourceManager::File::GetLineInternal (uint32_t line_no, std::string &buffer)
+{
+    if (!LineIsValidInternal(line_no))
         return false;
 
-    size_t start_offset = GetLineOffset (line_no);
-    size_t end_offset = GetLineOffset (line_no + 1);
+    size_t start_offset = GetLineOffsetInternal (line_no);
+    size_t end_offset = GetLineOffsetInternal (line_no + 1);
     if (end_offset == UINT32_MAX)
     {
         end_offset = m_data_sp->GetByteSize();
@@ -628,24 +849,38 @@ SourceManager::File::GetLine (uint32_t line_no, std::string &buffer)
 void 
 SourceManager::SourceFileCache::AddSourceFile (const FileSP &file_sp)
 {
-    FileSpec file_spec;
+    Mutex::Locker locker (m_mutex);
+    const FileSpec &file_spec = file_sp->GetOriginalFileSpec();
     FileCache::iterator pos = m_file_cache.find(file_spec);
-    if (pos == m_file_cache.end())
-        m_file_cache[file_spec] = file_sp;
-    else
+    if (pos != m_file_cache.end())
     {
-        if (file_sp != pos->second)
-            m_file_cache[file_spec] = file_sp;
+        pos->second.first = file_sp;
+        m_lru_list.splice (m_lru_list.begin(), m_lru_list, pos->second.second);
+        return;
     }
+
+    // Drop the least recently used files to make room; any source manager
+    // still showing one keeps it alive through its own FileSP.
+    while (!m_lru_list.empty() && m_file_cache.size() >= m_max_files)
+    {
+        m_file_cache.erase (m_lru_list.back());
+        m_lru_list.pop_back();
+    }
+
+    m_lru_list.push_front (file_spec);
+    m_file_cache[file_spec] = std::make_pair (file_sp, m_lru_list.begin());
 }
 
 SourceManager::FileSP 
-SourceManager::SourceFileCache::FindSourceFile (const FileSpec &file_spec) const
+SourceManager::SourceFileCache::FindSourceFile (const FileSpec &file_spec)
 {
+    Mutex::Locker locker (m_mutex);
     FileSP file_sp;
-    FileCache::const_iterator pos = m_file_cache.find(file_spec);
+    FileCache::iterator pos = m_file_cache.find(file_spec);
     if (pos != m_file_cache.end())
-        file_sp = pos->second;
+    {
+        file_sp = pos->second.first;
+        m_lru_list.splice (m_lru_list.begin(), m_lru_list, pos->second.second);
+    }
     return file_sp;
 }
-
@@ -89,6 +89,9 @@ ValueObject::ValueObject (ValueObject &parent) :
     m_synthetic_children_sp(),
     m_user_id_of_forced_summary(),
     m_address_type_of_ptr_or_ref_children(eAddressTypeInvalid),
+    m_children_data_sp(),
+    m_children_data_addr(LLDB_INVALID_ADDRESS),
+    m_data_hash(0),
     m_value_is_valid (false),
     m_value_did_change (false),
     m_children_count_valid (false),
@@ -98,7 +101,9 @@ ValueObject::ValueObject (ValueObject &parent) :
     m_is_bitfield_for_scalar(false),
     m_is_child_at_offset(false),
     m_is_getting_summary(false),
-    m_did_calculate_complete_objc_class_type(false)
+    m_did_calculate_complete_objc_class_type(false),
+    m_data_hash_valid(false),
+    m_data_is_unchanged(false)
 {
     m_manager->ManageObject(this);
 }
@@ -135,6 +140,9 @@ ValueObject::ValueObject (ExecutionContextScope *exe_scope,
     m_synthetic_children_sp(),
     m_user_id_of_forced_summary(),
     m_address_type_of_ptr_or_ref_children(child_ptr_or_ref_addr_type),
+    m_children_data_sp(),
+    m_children_data_addr(LLDB_INVALID_ADDRESS),
+    m_data_hash(0),
     m_value_is_valid (false),
     m_value_did_change (false),
     m_children_count_valid (false),
@@ -144,7 +152,9 @@ ValueObject::ValueObject (ExecutionContextScope *exe_scope,
     m_is_bitfield_for_scalar(false),
     m_is_child_at_offset(false),
     m_is_getting_summary(false),
-    m_did_calculate_complete_objc_class_type(false)
+    m_did_calculate_complete_objc_class_type(false),
+    m_data_hash_valid(false),
+    m_data_is_unchanged(false)
 {
     m_manager = new ValueObjectManager();
     m_manager->ManageObject (this);
@@ -186,6 +196,10 @@ ValueObject::UpdateValueIfNeeded (bool update_format)
     {
         m_update_point.SetUpdated();
         
+        // The bytes we read for our children are from an older stop
+        m_children_data_sp.reset();
+        m_children_data_addr = LLDB_INVALID_ADDRESS;
+        
         // Save the old value using swap to avoid a string copy which
         // also will clear our m_value_str
         if (m_value_str.empty())
@@ -199,6 +213,13 @@ ValueObject::UpdateValueIfNeeded (bool update_format)
             ClearUserVisibleData(eClearUserVisibleDataItemsValue);
         }
 
+        // Hold on to our summary, we can keep it if our bytes didn't change
+        std::string old_summary_str;
+        TargetSP target_sp (GetTargetSP());
+        const bool reuse_summary = target_sp && target_sp->GetIncrementalValueUpdates();
+        if (reuse_summary)
+            old_summary_str.swap (m_summary_str);
+
         ClearUserVisibleData();
         
         if (IsInScope())
@@ -212,6 +233,7 @@ ValueObject::UpdateValueIfNeeded (bool update_format)
             bool success = UpdateValue ();
             
             SetValueIsValid (success);
+            UpdateDataHash (success);
             
             if (first_update)
                 SetValueDidChange (false);
@@ -221,9 +243,30 @@ ValueObject::UpdateValueIfNeeded (bool update_format)
                 // as changed if the value used to be valid and now isn't
                 SetValueDidChange (value_was_valid);
             }
+            
+            if (m_data_is_unchanged)
+            {
+                // The same bytes format to the same value string, which also
+                // tells GetValueAsCString() the value didn't change without it
+                // having to format anything (C strings depend on the pointee)
+                if (m_old_value_valid && m_last_format != eFormatCString)
+                    m_value_str = m_old_value_str;
+                if (reuse_summary)
+                    m_summary_str.swap (old_summary_str);
+            }
+            
+            // Read the bytes of the children we already have in one go
+            // rather than have each of them read its own
+            if (success)
+            {
+                const size_t children_end = m_children.GetDenseChildrenEnd();
+                if (children_end > 1)
+                    PrefetchChildrenData (0, children_end);
+            }
         }
         else
         {
+            UpdateDataHash (false);
             m_error.SetErrorString("out of scope");
         }
     }
@@ -536,6 +579,173 @@ ValueObject::GetChildAtIndex (size_t idx, bool can_create)
     return child_sp;
 }
 
+size_t
+ValueObject::GetChildrenAtIndexRange (size_t idx, size_t count, bool can_create,
+                                      std::vector<lldb::ValueObjectSP> &children)
+{
+    // Make sure our value is current, updating it drops the bytes we may
+    // have read for our children at an earlier stop
+    UpdateValueIfNeeded(false);
+
+    const size_t num_children = GetNumChildren();
+    if (idx >= num_children)
+        return 0;
+    if (count > num_children - idx)
+        count = num_children - idx;
+
+    if (can_create && !IsSynthetic())
+    {
+        // Create all the children first so we know where their bytes are,
+        // then read those bytes in one go before any child updates itself
+        for (size_t i = idx; i < idx + count; ++i)
+        {
+            if (!m_children.HasChildAtIndex(i))
+                m_children.SetChildAtIndex(i, CreateChildAtIndex (i, false, 0));
+        }
+        PrefetchChildrenData (idx, count);
+    }
+
+    const size_t old_size = children.size();
+    children.reserve (old_size + count);
+    for (size_t i = idx; i < idx + count; ++i)
+    {
+        ValueObjectSP child_sp (GetChildAtIndex (i, can_create));
+        if (child_sp)
+            children.push_back (child_sp);
+    }
+    return children.size() - old_size;
+}
+
+void
+ValueObject::PrefetchChildrenData (size_t idx, size_t count)
+{
+    // Don't bother for a single child, and never read more than this for
+    // one range (the parent may be a pointer with a garbage value)
+    static const size_t k_max_prefetch_size = 4 * 1024 * 1024;
+
+    if (count < 2 || IsSynthetic())
+        return;
+
+    ProcessSP process_sp (GetProcessSP());
+    if (!process_sp || !process_sp->IsAlive())
+        return;
+
+    // Work out the load address our children are relative to the same way
+    // ValueObjectChild::UpdateValue() does
+    lldb::addr_t base_addr = LLDB_INVALID_ADDRESS;
+    const bool is_ptr_or_ref = ClangASTContext::IsPointerOrReferenceType (GetClangType());
+    if (is_ptr_or_ref)
+    {
+        const AddressType addr_type = GetAddressTypeOfChildren();
+        if (addr_type != eAddressTypeLoad && addr_type != eAddressTypeFile)
+            return;
+        base_addr = GetPointerValue ();
+    }
+    else
+    {
+        if (m_value.GetValueType() != Value::eValueTypeLoadAddress)
+            return;
+        base_addr = m_value.GetScalar().ULongLong(LLDB_INVALID_ADDRESS);
+    }
+    if (base_addr == LLDB_INVALID_ADDRESS || base_addr == 0)
+        return;
+
+    lldb::addr_t low_addr = LLDB_INVALID_ADDRESS;
+    lldb::addr_t high_addr = 0;
+    for (size_t i = idx; i < idx + count; ++i)
+    {
+        if (!m_children.HasMaterializedChildAtIndex(i))
+            continue;
+        ValueObject *child = m_children.GetChildAtIndex(i);
+        const uint64_t child_size = child->GetByteSize();
+        if (child_size == 0)
+            continue;
+        const lldb::addr_t child_addr = base_addr + child->GetByteOffset();
+        if (child_addr < low_addr)
+            low_addr = child_addr;
+        if (child_addr + child_size > high_addr)
+            high_addr = child_addr + child_size;
+    }
+    if (low_addr == LLDB_INVALID_ADDRESS || high_addr <= low_addr)
+        return;
+    const size_t range_size = high_addr - low_addr;
+    if (range_size > k_max_prefetch_size)
+        return;
+
+    // Nothing to do if an earlier range already covers this one
+    if (m_children_data_sp &&
+        m_children_data_addr <= low_addr &&
+        high_addr <= m_children_data_addr + m_children_data_sp->GetByteSize())
+        return;
+
+    DataBufferSP data_sp (new DataBufferHeap (range_size, 0));
+    if (!is_ptr_or_ref && low_addr >= base_addr && high_addr - base_addr <= m_data.GetByteSize())
+    {
+        // Our own bytes already hold the children, e.g. an array or struct
+        // variable that was read as a whole
+        memcpy (data_sp->GetBytes(), m_data.GetDataStart() + (low_addr - base_addr), range_size);
+    }
+    else
+    {
+        Error error;
+        if (process_sp->ReadMemory (low_addr, data_sp->GetBytes(), range_size, error) != range_size)
+            return;
+    }
+
+    m_children_data_sp = data_sp;
+    m_children_data_addr = low_addr;
+}
+
+void
+ValueObject::UpdateDataHash (bool success)
+{
+    const uint64_t old_hash = m_data_hash;
+    const bool old_hash_valid = m_data_hash_valid;
+    
+    m_data_hash_valid = false;
+    m_data_is_unchanged = false;
+    
+    const size_t byte_size = m_data.GetByteSize();
+    if (!success || byte_size == 0)
+        return;
+    
+    // FNV-1a, our bytes are usually small so there is no point in anything
+    // fancier
+    uint64_t hash = 14695981039346656037ULL;
+    const uint8_t *bytes = m_data.GetDataStart();
+    for (size_t i = 0; i < byte_size; ++i)
+    {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    hash ^= byte_size;
+    
+    m_data_hash = hash;
+    m_data_hash_valid = true;
+    m_data_is_unchanged = old_hash_valid && old_hash == hash;
+}
+
+bool
+ValueObject::GetPrefetchedChildData (lldb::addr_t addr, size_t byte_size, DataExtractor &data)
+{
+    if (!m_children_data_sp || byte_size == 0 || addr == LLDB_INVALID_ADDRESS)
+        return false;
+    if (addr < m_children_data_addr ||
+        addr + byte_size > m_children_data_addr + m_children_data_sp->GetByteSize())
+        return false;
+
+    ProcessSP process_sp (GetProcessSP());
+    if (!process_sp)
+        return false;
+
+    const ArchSpec &arch = process_sp->GetTarget().GetArchitecture();
+    data.Clear();
+    data.SetByteOrder (arch.GetByteOrder());
+    data.SetAddressByteSize (arch.GetAddressByteSize());
+    data.SetData (m_children_data_sp, addr - m_children_data_addr, byte_size);
+    return true;
+}
+
 ValueObjectSP
 ValueObject::GetChildAtIndexPath (const std::initializer_list<size_t>& idxs,
                                   size_t* index_of_error)
@@ -3378,6 +3588,44 @@ ValueObject::ExpandArraySliceExpression(const char* expression_cstr,
     }
 }
 
+//----------------------------------------------------------------------
+// The character pointer children of a value each read their string on
+// their own when their summary is printed, which over a remote
+// connection costs a round trip per string. Get the start of all of them
+// into the memory cache at once so those reads don't have to go to the
+// process.
+//----------------------------------------------------------------------
+void
+ValueObject::PrefetchPointedStrings (const std::vector<ValueObjectSP> &children)
+{
+    std::vector<addr_t> string_addrs;
+    ProcessSP process_sp;
+    for (size_t idx = 0; idx < children.size(); ++idx)
+    {
+        ValueObject *child = children[idx].get();
+        if (child == NULL)
+            continue;
+        clang_type_t pointee_clang_type = NULL;
+        const Flags type_flags (child->GetTypeInfo (&pointee_clang_type));
+        if (!type_flags.Test (ClangASTContext::eTypeIsPointer) || pointee_clang_type == NULL)
+            continue;
+        // char, wchar_t, char16_t and char32_t all have string summaries
+        if (!clang::QualType::getFromOpaquePtr (pointee_clang_type)->isAnyCharacterType())
+            continue;
+        AddressType address_type = eAddressTypeInvalid;
+        const addr_t string_addr = child->GetPointerValue (&address_type);
+        if (address_type != eAddressTypeLoad || string_addr == 0 || string_addr == LLDB_INVALID_ADDRESS)
+            continue;
+        if (!process_sp)
+            process_sp = child->GetProcessSP();
+        string_addrs.push_back (string_addr);
+    }
+    
+    // A single string gains nothing over reading it directly
+    if (process_sp && string_addrs.size() > 1)
+        process_sp->PrefetchStringsFromMemory (string_addrs, process_sp->GetTarget().GetMaximumSizeOfStringSummary());
+}
+
 static void
 DumpValueObject_Impl (Stream &s,
                       ValueObject *valobj,
@@ -3598,9 +3846,15 @@ DumpValueObject_Impl (Stream &s,
                         child_options.SetFormat(options.m_format).SetSummary().SetRootValueObjectName();
                         child_options.SetScopeChecked(true).SetHideName(options.m_hide_name).SetHideValue(options.m_hide_value)
                         .SetOmitSummaryDepth(child_options.m_omit_summary_depth > 1 ? child_options.m_omit_summary_depth - 1 : 0);
-                        for (size_t idx=0; idx<num_children; ++idx)
+                        // Get the children together so that their bytes are read
+                        // with a single memory access rather than one per child
+                        std::vector<ValueObjectSP> children;
+                        synth_valobj->GetChildrenAtIndexRange(0, num_children, true, children);
+                        if (!child_options.m_hide_value)
+                            ValueObject::PrefetchPointedStrings(children);
+                        for (size_t idx=0; idx<children.size(); ++idx)
                         {
-                            ValueObjectSP child_sp(synth_valobj->GetChildAtIndex(idx, true));
+                            ValueObjectSP child_sp(children[idx]);
                             if (child_sp.get())
                             {
                                 DumpValueObject_Impl (s,
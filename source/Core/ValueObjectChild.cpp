@@ -208,8 +208,20 @@ ValueObjectChild::UpdateValue ()
 
             if (m_error.Success())
             {
-                ExecutionContext exe_ctx (GetExecutionContextRef().Lock());
-                m_error = m_value.GetValueAsData (&exe_ctx, GetClangAST (), m_data, 0, GetModule().get());
+                // Take our bytes from the parent if it read them for a whole
+                // range of children, otherwise read them ourselves
+                bool got_data = false;
+                if (m_value.GetValueType() == Value::eValueTypeLoadAddress)
+                {
+                    const lldb::addr_t addr = m_value.GetScalar().ULongLong(LLDB_INVALID_ADDRESS);
+                    const size_t byte_size = m_value.GetValueByteSize (GetClangAST (), NULL);
+                    got_data = parent->GetPrefetchedChildData (addr, byte_size, m_data);
+                }
+                if (!got_data)
+                {
+                    ExecutionContext exe_ctx (GetExecutionContextRef().Lock());
+                    m_error = m_value.GetValueAsData (&exe_ctx, GetClangAST (), m_data, 0, GetModule().get());
+                }
             }
         }
         else
@@ -17,6 +17,7 @@
 // Project includes
 #include "lldb/Core/ValueObject.h"
 #include "lldb/DataFormatters/FormatClasses.h"
+#include "lldb/Target/Target.h"
 
 using namespace lldb_private;
 
@@ -66,6 +67,8 @@ ValueObjectSynthetic::ValueObjectSynthetic (ValueObject &parent, lldb::Synthetic
     m_name_toindex(),
     m_synthetic_children_count(UINT32_MAX),
     m_parent_type_name(parent.GetTypeName()),
+    m_parent_data_hash(0),
+    m_parent_data_hash_valid(false),
     m_might_have_children(eLazyBoolCalculate)
 {
 #ifdef LLDB_CONFIGURATION_DEBUG
@@ -171,15 +174,29 @@ ValueObjectSynthetic::UpdateValue ()
     
     // regenerate the synthetic filter if our typename changes
     // <rdar://problem/12424824>
+    bool needs_update = true;
+    uint64_t parent_data_hash = 0;
+    const bool parent_data_hash_valid = m_parent->GetDataHash (parent_data_hash);
     ConstString new_parent_type_name = m_parent->GetTypeName();
     if (new_parent_type_name != m_parent_type_name)
     {
         m_parent_type_name = new_parent_type_name;
         CreateSynthFilter();
     }
+    else if (parent_data_hash_valid && m_parent_data_hash_valid && parent_data_hash == m_parent_data_hash)
+    {
+        // If the bytes of our parent didn't change the backend would come
+        // up with the same children, unless it looks past those bytes,
+        // which is why this is up to the user
+        lldb::TargetSP target_sp (GetTargetSP());
+        if (target_sp && target_sp->GetIncrementalValueUpdates())
+            needs_update = false;
+    }
+    m_parent_data_hash = parent_data_hash;
+    m_parent_data_hash_valid = parent_data_hash_valid;
 
     // let our backend do its update
-    if (m_synth_filter_ap->Update() == false)
+    if (needs_update && m_synth_filter_ap->Update() == false)
     {
         // filter said that cached values are stale
         m_children_byindex.clear();
@@ -222,6 +239,55 @@ ValueObjectSynthetic::GetChildAtIndex (size_t idx, bool can_create)
         return iter->second->GetSP();
 }
 
+size_t
+ValueObjectSynthetic::GetChildrenAtIndexRange (size_t idx, size_t count, bool can_create,
+                                               std::vector<lldb::ValueObjectSP> &children)
+{
+    UpdateValueIfNeeded();
+    
+    const size_t num_children = GetNumChildren();
+    if (idx >= num_children)
+        return 0;
+    if (count > num_children - idx)
+        count = num_children - idx;
+    
+    const size_t old_size = children.size();
+    
+    // Find the part of the range we don't have yet and ask the front-end
+    // for it in one go, it can walk its data structure once for all of it
+    size_t first_missing = idx + count;
+    size_t last_missing = idx;
+    for (size_t i = idx; i < idx + count; ++i)
+    {
+        if (m_children_byindex.find(i) == m_children_byindex.end())
+        {
+            if (first_missing > i)
+                first_missing = i;
+            last_missing = i;
+        }
+    }
+    
+    if (first_missing <= last_missing && can_create && m_synth_filter_ap.get() != NULL)
+    {
+        std::vector<lldb::ValueObjectSP> fetched;
+        m_synth_filter_ap->GetChildrenAtIndexRange (first_missing, last_missing - first_missing + 1, fetched);
+        for (size_t i = 0; i < fetched.size(); ++i)
+        {
+            if (fetched[i] && m_children_byindex.find(first_missing + i) == m_children_byindex.end())
+                m_children_byindex[first_missing + i] = fetched[i].get();
+        }
+    }
+    
+    children.reserve (old_size + count);
+    for (size_t i = idx; i < idx + count; ++i)
+    {
+        ByIndexIterator iter = m_children_byindex.find(i);
+        if (iter != m_children_byindex.end())
+            children.push_back(iter->second->GetSP());
+    }
+    return children.size() - old_size;
+}
+
 lldb::ValueObjectSP
 ValueObjectSynthetic::GetChildMemberWithName (const ConstString &name, bool can_create)
 {
@@ -1376,6 +1376,28 @@ lldb_private::formatters::ExtractIndexFromString (const char* item_name)
     return idx;
 }
 
+lldb::ValueObjectSP
+lldb_private::formatters::CreateValueObjectCopyFromMemory (const char* name,
+                                                           lldb::addr_t address,
+                                                           const ExecutionContext& exe_ctx,
+                                                           ClangASTType type)
+{
+    if (address == 0 || address == LLDB_INVALID_ADDRESS)
+        return lldb::ValueObjectSP();
+    ProcessSP process_sp(exe_ctx.GetProcessSP());
+    if (!process_sp)
+        return lldb::ValueObjectSP();
+    const uint64_t byte_size = type.GetClangTypeByteSize();
+    if (byte_size == 0)
+        return lldb::ValueObjectSP();
+    DataBufferSP buffer_sp(new DataBufferHeap(byte_size, 0));
+    Error error;
+    if (process_sp->ReadMemory(address, buffer_sp->GetBytes(), byte_size, error) != byte_size)
+        return lldb::ValueObjectSP();
+    DataExtractor data(buffer_sp, process_sp->GetByteOrder(), process_sp->GetAddressByteSize());
+    return ValueObject::CreateValueObjectFromData(name, data, exe_ctx, type);
+}
+
 lldb_private::formatters::VectorIteratorSyntheticFrontEnd::VectorIteratorSyntheticFrontEnd (lldb::ValueObjectSP valobj_sp,
                                                                                             ConstString item_name) :
 SyntheticChildrenFrontEnd(*valobj_sp.get()),
@@ -24,42 +24,12 @@ using namespace lldb_private;
 FormatCache::Entry::Entry () :
 m_summary_cached(false),
 m_synthetic_cached(false),
+m_summary_revision(),
+m_synthetic_revision(),
 m_summary_sp(),
 m_synthetic_sp()
 {}
 
-FormatCache::Entry::Entry (lldb::TypeSummaryImplSP summary_sp) :
-m_synthetic_cached(false),
-m_synthetic_sp()
-{
-    SetSummary (summary_sp);
-}
-
-FormatCache::Entry::Entry (lldb::SyntheticChildrenSP synthetic_sp) :
-m_summary_cached(false),
-m_summary_sp()
-{
-    SetSynthetic (synthetic_sp);
-}
-
-FormatCache::Entry::Entry (lldb::TypeSummaryImplSP summary_sp,lldb::SyntheticChildrenSP synthetic_sp)
-{
-    SetSummary (summary_sp);
-    SetSynthetic (synthetic_sp);
-}
-
-bool
-FormatCache::Entry::IsSummaryCached ()
-{
-    return m_summary_cached;
-}
-
-bool
-FormatCache::Entry::IsSyntheticCached ()
-{
-    return m_synthetic_cached;
-}
-
 lldb::TypeSummaryImplSP
 FormatCache::Entry::GetSummary ()
 {
@@ -73,97 +43,157 @@ FormatCache::Entry::GetSynthetic ()
 }
 
 void
-FormatCache::Entry::SetSummary (lldb::TypeSummaryImplSP summary_sp)
+FormatCache::Entry::SetSummary (lldb::TypeSummaryImplSP summary_sp, const TypeCategoryMap::Revision& revision)
 {
     m_summary_cached = true;
+    m_summary_revision = revision;
     m_summary_sp = summary_sp;
 }
 
 void
-FormatCache::Entry::SetSynthetic (lldb::SyntheticChildrenSP synthetic_sp)
+FormatCache::Entry::SetSynthetic (lldb::SyntheticChildrenSP synthetic_sp, const TypeCategoryMap::Revision& revision)
 {
     m_synthetic_cached = true;
+    m_synthetic_revision = revision;
     m_synthetic_sp = synthetic_sp;
 }
 
-FormatCache::FormatCache () :
-m_map(),
-m_mutex (Mutex::eMutexTypeRecursive)
+void
+FormatCache::Entry::ClearSummary ()
+{
+    m_summary_cached = false;
+    m_summary_revision = TypeCategoryMap::Revision();
+    m_summary_sp.reset();
+}
+
+void
+FormatCache::Entry::ClearSynthetic ()
+{
+    m_synthetic_cached = false;
+    m_synthetic_revision = TypeCategoryMap::Revision();
+    m_synthetic_sp.reset();
+}
+
+FormatCache::FormatCache ()
 #ifdef LLDB_CONFIGURATION_DEBUG
-,m_cache_hits(0),m_cache_misses(0)
+: m_cache_hits(0),m_cache_misses(0)
 #endif
 {
 }
 
-FormatCache::Entry&
-FormatCache::GetEntry (const ConstString& type)
+FormatCache::Shard&
+FormatCache::GetShard (const ConstString& type)
 {
-    auto i = m_map.find(type),
-    e = m_map.end();
-    if (i != e)
-        return i->second;
-    m_map[type] = FormatCache::Entry();
-    return m_map[type];
+    // ConstString pointers are at least pointer aligned, skip the low bits
+    uintptr_t key = (uintptr_t)type.GetCString();
+    return m_shards[(key >> 4) % kNumShards];
 }
 
 bool
-FormatCache::GetSummary (const ConstString& type,lldb::TypeSummaryImplSP& summary_sp)
+FormatCache::GetSummary (const ConstString& type,TypeCategoryMap& categories,lldb::TypeSummaryImplSP& summary_sp)
 {
-    Mutex::Locker lock(m_mutex);
-    auto entry = GetEntry(type);
-    if (entry.IsSummaryCached())
+    Shard &shard = GetShard(type);
+    TypeCategoryMap::Revision revision;
+    bool cached = false;
+    {
+        Mutex::Locker lock(shard.m_mutex);
+        CacheMap::iterator pos = shard.m_map.find(type.GetCString());
+        if (pos != shard.m_map.end() && pos->second.IsSummaryCached())
+        {
+            cached = true;
+            revision = pos->second.GetSummaryRevision();
+            summary_sp = pos->second.GetSummary();
+        }
+    }
+    // IsCurrent() takes the category map lock, don't hold the shard lock
+    if (cached && categories.IsCurrent(revision))
     {
 #ifdef LLDB_CONFIGURATION_DEBUG
-        m_cache_hits++;
+        __sync_add_and_fetch(&m_cache_hits, 1);
 #endif
-        summary_sp = entry.GetSummary();
         return true;
     }
+    if (cached)
+        DropSummary(type, revision);
 #ifdef LLDB_CONFIGURATION_DEBUG
-    m_cache_misses++;
+    __sync_add_and_fetch(&m_cache_misses, 1);
 #endif
     summary_sp.reset();
     return false;
 }
 
 bool
-FormatCache::GetSynthetic (const ConstString& type,lldb::SyntheticChildrenSP& synthetic_sp)
+FormatCache::GetSynthetic (const ConstString& type,TypeCategoryMap& categories,lldb::SyntheticChildrenSP& synthetic_sp)
 {
-    Mutex::Locker lock(m_mutex);
-    auto entry = GetEntry(type);
-    if (entry.IsSyntheticCached())
+    Shard &shard = GetShard(type);
+    TypeCategoryMap::Revision revision;
+    bool cached = false;
+    {
+        Mutex::Locker lock(shard.m_mutex);
+        CacheMap::iterator pos = shard.m_map.find(type.GetCString());
+        if (pos != shard.m_map.end() && pos->second.IsSyntheticCached())
+        {
+            cached = true;
+            revision = pos->second.GetSyntheticRevision();
+            synthetic_sp = pos->second.GetSynthetic();
+        }
+    }
+    if (cached && categories.IsCurrent(revision))
     {
 #ifdef LLDB_CONFIGURATION_DEBUG
-        m_cache_hits++;
+        __sync_add_and_fetch(&m_cache_hits, 1);
 #endif
-        synthetic_sp = entry.GetSynthetic();
         return true;
     }
+    if (cached)
+        DropSynthetic(type, revision);
 #ifdef LLDB_CONFIGURATION_DEBUG
-    m_cache_misses++;
+    __sync_add_and_fetch(&m_cache_misses, 1);
 #endif
     synthetic_sp.reset();
     return false;
 }
 
+// Drops a stale result unless another thread has replaced it in the
+// meantime. The entry goes away once neither kind is cached.
 void
-FormatCache::SetSummary (const ConstString& type,lldb::TypeSummaryImplSP& summary_sp)
+FormatCache::DropSummary (const ConstString& type, const TypeCategoryMap::Revision& revision)
 {
-    Mutex::Locker lock(m_mutex);
-    GetEntry(type).SetSummary(summary_sp);
+    Shard &shard = GetShard(type);
+    Mutex::Locker lock(shard.m_mutex);
+    CacheMap::iterator pos = shard.m_map.find(type.GetCString());
+    if (pos == shard.m_map.end() || !pos->second.IsSummaryCached() || !(pos->second.GetSummaryRevision() == revision))
+        return;
+    pos->second.ClearSummary();
+    if (!pos->second.IsSyntheticCached())
+        shard.m_map.erase(pos);
 }
 
 void
-FormatCache::SetSynthetic (const ConstString& type,lldb::SyntheticChildrenSP& synthetic_sp)
+FormatCache::DropSynthetic (const ConstString& type, const TypeCategoryMap::Revision& revision)
 {
-    Mutex::Locker lock(m_mutex);
-    GetEntry(type).SetSynthetic(synthetic_sp);
+    Shard &shard = GetShard(type);
+    Mutex::Locker lock(shard.m_mutex);
+    CacheMap::iterator pos = shard.m_map.find(type.GetCString());
+    if (pos == shard.m_map.end() || !pos->second.IsSyntheticCached() || !(pos->second.GetSyntheticRevision() == revision))
+        return;
+    pos->second.ClearSynthetic();
+    if (!pos->second.IsSummaryCached())
+        shard.m_map.erase(pos);
 }
 
 void
-FormatCache::Clear ()
+FormatCache::SetSummary (const ConstString& type,lldb::TypeSummaryImplSP& summary_sp,const TypeCategoryMap::Revision& revision)
 {
-    Mutex::Locker lock(m_mutex);
-    m_map.clear();
+    Shard &shard = GetShard(type);
+    Mutex::Locker lock(shard.m_mutex);
+    shard.m_map[type.GetCString()].SetSummary(summary_sp, revision);
 }
 
+void
+FormatCache::SetSynthetic (const ConstString& type,lldb::SyntheticChildrenSP& synthetic_sp,const TypeCategoryMap::Revision& revision)
+{
+    Shard &shard = GetShard(type);
+    Mutex::Locker lock(shard.m_mutex);
+    shard.m_map[type.GetCString()].SetSynthetic(synthetic_sp, revision);
+}
@@ -347,19 +347,20 @@ FormatManager::GetSummaryFormat (ValueObject& valobj,
     {
         if (log)
             log->Printf("[FormatManager::GetSummaryFormat] Looking into cache for type %s", valobj_type.AsCString("<invalid>"));
-        if (m_format_cache.GetSummary(valobj_type,retval))
+        if (m_format_cache.GetSummary(valobj_type,m_categories_map,retval))
             return retval;
         if (log)
             log->Printf("[FormatManager::GetSummaryFormat] Cache search failed. Going normal route");
     }
 #endif
-    retval = m_categories_map.GetSummaryFormat(valobj, use_dynamic);
+    TypeCategoryMap::Revision cache_revision;
+    retval = m_categories_map.GetSummaryFormat(valobj, use_dynamic, &cache_revision);
 #if USE_CACHE
     if (valobj_type)
     {
         if (log)
             log->Printf("[FormatManager::GetSummaryFormat] Caching %p for type %s",retval.get(),valobj_type.AsCString("<invalid>"));
-        m_format_cache.SetSummary(valobj_type,retval);
+        m_format_cache.SetSummary(valobj_type,retval,cache_revision);
     }
 #ifdef LLDB_CONFIGURATION_DEBUG
     if (log)
@@ -382,19 +383,20 @@ FormatManager::GetSyntheticChildren (ValueObject& valobj,
     {
         if (log)
             log->Printf("[FormatManager::GetSyntheticChildren] Looking into cache for type %s\n", valobj_type.AsCString("<invalid>"));
-        if (m_format_cache.GetSynthetic(valobj_type,retval))
+        if (m_format_cache.GetSynthetic(valobj_type,m_categories_map,retval))
             return retval;
         if (log)
             log->Printf("[FormatManager::GetSyntheticChildren] Cache search failed. Going normal route\n");
     }
 #endif
-    retval = m_categories_map.GetSyntheticChildren(valobj, use_dynamic);
+    TypeCategoryMap::Revision cache_revision;
+    retval = m_categories_map.GetSyntheticChildren(valobj, use_dynamic, &cache_revision);
 #if USE_CACHE
     if (valobj_type)
     {
         if (log)
             log->Printf("[FormatManager::GetSyntheticChildren] Caching %p for type %s\n",retval.get(),valobj_type.AsCString("<invalid>"));
-        m_format_cache.SetSynthetic(valobj_type,retval);
+        m_format_cache.SetSynthetic(valobj_type,retval,cache_revision);
     }
 #ifdef LLDB_CONFIGURATION_DEBUG
     if (log)
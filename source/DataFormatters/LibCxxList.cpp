@@ -19,128 +19,23 @@
 #include "lldb/Host/Endian.h"
 #include "lldb/Symbol/ClangASTContext.h"
 #include "lldb/Target/ObjCLanguageRuntime.h"
+#include "lldb/Target/Process.h"
 #include "lldb/Target/Target.h"
 
 using namespace lldb;
 using namespace lldb_private;
 using namespace lldb_private::formatters;
 
-class ListEntry
+// Read one of the links of a list node, LLDB_INVALID_ADDRESS if we can't
+static lldb::addr_t
+ReadNodePointer (Process &process, lldb::addr_t addr)
 {
-public:
-    ListEntry () {}
-    ListEntry (ValueObjectSP entry_sp) : m_entry_sp(entry_sp) {}
-    ListEntry (const ListEntry& rhs) : m_entry_sp(rhs.m_entry_sp) {}
-    ListEntry (ValueObject* entry) : m_entry_sp(entry ? entry->GetSP() : ValueObjectSP()) {}
-    
-    ValueObjectSP
-    next ()
-    {
-        if (!m_entry_sp)
-            return m_entry_sp;
-        return m_entry_sp->GetChildMemberWithName(ConstString("__next_"), true);
-    }
-    
-    ValueObjectSP
-    prev ()
-    {
-        if (!m_entry_sp)
-            return m_entry_sp;
-        return m_entry_sp->GetChildMemberWithName(ConstString("__prev_"), true);
-    }
-    
-    uint64_t
-    value ()
-    {
-        if (!m_entry_sp)
-            return 0;
-        return m_entry_sp->GetValueAsUnsigned(0);
-    }
-
-    bool
-    null()
-    {
-        return (value() == 0);
-    }
-    
-    ValueObjectSP
-    GetEntry ()
-    {
-        return m_entry_sp;
-    }
-    
-    void
-    SetEntry (ValueObjectSP entry)
-    {
-        m_entry_sp = entry;
-    }
-    
-    bool
-    operator == (const ListEntry& rhs) const
-    {
-        return (rhs.m_entry_sp.get() == m_entry_sp.get());
-    }
-    
-private:
-    ValueObjectSP m_entry_sp;
-};
-
-class ListIterator
-{
-public:
-    ListIterator () {}
-    ListIterator (ListEntry entry) : m_entry(entry) {}
-    ListIterator (ValueObjectSP entry) : m_entry(entry) {}
-    ListIterator (const ListIterator& rhs) : m_entry(rhs.m_entry) {}
-    ListIterator (ValueObject* entry) : m_entry(entry) {}
-
-    ValueObjectSP
-    value ()
-    {
-        return m_entry.GetEntry();
-    }
-    
-    ValueObjectSP
-    advance (size_t count)
-    {
-        if (count == 0)
-            return m_entry.GetEntry();
-        if (count == 1)
-        {
-            next ();
-            return m_entry.GetEntry();
-        }
-        while (count > 0)
-        {
-            next ();
-            count--;
-            if (m_entry.null())
-                return lldb::ValueObjectSP();
-        }
-        return m_entry.GetEntry();
-    }
-    
-    bool
-    operator == (const ListIterator& rhs) const
-    {
-        return (rhs.m_entry == m_entry);
-    }
-    
-protected:
-    void
-    next ()
-    {
-        m_entry.SetEntry(m_entry.next());
-    }
-    
-    void
-    prev ()
-    {
-        m_entry.SetEntry(m_entry.prev());
-    }
-private:
-    ListEntry m_entry;
-};
+    Error error;
+    lldb::addr_t value = process.ReadPointerFromMemory(addr, error);
+    if (error.Fail())
+        return LLDB_INVALID_ADDRESS;
+    return value;
+}
 
 lldb_private::formatters::LibcxxStdListSyntheticFrontEnd::LibcxxStdListSyntheticFrontEnd (lldb::ValueObjectSP valobj_sp) :
 SyntheticChildrenFrontEnd(*valobj_sp.get()),
@@ -150,30 +45,102 @@ m_head(NULL),
 m_tail(NULL),
 m_element_type(),
 m_count(UINT32_MAX),
-m_children()
+m_children(),
+m_nodes(),
+m_next_offset(UINT32_MAX),
+m_value_offset(UINT32_MAX),
+m_walk_done(false)
 {
     if (valobj_sp)
         Update();
 }
 
 bool
-lldb_private::formatters::LibcxxStdListSyntheticFrontEnd::HasLoop()
+lldb_private::formatters::LibcxxStdListSyntheticFrontEnd::GetNodeLayout ()
 {
-    if (g_use_loop_detect == false)
+    if (m_value_offset != UINT32_MAX)
+        return true;
+    if (!m_head)
         return false;
-    ListEntry slow(m_head);
-    ListEntry fast1(m_head);
-    ListEntry fast2(m_head);
-    while (slow.next() && slow.next()->GetValueAsUnsigned(0) != m_node_address)
+    Error error;
+    ValueObjectSP node_sp(m_head->Dereference(error));
+    if (!node_sp || error.Fail())
+        return false;
+    ValueObjectSP next_sp(node_sp->GetChildMemberWithName(ConstString("__next_"), true));
+    ValueObjectSP value_sp(node_sp->GetChildMemberWithName(ConstString("__value_"), true));
+    if (!next_sp || !value_sp)
+        return false;
+    lldb::addr_t node_addr = node_sp->GetAddressOf();
+    lldb::addr_t next_addr = next_sp->GetAddressOf();
+    lldb::addr_t value_addr = value_sp->GetAddressOf();
+    if (node_addr == LLDB_INVALID_ADDRESS || next_addr == LLDB_INVALID_ADDRESS || value_addr == LLDB_INVALID_ADDRESS)
+        return false;
+    if (next_addr < node_addr || value_addr < node_addr)
+        return false;
+    m_next_offset = next_addr - node_addr;
+    m_value_offset = value_addr - node_addr;
+    return true;
+}
+
+lldb::addr_t
+lldb_private::formatters::LibcxxStdListSyntheticFrontEnd::GetNodeAtIndex (size_t idx)
+{
+    if (m_nodes.empty() && !m_walk_done)
     {
-        auto slow_value = slow.value();
-        fast1.SetEntry(fast2.next());
-        fast2.SetEntry(fast1.next());
-        if (fast1.value() == slow_value || fast2.value() == slow_value)
-            return true;
-        slow.SetEntry(slow.next());
+        uint64_t head_addr = m_head ? m_head->GetValueAsUnsigned(0) : 0;
+        if (head_addr == 0 || head_addr == m_node_address)
+            m_walk_done = true;
+        else
+            m_nodes.push_back(head_addr);
     }
-    return false;
+    if (idx >= m_nodes.size() && !m_walk_done)
+    {
+        ProcessSP process_sp(m_backend.GetProcessSP());
+        if (!process_sp || !GetNodeLayout())
+            return LLDB_INVALID_ADDRESS;
+        // carry on from the last node we got to instead of starting over from
+        // the head, the links are read with plain pointer reads that the process
+        // memory cache can mostly satisfy without talking to the inferior
+        while (idx >= m_nodes.size())
+        {
+            lldb::addr_t next_addr = ReadNodePointer(*process_sp, m_nodes.back() + m_next_offset);
+            if (next_addr == LLDB_INVALID_ADDRESS || next_addr == 0 || next_addr == m_node_address)
+            {
+                m_walk_done = true;
+                break;
+            }
+            // a corrupt list may loop back on itself. comparing the node at every
+            // even index 2i with the one at index i (Floyd's cycle finding) catches
+            // that without any extra reads
+            size_t next_idx = m_nodes.size();
+            if (g_use_loop_detect && (next_idx % 2) == 0 && m_nodes[next_idx / 2] == next_addr)
+            {
+                m_nodes.push_back(next_addr);
+                DropRepeatedNodes(next_idx / 2);
+                m_walk_done = true;
+                break;
+            }
+            m_nodes.push_back(next_addr);
+        }
+    }
+    if (idx < m_nodes.size())
+        return m_nodes[idx];
+    return LLDB_INVALID_ADDRESS;
+}
+
+void
+lldb_private::formatters::LibcxxStdListSyntheticFrontEnd::DropRepeatedNodes (size_t period)
+{
+    // node i and node 2i are the same, so the nodes repeat every "period"
+    // nodes from some point on. find where the loop starts and how long it
+    // is, and keep every node in it only once
+    size_t loop_start = 0;
+    while (m_nodes[loop_start] != m_nodes[loop_start + period])
+        ++loop_start;
+    size_t loop_length = 1;
+    while (m_nodes[loop_start + loop_length] != m_nodes[loop_start])
+        ++loop_length;
+    m_nodes.resize(loop_start + loop_length);
 }
 
 size_t
@@ -194,9 +161,19 @@ lldb_private::formatters::LibcxxStdListSyntheticFrontEnd::CalculateNumChildren (
     }
     if (m_count != UINT32_MAX)
     {
-        if (!HasLoop())
-            return m_count;
-        return m_count = 0;
+        // don't trust the size of a list that loops back on itself. walk as
+        // far as we would display, and twice as far again so that a loop
+        // among those nodes is found, and never claim more children than
+        // the walk got to. this way GetChildAtIndex() has a child for every
+        // index below the count we return
+        if (m_count > 0)
+        {
+            const size_t check_count = std::min<size_t>(m_count, m_list_capping_size);
+            GetNodeAtIndex(2 * check_count - 1);
+            if (m_walk_done && m_nodes.size() < m_count)
+                m_count = m_nodes.size();
+        }
+        return m_count;
     }
     else
     {
@@ -208,18 +185,9 @@ lldb_private::formatters::LibcxxStdListSyntheticFrontEnd::CalculateNumChildren (
             return 0;
         if (next_val == prev_val)
             return 1;
-        if (HasLoop())
-            return 0;
-        uint64_t size = 2;
-        ListEntry current(m_head);
-        while (current.next() && current.next()->GetValueAsUnsigned(0) != m_node_address)
-        {
-            size++;
-            current.SetEntry(current.next());
-            if (size > m_list_capping_size)
-                break;
-        }
-        return m_count = (size-1);
+        // count the nodes, but don't go any further than we would display
+        GetNodeAtIndex(m_list_capping_size);
+        return m_count = m_nodes.size();
     }
 }
 
@@ -236,19 +204,16 @@ lldb_private::formatters::LibcxxStdListSyntheticFrontEnd::GetChildAtIndex (size_
     if (cached != m_children.end())
         return cached->second;
     
-    ListIterator current(m_head);
-    ValueObjectSP current_sp(current.advance(idx));
-    if (!current_sp)
-        return lldb::ValueObjectSP();
-    current_sp = current_sp->GetChildMemberWithName(ConstString("__value_"), true);
-    if (!current_sp)
+    lldb::addr_t node_addr = GetNodeAtIndex(idx);
+    if (node_addr == LLDB_INVALID_ADDRESS || !GetNodeLayout())
         return lldb::ValueObjectSP();
-    // we need to copy current_sp into a new object otherwise we will end up with all items named __value_
-    DataExtractor data;
-    current_sp->GetData(data);
+    // we need to copy the value into a new object otherwise we will end up with all items named __value_
     StreamString name;
     name.Printf("[%zu]",idx);
-    return (m_children[idx] = ValueObject::CreateValueObjectFromData(name.GetData(), data, m_backend.GetExecutionContextRef(), m_element_type));
+    ValueObjectSP child_sp(CreateValueObjectCopyFromMemory(name.GetData(), node_addr + m_value_offset, m_backend.GetExecutionContextRef(), m_element_type));
+    if (child_sp)
+        m_children[idx] = child_sp;
+    return child_sp;
 }
 
 bool
@@ -257,6 +222,9 @@ lldb_private::formatters::LibcxxStdListSyntheticFrontEnd::Update()
     m_head = m_tail = NULL;
     m_node_address = 0;
     m_count = UINT32_MAX;
+    m_children.clear();
+    m_nodes.clear();
+    m_walk_done = false;
     Error err;
     ValueObjectSP backend_addr(m_backend.AddressOf(err));
     m_list_capping_size = 0;
@@ -19,223 +19,23 @@
 #include "lldb/Host/Endian.h"
 #include "lldb/Symbol/ClangASTContext.h"
 #include "lldb/Target/ObjCLanguageRuntime.h"
+#include "lldb/Target/Process.h"
 #include "lldb/Target/Target.h"
 
 using namespace lldb;
 using namespace lldb_private;
 using namespace lldb_private::formatters;
 
-class MapEntry
+// Read one of the links of a tree node, LLDB_INVALID_ADDRESS if we can't
+static lldb::addr_t
+ReadNodePointer (Process &process, lldb::addr_t addr)
 {
-public:
-    MapEntry () {}
-    MapEntry (ValueObjectSP entry_sp) : m_entry_sp(entry_sp) {}
-    MapEntry (const MapEntry& rhs) : m_entry_sp(rhs.m_entry_sp) {}
-    MapEntry (ValueObject* entry) : m_entry_sp(entry ? entry->GetSP() : ValueObjectSP()) {}
-    
-    ValueObjectSP
-    left ()
-    {
-        if (!m_entry_sp)
-            return m_entry_sp;
-        return m_entry_sp->GetChildMemberWithName(ConstString("__left_"), true);
-    }
-    
-    ValueObjectSP
-    right ()
-    {
-        if (!m_entry_sp)
-            return m_entry_sp;
-        return m_entry_sp->GetChildMemberWithName(ConstString("__right_"), true);
-    }
-    
-    ValueObjectSP
-    parent ()
-    {
-        if (!m_entry_sp)
-            return m_entry_sp;
-        return m_entry_sp->GetChildMemberWithName(ConstString("__parent_"), true);
-    }
-    
-    uint64_t
-    value ()
-    {
-        if (!m_entry_sp)
-            return 0;
-        return m_entry_sp->GetValueAsUnsigned(0);
-    }
-    
-    bool
-    error ()
-    {
-        if (!m_entry_sp)
-            return true;
-        return m_entry_sp->GetError().Fail();
-    }
-    
-    bool
-    null()
-    {
-        return (value() == 0);
-    }
-    
-    ValueObjectSP
-    GetEntry ()
-    {
-        return m_entry_sp;
-    }
-    
-    void
-    SetEntry (ValueObjectSP entry)
-    {
-        m_entry_sp = entry;
-    }
-    
-    bool
-    operator == (const MapEntry& rhs) const
-    {
-        return (rhs.m_entry_sp.get() == m_entry_sp.get());
-    }
-    
-private:
-    ValueObjectSP m_entry_sp;
-};
-
-class MapIterator
-{
-public:
-    MapIterator () {}
-    MapIterator (MapEntry entry, size_t depth = 0) : m_entry(entry), m_max_depth(depth), m_error(false) {}
-    MapIterator (ValueObjectSP entry, size_t depth = 0) : m_entry(entry), m_max_depth(depth), m_error(false) {}
-    MapIterator (const MapIterator& rhs) : m_entry(rhs.m_entry),m_max_depth(rhs.m_max_depth), m_error(false) {}
-    MapIterator (ValueObject* entry, size_t depth = 0) : m_entry(entry), m_max_depth(depth), m_error(false) {}
-    
-    ValueObjectSP
-    value ()
-    {
-        return m_entry.GetEntry();
-    }
-    
-    ValueObjectSP
-    advance (size_t count)
-    {
-        if (m_error)
-            return lldb::ValueObjectSP();
-        if (count == 0)
-            return m_entry.GetEntry();
-        if (count == 1)
-        {
-            next ();
-            return m_entry.GetEntry();
-        }
-        size_t steps = 0;
-        while (count > 0)
-        {
-            if (m_error)
-                return lldb::ValueObjectSP();
-            next ();
-            count--;
-            if (m_entry.null())
-                return lldb::ValueObjectSP();
-            steps++;
-            if (steps > m_max_depth)
-                return lldb::ValueObjectSP();
-        }
-        return m_entry.GetEntry();
-    }
-protected:
-    void
-    next ()
-    {
-        m_entry.SetEntry(increment(m_entry.GetEntry()));
-    }
-
-private:
-    ValueObjectSP
-    tree_min (ValueObjectSP x_sp)
-    {
-        MapEntry x(x_sp);
-        if (x.null())
-            return ValueObjectSP();
-        MapEntry left(x.left());
-        size_t steps = 0;
-        while (left.null() == false)
-        {
-            if (left.error())
-            {
-                m_error = true;
-                return lldb::ValueObjectSP();
-            }
-            x.SetEntry(left.GetEntry());
-            left.SetEntry(x.left());
-            steps++;
-            if (steps > m_max_depth)
-                return lldb::ValueObjectSP();
-        }
-        return x.GetEntry();
-    }
-    
-    ValueObjectSP
-    tree_max (ValueObjectSP x_sp)
-    {
-        MapEntry x(x_sp);
-        if (x.null())
-            return ValueObjectSP();
-        MapEntry right(x.right());
-        size_t steps = 0;
-        while (right.null() == false)
-        {
-            if (right.error())
-                return lldb::ValueObjectSP();
-            x.SetEntry(right.GetEntry());
-            right.SetEntry(x.right());
-            steps++;
-            if (steps > m_max_depth)
-                return lldb::ValueObjectSP();
-        }
-        return x.GetEntry();
-    }
-    
-    bool
-    is_left_child (ValueObjectSP x_sp)
-    {
-        MapEntry x(x_sp);
-        if (x.null())
-            return false;
-        MapEntry rhs(x.parent());
-        rhs.SetEntry(rhs.left());
-        return x.value() == rhs.value();
-    }
-    
-    ValueObjectSP
-    increment (ValueObjectSP x_sp)
-    {
-        MapEntry node(x_sp);
-        if (node.null())
-            return ValueObjectSP();
-        MapEntry right(node.right());
-        if (right.null() == false)
-            return tree_min(right.GetEntry());
-        size_t steps = 0;
-        while (!is_left_child(node.GetEntry()))
-        {
-            if (node.error())
-            {
-                m_error = true;
-                return lldb::ValueObjectSP();
-            }
-            node.SetEntry(node.parent());
-            steps++;
-            if (steps > m_max_depth)
-                return lldb::ValueObjectSP();
-        }
-        return node.parent();
-    }
-        
-    MapEntry m_entry;
-    size_t m_max_depth;
-    bool m_error;
-};
+    Error error;
+    lldb::addr_t value = process.ReadPointerFromMemory(addr, error);
+    if (error.Fail())
+        return LLDB_INVALID_ADDRESS;
+    return value;
+}
 
 lldb_private::formatters::LibcxxStdMapSyntheticFrontEnd::LibcxxStdMapSyntheticFrontEnd (lldb::ValueObjectSP valobj_sp) :
 SyntheticChildrenFrontEnd(*valobj_sp.get()),
@@ -244,7 +44,11 @@ m_root_node(NULL),
 m_element_type(),
 m_skip_size(UINT32_MAX),
 m_count(UINT32_MAX),
-m_children()
+m_children(),
+m_nodes(),
+m_left_offset(UINT32_MAX),
+m_right_offset(UINT32_MAX),
+m_parent_offset(UINT32_MAX)
 {
     if (valobj_sp)
         Update();
@@ -299,6 +103,113 @@ lldb_private::formatters::LibcxxStdMapSyntheticFrontEnd::GetValueOffset (const l
     m_skip_size = bit_offset / 8u;
 }
 
+bool
+lldb_private::formatters::LibcxxStdMapSyntheticFrontEnd::GetNodeLayout ()
+{
+    if (m_parent_offset != UINT32_MAX)
+        return true;
+    if (m_root_node == NULL || !GetDataType())
+        return false;
+    Error error;
+    ValueObjectSP node_sp(m_root_node->Dereference(error));
+    if (!node_sp || error.Fail())
+        return false;
+    GetValueOffset(node_sp);
+    if (m_skip_size == UINT32_MAX)
+        return false;
+    // the links live in base classes of the node, let the ValueObject
+    // machinery find them once and just remember where they are
+    ValueObjectSP left_sp(node_sp->GetChildMemberWithName(ConstString("__left_"), true));
+    ValueObjectSP right_sp(node_sp->GetChildMemberWithName(ConstString("__right_"), true));
+    ValueObjectSP parent_sp(node_sp->GetChildMemberWithName(ConstString("__parent_"), true));
+    if (!left_sp || !right_sp || !parent_sp)
+        return false;
+    lldb::addr_t node_addr = node_sp->GetAddressOf();
+    lldb::addr_t left_addr = left_sp->GetAddressOf();
+    lldb::addr_t right_addr = right_sp->GetAddressOf();
+    lldb::addr_t parent_addr = parent_sp->GetAddressOf();
+    if (node_addr == LLDB_INVALID_ADDRESS || left_addr == LLDB_INVALID_ADDRESS ||
+        right_addr == LLDB_INVALID_ADDRESS || parent_addr == LLDB_INVALID_ADDRESS)
+        return false;
+    if (left_addr < node_addr || right_addr < node_addr || parent_addr < node_addr)
+        return false;
+    m_left_offset = left_addr - node_addr;
+    m_right_offset = right_addr - node_addr;
+    m_parent_offset = parent_addr - node_addr;
+    return true;
+}
+
+// the node that follows node in an in-order walk, the same as __tree_next()
+// in libc++. the number of steps is bounded by the size of the tree so that
+// a corrupt tree can't keep us going forever
+lldb::addr_t
+lldb_private::formatters::LibcxxStdMapSyntheticFrontEnd::GetNextNode (Process &process, lldb::addr_t node)
+{
+    const size_t max_depth = CalculateNumChildren();
+    lldb::addr_t right = ReadNodePointer(process, node + m_right_offset);
+    if (right == LLDB_INVALID_ADDRESS)
+        return LLDB_INVALID_ADDRESS;
+    if (right != 0)
+    {
+        // the leftmost node of the right subtree
+        node = right;
+        for (size_t steps = 0; steps <= max_depth; steps++)
+        {
+            lldb::addr_t left = ReadNodePointer(process, node + m_left_offset);
+            if (left == LLDB_INVALID_ADDRESS)
+                return LLDB_INVALID_ADDRESS;
+            if (left == 0)
+                return node;
+            node = left;
+        }
+        return LLDB_INVALID_ADDRESS;
+    }
+    // go up until we come from a left child
+    for (size_t steps = 0; steps <= max_depth; steps++)
+    {
+        lldb::addr_t parent = ReadNodePointer(process, node + m_parent_offset);
+        if (parent == LLDB_INVALID_ADDRESS || parent == 0)
+            return LLDB_INVALID_ADDRESS;
+        lldb::addr_t parent_left = ReadNodePointer(process, parent + m_left_offset);
+        if (parent_left == LLDB_INVALID_ADDRESS)
+            return LLDB_INVALID_ADDRESS;
+        if (parent_left == node)
+            return parent;
+        node = parent;
+    }
+    return LLDB_INVALID_ADDRESS;
+}
+
+lldb::addr_t
+lldb_private::formatters::LibcxxStdMapSyntheticFrontEnd::GetNodeAtIndex (size_t idx)
+{
+    if (m_nodes.empty())
+    {
+        lldb::addr_t begin_addr = m_root_node->GetValueAsUnsigned(0);
+        if (begin_addr == 0)
+            return LLDB_INVALID_ADDRESS;
+        m_nodes.push_back(begin_addr);
+    }
+    if (idx >= m_nodes.size())
+    {
+        ProcessSP process_sp(m_backend.GetProcessSP());
+        if (!process_sp)
+            return LLDB_INVALID_ADDRESS;
+        // carry on from the last node we got to instead of walking from the
+        // beginning for every child, the links are plain pointer reads that
+        // the process memory cache can mostly satisfy without talking to the
+        // inferior
+        while (idx >= m_nodes.size())
+        {
+            lldb::addr_t next_addr = GetNextNode(*process_sp, m_nodes.back());
+            if (next_addr == LLDB_INVALID_ADDRESS)
+                return LLDB_INVALID_ADDRESS;
+            m_nodes.push_back(next_addr);
+        }
+    }
+    return m_nodes[idx];
+}
+
 lldb::ValueObjectSP
 lldb_private::formatters::LibcxxStdMapSyntheticFrontEnd::GetChildAtIndex (size_t idx)
 {
@@ -311,65 +222,28 @@ lldb_private::formatters::LibcxxStdMapSyntheticFrontEnd::GetChildAtIndex (size_t
     if (cached != m_children.end())
         return cached->second;
     
-    bool need_to_skip = (idx > 0);
-    MapIterator iterator(m_root_node, CalculateNumChildren());
-    ValueObjectSP iterated_sp(iterator.advance(idx));
-    if (iterated_sp.get() == NULL)
+    if (!GetNodeLayout())
     {
-        // this tree is garbage - stop
-        m_tree = NULL; // this will stop all future searches until an Update() happens
-        return iterated_sp;
-    }
-    if (GetDataType())
-    {
-        if (!need_to_skip)
-        {
-            Error error;
-            iterated_sp = iterated_sp->Dereference(error);
-            if (!iterated_sp || error.Fail())
-            {
-                m_tree = NULL;
-                return lldb::ValueObjectSP();
-            }
-            GetValueOffset(iterated_sp);
-            iterated_sp = iterated_sp->GetChildMemberWithName(ConstString("__value_"), true);
-            if (!iterated_sp)
-            {
-                m_tree = NULL;
-                return lldb::ValueObjectSP();
-            }
-        }
-        else
-        {
-            // because of the way our debug info is made, we need to read item 0 first
-            // so that we can cache information used to generate other elements
-            if (m_skip_size == UINT32_MAX)
-                GetChildAtIndex(0);
-            if (m_skip_size == UINT32_MAX)
-            {
-                m_tree = NULL;
-                return lldb::ValueObjectSP();
-            }
-            iterated_sp = iterated_sp->GetSyntheticChildAtOffset(m_skip_size, m_element_type, true);
-            if (!iterated_sp)
-            {
-                m_tree = NULL;
-                return lldb::ValueObjectSP();
-            }
-        }
+        m_tree = NULL;
+        return lldb::ValueObjectSP();
     }
-    else
+    lldb::addr_t node_addr = GetNodeAtIndex(idx);
+    if (node_addr == LLDB_INVALID_ADDRESS)
     {
-        m_tree = NULL;
+        // this tree is garbage - stop
+        m_tree = NULL; // this will stop all future searches until an Update() happens
         return lldb::ValueObjectSP();
     }
-    // at this point we have a valid 
-    // we need to copy current_sp into a new object otherwise we will end up with all items named __value_
-    DataExtractor data;
-    iterated_sp->GetData(data);
+    // we need to copy the value into a new object otherwise we will end up with all items named __value_
     StreamString name;
     name.Printf("[%zu]",idx);
-    return (m_children[idx] = ValueObject::CreateValueObjectFromData(name.GetData(), data, m_backend.GetExecutionContextRef(), m_element_type));
+    ValueObjectSP child_sp(CreateValueObjectCopyFromMemory(name.GetData(), node_addr + m_skip_size, m_backend.GetExecutionContextRef(), m_element_type));
+    if (!child_sp)
+    {
+        m_tree = NULL;
+        return child_sp;
+    }
+    return (m_children[idx] = child_sp);
 }
 
 bool
@@ -378,6 +252,7 @@ lldb_private::formatters::LibcxxStdMapSyntheticFrontEnd::Update()
     m_count = UINT32_MAX;
     m_tree = m_root_node = NULL;
     m_children.clear();
+    m_nodes.clear();
     m_tree = m_backend.GetChildMemberWithName(ConstString("__tree_"), true).get();
     if (!m_tree)
         return false;
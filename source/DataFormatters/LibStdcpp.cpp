@@ -21,6 +21,8 @@
 #include "lldb/Target/ObjCLanguageRuntime.h"
 #include "lldb/Target/Target.h"
 
+#include <algorithm>
+
 using namespace lldb;
 using namespace lldb_private;
 using namespace lldb_private::formatters;
@@ -30,7 +32,10 @@ SyntheticChildrenFrontEnd(*valobj_sp.get()),
 m_exe_ctx_ref(),
 m_count(0),
 m_base_data_address(0),
-m_options()
+m_options(),
+m_children(),
+m_page(),
+m_page_byte_idx(0)
 {
     if (valobj_sp)
         Update();
@@ -46,6 +51,33 @@ lldb_private::formatters::LibstdcppVectorBoolSyntheticFrontEnd::CalculateNumChil
     return m_count;
 }
 
+bool
+lldb_private::formatters::LibstdcppVectorBoolSyntheticFrontEnd::ReadStorageByte (size_t byte_idx, uint8_t &byte)
+{
+    // read the bits a page at a time rather than a byte per child
+    static const size_t k_page_size = 256;
+    if (byte_idx < m_page_byte_idx || byte_idx >= m_page_byte_idx + m_page.size())
+    {
+        ProcessSP process_sp(m_exe_ctx_ref.GetProcessSP());
+        if (!process_sp)
+            return false;
+        const size_t num_bytes = (m_count + 7) / 8;
+        const size_t page_byte_idx = byte_idx - (byte_idx % k_page_size);
+        const size_t page_size = std::min<size_t>(k_page_size, num_bytes - page_byte_idx);
+        m_page.resize(page_size);
+        m_page_byte_idx = page_byte_idx;
+        Error err;
+        size_t bytes_read = process_sp->ReadMemory(m_base_data_address + page_byte_idx, &m_page[0], page_size, err);
+        if (err.Fail() || bytes_read != page_size)
+        {
+            m_page.clear();
+            return false;
+        }
+    }
+    byte = m_page[byte_idx - m_page_byte_idx];
+    return true;
+}
+
 lldb::ValueObjectSP
 lldb_private::formatters::LibstdcppVectorBoolSyntheticFrontEnd::GetChildAtIndex (size_t idx)
 {
@@ -53,49 +85,35 @@ lldb_private::formatters::LibstdcppVectorBoolSyntheticFrontEnd::GetChildAtIndex
         return ValueObjectSP();
     if (m_base_data_address == 0 || m_count == 0)
         return ValueObjectSP();
+    auto cached = m_children.find(idx);
+    if (cached != m_children.end())
+        return cached->second;
     size_t byte_idx = (idx >> 3); // divide by 8 to get byte index
     size_t bit_index = (idx & 7); // efficient idx % 8 for bit index
-    lldb::addr_t byte_location = m_base_data_address + byte_idx;
     ProcessSP process_sp(m_exe_ctx_ref.GetProcessSP());
     if (!process_sp)
         return ValueObjectSP();
     uint8_t byte = 0;
-    uint8_t mask = 0;
-    Error err;
-    size_t bytes_read = process_sp->ReadMemory(byte_location, &byte, 1, err);
-    if (err.Fail() || bytes_read == 0)
+    if (!ReadStorageByte(byte_idx, byte))
         return ValueObjectSP();
-    switch (bit_index)
-    {
-        case 0:
-            mask = 1; break;
-        case 1:
-            mask = 2; break;
-        case 2:
-            mask = 4; break;
-        case 3:
-            mask = 8; break;
-        case 4:
-            mask = 16; break;
-        case 5:
-            mask = 32; break;
-        case 6:
-            mask = 64; break;
-        case 7:
-            mask = 128; break;
-        default:
-            return ValueObjectSP();
-    }
-    bool bit_set = ((byte & mask) != 0);
-    Target& target(process_sp->GetTarget());
-    ValueObjectSP retval_sp;
+    bool bit_set = ((byte & (1u << bit_index)) != 0);
+    // make the bool from its bytes instead of evaluating an expression for
+    // every element
+    clang::ASTContext *ast = m_backend.GetClangAST();
+    if (!ast)
+        return ValueObjectSP();
+    ClangASTType bool_type(ast, ast->BoolTy.getAsOpaquePtr());
+    const uint64_t bool_size = bool_type.GetClangTypeByteSize();
+    if (bool_size == 0)
+        return ValueObjectSP();
+    DataBufferSP buffer_sp(new DataBufferHeap(bool_size, 0));
     if (bit_set)
-        target.EvaluateExpression("(bool)true", NULL, retval_sp);
-    else
-        target.EvaluateExpression("(bool)false", NULL, retval_sp);
+        buffer_sp->GetBytes()[process_sp->GetByteOrder() == eByteOrderBig ? bool_size - 1 : 0] = 1;
+    DataExtractor data(buffer_sp, process_sp->GetByteOrder(), process_sp->GetAddressByteSize());
     StreamString name; name.Printf("[%zu]",idx);
+    ValueObjectSP retval_sp(ValueObject::CreateValueObjectFromData(name.GetData(), data, m_exe_ctx_ref, bool_type));
     if (retval_sp)
-        retval_sp->SetName(ConstString(name.GetData()));
+        m_children[idx] = retval_sp;
     return retval_sp;
 }
 
@@ -129,6 +147,9 @@ lldb_private::formatters::LibstdcppVectorBoolSyntheticFrontEnd::Update()
     if (!valobj_sp)
         return false;
     m_exe_ctx_ref = valobj_sp->GetExecutionContextRef();
+    m_children.clear();
+    m_page.clear();
+    m_page_byte_idx = 0;
     
     ValueObjectSP m_impl_sp(valobj_sp->GetChildMemberWithName(ConstString("_M_impl"), true));
     if (!m_impl_sp)
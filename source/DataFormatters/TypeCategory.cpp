@@ -21,18 +21,19 @@ using namespace lldb_private;
 
 TypeCategoryImpl::TypeCategoryImpl(IFormatChangeListener* clist,
                                    ConstString name) :
-m_summary_nav(new SummaryNavigator("summary",clist)),
-m_regex_summary_nav(new RegexSummaryNavigator("regex-summary",clist)),
-m_filter_nav(new FilterNavigator("filter",clist)),
-m_regex_filter_nav(new RegexFilterNavigator("regex-filter",clist)),
+m_summary_nav(new SummaryNavigator("summary",this)),
+m_regex_summary_nav(new RegexSummaryNavigator("regex-summary",this)),
+m_filter_nav(new FilterNavigator("filter",this)),
+m_regex_filter_nav(new RegexFilterNavigator("regex-filter",this)),
 #ifndef LLDB_DISABLE_PYTHON
-m_synth_nav(new SynthNavigator("synth",clist)),
-m_regex_synth_nav(new RegexSynthNavigator("regex-synth",clist)),
+m_synth_nav(new SynthNavigator("synth",this)),
+m_regex_synth_nav(new RegexSynthNavigator("regex-synth",this)),
 #endif
 m_enabled(false),
 m_change_listener(clist),
 m_mutex(Mutex::eMutexTypeRecursive),
-m_name(name)
+m_name(name),
+m_revision(0)
 {}
 
 bool
@@ -377,6 +378,23 @@ TypeCategoryImpl::Enable (bool value, uint32_t position)
     Mutex::Locker locker(m_mutex);
     m_enabled = value;
     m_enabled_position = position;
+    Changed();
+}
+
+void
+TypeCategoryImpl::Changed ()
+{
+    __sync_add_and_fetch(&m_revision, +1);
     if (m_change_listener)
         m_change_listener->Changed();
 }
+
+uint32_t
+TypeCategoryImpl::GetCurrentRevision ()
+{
+    // formatters are stamped with the global revision so that a filter and
+    // a synthetic provider from different categories can be ordered
+    if (m_change_listener)
+        return m_change_listener->GetCurrentRevision();
+    return 0;
+}
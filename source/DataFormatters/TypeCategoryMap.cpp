@@ -22,6 +22,7 @@ using namespace lldb_private;
 TypeCategoryMap::TypeCategoryMap (IFormatChangeListener* lst) :
 m_map_mutex(Mutex::eMutexTypeRecursive),
 listener(lst),
+m_revision(0),
 m_map(),
 m_active_categories()
 {
@@ -36,6 +37,7 @@ TypeCategoryMap::Add (KeyType name, const ValueSP& entry)
 {
     Mutex::Locker locker(m_map_mutex);
     m_map[name] = entry;
+    m_revision++;
     if (listener)
         listener->Changed();
 }
@@ -49,6 +51,7 @@ TypeCategoryMap::Delete (KeyType name)
         return false;
     m_map.erase(name);
     Disable(name);
+    m_revision++;
     if (listener)
         listener->Changed();
     return true;
@@ -96,6 +99,7 @@ TypeCategoryMap::Enable (ValueSP category, Position pos)
         }
         else
             return false;
+        m_revision++;
         category->Enable(true,
                          pos);
         return true;
@@ -110,6 +114,7 @@ TypeCategoryMap::Disable (ValueSP category)
     if (category.get())
     {
         m_active_categories.remove_if(delete_matching_categories(category));
+        m_revision++;
         category->Disable();
         return true;
     }
@@ -122,6 +127,7 @@ TypeCategoryMap::Clear ()
     Mutex::Locker locker(m_map_mutex);
     m_map.clear();
     m_active_categories.clear();
+    m_revision++;
     if (listener)
         listener->Changed();
 }
@@ -178,10 +184,17 @@ TypeCategoryMap::AnyMatches (ConstString type_name,
 
 lldb::TypeSummaryImplSP
 TypeCategoryMap::GetSummaryFormat (ValueObject& valobj,
-                                   lldb::DynamicValueType use_dynamic)
+                                   lldb::DynamicValueType use_dynamic,
+                                   Revision* revision)
 {
     Mutex::Locker locker(m_map_mutex);
     
+    if (revision)
+    {
+        *revision = Revision();
+        revision->m_map_revision = m_revision;
+    }
+    
     uint32_t reason_why;
     ActiveCategoriesIterator begin, end = m_active_categories.end();
     
@@ -191,6 +204,11 @@ TypeCategoryMap::GetSummaryFormat (ValueObject& valobj,
     {
         lldb::TypeCategoryImplSP category_sp = *begin;
         lldb::TypeSummaryImplSP current_format;
+        if (revision)
+        {
+            revision->m_depth++;
+            revision->m_categories_revision += category_sp->GetRevision();
+        }
         if (log)
             log->Printf("[CategoryMap::GetSummaryFormat] Trying to use category %s\n", category_sp->GetName());
         if (!category_sp->Get(valobj, current_format, use_dynamic, &reason_why))
@@ -205,10 +223,17 @@ TypeCategoryMap::GetSummaryFormat (ValueObject& valobj,
 #ifndef LLDB_DISABLE_PYTHON
 lldb::SyntheticChildrenSP
 TypeCategoryMap::GetSyntheticChildren (ValueObject& valobj,
-                                       lldb::DynamicValueType use_dynamic)
+                                       lldb::DynamicValueType use_dynamic,
+                                       Revision* revision)
 {
     Mutex::Locker locker(m_map_mutex);
     
+    if (revision)
+    {
+        *revision = Revision();
+        revision->m_map_revision = m_revision;
+    }
+    
     uint32_t reason_why;
     
     ActiveCategoriesIterator begin, end = m_active_categories.end();
@@ -219,6 +244,11 @@ TypeCategoryMap::GetSyntheticChildren (ValueObject& valobj,
     {
         lldb::TypeCategoryImplSP category_sp = *begin;
         lldb::SyntheticChildrenSP current_format;
+        if (revision)
+        {
+            revision->m_depth++;
+            revision->m_categories_revision += category_sp->GetRevision();
+        }
         if (log)
             log->Printf("[CategoryMap::GetSyntheticChildren] Trying to use category %s\n", category_sp->GetName());
         if (!category_sp->Get(valobj, current_format, use_dynamic, &reason_why))
@@ -231,6 +261,24 @@ TypeCategoryMap::GetSyntheticChildren (ValueObject& valobj,
 }
 #endif
 
+bool
+TypeCategoryMap::IsCurrent (const Revision& revision)
+{
+    Mutex::Locker locker(m_map_mutex);
+    
+    if (revision.m_map_revision != m_revision)
+        return false;
+    
+    // category revisions only ever grow, so the sum over the same categories
+    // only matches if none of them changed
+    uint32_t categories_revision = 0;
+    uint32_t depth = revision.m_depth;
+    ActiveCategoriesIterator begin, end = m_active_categories.end();
+    for (begin = m_active_categories.begin(); begin != end && depth > 0; begin++, depth--)
+        categories_revision += (*begin)->GetRevision();
+    return categories_revision == revision.m_categories_revision;
+}
+
 void
 TypeCategoryMap::LoopThrough(CallbackType callback, void* param)
 {
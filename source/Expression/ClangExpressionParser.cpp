@@ -15,6 +15,7 @@
 #include "lldb/Core/DataBufferHeap.h"
 #include "lldb/Core/Debugger.h"
 #include "lldb/Core/Disassembler.h"
+#include "lldb/Core/PluginManager.h"
 #include "lldb/Core/Stream.h"
 #include "lldb/Core/StreamString.h"
 #include "lldb/Expression/ClangASTSource.h"
@@ -192,6 +193,10 @@ ClangExpressionParser::ClangExpressionParser (ExecutionContextScope *exe_scope,
     m_code_generator ()
 {
     // Initialize targets first, so that --version shows registered targets.
+    // The LLVM MC parts are registered by a deferred initializer that the
+    // disassembler and unwinders share; run it first so the two never
+    // register targets concurrently.
+    PluginManager::RunDeferredInitializer (PluginManager::GetLLVMTargetsInitializerName());
     static struct InitializeLLVM {
         InitializeLLVM() {
             llvm::InitializeAllTargets();
@@ -9,6 +9,7 @@
 
 // C Includes
 #include <stdio.h>
+#include <string.h>
 #if HAVE_SYS_TYPES_H
 #  include <sys/types.h>
 #endif
@@ -380,6 +381,26 @@ ClangUserExpression::MatchesContext (ExecutionContext &exe_ctx)
     return LockAndCheckContext(exe_ctx, target_sp, process_sp, frame_sp);
 }
 
+bool
+ClangUserExpression::RebindContext (ExecutionContext &exe_ctx)
+{
+    if (m_target != exe_ctx.GetTargetPtr())
+        return false;
+    
+    if (m_process_wp.lock() != exe_ctx.GetProcessSP())
+        return false;
+    
+    if (m_dematerializer_sp)
+        return false;
+    
+    if (m_jit_start_addr == LLDB_INVALID_ADDRESS && !m_can_interpret)
+        return false;
+    
+    InstallContext(exe_ctx);
+    
+    return true;
+}
+
 // This is a really nasty hack, meant to fix Objective-C expressions of the form
 // (int)[myArray count].  Right now, because the type information for count is
 // not available, [myArray count] returns id, which can't be directly cast to
@@ -830,7 +851,8 @@ ClangUserExpression::Execute (Stream &error_stream,
                                       *m_execution_unit_ap.get(),
                                       interpreter_error,
                                       function_stack_bottom,
-                                      function_stack_top);
+                                      function_stack_top,
+                                      &m_interpreter_function_sp);
             
             if (!interpreter_error.Success())
             {
@@ -994,16 +1016,45 @@ ClangUserExpression::EvaluateWithError (ExecutionContext &exe_ctx,
     if (process == NULL || !process->CanJIT())
         execution_policy = eExecutionPolicyNever;
     
-    ClangUserExpressionSP user_expression_sp (new ClangUserExpression (expr_cstr, expr_prefix, language, desired_type));
+    // Expressions that are evaluated again and again in the same scope, like
+    // stop-hook and display expressions, are kept by the target once they
+    // ran so we don't have to parse and JIT them every time.
+    ClangUserExpressionCache *expr_cache = NULL;
+    std::string cache_key;
+    
+    Target *target = exe_ctx.GetTargetPtr();
+    if (target && ClangUserExpressionCache::MakeKey (exe_ctx, execution_policy, language, desired_type, expr_cstr, expr_prefix, cache_key))
+        expr_cache = &target->GetUserExpressionCache();
+    
+    ClangUserExpressionSP user_expression_sp;
+    
+    if (expr_cache)
+        user_expression_sp = expr_cache->Take (cache_key, exe_ctx);
 
     StreamString error_stream;
-        
-    if (log)
-        log->Printf("== [ClangUserExpression::Evaluate] Parsing expression %s ==", expr_cstr);
     
-    const bool keep_expression_in_memory = true;
+    bool parsed = false;
     
-    if (!user_expression_sp->Parse (error_stream, exe_ctx, execution_policy, keep_expression_in_memory))
+    if (user_expression_sp)
+    {
+        if (log)
+            log->Printf("== [ClangUserExpression::Evaluate] Reusing parsed expression %s ==", expr_cstr);
+        
+        parsed = true;
+    }
+    else
+    {
+        user_expression_sp.reset (new ClangUserExpression (expr_cstr, expr_prefix, language, desired_type));
+        
+        if (log)
+            log->Printf("== [ClangUserExpression::Evaluate] Parsing expression %s ==", expr_cstr);
+        
+        const bool keep_expression_in_memory = true;
+        
+        parsed = user_expression_sp->Parse (error_stream, exe_ctx, execution_policy, keep_expression_in_memory);
+    }
+    
+    if (!parsed)
     {
         if (error_stream.GetString().empty())
             error.SetErrorString ("expression failed to parse, unknown error");
@@ -1039,6 +1090,9 @@ ClangUserExpression::EvaluateWithError (ExecutionContext &exe_ctx,
                                                              run_others,
                                                              timeout_usec);
             
+            if (execution_results == eExecutionCompleted && expr_cache)
+                expr_cache->Give (cache_key, user_expression_sp);
+            
             if (execution_results != eExecutionCompleted)
             {
                 if (log)
@@ -1074,3 +1128,128 @@ ClangUserExpression::EvaluateWithError (ExecutionContext &exe_ctx,
 
     return execution_results;
 }
+
+//----------------------------------------------------------------------
+// ClangUserExpressionCache
+//----------------------------------------------------------------------
+ClangUserExpressionCache::ClangUserExpressionCache () :
+    m_mutex (Mutex::eMutexTypeNormal),
+    m_entries (),
+    m_use_counter (0)
+{
+}
+
+ClangUserExpressionCache::~ClangUserExpressionCache ()
+{
+}
+
+bool
+ClangUserExpressionCache::MakeKey (ExecutionContext &exe_ctx,
+                                   lldb_private::ExecutionPolicy execution_policy,
+                                   lldb::LanguageType language,
+                                   ClangUserExpression::ResultType desired_type,
+                                   const char *expr_cstr,
+                                   const char *expr_prefix,
+                                   std::string &key)
+{
+    if (expr_cstr == NULL || expr_cstr[0] == '\0')
+        return false;
+    
+    // Persistent variables are declared when the expression is parsed and
+    // their types are baked into the code, don't hand out stale copies of
+    // expressions that use them.
+    if (::strchr (expr_cstr, '$'))
+        return false;
+    
+    // The JIT'ed code and the materialized struct live in the process.
+    Process *process = exe_ctx.GetProcessPtr();
+    if (process == NULL)
+        return false;
+    
+    // The declarations the parser found depend on the innermost lexical
+    // block the frame is stopped in; fall back to the symbol for code
+    // without debug info and to the exact pc after that.
+    const void *scope = NULL;
+    lldb::addr_t scope_addr = LLDB_INVALID_ADDRESS;
+    
+    StackFrame *frame = exe_ctx.GetFramePtr();
+    if (frame)
+    {
+        const SymbolContext &sc = frame->GetSymbolContext (lldb::eSymbolContextBlock | lldb::eSymbolContextSymbol);
+        if (sc.block)
+            scope = sc.block;
+        else if (sc.symbol)
+            scope = sc.symbol;
+        else
+            scope_addr = frame->GetFrameCodeAddress().GetLoadAddress (exe_ctx.GetTargetPtr());
+    }
+    
+    StreamString key_strm;
+    key_strm.Printf ("%" PRIu64 "|%p|%" PRIx64 "|%i|%i|%i|",
+                     process->GetID(),
+                     scope,
+                     scope_addr,
+                     (int)execution_policy,
+                     (int)language,
+                     (int)desired_type);
+    if (expr_prefix)
+        key_strm.PutCString (expr_prefix);
+    key_strm.PutChar ('|');
+    key_strm.PutCString (expr_cstr);
+    
+    key.swap (key_strm.GetString());
+    return true;
+}
+
+ClangUserExpression::ClangUserExpressionSP
+ClangUserExpressionCache::Take (const std::string &key, ExecutionContext &exe_ctx)
+{
+    ClangUserExpression::ClangUserExpressionSP expr_sp;
+    
+    Mutex::Locker locker (m_mutex);
+    
+    EntryMap::iterator pos = m_entries.find (key);
+    if (pos == m_entries.end())
+        return expr_sp;
+    
+    expr_sp = pos->second.expr_sp;
+    m_entries.erase (pos);
+    
+    if (!expr_sp->RebindContext (exe_ctx))
+        expr_sp.reset();
+    
+    return expr_sp;
+}
+
+void
+ClangUserExpressionCache::Give (const std::string &key, const ClangUserExpression::ClangUserExpressionSP &expr_sp)
+{
+    Mutex::Locker locker (m_mutex);
+    
+    if (m_entries.size() >= kMaxEntries && m_entries.find (key) == m_entries.end())
+    {
+        EntryMap::iterator oldest_pos = m_entries.begin();
+        for (EntryMap::iterator pos = m_entries.begin(), end = m_entries.end(); pos != end; ++pos)
+        {
+            if (pos->second.last_use < oldest_pos->second.last_use)
+                oldest_pos = pos;
+        }
+        m_entries.erase (oldest_pos);
+    }
+    
+    Entry &entry = m_entries[key];
+    entry.expr_sp = expr_sp;
+    entry.last_use = ++m_use_counter;
+}
+
+void
+ClangUserExpressionCache::Clear ()
+{
+    // Release the expressions outside of the lock, freeing their JIT'ed
+    // code and materialized structs talks to the process.
+    EntryMap entries;
+    {
+        Mutex::Locker locker (m_mutex);
+        entries.swap (m_entries);
+    }
+}
@@ -15,14 +15,17 @@
 #include "lldb/Expression/IRMemoryMap.h"
 #include "lldb/Expression/IRInterpreter.h"
 
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SmallVector.h"
 #include "llvm/IR/Constants.h"
 #include "llvm/IR/DataLayout.h"
 #include "llvm/IR/Function.h"
 #include "llvm/IR/Instructions.h"
 #include "llvm/IR/Module.h"
+#include "llvm/Support/GetElementPtrTypeIterator.h"
 #include "llvm/Support/raw_ostream.h"
 
-#include <map>
+#include <vector>
 
 using namespace llvm;
 
@@ -57,73 +60,151 @@ PrintType(const Type *type, bool truncate = false)
     return s;
 }
 
+static const char *unsupported_opcode_error         = "Interpreter doesn't handle one of the expression's opcodes";
+static const char *unsupported_operand_error        = "Interpreter doesn't handle one of the expression's operands";
+//static const char *interpreter_initialization_error = "Interpreter couldn't be initialized";
+static const char *interpreter_internal_error       = "Interpreter encountered an internal error";
+static const char *bad_value_error                  = "Interpreter couldn't resolve a value during execution";
+static const char *memory_allocation_error          = "Interpreter couldn't allocate memory";
+static const char *memory_write_error               = "Interpreter couldn't write to memory";
+static const char *memory_read_error                = "Interpreter couldn't read from memory";
+static const char *infinite_loop_error              = "Interpreter ran for too many cycles";
+//static const char *bad_result_error                 = "Result of expression is in bad memory";
+
+//----------------------------------------------------------------------
+// The function is decoded once into a flat list of instructions before
+// it is interpreted.  Every argument, instruction and constant operand is
+// numbered into a dense slot whose value is kept in a host side buffer in
+// target byte order, so operands are found by index and scalar temporaries
+// never go through the IRMemoryMap.  Only the regions created by Alloca
+// live in the interpreter's stack frame in the memory map, since the
+// expression can take their address.
+//
+// The decoded form only depends on the function, so callers keep it
+// between runs and each run starts from a copy of its slot values.
+//----------------------------------------------------------------------
+class IRInterpreter::DecodedFunction
+{
+public:
+    enum { kInvalidSlot = UINT32_MAX };
+
+    struct Slot
+    {
+        const Value    *value;
+        size_t          offset;         // Offset of the value in m_slot_data
+        size_t          byte_size;
+        bool            valid;          // False for constants we couldn't resolve
+    };
+
+    // A variable index of a GetElementPtr, scaled by the size of the type
+    // it steps over
+    struct IndexTerm
+    {
+        uint32_t        slot;
+        uint32_t        bit_width;
+        int64_t         scale;
+    };
+
+    struct DecodedInst
+    {
+        const Instruction          *inst;
+        unsigned                    opcode;
+        uint32_t                    result;         // Slot of the instruction's value, or kInvalidSlot
+        uint32_t                    operands[2];    // Slots of the operands
+        uint32_t                    targets[2];     // Indices of the instructions a Br jumps to
+        uint32_t                    src_bit_width;  // Source width of SExt
+        size_t                      alloc_size;     // Size and alignment of the region made by an Alloca
+        size_t                      alloc_align;
+        int64_t                     gep_offset;     // Constant part of a GetElementPtr's offset
+        SmallVector<IndexTerm, 2>   gep_terms;
+    };
+
+    typedef DenseMap <const Value*, uint32_t> SlotMap;
+    typedef std::vector <Slot> SlotVector;
+    typedef std::vector <DecodedInst> DecodedInstVector;
+
+    DecodedFunction (const Function *function) :
+        m_function (function)
+    {
+    }
+
+    const Function                         *m_function;
+    SlotMap                                 m_slot_map;
+    SlotVector                              m_slots;
+    std::vector<uint8_t>                    m_slot_data;    // Constants are resolved, all other slots are filled in by each run
+    DecodedInstVector                       m_insts;
+};
+
 class InterpreterStackFrame
 {
 public:
-    typedef std::map <const Value*, lldb::addr_t> ValueMap;
-    
-    ValueMap                                m_values;
+    typedef IRInterpreter::DecodedFunction DecodedFunction;
+    typedef DecodedFunction::Slot Slot;
+    typedef DecodedFunction::IndexTerm IndexTerm;
+    typedef DecodedFunction::DecodedInst DecodedInst;
+    typedef DecodedFunction::SlotMap SlotMap;
+    typedef DecodedFunction::SlotVector SlotVector;
+    typedef DecodedFunction::DecodedInstVector DecodedInstVector;
+
+    enum { kInvalidSlot = DecodedFunction::kInvalidSlot };
+
+    SlotMap                                &m_slot_map;
+    SlotVector                             &m_slots;
+    std::vector<uint8_t>                    m_slot_data;
+    DecodedInstVector                      &m_insts;
     DataLayout                             &m_target_data;
     lldb_private::IRMemoryMap              &m_memory_map;
-    const BasicBlock                       *m_bb;
-    BasicBlock::const_iterator              m_ii;
-    BasicBlock::const_iterator              m_ie;
-    
+
     lldb::addr_t                            m_frame_process_address;
     size_t                                  m_frame_size;
     lldb::addr_t                            m_stack_pointer;
-    
+
     lldb::ByteOrder                         m_byte_order;
     size_t                                  m_addr_byte_size;
-    
+
     InterpreterStackFrame (DataLayout &target_data,
                            lldb_private::IRMemoryMap &memory_map,
+                           DecodedFunction &decoded_function,
                            lldb::addr_t stack_frame_bottom,
                            lldb::addr_t stack_frame_top) :
+        m_slot_map (decoded_function.m_slot_map),
+        m_slots (decoded_function.m_slots),
+        m_slot_data (decoded_function.m_slot_data),
+        m_insts (decoded_function.m_insts),
         m_target_data (target_data),
         m_memory_map (memory_map)
     {
         m_byte_order = (target_data.isLittleEndian() ? lldb::eByteOrderLittle : lldb::eByteOrderBig);
         m_addr_byte_size = (target_data.getPointerSize(0));
-                        
+
         m_frame_process_address = stack_frame_bottom;
         m_frame_size = stack_frame_top - stack_frame_bottom;
         m_stack_pointer = stack_frame_top;
     }
-    
+
     ~InterpreterStackFrame ()
     {
     }
-    
-    void Jump (const BasicBlock *bb)
-    {
-        m_bb = bb;
-        m_ii = m_bb->begin();
-        m_ie = m_bb->end();
-    }
-    
-    std::string SummarizeValue (const Value *value)
+
+    std::string SummarizeValue (uint32_t slot)
     {
         lldb_private::StreamString ss;
 
-        ss.Printf("%s", PrintValue(value).c_str());
-        
-        ValueMap::iterator i = m_values.find(value);
+        if (slot == kInvalidSlot)
+            return std::string("<no value>");
+
+        ss.Printf("%s", PrintValue(m_slots[slot].value).c_str());
+
+        lldb_private::Scalar scalar;
+
+        if (EvaluateSlot(scalar, slot))
+            ss.Printf(" = 0x%llx", (unsigned long long)scalar.GetRawBits64(0));
 
-        if (i != m_values.end())
-        {
-            lldb::addr_t addr = i->second;
-            
-            ss.Printf(" 0x%llx", (unsigned long long)addr);
-        }
-        
         return ss.GetString();
     }
-    
-    bool AssignToMatchType (lldb_private::Scalar &scalar, uint64_t u64value, Type *type)
-    {
-        size_t type_size = m_target_data.getTypeStoreSize(type);
 
+    bool AssignToMatchType (lldb_private::Scalar &scalar, uint64_t u64value, size_t type_size)
+    {
         switch (type_size)
         {
         case 1:
@@ -141,75 +222,74 @@ public:
         default:
             return false;
         }
-        
+
         return true;
     }
-    
-    bool EvaluateValue (lldb_private::Scalar &scalar, const Value *value, Module &module)
+
+    uint8_t *GetSlotBytes (uint32_t slot)
     {
-        const Constant *constant = dyn_cast<Constant>(value);
-        
-        if (constant)
-        {
-            APInt value_apint;
-            
-            if (!ResolveConstantValue(value_apint, constant))
-                return false;
-            
-            return AssignToMatchType(scalar, value_apint.getLimitedValue(), value->getType());
-        }
-        else
-        {
-            lldb::addr_t process_address = ResolveValue(value, module);
-            size_t value_size = m_target_data.getTypeStoreSize(value->getType());
-        
-            lldb_private::DataExtractor value_extractor;
-            lldb_private::Error extract_error;
-            
-            m_memory_map.GetMemoryData(value_extractor, process_address, value_size, extract_error);
-            
-            if (!extract_error.Success())
-                return false;
-            
-            lldb::offset_t offset = 0;
-            if (value_size <= 8)
-            {
-                uint64_t u64value = value_extractor.GetMaxU64(&offset, value_size);
-                return AssignToMatchType(scalar, u64value, value->getType());
-            }
-        }
-        
-        return false;
+        return &m_slot_data[m_slots[slot].offset];
     }
-    
-    bool AssignValue (const Value *value, lldb_private::Scalar &scalar, Module &module)
+
+    uint32_t GetSlot (const Value *value)
     {
-        lldb::addr_t process_address = ResolveValue (value, module);
-        
-        if (process_address == LLDB_INVALID_ADDRESS)
+        SlotMap::iterator pos = m_slot_map.find(value);
+
+        if (pos != m_slot_map.end())
+            return pos->second;
+
+        uint32_t slot = m_slots.size();
+
+        Slot new_slot;
+        new_slot.value = value;
+        new_slot.byte_size = (value->getType()->isSized() ? m_target_data.getTypeStoreSize(value->getType()) : 0);
+        new_slot.offset = (m_slot_data.size() + 7) & ~((size_t)7);
+        new_slot.valid = true;
+
+        m_slot_data.resize(new_slot.offset + new_slot.byte_size, 0);
+        m_slots.push_back(new_slot);
+        m_slot_map[value] = slot;
+
+        if (const Constant *constant = dyn_cast<Constant>(value))
+            m_slots[slot].valid = ResolveConstant(slot, constant);
+
+        return slot;
+    }
+
+    bool EvaluateSlot (lldb_private::Scalar &scalar, uint32_t slot)
+    {
+        if (slot == kInvalidSlot)
             return false;
-    
+
+        const Slot &value_slot = m_slots[slot];
+
+        if (!value_slot.valid || value_slot.byte_size == 0 || value_slot.byte_size > 8)
+            return false;
+
+        lldb_private::DataExtractor value_extractor(GetSlotBytes(slot), value_slot.byte_size, m_byte_order, m_addr_byte_size);
+
+        lldb::offset_t offset = 0;
+        uint64_t u64value = value_extractor.GetMaxU64(&offset, value_slot.byte_size);
+        return AssignToMatchType(scalar, u64value, value_slot.byte_size);
+    }
+
+    bool AssignSlot (uint32_t slot, const lldb_private::Scalar &scalar)
+    {
+        if (slot == kInvalidSlot)
+            return false;
+
+        const Slot &value_slot = m_slots[slot];
+
         lldb_private::Scalar cast_scalar;
-        
-        if (!AssignToMatchType(cast_scalar, scalar.GetRawBits64(0), value->getType()))
+
+        if (!AssignToMatchType(cast_scalar, scalar.GetRawBits64(0), value_slot.byte_size))
             return false;
-                
-        size_t value_byte_size = m_target_data.getTypeStoreSize(value->getType());
-        
-        lldb_private::DataBufferHeap buf(value_byte_size, 0);
-        
+
         lldb_private::Error get_data_error;
-        
-        if (!cast_scalar.GetAsMemoryData(buf.GetBytes(), buf.GetByteSize(), m_byte_order, get_data_error))
-            return false;
-        
-        lldb_private::Error write_error;
-        
-        m_memory_map.WriteMemory(process_address, buf.GetBytes(), buf.GetByteSize(), write_error);
-        
-        return write_error.Success();
+
+        return cast_scalar.GetAsMemoryData(GetSlotBytes(slot), value_slot.byte_size, m_byte_order, get_data_error) != 0;
     }
-    
+
     bool ResolveConstantValue (APInt &value, const Constant *constant)
     {
         switch (constant->getValueID())
@@ -245,27 +325,27 @@ public:
                     {
                         ConstantExpr::const_op_iterator op_cursor = constant_expr->op_begin();
                         ConstantExpr::const_op_iterator op_end = constant_expr->op_end();
-                        
+
                         Constant *base = dyn_cast<Constant>(*op_cursor);
-                        
+
                         if (!base)
                             return false;
-                        
+
                         if (!ResolveConstantValue(value, base))
                             return false;
-                        
+
                         op_cursor++;
-                        
+
                         if (op_cursor == op_end)
                             return true; // no offset to apply!
-                        
+
                         SmallVector <Value *, 8> indices (op_cursor, op_end);
-                        
+
                         uint64_t offset = m_target_data.getIndexedOffset(base->getType(), indices);
-                        
+
                         const bool is_signed = true;
                         value += APInt(value.getBitWidth(), offset, is_signed);
-                        
+
                         return true;
                     }
                 }
@@ -281,145 +361,230 @@ public:
         }
         return false;
     }
-    
+
     bool MakeArgument(const Argument *value, uint64_t address)
     {
-        lldb::addr_t data_address = Malloc(value->getType());
-        
-        if (data_address == LLDB_INVALID_ADDRESS)
-            return false;
-        
-        lldb_private::Error write_error;
-        
-        m_memory_map.WritePointerToMemory(data_address, address, write_error);
-        
-        if (!write_error.Success())
-        {
-            lldb_private::Error free_error;
-            m_memory_map.Free(data_address, free_error);
+        uint32_t slot = GetSlot(value);
+
+        if (!AssignSlot(slot, lldb_private::Scalar(address)))
             return false;
-        }
-        
-        m_values[value] = data_address;
-        
+
         lldb_private::Log *log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_EXPRESSIONS));
 
         if (log)
         {
-            log->Printf("Made an allocation for argument %s", PrintValue(value).c_str());
+            log->Printf("Made a slot for argument %s", PrintValue(value).c_str());
             log->Printf("  Data region    : %llx", (unsigned long long)address);
-            log->Printf("  Ref region     : %llx", (unsigned long long)data_address);
+            log->Printf("  Slot           : %u", slot);
         }
-        
+
         return true;
     }
-    
-    bool ResolveConstant (lldb::addr_t process_address, const Constant *constant)
+
+    bool ResolveConstant (uint32_t slot, const Constant *constant)
     {
         APInt resolved_value;
-        
+
         if (!ResolveConstantValue(resolved_value, constant))
             return false;
-        
-        const uint64_t *raw_data = resolved_value.getRawData();
-            
-        size_t constant_size = m_target_data.getTypeStoreSize(constant->getType());
-        
-        lldb_private::Error write_error;
-        
-        m_memory_map.WriteMemory(process_address, (uint8_t*)raw_data, constant_size, write_error);
-        
-        return write_error.Success();
+
+        return AssignSlot(slot, lldb_private::Scalar((uint64_t)resolved_value.getLimitedValue()));
     }
-    
-    lldb::addr_t Malloc (size_t size, uint8_t byte_alignment)
+
+    lldb::addr_t Malloc (size_t size, size_t byte_alignment)
     {
         lldb::addr_t ret = m_stack_pointer;
-        
+
+        if (byte_alignment == 0)
+            byte_alignment = 1;
+
         ret -= size;
         ret -= (ret % byte_alignment);
-        
+
         if (ret < m_frame_process_address)
             return LLDB_INVALID_ADDRESS;
-        
+
         m_stack_pointer = ret;
         return ret;
     }
-        
-    lldb::addr_t MallocPointer ()
-    {
-        return Malloc(m_target_data.getPointerSize(), m_target_data.getPointerPrefAlignment());
-    }
-    
-    lldb::addr_t Malloc (llvm::Type *type)
+
+    static int64_t SignExtend (uint64_t value, uint32_t bit_width)
     {
-        lldb_private::Error alloc_error;
-        
-        return Malloc(m_target_data.getTypeAllocSize(type), m_target_data.getPrefTypeAlignment(type));
+        if (bit_width == 0 || bit_width >= 64)
+            return (int64_t)value;
+
+        const uint32_t shift = 64 - bit_width;
+        return ((int64_t)(value << shift)) >> shift;
     }
-    
-    std::string PrintData (lldb::addr_t addr, llvm::Type *type)
+
+    bool Decode (const Function &function, lldb_private::Error &error)
     {
-        size_t length = m_target_data.getTypeStoreSize(type);
-        
-        lldb_private::DataBufferHeap buf(length, 0);
-        
-        lldb_private::Error read_error;
-        
-        m_memory_map.ReadMemory(buf.GetBytes(), addr, length, read_error);
-        
-        if (!read_error.Success())
-            return std::string("<couldn't read data>");
-        
-        lldb_private::StreamString ss;
-        
-        for (size_t i = 0; i < length; i++)
+        lldb_private::Log *log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_EXPRESSIONS));
+
+        DenseMap <const BasicBlock*, uint32_t> block_starts;
+        size_t num_insts = 0;
+
+        for (Function::const_iterator bbi = function.begin(), bbe = function.end();
+             bbi != bbe;
+             ++bbi)
         {
-            if ((!(i & 0xf)) && i)
-                ss.Printf("%02hhx - ", buf.GetBytes()[i]);
-            else
-                ss.Printf("%02hhx ", buf.GetBytes()[i]);
+            block_starts[bbi] = num_insts;
+            num_insts += bbi->size();
         }
-        
-        return ss.GetString();
-    }
-    
-    lldb::addr_t ResolveValue (const Value *value, Module &module)
-    {
-        ValueMap::iterator i = m_values.find(value);
-        
-        if (i != m_values.end())
-            return i->second;
-        
-        // Fall back and allocate space [allocation type Alloca]
-        
-        lldb::addr_t data_address = Malloc(value->getType());
-        
-        if (const Constant *constant = dyn_cast<Constant>(value))
+
+        m_insts.reserve(num_insts);
+
+        for (Function::const_iterator bbi = function.begin(), bbe = function.end();
+             bbi != bbe;
+             ++bbi)
         {
-            if (!ResolveConstant (data_address, constant))
+            for (BasicBlock::const_iterator ii = bbi->begin(), ie = bbi->end();
+                 ii != ie;
+                 ++ii)
             {
-                lldb_private::Error free_error;
-                m_memory_map.Free(data_address, free_error);
-                return LLDB_INVALID_ADDRESS;
+                const Instruction *inst = ii;
+
+                m_insts.push_back(DecodedInst());
+                DecodedInst &decoded = m_insts.back();
+
+                decoded.inst = inst;
+                decoded.opcode = inst->getOpcode();
+                decoded.result = (inst->getType()->isSized() ? GetSlot(inst) : (uint32_t)kInvalidSlot);
+                decoded.operands[0] = decoded.operands[1] = kInvalidSlot;
+                decoded.targets[0] = decoded.targets[1] = 0;
+                decoded.src_bit_width = 0;
+                decoded.alloc_size = 0;
+                decoded.alloc_align = 1;
+                decoded.gep_offset = 0;
+
+                switch (decoded.opcode)
+                {
+                    default:
+                        break;
+                    case Instruction::Add:
+                    case Instruction::Sub:
+                    case Instruction::Mul:
+                    case Instruction::SDiv:
+                    case Instruction::UDiv:
+                    case Instruction::SRem:
+                    case Instruction::URem:
+                    case Instruction::Shl:
+                    case Instruction::LShr:
+                    case Instruction::AShr:
+                    case Instruction::And:
+                    case Instruction::Or:
+                    case Instruction::Xor:
+                    case Instruction::ICmp:
+                        decoded.operands[0] = GetSlot(inst->getOperand(0));
+                        decoded.operands[1] = GetSlot(inst->getOperand(1));
+                        break;
+                    case Instruction::BitCast:
+                    case Instruction::ZExt:
+                    case Instruction::IntToPtr:
+                    case Instruction::PtrToInt:
+                        decoded.operands[0] = GetSlot(inst->getOperand(0));
+                        break;
+                    case Instruction::SExt:
+                        decoded.operands[0] = GetSlot(inst->getOperand(0));
+                        decoded.src_bit_width = inst->getOperand(0)->getType()->getScalarSizeInBits();
+                        break;
+                    case Instruction::Alloca:
+                    {
+                        const AllocaInst *alloca_inst = cast<AllocaInst>(inst);
+                        Type *T = alloca_inst->getAllocatedType();
+
+                        decoded.alloc_size = m_target_data.getTypeAllocSize(T);
+                        decoded.alloc_align = m_target_data.getPrefTypeAlignment(T);
+                    }
+                        break;
+                    case Instruction::Br:
+                    {
+                        const BranchInst *br_inst = cast<BranchInst>(inst);
+
+                        if (br_inst->isConditional())
+                        {
+                            decoded.operands[0] = GetSlot(br_inst->getCondition());
+                            decoded.targets[0] = block_starts[br_inst->getSuccessor(0)];
+                            decoded.targets[1] = block_starts[br_inst->getSuccessor(1)];
+                        }
+                        else
+                        {
+                            decoded.targets[0] = block_starts[br_inst->getSuccessor(0)];
+                        }
+                    }
+                        break;
+                    case Instruction::GetElementPtr:
+                    {
+                        const GetElementPtrInst *gep_inst = cast<GetElementPtrInst>(inst);
+
+                        decoded.operands[0] = GetSlot(gep_inst->getPointerOperand());
+
+                        for (gep_type_iterator gti = gep_type_begin(gep_inst), gte = gep_type_end(gep_inst);
+                             gti != gte;
+                             ++gti)
+                        {
+                            Value *index = gti.getOperand();
+
+                            if (StructType *struct_ty = dyn_cast<StructType>(*gti))
+                            {
+                                const ConstantInt *field = dyn_cast<ConstantInt>(index);
+
+                                if (!field)
+                                {
+                                    if (log)
+                                        log->Printf("Struct index of %s is not a constant", PrintValue(inst).c_str());
+                                    error.SetErrorToGenericError();
+                                    error.SetErrorString(unsupported_operand_error);
+                                    return false;
+                                }
+
+                                decoded.gep_offset += m_target_data.getStructLayout(struct_ty)->getElementOffset(field->getZExtValue());
+                            }
+                            else
+                            {
+                                int64_t scale = m_target_data.getTypeAllocSize(gti.getIndexedType());
+
+                                if (const ConstantInt *constant_index = dyn_cast<ConstantInt>(index))
+                                {
+                                    decoded.gep_offset += constant_index->getSExtValue() * scale;
+                                }
+                                else
+                                {
+                                    IndexTerm term;
+                                    term.slot = GetSlot(index);
+                                    term.bit_width = index->getType()->getScalarSizeInBits();
+                                    term.scale = scale;
+                                    decoded.gep_terms.push_back(term);
+                                }
+                            }
+                        }
+                    }
+                        break;
+                    case Instruction::Load:
+                        decoded.operands[0] = GetSlot(cast<LoadInst>(inst)->getPointerOperand());
+                        break;
+                    case Instruction::Store:
+                    {
+                        const StoreInst *store_inst = cast<StoreInst>(inst);
+
+                        decoded.operands[0] = GetSlot(store_inst->getValueOperand());
+                        decoded.operands[1] = GetSlot(store_inst->getPointerOperand());
+                    }
+                        break;
+                }
             }
         }
-        
-        m_values[value] = data_address;
-        return data_address;
+
+        if (log)
+            log->Printf("Decoded %llu instructions into %llu slots (%llu bytes)",
+                        (unsigned long long)m_insts.size(),
+                        (unsigned long long)m_slots.size(),
+                        (unsigned long long)m_slot_data.size());
+
+        return true;
     }
 };
 
-static const char *unsupported_opcode_error         = "Interpreter doesn't handle one of the expression's opcodes";
-static const char *unsupported_operand_error        = "Interpreter doesn't handle one of the expression's operands";
-//static const char *interpreter_initialization_error = "Interpreter couldn't be initialized";
-static const char *interpreter_internal_error       = "Interpreter encountered an internal error";
-static const char *bad_value_error                  = "Interpreter couldn't resolve a value during execution";
-static const char *memory_allocation_error          = "Interpreter couldn't allocate memory";
-static const char *memory_write_error               = "Interpreter couldn't write to memory";
-static const char *memory_read_error                = "Interpreter couldn't read from memory";
-static const char *infinite_loop_error              = "Interpreter ran for too many cycles";
-//static const char *bad_result_error                 = "Result of expression is in bad memory";
 
 bool
 IRInterpreter::CanInterpret (llvm::Module &module,
@@ -543,33 +708,43 @@ IRInterpreter::Interpret (llvm::Module &module,
                           lldb_private::IRMemoryMap &memory_map,
                           lldb_private::Error &error,
                           lldb::addr_t stack_frame_bottom,
-                          lldb::addr_t stack_frame_top)
+                          lldb::addr_t stack_frame_top,
+                          DecodedFunctionSP *decoded_function_sp)
 {
     lldb_private::Log *log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_EXPRESSIONS));
-    
+
     if (log)
     {
         std::string s;
         raw_string_ostream oss(s);
-        
+
         module.print(oss, NULL);
-        
+
         oss.flush();
-        
+
         log->Printf("Module as passed in to IRInterpreter::Interpret: \n\"%s\"", s.c_str());
     }
-    
+
     DataLayout data_layout(&module);
-    
-    InterpreterStackFrame frame(data_layout, memory_map, stack_frame_bottom, stack_frame_top);
-    
+
+    // Reuse the decoded form of the function from an earlier run if the
+    // caller kept one for this function
+    DecodedFunctionSP decoded_sp;
+    if (decoded_function_sp && *decoded_function_sp && (*decoded_function_sp)->m_function == &function)
+        decoded_sp = *decoded_function_sp;
+    const bool needs_decode = !decoded_sp;
+    if (needs_decode)
+        decoded_sp.reset(new DecodedFunction(&function));
+
+    InterpreterStackFrame frame(data_layout, memory_map, *decoded_sp, stack_frame_bottom, stack_frame_top);
+
     if (frame.m_frame_process_address == LLDB_INVALID_ADDRESS)
     {
         error.SetErrorString("Couldn't allocate stack frame");
     }
-    
+
     int arg_index = 0;
-    
+
     for (llvm::Function::arg_iterator ai = function.arg_begin(), ae = function.arg_end();
          ai != ae;
          ++ai, ++arg_index)
@@ -579,24 +754,40 @@ IRInterpreter::Interpret (llvm::Module &module,
             error.SetErrorString ("Not enough arguments passed in to function");
             return false;
         }
-        
+
         lldb::addr_t ptr = args[arg_index];
 
         frame.MakeArgument(ai, ptr);
     }
-    
+
+    if (needs_decode)
+    {
+        if (!frame.Decode(function, error))
+            return false;
+
+        // Keep the constants that were resolved while decoding for the next
+        // run, it rewrites the arguments and computes everything else
+        decoded_sp->m_slot_data = frame.m_slot_data;
+
+        if (decoded_function_sp)
+            *decoded_function_sp = decoded_sp;
+    }
+
+    typedef InterpreterStackFrame::DecodedInst DecodedInst;
+
+    const size_t num_decoded_insts = frame.m_insts.size();
+    size_t pc = 0;
     uint32_t num_insts = 0;
-    
-    frame.Jump(function.begin());
-    
-    while (frame.m_ii != frame.m_ie && (++num_insts < 4096))
+
+    while (pc < num_decoded_insts && (++num_insts < 4096))
     {
-        const Instruction *inst = frame.m_ii;
-        
+        const DecodedInst &decoded = frame.m_insts[pc];
+        const Instruction *inst = decoded.inst;
+
         if (log)
             log->Printf("Interpreting %s", PrintValue(inst).c_str());
-        
-        switch (inst->getOpcode())
+
+        switch (decoded.opcode)
         {
             default:
                 break;
@@ -614,44 +805,30 @@ IRInterpreter::Interpret (llvm::Module &module,
             case Instruction::Or:
             case Instruction::Xor:
             {
-                const BinaryOperator *bin_op = dyn_cast<BinaryOperator>(inst);
-                
-                if (!bin_op)
-                {
-                    if (log)
-                        log->Printf("getOpcode() returns %s, but instruction is not a BinaryOperator", inst->getOpcodeName());
-                    error.SetErrorToGenericError();
-                    error.SetErrorString(interpreter_internal_error);
-                    return false;
-                }
-                
-                Value *lhs = inst->getOperand(0);
-                Value *rhs = inst->getOperand(1);
-                
                 lldb_private::Scalar L;
                 lldb_private::Scalar R;
-                
-                if (!frame.EvaluateValue(L, lhs, module))
+
+                if (!frame.EvaluateSlot(L, decoded.operands[0]))
                 {
                     if (log)
-                        log->Printf("Couldn't evaluate %s", PrintValue(lhs).c_str());
+                        log->Printf("Couldn't evaluate %s", PrintValue(inst->getOperand(0)).c_str());
                     error.SetErrorToGenericError();
                     error.SetErrorString(bad_value_error);
                     return false;
                 }
-                
-                if (!frame.EvaluateValue(R, rhs, module))
+
+                if (!frame.EvaluateSlot(R, decoded.operands[1]))
                 {
                     if (log)
-                        log->Printf("Couldn't evaluate %s", PrintValue(rhs).c_str());
+                        log->Printf("Couldn't evaluate %s", PrintValue(inst->getOperand(1)).c_str());
                     error.SetErrorToGenericError();
                     error.SetErrorString(bad_value_error);
                     return false;
                 }
-                
+
                 lldb_private::Scalar result;
-                
-                switch (inst->getOpcode())
+
+                switch (decoded.opcode)
                 {
                     default:
                         break;
@@ -700,31 +877,22 @@ IRInterpreter::Interpret (llvm::Module &module,
                         result = L ^ R;
                         break;
                 }
-                
-                frame.AssignValue(inst, result, module);
-                
+
+                frame.AssignSlot(decoded.result, result);
+
                 if (log)
                 {
                     log->Printf("Interpreted a %s", inst->getOpcodeName());
-                    log->Printf("  L : %s", frame.SummarizeValue(lhs).c_str());
-                    log->Printf("  R : %s", frame.SummarizeValue(rhs).c_str());
-                    log->Printf("  = : %s", frame.SummarizeValue(inst).c_str());
+                    log->Printf("  L : %s", frame.SummarizeValue(decoded.operands[0]).c_str());
+                    log->Printf("  R : %s", frame.SummarizeValue(decoded.operands[1]).c_str());
+                    log->Printf("  = : %s", frame.SummarizeValue(decoded.result).c_str());
                 }
             }
                 break;
             case Instruction::Alloca:
             {
-                const AllocaInst *alloca_inst = dyn_cast<AllocaInst>(inst);
-                
-                if (!alloca_inst)
-                {
-                    if (log)
-                        log->Printf("getOpcode() returns Alloca, but instruction is not an AllocaInst");
-                    error.SetErrorToGenericError();
-                    error.SetErrorString(interpreter_internal_error);
-                    return false;
-                }
-                
+                const AllocaInst *alloca_inst = cast<AllocaInst>(inst);
+
                 if (alloca_inst->isArrayAllocation())
                 {
                     if (log)
@@ -733,17 +901,13 @@ IRInterpreter::Interpret (llvm::Module &module,
                     error.SetErrorString(unsupported_opcode_error);
                     return false;
                 }
-                
+
                 // The semantics of Alloca are:
                 //   Create a region R of virtual memory of type T, backed by a data buffer
-                //   Create a region P of virtual memory of type T*, backed by a data buffer
-                //   Write the virtual address of R into P
-                
-                Type *T = alloca_inst->getAllocatedType();
-                Type *Tptr = alloca_inst->getType();
-                
-                lldb::addr_t R = frame.Malloc(T);
-                
+                //   Make the value of the instruction the virtual address of R
+
+                lldb::addr_t R = frame.Malloc(decoded.alloc_size, decoded.alloc_align);
+
                 if (R == LLDB_INVALID_ADDRESS)
                 {
                     if (log)
@@ -752,150 +916,99 @@ IRInterpreter::Interpret (llvm::Module &module,
                     error.SetErrorString(memory_allocation_error);
                     return false;
                 }
-                
-                lldb::addr_t P = frame.Malloc(Tptr);
-                
-                if (P == LLDB_INVALID_ADDRESS)
-                {
-                    if (log)
-                        log->Printf("Couldn't allocate the result pointer for an AllocaInst");
-                    error.SetErrorToGenericError();
-                    error.SetErrorString(memory_allocation_error);
-                    return false;
-                }
-                
-                lldb_private::Error write_error;
-                
-                memory_map.WritePointerToMemory(P, R, write_error);
-                
-                if (!write_error.Success())
+
+                if (!frame.AssignSlot(decoded.result, lldb_private::Scalar(R)))
                 {
                     if (log)
                         log->Printf("Couldn't write the result pointer for an AllocaInst");
                     error.SetErrorToGenericError();
                     error.SetErrorString(memory_write_error);
-                    lldb_private::Error free_error;
-                    memory_map.Free(P, free_error);
-                    memory_map.Free(R, free_error);
                     return false;
                 }
-                
-                frame.m_values[alloca_inst] = P;
-                
+
                 if (log)
                 {
                     log->Printf("Interpreted an AllocaInst");
                     log->Printf("  R : 0x%" PRIx64, R);
-                    log->Printf("  P : 0x%" PRIx64, P);
                 }
             }
                 break;
             case Instruction::BitCast:
             case Instruction::ZExt:
+            case Instruction::IntToPtr:
+            case Instruction::PtrToInt:
             {
-                const CastInst *cast_inst = dyn_cast<CastInst>(inst);
-                
-                if (!cast_inst)
-                {
-                    if (log)
-                        log->Printf("getOpcode() returns %s, but instruction is not a BitCastInst", cast_inst->getOpcodeName());
-                    error.SetErrorToGenericError();
-                    error.SetErrorString(interpreter_internal_error);
-                    return false;
-                }
-                
-                Value *source = cast_inst->getOperand(0);
-                
                 lldb_private::Scalar S;
-                
-                if (!frame.EvaluateValue(S, source, module))
+
+                if (!frame.EvaluateSlot(S, decoded.operands[0]))
                 {
                     if (log)
-                        log->Printf("Couldn't evaluate %s", PrintValue(source).c_str());
+                        log->Printf("Couldn't evaluate %s", PrintValue(inst->getOperand(0)).c_str());
                     error.SetErrorToGenericError();
                     error.SetErrorString(bad_value_error);
                     return false;
                 }
-                
-                frame.AssignValue(inst, S, module);
+
+                frame.AssignSlot(decoded.result, S);
+
+                if (log)
+                {
+                    log->Printf("Interpreted a %s", inst->getOpcodeName());
+                    log->Printf("  Src : %s", frame.SummarizeValue(decoded.operands[0]).c_str());
+                    log->Printf("  =   : %s", frame.SummarizeValue(decoded.result).c_str());
+                }
             }
                 break;
             case Instruction::SExt:
             {
-                const CastInst *cast_inst = dyn_cast<CastInst>(inst);
-                
-                if (!cast_inst)
-                {
-                    if (log)
-                        log->Printf("getOpcode() returns %s, but instruction is not a BitCastInst", cast_inst->getOpcodeName());
-                    error.SetErrorToGenericError();
-                    error.SetErrorString(interpreter_internal_error);
-                    return false;
-                }
-                
-                Value *source = cast_inst->getOperand(0);
-                
                 lldb_private::Scalar S;
-                
-                if (!frame.EvaluateValue(S, source, module))
+
+                if (!frame.EvaluateSlot(S, decoded.operands[0]))
                 {
                     if (log)
-                        log->Printf("Couldn't evaluate %s", PrintValue(source).c_str());
+                        log->Printf("Couldn't evaluate %s", PrintValue(inst->getOperand(0)).c_str());
                     error.SetErrorToGenericError();
                     error.SetErrorString(bad_value_error);
                     return false;
                 }
-                
-                S.MakeSigned();
-                
-                lldb_private::Scalar S_signextend(S.SLongLong());
-                
-                frame.AssignValue(inst, S_signextend, module);
+
+                lldb_private::Scalar S_signextend((long long)InterpreterStackFrame::SignExtend(S.GetRawBits64(0), decoded.src_bit_width));
+
+                frame.AssignSlot(decoded.result, S_signextend);
             }
                 break;
             case Instruction::Br:
             {
-                const BranchInst *br_inst = dyn_cast<BranchInst>(inst);
-                
-                if (!br_inst)
-                {
-                    if (log)
-                        log->Printf("getOpcode() returns Br, but instruction is not a BranchInst");
-                    error.SetErrorToGenericError();
-                    error.SetErrorString(interpreter_internal_error);
-                    return false;
-                }
-                
+                const BranchInst *br_inst = cast<BranchInst>(inst);
+
                 if (br_inst->isConditional())
                 {
-                    Value *condition = br_inst->getCondition();
-                    
                     lldb_private::Scalar C;
-                    
-                    if (!frame.EvaluateValue(C, condition, module))
+
+                    if (!frame.EvaluateSlot(C, decoded.operands[0]))
                     {
                         if (log)
-                            log->Printf("Couldn't evaluate %s", PrintValue(condition).c_str());
+                            log->Printf("Couldn't evaluate %s", PrintValue(br_inst->getCondition()).c_str());
                         error.SetErrorToGenericError();
                         error.SetErrorString(bad_value_error);
                         return false;
                     }
-                    
+
                     if (C.GetRawBits64(0))
-                        frame.Jump(br_inst->getSuccessor(0));
+                        pc = decoded.targets[0];
                     else
-                        frame.Jump(br_inst->getSuccessor(1));
-                    
+                        pc = decoded.targets[1];
+
                     if (log)
                     {
                         log->Printf("Interpreted a BrInst with a condition");
-                        log->Printf("  cond : %s", frame.SummarizeValue(condition).c_str());
+                        log->Printf("  cond : %s", frame.SummarizeValue(decoded.operands[0]).c_str());
                     }
                 }
                 else
                 {
-                    frame.Jump(br_inst->getSuccessor(0));
-                    
+                    pc = decoded.targets[0];
+
                     if (log)
                     {
                         log->Printf("Interpreted a BrInst with no condition");
@@ -905,122 +1018,78 @@ IRInterpreter::Interpret (llvm::Module &module,
                 continue;
             case Instruction::GetElementPtr:
             {
-                const GetElementPtrInst *gep_inst = dyn_cast<GetElementPtrInst>(inst);
-                
-                if (!gep_inst)
-                {
-                    if (log)
-                        log->Printf("getOpcode() returns GetElementPtr, but instruction is not a GetElementPtrInst");
-                    error.SetErrorToGenericError();
-                    error.SetErrorString(interpreter_internal_error);
-                    return false;
-                }
-                
-                const Value *pointer_operand = gep_inst->getPointerOperand();
-                Type *pointer_type = pointer_operand->getType();
-                
                 lldb_private::Scalar P;
-                
-                if (!frame.EvaluateValue(P, pointer_operand, module))
+
+                if (!frame.EvaluateSlot(P, decoded.operands[0]))
                 {
                     if (log)
-                        log->Printf("Couldn't evaluate %s", PrintValue(pointer_operand).c_str());
+                        log->Printf("Couldn't evaluate %s", PrintValue(cast<GetElementPtrInst>(inst)->getPointerOperand()).c_str());
                     error.SetErrorToGenericError();
                     error.SetErrorString(bad_value_error);
                     return false;
                 }
-                
-                typedef SmallVector <Value *, 8> IndexVector;
-                typedef IndexVector::iterator IndexIterator;
-                
-                SmallVector <Value *, 8> indices (gep_inst->idx_begin(),
-                                                  gep_inst->idx_end());
-                
-                SmallVector <Value *, 8> const_indices;
-                
-                for (IndexIterator ii = indices.begin(), ie = indices.end();
-                     ii != ie;
-                     ++ii)
+
+                int64_t offset = decoded.gep_offset;
+
+                for (size_t ti = 0, te = decoded.gep_terms.size(); ti < te; ++ti)
                 {
-                    ConstantInt *constant_index = dyn_cast<ConstantInt>(*ii);
-                    
-                    if (!constant_index)
+                    const InterpreterStackFrame::IndexTerm &term = decoded.gep_terms[ti];
+
+                    lldb_private::Scalar I;
+
+                    if (!frame.EvaluateSlot(I, term.slot))
                     {
-                        lldb_private::Scalar I;
-                        
-                        if (!frame.EvaluateValue(I, *ii, module))
-                        {
-                            if (log)
-                                log->Printf("Couldn't evaluate %s", PrintValue(*ii).c_str());
-                            error.SetErrorToGenericError();
-                            error.SetErrorString(bad_value_error);
-                            return false;
-                        }
-                        
                         if (log)
-                            log->Printf("Evaluated constant index %s as %llu", PrintValue(*ii).c_str(), I.ULongLong(LLDB_INVALID_ADDRESS));
-                        
-                        constant_index = cast<ConstantInt>(ConstantInt::get((*ii)->getType(), I.ULongLong(LLDB_INVALID_ADDRESS)));
+                            log->Printf("Couldn't evaluate %s", frame.SummarizeValue(term.slot).c_str());
+                        error.SetErrorToGenericError();
+                        error.SetErrorString(bad_value_error);
+                        return false;
                     }
-                    
-                    const_indices.push_back(constant_index);
+
+                    offset += InterpreterStackFrame::SignExtend(I.GetRawBits64(0), term.bit_width) * term.scale;
                 }
-                
-                uint64_t offset = data_layout.getIndexedOffset(pointer_type, const_indices);
-                
-                lldb_private::Scalar Poffset = P + offset;
-                
-                frame.AssignValue(inst, Poffset, module);
-                
+
+                lldb_private::Scalar Poffset = P + (uint64_t)offset;
+
+                frame.AssignSlot(decoded.result, Poffset);
+
                 if (log)
                 {
                     log->Printf("Interpreted a GetElementPtrInst");
-                    log->Printf("  P       : %s", frame.SummarizeValue(pointer_operand).c_str());
-                    log->Printf("  Poffset : %s", frame.SummarizeValue(inst).c_str());
+                    log->Printf("  P       : %s", frame.SummarizeValue(decoded.operands[0]).c_str());
+                    log->Printf("  Poffset : %s", frame.SummarizeValue(decoded.result).c_str());
                 }
             }
                 break;
             case Instruction::ICmp:
             {
-                const ICmpInst *icmp_inst = dyn_cast<ICmpInst>(inst);
-                
-                if (!icmp_inst)
-                {
-                    if (log)
-                        log->Printf("getOpcode() returns ICmp, but instruction is not an ICmpInst");
-                    error.SetErrorToGenericError();
-                    error.SetErrorString(interpreter_internal_error);
-                    return false;
-                }
-                
+                const ICmpInst *icmp_inst = cast<ICmpInst>(inst);
+
                 CmpInst::Predicate predicate = icmp_inst->getPredicate();
-                
-                Value *lhs = inst->getOperand(0);
-                Value *rhs = inst->getOperand(1);
-                
+
                 lldb_private::Scalar L;
                 lldb_private::Scalar R;
-                
-                if (!frame.EvaluateValue(L, lhs, module))
+
+                if (!frame.EvaluateSlot(L, decoded.operands[0]))
                 {
                     if (log)
-                        log->Printf("Couldn't evaluate %s", PrintValue(lhs).c_str());
+                        log->Printf("Couldn't evaluate %s", PrintValue(inst->getOperand(0)).c_str());
                     error.SetErrorToGenericError();
                     error.SetErrorString(bad_value_error);
                     return false;
                 }
-                
-                if (!frame.EvaluateValue(R, rhs, module))
+
+                if (!frame.EvaluateSlot(R, decoded.operands[1]))
                 {
                     if (log)
-                        log->Printf("Couldn't evaluate %s", PrintValue(rhs).c_str());
+                        log->Printf("Couldn't evaluate %s", PrintValue(inst->getOperand(1)).c_str());
                     error.SetErrorToGenericError();
                     error.SetErrorString(bad_value_error);
                     return false;
                 }
-                
+
                 lldb_private::Scalar result;
-                
+
                 switch (predicate)
                 {
                     default:
@@ -1064,127 +1133,27 @@ IRInterpreter::Interpret (llvm::Module &module,
                         result = (L <= R);
                         break;
                 }
-                
-                frame.AssignValue(inst, result, module);
-                
+
+                frame.AssignSlot(decoded.result, result);
+
                 if (log)
                 {
                     log->Printf("Interpreted an ICmpInst");
-                    log->Printf("  L : %s", frame.SummarizeValue(lhs).c_str());
-                    log->Printf("  R : %s", frame.SummarizeValue(rhs).c_str());
-                    log->Printf("  = : %s", frame.SummarizeValue(inst).c_str());
-                }
-            }
-                break;
-            case Instruction::IntToPtr:
-            {
-                const IntToPtrInst *int_to_ptr_inst = dyn_cast<IntToPtrInst>(inst);
-                
-                if (!int_to_ptr_inst)
-                {
-                    if (log)
-                        log->Printf("getOpcode() returns IntToPtr, but instruction is not an IntToPtrInst");
-                    error.SetErrorToGenericError();
-                    error.SetErrorString(interpreter_internal_error);
-                    return false;
-                }
-                
-                Value *src_operand = int_to_ptr_inst->getOperand(0);
-                
-                lldb_private::Scalar I;
-                
-                if (!frame.EvaluateValue(I, src_operand, module))
-                {
-                    if (log)
-                        log->Printf("Couldn't evaluate %s", PrintValue(src_operand).c_str());
-                    error.SetErrorToGenericError();
-                    error.SetErrorString(bad_value_error);
-                    return false;
-                }
-                
-                frame.AssignValue(inst, I, module);
-                
-                if (log)
-                {
-                    log->Printf("Interpreted an IntToPtr");
-                    log->Printf("  Src : %s", frame.SummarizeValue(src_operand).c_str());
-                    log->Printf("  =   : %s", frame.SummarizeValue(inst).c_str());
-                }
-            }
-                break;
-            case Instruction::PtrToInt:
-            {
-                const PtrToIntInst *ptr_to_int_inst = dyn_cast<PtrToIntInst>(inst);
-                
-                if (!ptr_to_int_inst)
-                {
-                    if (log)
-                        log->Printf("getOpcode() returns PtrToInt, but instruction is not an PtrToIntInst");
-                    error.SetErrorToGenericError();
-                    error.SetErrorString(interpreter_internal_error);
-                    return false;
-                }
-                
-                Value *src_operand = ptr_to_int_inst->getOperand(0);
-                
-                lldb_private::Scalar I;
-                
-                if (!frame.EvaluateValue(I, src_operand, module))
-                {
-                    if (log)
-                        log->Printf("Couldn't evaluate %s", PrintValue(src_operand).c_str());
-                    error.SetErrorToGenericError();
-                    error.SetErrorString(bad_value_error);
-                    return false;
-                }
-                
-                frame.AssignValue(inst, I, module);
-                
-                if (log)
-                {
-                    log->Printf("Interpreted a PtrToInt");
-                    log->Printf("  Src : %s", frame.SummarizeValue(src_operand).c_str());
-                    log->Printf("  =   : %s", frame.SummarizeValue(inst).c_str());
+                    log->Printf("  L : %s", frame.SummarizeValue(decoded.operands[0]).c_str());
+                    log->Printf("  R : %s", frame.SummarizeValue(decoded.operands[1]).c_str());
+                    log->Printf("  = : %s", frame.SummarizeValue(decoded.result).c_str());
                 }
             }
                 break;
             case Instruction::Load:
             {
-                const LoadInst *load_inst = dyn_cast<LoadInst>(inst);
-                
-                if (!load_inst)
-                {
-                    if (log)
-                        log->Printf("getOpcode() returns Load, but instruction is not a LoadInst");
-                    error.SetErrorToGenericError();
-                    error.SetErrorString(interpreter_internal_error);
-                    return false;
-                }
-                
                 // The semantics of Load are:
-                //   Create a region D that will contain the loaded data
-                //   Resolve the region P containing a pointer
-                //   Dereference P to get the region R that the data should be loaded from
-                //   Transfer a unit of type type(D) from R to D
-                
-                const Value *pointer_operand = load_inst->getPointerOperand();
-                
-                Type *pointer_ty = pointer_operand->getType();
-                PointerType *pointer_ptr_ty = dyn_cast<PointerType>(pointer_ty);
-                if (!pointer_ptr_ty)
-                {
-                    if (log)
-                        log->Printf("getPointerOperand()->getType() is not a PointerType");
-                    error.SetErrorToGenericError();
-                    error.SetErrorString(interpreter_internal_error);
-                    return false;
-                }
-                Type *target_ty = pointer_ptr_ty->getElementType();
-                
-                lldb::addr_t D = frame.ResolveValue(load_inst, module);
-                lldb::addr_t P = frame.ResolveValue(pointer_operand, module);
-                
-                if (D == LLDB_INVALID_ADDRESS)
+                //   Evaluate the pointer operand to get the region R that the data should be loaded from
+                //   Transfer a unit of the instruction's type from R to the instruction's slot
+
+                lldb_private::Scalar P;
+
+                if (decoded.result == InterpreterStackFrame::kInvalidSlot)
                 {
                     if (log)
                         log->Printf("LoadInst's value doesn't resolve to anything");
@@ -1192,8 +1161,8 @@ IRInterpreter::Interpret (llvm::Module &module,
                     error.SetErrorString(bad_value_error);
                     return false;
                 }
-                
-                if (P == LLDB_INVALID_ADDRESS)
+
+                if (!frame.EvaluateSlot(P, decoded.operands[0]))
                 {
                     if (log)
                         log->Printf("LoadInst's pointer doesn't resolve to anything");
@@ -1201,25 +1170,11 @@ IRInterpreter::Interpret (llvm::Module &module,
                     error.SetErrorString(bad_value_error);
                     return false;
                 }
-                
-                lldb::addr_t R;
+
+                lldb::addr_t R = P.GetRawBits64(LLDB_INVALID_ADDRESS);
+
                 lldb_private::Error read_error;
-                memory_map.ReadPointerFromMemory(&R, P, read_error);
-                
-                if (!read_error.Success())
-                {
-                    if (log)
-                        log->Printf("Couldn't read the address to be loaded for a LoadInst");
-                    error.SetErrorToGenericError();
-                    error.SetErrorString(memory_read_error);
-                    return false;
-                }
-                
-                size_t target_size = data_layout.getTypeStoreSize(target_ty);
-                lldb_private::DataBufferHeap buffer(target_size, 0);
-                
-                read_error.Clear();
-                memory_map.ReadMemory(buffer.GetBytes(), R, buffer.GetByteSize(), read_error);
+                memory_map.ReadMemory(frame.GetSlotBytes(decoded.result), R, frame.m_slots[decoded.result].byte_size, read_error);
                 if (!read_error.Success())
                 {
                     if (log)
@@ -1228,24 +1183,12 @@ IRInterpreter::Interpret (llvm::Module &module,
                     error.SetErrorString(memory_read_error);
                     return false;
                 }
-                
-                lldb_private::Error write_error;
-                memory_map.WriteMemory(D, buffer.GetBytes(), buffer.GetByteSize(), write_error);
-                if (!write_error.Success())
-                {
-                    if (log)
-                        log->Printf("Couldn't write to a region on behalf of a LoadInst");
-                    error.SetErrorToGenericError();
-                    error.SetErrorString(memory_read_error);
-                    return false;
-                }
-                
+
                 if (log)
                 {
                     log->Printf("Interpreted a LoadInst");
-                    log->Printf("  P : 0x%" PRIx64, P);
                     log->Printf("  R : 0x%" PRIx64, R);
-                    log->Printf("  D : 0x%" PRIx64, D);
+                    log->Printf("  = : %s", frame.SummarizeValue(decoded.result).c_str());
                 }
             }
                 break;
@@ -1255,36 +1198,13 @@ IRInterpreter::Interpret (llvm::Module &module,
             }
             case Instruction::Store:
             {
-                const StoreInst *store_inst = dyn_cast<StoreInst>(inst);
-                
-                if (!store_inst)
-                {
-                    if (log)
-                        log->Printf("getOpcode() returns Store, but instruction is not a StoreInst");
-                    error.SetErrorToGenericError();
-                    error.SetErrorString(interpreter_internal_error);
-                    return false;
-                }
-                
                 // The semantics of Store are:
-                //   Resolve the region D containing the data to be stored
-                //   Resolve the region P containing a pointer
-                //   Dereference P to get the region R that the data should be stored in
-                //   Transfer a unit of type type(D) from D to R
-                
-                const Value *value_operand = store_inst->getValueOperand();
-                const Value *pointer_operand = store_inst->getPointerOperand();
-                
-                Type *pointer_ty = pointer_operand->getType();
-                PointerType *pointer_ptr_ty = dyn_cast<PointerType>(pointer_ty);
-                if (!pointer_ptr_ty)
-                    return false;
-                Type *target_ty = pointer_ptr_ty->getElementType();
-                
-                lldb::addr_t D = frame.ResolveValue(value_operand, module);
-                lldb::addr_t P = frame.ResolveValue(pointer_operand, module);
-                
-                if (D == LLDB_INVALID_ADDRESS)
+                //   Evaluate the pointer operand to get the region R that the data should be stored in
+                //   Transfer a unit of the value operand's type from its slot to R
+
+                const uint32_t D = decoded.operands[0];
+
+                if (!frame.m_slots[D].valid)
                 {
                     if (log)
                         log->Printf("StoreInst's value doesn't resolve to anything");
@@ -1292,8 +1212,10 @@ IRInterpreter::Interpret (llvm::Module &module,
                     error.SetErrorString(bad_value_error);
                     return false;
                 }
-                
-                if (P == LLDB_INVALID_ADDRESS)
+
+                lldb_private::Scalar P;
+
+                if (!frame.EvaluateSlot(P, decoded.operands[1]))
                 {
                     if (log)
                         log->Printf("StoreInst's pointer doesn't resolve to anything");
@@ -1301,36 +1223,11 @@ IRInterpreter::Interpret (llvm::Module &module,
                     error.SetErrorString(bad_value_error);
                     return false;
                 }
-                
-                lldb::addr_t R;
-                lldb_private::Error read_error;
-                memory_map.ReadPointerFromMemory(&R, P, read_error);
-                
-                if (!read_error.Success())
-                {
-                    if (log)
-                        log->Printf("Couldn't read the address to be loaded for a LoadInst");
-                    error.SetErrorToGenericError();
-                    error.SetErrorString(memory_read_error);
-                    return false;
-                }
-                
-                size_t target_size = data_layout.getTypeStoreSize(target_ty);
-                lldb_private::DataBufferHeap buffer(target_size, 0);
-                
-                read_error.Clear();
-                memory_map.ReadMemory(buffer.GetBytes(), D, buffer.GetByteSize(), read_error);
-                if (!read_error.Success())
-                {
-                    if (log)
-                        log->Printf("Couldn't read from a region on behalf of a StoreInst");
-                    error.SetErrorToGenericError();
-                    error.SetErrorString(memory_read_error);
-                    return false;
-                }
-                
+
+                lldb::addr_t R = P.GetRawBits64(LLDB_INVALID_ADDRESS);
+
                 lldb_private::Error write_error;
-                memory_map.WriteMemory(R, buffer.GetBytes(), buffer.GetByteSize(), write_error);
+                memory_map.WriteMemory(R, frame.GetSlotBytes(D), frame.m_slots[D].byte_size, write_error);
                 if (!write_error.Success())
                 {
                     if (log)
@@ -1339,27 +1236,26 @@ IRInterpreter::Interpret (llvm::Module &module,
                     error.SetErrorString(memory_write_error);
                     return false;
                 }
-                
+
                 if (log)
                 {
                     log->Printf("Interpreted a StoreInst");
-                    log->Printf("  D : 0x%" PRIx64, D);
-                    log->Printf("  P : 0x%" PRIx64, P);
+                    log->Printf("  D : %s", frame.SummarizeValue(D).c_str());
                     log->Printf("  R : 0x%" PRIx64, R);
                 }
             }
                 break;
         }
-        
-        ++frame.m_ii;
+
+        ++pc;
     }
-    
+
     if (num_insts >= 4096)
     {
         error.SetErrorToGenericError();
         error.SetErrorString(infinite_loop_error);
         return false;
     }
-    
+
     return false;
 }
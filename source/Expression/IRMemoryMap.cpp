@@ -43,6 +43,11 @@ IRMemoryMap::~IRMemoryMap ()
             else
                 Free(iter->first, err);
         }
+        
+        // The arenas are released as a whole.  Nothing carved from them can
+        // have been leaked.
+        for (ArenaVector::iterator pos = m_arenas.begin(), end = m_arenas.end(); pos != end; ++pos)
+            FreeRegion(pos->m_process_alloc, pos->m_policy);
     }
 }
 
@@ -169,6 +174,14 @@ IRMemoryMap::IntersectsAllocation (lldb::addr_t addr, size_t size)
         ++iter;
     }
     
+    // The unused parts of the arenas aren't in m_allocations but are taken
+    // all the same.
+    for (ArenaVector::const_iterator pos = m_arenas.begin(), end = m_arenas.end(); pos != end; ++pos)
+    {
+        if (pos->m_process_alloc < addr + size && pos->m_process_alloc + pos->m_size > addr)
+            return true;
+    }
+    
     return false;
 }
 
@@ -225,7 +238,8 @@ IRMemoryMap::Allocation::Allocation (lldb::addr_t process_alloc,
                                      size_t size,
                                      uint32_t permissions,
                                      uint8_t alignment,
-                                     AllocationPolicy policy)
+                                     AllocationPolicy policy,
+                                     uint32_t arena_index)
 {
     m_process_alloc = process_alloc;
     m_process_start = process_start;
@@ -233,6 +247,8 @@ IRMemoryMap::Allocation::Allocation (lldb::addr_t process_alloc,
     m_permissions = permissions;
     m_alignment = alignment;
     m_policy = policy;
+    m_leak = false;
+    m_arena_index = arena_index;
     
     switch (policy)
     {
@@ -251,8 +267,222 @@ IRMemoryMap::Allocation::Allocation (lldb::addr_t process_alloc,
     }
 }
 
+lldb::addr_t
+IRMemoryMap::AllocateRegion (size_t size, uint32_t permissions, AllocationPolicy policy, Error &error)
+{
+    lldb::ProcessSP process_sp;
+    
+    switch (policy)
+    {
+    default:
+        error.SetErrorToGenericError();
+        error.SetErrorString("Couldn't malloc: invalid allocation policy");
+        return LLDB_INVALID_ADDRESS;
+    case eAllocationPolicyHostOnly:
+        return FindSpace(size);
+    case eAllocationPolicyMirror:
+    case eAllocationPolicyProcessOnly:
+        process_sp = m_process_wp.lock();
+        if (!process_sp || !process_sp->CanJIT())
+        {
+            error.SetErrorToGenericError();
+            error.SetErrorString("Couldn't malloc: process doesn't support allocating memory");
+            return LLDB_INVALID_ADDRESS;
+        }
+        return process_sp->AllocateMemory(size, permissions, error);
+    }
+}
+
+void
+IRMemoryMap::FreeRegion (lldb::addr_t process_alloc, AllocationPolicy policy)
+{
+    lldb::ProcessSP process_sp = m_process_wp.lock();
+    
+    if (!process_sp)
+        return;
+    
+    switch (policy)
+    {
+    default:
+    case eAllocationPolicyHostOnly:
+        if (process_sp->CanJIT())
+            process_sp->DeallocateMemory(process_alloc); // FindSpace allocated this for real
+        else
+            process_sp->GetReservationCache().Unreserve(process_alloc); // FindSpace registered this memory
+        break;
+    case eAllocationPolicyMirror:
+    case eAllocationPolicyProcessOnly:
+        process_sp->DeallocateMemory(process_alloc);
+        break;
+    }
+}
+
+lldb::addr_t
+IRMemoryMap::MallocFromArena (size_t size, uint8_t alignment, uint32_t permissions, AllocationPolicy policy)
+{
+    lldb::ProcessSP process_sp = m_process_wp.lock();
+    
+    // Resolve the policy the same way Malloc does; allocations that would
+    // fail there are left for Malloc to report.
+    switch (policy)
+    {
+    default:
+        return LLDB_INVALID_ADDRESS;
+    case eAllocationPolicyHostOnly:
+        break;
+    case eAllocationPolicyMirror:
+        if (!process_sp || !process_sp->CanJIT())
+            policy = eAllocationPolicyHostOnly;
+        break;
+    case eAllocationPolicyProcessOnly:
+        if (!process_sp || !process_sp->CanJIT())
+            return LLDB_INVALID_ADDRESS;
+        break;
+    }
+    
+    const lldb::addr_t mask = alignment - 1;
+    
+    // Reuse a freed block first, as long as it doesn't waste more than half
+    // of itself.
+    for (uint32_t arena_index = 0, num_arenas = m_arenas.size(); arena_index < num_arenas; ++arena_index)
+    {
+        Arena &arena = m_arenas[arena_index];
+        
+        if (arena.m_policy != policy || arena.m_permissions != permissions)
+            continue;
+        
+        for (FreeBlockMap::iterator pos = arena.m_free_blocks.lower_bound(size), end = arena.m_free_blocks.end();
+             pos != end && pos->first <= 2 * size;
+             ++pos)
+        {
+            const lldb::addr_t block_start = pos->second;
+            const size_t block_size = pos->first;
+            
+            if (block_start & mask)
+                continue;
+            
+            arena.m_free_blocks.erase(pos);
+            ++arena.m_num_live;
+            
+            m_allocations[block_start] = Allocation(block_start,
+                                                    block_start,
+                                                    block_size,
+                                                    permissions,
+                                                    alignment,
+                                                    policy,
+                                                    arena_index);
+            return block_start;
+        }
+    }
+    
+    // Then bump allocate from an arena with room left, reserving a new
+    // region if there is none.
+    uint32_t arena_index = 0;
+    lldb::addr_t aligned_address = LLDB_INVALID_ADDRESS;
+    
+    for (uint32_t num_arenas = m_arenas.size(); arena_index < num_arenas; ++arena_index)
+    {
+        const Arena &arena = m_arenas[arena_index];
+        
+        if (arena.m_policy != policy || arena.m_permissions != permissions)
+            continue;
+        
+        lldb::addr_t candidate = (arena.m_process_alloc + arena.m_used + mask) & (~mask);
+        
+        if (candidate + size <= arena.m_process_alloc + arena.m_size)
+        {
+            aligned_address = candidate;
+            break;
+        }
+    }
+    
+    if (aligned_address == LLDB_INVALID_ADDRESS)
+    {
+        Error region_error;
+        
+        lldb::addr_t region = AllocateRegion(kArenaRegionSize, permissions, policy, region_error);
+        
+        if (region == LLDB_INVALID_ADDRESS || !region_error.Success())
+            return LLDB_INVALID_ADDRESS;
+        
+        Arena arena;
+        arena.m_process_alloc = region;
+        arena.m_size = kArenaRegionSize;
+        arena.m_used = 0;
+        arena.m_permissions = permissions;
+        arena.m_policy = policy;
+        arena.m_num_live = 0;
+        
+        arena_index = m_arenas.size();
+        m_arenas.push_back(arena);
+        
+        aligned_address = (region + mask) & (~mask);
+        
+        if (lldb_private::Log *log = lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_EXPRESSIONS))
+            log->Printf("IRMemoryMap::MallocFromArena reserved arena %u at [0x%" PRIx64 "..0x%" PRIx64 ")",
+                        arena_index,
+                        region,
+                        region + kArenaRegionSize);
+    }
+    
+    Arena &arena = m_arenas[arena_index];
+    
+    arena.m_used = aligned_address + size - arena.m_process_alloc;
+    ++arena.m_num_live;
+    
+    m_allocations[aligned_address] = Allocation(aligned_address,
+                                                aligned_address,
+                                                size,
+                                                permissions,
+                                                alignment,
+                                                policy,
+                                                arena_index);
+    return aligned_address;
+}
+
+void
+IRMemoryMap::FreeToArena (Allocation &allocation)
+{
+    Arena &arena = m_arenas[allocation.m_arena_index];
+    
+    if (arena.m_num_live > 0)
+        --arena.m_num_live;
+    
+    // Once everything carved from the arena is gone the whole region can be
+    // handed out again.
+    if (arena.m_num_live == 0)
+    {
+        arena.m_used = 0;
+        arena.m_free_blocks.clear();
+    }
+    else
+    {
+        arena.m_free_blocks.insert(FreeBlockMap::value_type(allocation.m_size, allocation.m_process_start));
+    }
+}
+
 lldb::addr_t
 IRMemoryMap::Malloc (size_t size, uint8_t alignment, uint32_t permissions, AllocationPolicy policy, Error &error)
+{
+    return DoMalloc(size, alignment, permissions, policy, true, error);
+}
+
+lldb::addr_t
+IRMemoryMap::MallocLeaked (size_t size, uint8_t alignment, uint32_t permissions, AllocationPolicy policy, Error &error)
+{
+    // Leaked memory outlives the map, so it gets a region of its own
+    // rather than pinning an arena that would otherwise be released with
+    // the map.  The process still packs small allocations into pages.
+    lldb::addr_t process_address = DoMalloc(size, alignment, permissions, policy, false, error);
+    
+    if (process_address != LLDB_INVALID_ADDRESS)
+        m_allocations[process_address].m_leak = true;
+    
+    return process_address;
+}
+
+lldb::addr_t
+IRMemoryMap::DoMalloc (size_t size, uint8_t alignment, uint32_t permissions, AllocationPolicy policy, bool use_arena, Error &error)
 {
     error.Clear();
     
@@ -268,6 +498,26 @@ IRMemoryMap::Malloc (size_t size, uint8_t alignment, uint32_t permissions, Alloc
     else
         allocation_size = (size & alignment_mask) ? ((size + alignment) & (~alignment_mask)) : size;
     
+    if (use_arena && allocation_size <= kArenaMaxAllocationSize)
+    {
+        aligned_address = MallocFromArena(allocation_size, alignment, permissions, policy);
+        
+        if (aligned_address != LLDB_INVALID_ADDRESS)
+        {
+            if (lldb_private::Log *log = lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_EXPRESSIONS))
+            {
+                log->Printf("IRMemoryMap::Malloc (%" PRIu64 ", 0x%" PRIx64 ", 0x%" PRIx64 ") -> 0x%" PRIx64 " from arena %u",
+                            (uint64_t)allocation_size,
+                            (uint64_t)alignment,
+                            (uint64_t)permissions,
+                            aligned_address,
+                            m_allocations[aligned_address].m_arena_index);
+            }
+            
+            return aligned_address;
+        }
+    }
+    
     switch (policy)
     {
     default:
@@ -386,6 +636,16 @@ IRMemoryMap::Leak (lldb::addr_t process_address, Error &error)
     }
     
     Allocation &allocation = iter->second;
+    
+    // The arena goes away with the map, and leaking the block must not keep
+    // the rest of it alive.  Memory that outlives the map comes from
+    // MallocLeaked().
+    if (allocation.m_arena_index != UINT32_MAX)
+    {
+        error.SetErrorToGenericError();
+        error.SetErrorString("Couldn't leak: allocation is part of an arena that is released with the map");
+        return;
+    }
 
     allocation.m_leak = true;
 }
@@ -405,31 +665,11 @@ IRMemoryMap::Free (lldb::addr_t process_address, Error &error)
     }
     
     Allocation &allocation = iter->second;
-        
-    switch (allocation.m_policy)
-    {
-    default:
-    case eAllocationPolicyHostOnly:
-        {
-            lldb::ProcessSP process_sp = m_process_wp.lock();
-            if (process_sp)
-            {
-                if (process_sp->CanJIT())
-                    process_sp->DeallocateMemory(allocation.m_process_alloc); // FindSpace allocated this for real
-                else
-                    process_sp->GetReservationCache().Unreserve(allocation.m_process_alloc); // FindSpace registered this memory
-            }
     
-            break;
-        }
-    case eAllocationPolicyMirror:
-    case eAllocationPolicyProcessOnly:
-        {
-            lldb::ProcessSP process_sp = m_process_wp.lock();
-            if (process_sp)
-                process_sp->DeallocateMemory(allocation.m_process_alloc);
-        }
-    }
+    if (allocation.m_arena_index != UINT32_MAX)
+        FreeToArena(allocation);
+    else
+        FreeRegion(allocation.m_process_alloc, allocation.m_policy);
     
     if (lldb_private::Log *log = lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_EXPRESSIONS))
     {        
@@ -78,14 +78,27 @@ public:
         Log *log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_EXPRESSIONS));
 
         // Allocate a spare memory area to store the persistent variable's contents.
+        // Variables that are kept in the target outlive the map, so they are
+        // leaked right away.
+        
+        const bool keep_in_target = (m_persistent_variable_sp->m_flags & ClangExpressionVariable::EVKeepInTarget) != 0;
         
         Error allocate_error;
         
-        lldb::addr_t mem = map.Malloc(m_persistent_variable_sp->GetByteSize(),
-                                      8,
-                                      lldb::ePermissionsReadable | lldb::ePermissionsWritable,
-                                      IRMemoryMap::eAllocationPolicyMirror,
-                                      allocate_error);
+        lldb::addr_t mem;
+        
+        if (keep_in_target)
+            mem = map.MallocLeaked(m_persistent_variable_sp->GetByteSize(),
+                                   8,
+                                   lldb::ePermissionsReadable | lldb::ePermissionsWritable,
+                                   IRMemoryMap::eAllocationPolicyMirror,
+                                   allocate_error);
+        else
+            mem = map.Malloc(m_persistent_variable_sp->GetByteSize(),
+                             8,
+                             lldb::ePermissionsReadable | lldb::ePermissionsWritable,
+                             IRMemoryMap::eAllocationPolicyMirror,
+                             allocate_error);
         
         if (!allocate_error.Success())
         {
@@ -108,12 +121,8 @@ public:
         
         // Clear the flag if the variable will never be deallocated.
         
-        if (m_persistent_variable_sp->m_flags & ClangExpressionVariable::EVKeepInTarget)
-        {
-            Error leak_error;
-            map.Leak(mem, leak_error);
+        if (keep_in_target)
             m_persistent_variable_sp->m_flags &= ~ClangExpressionVariable::EVNeedsAllocation;
-        }
         
         // Write the contents of the variable to the area.
         
@@ -63,6 +63,15 @@ public:
     virtual bool
     DoesBranch ()
     {
+        lldb::addr_t file_addr = LLDB_INVALID_ADDRESS;
+        ConstString triple;
+        ModuleSP module_sp;
+        if (m_does_branch == eLazyBoolCalculate)
+        {
+            module_sp = GetCacheModule (file_addr, triple);
+            if (module_sp)
+                m_does_branch = module_sp->GetDecodedInstructionCache().GetDoesBranch (file_addr, triple, m_opcode);
+        }
         if (m_does_branch == eLazyBoolCalculate)
         {
             GetDisassemblerLLVMC().Lock(this, NULL);
@@ -93,26 +102,51 @@ public:
                 }
             }
             GetDisassemblerLLVMC().Unlock();
+            if (module_sp && m_does_branch != eLazyBoolCalculate)
+                module_sp->GetDecodedInstructionCache().SetDoesBranch (file_addr, triple, m_opcode, m_does_branch == eLazyBoolYes);
         }
         return m_does_branch == eLazyBoolYes;
     }
     
+    // Get the module we are in if what we work out about ourselves can be
+    // kept in its DecodedInstructionCache, along with our file address and
+    // the triple of the MC disassembler that decodes us
+    ModuleSP
+    GetCacheModule (lldb::addr_t &file_addr, ConstString &triple)
+    {
+        ModuleSP module_sp (m_address.GetModule());
+        file_addr = LLDB_INVALID_ADDRESS;
+        if (module_sp)
+        {
+            bool is_alternate_isa;
+            DisassemblerLLVMC::LLVMCDisassembler *mc_disasm_ptr = GetDisasmToUse (is_alternate_isa);
+            if (mc_disasm_ptr)
+            {
+                file_addr = m_address.GetFileAddress();
+                triple = mc_disasm_ptr->GetTriple();
+            }
+        }
+        if (file_addr == LLDB_INVALID_ADDRESS)
+            module_sp.reset();
+        return module_sp;
+    }
+    
     DisassemblerLLVMC::LLVMCDisassembler *
     GetDisasmToUse (bool &is_alternate_isa)
     {
         is_alternate_isa = false;
         DisassemblerLLVMC &llvm_disasm = GetDisassemblerLLVMC();
-        if (llvm_disasm.m_alternate_disasm_ap.get() != NULL)
+        if (llvm_disasm.m_alternate_disasm_sp.get() != NULL)
         {
             const AddressClass address_class = GetAddressClass ();
         
             if (address_class == eAddressClassCodeAlternateISA)
             {
                 is_alternate_isa = true;
-                return llvm_disasm.m_alternate_disasm_ap.get();
+                return llvm_disasm.m_alternate_disasm_sp.get();
             }
         }
-        return llvm_disasm.m_disasm_ap.get();
+        return llvm_disasm.m_disasm_sp.get();
     }
     
     virtual size_t
@@ -201,6 +235,17 @@ public:
                 const addr_t pc = m_address.GetFileAddress();
                 llvm::MCInst inst;
                 
+                // Code we have seen before at this address doesn't need to
+                // go through the MC disassembler again
+                lldb::addr_t file_addr = LLDB_INVALID_ADDRESS;
+                ConstString triple;
+                ModuleSP module_sp (GetCacheModule (file_addr, triple));
+                if (module_sp && module_sp->GetDecodedInstructionCache().GetOpcode (file_addr, triple, opcode_data, opcode_data_len, m_opcode))
+                {
+                    m_is_valid = true;
+                    return m_opcode.GetByteSize();
+                }
+                
                 llvm_disasm.Lock(this, NULL);
                 const size_t inst_size = mc_disasm_ptr->GetMCInst(opcode_data,
                                                                   opcode_data_len,
@@ -213,6 +258,8 @@ public:
                 {
                     m_opcode.SetOpcodeBytes(opcode_data, inst_size);
                     m_is_valid = true;
+                    if (module_sp)
+                        module_sp->GetDecodedInstructionCache().SetOpcode (file_addr, triple, m_opcode);
                 }
             }
         }
@@ -246,9 +293,9 @@ public:
             DisassemblerLLVMC::LLVMCDisassembler *mc_disasm_ptr;
             
             if (address_class == eAddressClassCodeAlternateISA)
-                mc_disasm_ptr = llvm_disasm.m_alternate_disasm_ap.get();
+                mc_disasm_ptr = llvm_disasm.m_alternate_disasm_sp.get();
             else
-                mc_disasm_ptr = llvm_disasm.m_disasm_ap.get();
+                mc_disasm_ptr = llvm_disasm.m_disasm_sp.get();
             
             lldb::addr_t pc = m_address.GetFileAddress();
             m_using_file_addr = true;
@@ -271,6 +318,24 @@ public:
                 }
             }
             
+            // Only strings made with an execution context have the symbol
+            // comments in them, so only those are cached
+            lldb::addr_t file_addr = LLDB_INVALID_ADDRESS;
+            ConstString triple;
+            ModuleSP module_sp;
+            if (exe_ctx && exe_ctx->GetTargetPtr())
+                module_sp = GetCacheModule (file_addr, triple);
+            const char *flavor = llvm_disasm.GetFlavor();
+            if (module_sp && module_sp->GetDecodedInstructionCache().GetStrings (file_addr,
+                                                                                 triple,
+                                                                                 m_opcode,
+                                                                                 pc,
+                                                                                 flavor,
+                                                                                 m_opcode_name,
+                                                                                 m_mnemonics,
+                                                                                 m_comment))
+                return;
+            
             llvm_disasm.Lock(this, exe_ctx);
             
             const uint8_t *opcode_data = data.GetDataStart();
@@ -373,6 +438,14 @@ public:
                 if (matches[2].rm_so != -1)
                     m_mnemonics.assign(out_string + matches[2].rm_so, matches[2].rm_eo - matches[2].rm_so);
             }
+            
+            if (module_sp)
+            {
+                DecodedInstructionCache &cache = module_sp->GetDecodedInstructionCache();
+                cache.SetStrings (file_addr, triple, m_opcode, pc, flavor, m_opcode_name, m_mnemonics, m_comment);
+                if (m_does_branch != eLazyBoolCalculate)
+                    cache.SetDoesBranch (file_addr, triple, m_opcode, m_does_branch == eLazyBoolYes);
+            }
         }
     }
     
@@ -412,7 +485,10 @@ protected:
 bool InstructionLLVMC::s_regex_compiled = false;
 ::regex_t InstructionLLVMC::s_regex;
 
-DisassemblerLLVMC::LLVMCDisassembler::LLVMCDisassembler (const char *triple, unsigned flavor, DisassemblerLLVMC &owner):
+DisassemblerLLVMC::LLVMCDisassembler::LLVMCDisassembler (const char *triple, unsigned flavor):
+    m_mutex(Mutex::eMutexTypeRecursive),
+    m_owner(NULL),
+    m_triple(triple),
     m_is_valid(true)
 {
     std::string Error;
@@ -444,11 +520,6 @@ DisassemblerLLVMC::LLVMCDisassembler::LLVMCDisassembler (const char *triple, uns
     m_disasm_ap.reset(curr_target->createMCDisassembler(*m_subtarget_info_ap.get()));
     if (m_disasm_ap.get())
     {
-        m_disasm_ap->setupForSymbolicDisassembly(NULL,
-                                                  DisassemblerLLVMC::SymbolLookupCallback,
-                                                  (void *) &owner,
-                                                  m_context_ap.get());
-        
         unsigned asm_printer_variant;
         if (flavor == ~0U)
             asm_printer_variant = m_asm_info_ap->getAssemblerDialect();
@@ -476,6 +547,19 @@ DisassemblerLLVMC::LLVMCDisassembler::~LLVMCDisassembler()
 {
 }
 
+void
+DisassemblerLLVMC::LLVMCDisassembler::SetOwner (DisassemblerLLVMC *owner)
+{
+    // The symbol lookup callback reports back to whoever is using us now
+    if (owner == m_owner || !m_disasm_ap.get())
+        return;
+    m_owner = owner;
+    m_disasm_ap->setupForSymbolicDisassembly(NULL,
+                                              DisassemblerLLVMC::SymbolLookupCallback,
+                                              (void *) owner,
+                                              m_context_ap.get());
+}
+
 namespace {
     // This is the memory object we use in GetInstruction.
     class LLDBDisasmMemoryObject : public llvm::MemoryObject {
@@ -562,11 +646,48 @@ DisassemblerLLVMC::FlavorValidForArchSpec (const lldb_private::ArchSpec &arch, c
 }
     
 
+//----------------------------------------------------------------------
+// The MC disassemblers don't depend on anything but the triple and the
+// flavor, so they are made once for each of those and then kept around
+// for as long as the plug-in is loaded.
+//----------------------------------------------------------------------
+Mutex &
+DisassemblerLLVMC::GetLLVMCDisassemblerMapMutex ()
+{
+    static Mutex g_mutex (Mutex::eMutexTypeNormal);
+    return g_mutex;
+}
+
+DisassemblerLLVMC::LLVMCDisassemblerMap &
+DisassemblerLLVMC::GetLLVMCDisassemblerMap ()
+{
+    static LLVMCDisassemblerMap g_map;
+    return g_map;
+}
+
+DisassemblerLLVMC::LLVMCDisassemblerSP
+DisassemblerLLVMC::GetSharedLLVMCDisassembler (const char *triple, unsigned flavor)
+{
+    Mutex::Locker locker (GetLLVMCDisassemblerMapMutex());
+    LLVMCDisassemblerMap &map = GetLLVMCDisassemblerMap();
+    LLVMCDisassemblerMap::key_type key (triple, flavor);
+    LLVMCDisassemblerMap::iterator pos = map.find (key);
+    if (pos != map.end())
+        return pos->second;
+    
+    // Remember the ones that fail too, so we don't keep trying
+    LLVMCDisassemblerSP disasm_sp (new LLVMCDisassembler (triple, flavor));
+    map[key] = disasm_sp;
+    return disasm_sp;
+}
+
 Disassembler *
 DisassemblerLLVMC::CreateInstance (const ArchSpec &arch, const char *flavor)
 {
     if (arch.GetTriple().getArch() != llvm::Triple::UnknownArch)
     {
+        PluginManager::RunDeferredInitializer (PluginManager::GetLLVMTargetsInitializerName());
+
         std::unique_ptr<DisassemblerLLVMC> disasm_ap (new DisassemblerLLVMC(arch, flavor));
     
         if (disasm_ap.get() && disasm_ap->IsValid())
@@ -604,12 +725,12 @@ DisassemblerLLVMC::DisassemblerLLVMC (const ArchSpec &arch, const char *flavor_s
         }
     }
     
-    m_disasm_ap.reset (new LLVMCDisassembler(triple, flavor, *this));
-    if (!m_disasm_ap->IsValid())
+    m_disasm_sp = GetSharedLLVMCDisassembler (triple, flavor);
+    if (!m_disasm_sp->IsValid())
     {
-        // We use m_disasm_ap.get() to tell whether we are valid or not, so if this isn't good for some reason,
+        // We use m_disasm_sp.get() to tell whether we are valid or not, so if this isn't good for some reason,
         // we reset it, and then we won't be valid and FindPlugin will fail and we won't get used.
-        m_disasm_ap.reset();
+        m_disasm_sp.reset();
     }
     
     if (arch.GetTriple().getArch() == llvm::Triple::arm)
@@ -628,11 +749,11 @@ DisassemblerLLVMC::DisassemblerLLVMC (const ArchSpec &arch, const char *flavor_s
         }
         thumb_arch.GetTriple().setArchName(llvm::StringRef(thumb_arch_name.c_str()));
         std::string thumb_triple(thumb_arch.GetTriple().getTriple());
-        m_alternate_disasm_ap.reset(new LLVMCDisassembler(thumb_triple.c_str(), flavor, *this));
-        if (!m_alternate_disasm_ap->IsValid())
+        m_alternate_disasm_sp = GetSharedLLVMCDisassembler (thumb_triple.c_str(), flavor);
+        if (!m_alternate_disasm_sp->IsValid())
         {
-            m_disasm_ap.reset();
-            m_alternate_disasm_ap.reset();
+            m_disasm_sp.reset();
+            m_alternate_disasm_sp.reset();
         }
     }
 }
@@ -641,6 +762,39 @@ DisassemblerLLVMC::~DisassemblerLLVMC()
 {
 }
 
+void
+DisassemblerLLVMC::Lock (InstructionLLVMC *inst,
+                         const lldb_private::ExecutionContext *exe_ctx)
+{
+    m_mutex.Lock();
+    // Our MC disassemblers are shared with other DisassemblerLLVMC objects
+    // for the same triple, take them over for the duration
+    if (m_disasm_sp.get())
+    {
+        m_disasm_sp->GetMutex().Lock();
+        m_disasm_sp->SetOwner (this);
+    }
+    if (m_alternate_disasm_sp.get())
+    {
+        m_alternate_disasm_sp->GetMutex().Lock();
+        m_alternate_disasm_sp->SetOwner (this);
+    }
+    m_inst = inst;
+    m_exe_ctx = exe_ctx;
+}
+
+void
+DisassemblerLLVMC::Unlock ()
+{
+    m_inst = NULL;
+    m_exe_ctx = NULL;
+    if (m_alternate_disasm_sp.get())
+        m_alternate_disasm_sp->GetMutex().Unlock();
+    if (m_disasm_sp.get())
+        m_disasm_sp->GetMutex().Unlock();
+    m_mutex.Unlock();
+}
+
 size_t
 DisassemblerLLVMC::DecodeInstructions (const Address &base_addr,
                                        const DataExtractor& data,
@@ -666,7 +820,7 @@ DisassemblerLLVMC::DecodeInstructions (const Address &base_addr,
         
         AddressClass address_class = eAddressClassCode;
         
-        if (m_alternate_disasm_ap.get() != NULL)
+        if (m_alternate_disasm_sp.get() != NULL)
             address_class = inst_addr.GetAddressClass ();
         
         InstructionSP inst_sp(new InstructionLLVMC(*this,
@@ -696,7 +850,16 @@ DisassemblerLLVMC::Initialize()
     PluginManager::RegisterPlugin (GetPluginNameStatic(),
                                    "Disassembler that uses LLVM MC to disassemble i386, x86_64 and ARM.",
                                    CreateInstance);
-    
+
+    // Registering all the LLVM targets is slow, wait until we are asked
+    // for a disassembler.
+    PluginManager::RegisterDeferredInitializer (PluginManager::GetLLVMTargetsInitializerName(),
+                                                InitializeLLVMTargets);
+}
+
+void
+DisassemblerLLVMC::InitializeLLVMTargets ()
+{
     llvm::InitializeAllTargetInfos();
     llvm::InitializeAllTargetMCs();
     llvm::InitializeAllAsmParsers();
@@ -707,6 +870,10 @@ void
 DisassemblerLLVMC::Terminate()
 {
     PluginManager::UnregisterPlugin (CreateInstance);
+    PluginManager::UnregisterDeferredInitializer (InitializeLLVMTargets);
+    
+    Mutex::Locker locker (GetLLVMCDisassemblerMapMutex());
+    GetLLVMCDisassemblerMap().clear();
 }
 
 
@@ -10,6 +10,8 @@
 #ifndef liblldb_DisassemblerLLVMC_h_
 #define liblldb_DisassemblerLLVMC_h_
 
+#include <map>
+#include <memory>
 #include <string>
 
 #include "llvm-c/Disassembler.h"
@@ -38,22 +40,43 @@ class DisassemblerLLVMC : public lldb_private::Disassembler
 {
     // Since we need to make two actual MC Disassemblers for ARM (ARM & THUMB), and there's a bit of goo to set up and own
     // in the MC disassembler world, I added this class to manage the actual disassemblers.
+    //
+    // Setting one up is by far the most expensive part of making a DisassemblerLLVMC, so they are made once per triple
+    // and flavor and shared by all the DisassemblerLLVMC objects that need them (see GetSharedLLVMCDisassembler()).
+    // Users must hold the mutex and point the symbol lookup callbacks at themselves with SetOwner() first, which
+    // DisassemblerLLVMC::Lock() does.
     class LLVMCDisassembler
     {
     public:
-        LLVMCDisassembler (const char *triple, unsigned flavor, DisassemblerLLVMC &owner);
+        LLVMCDisassembler (const char *triple, unsigned flavor);
         
         ~LLVMCDisassembler();
         
         uint64_t GetMCInst (const uint8_t *opcode_data, size_t opcode_data_len, lldb::addr_t pc, llvm::MCInst &mc_inst);
         uint64_t PrintMCInst (llvm::MCInst &mc_inst, char *output_buffer, size_t out_buffer_len);
         bool     CanBranch (llvm::MCInst &mc_inst);
+        void     SetOwner (DisassemblerLLVMC *owner);
         bool     IsValid()
         {
             return m_is_valid;
         }
         
+        const lldb_private::ConstString &
+        GetTriple () const
+        {
+            return m_triple;
+        }
+        
+        lldb_private::Mutex &
+        GetMutex ()
+        {
+            return m_mutex;
+        }
+        
     private:
+        lldb_private::Mutex                     m_mutex;
+        DisassemblerLLVMC                      *m_owner;
+        lldb_private::ConstString               m_triple;
         bool                                    m_is_valid;
         std::unique_ptr<llvm::MCContext>         m_context_ap;
         std::unique_ptr<llvm::MCAsmInfo>         m_asm_info_ap;
@@ -63,6 +86,9 @@ class DisassemblerLLVMC : public lldb_private::Disassembler
         std::unique_ptr<llvm::MCInstPrinter>     m_instr_printer_ap;
         std::unique_ptr<llvm::MCDisassembler>    m_disasm_ap;
     };
+    
+    typedef std::shared_ptr<LLVMCDisassembler> LLVMCDisassemblerSP;
+    typedef std::map<std::pair<std::string, unsigned>, LLVMCDisassemblerSP> LLVMCDisassemblerMap;
 
 public:
     //------------------------------------------------------------------
@@ -111,9 +137,21 @@ protected:
     bool
     IsValid()
     {
-        return (m_disasm_ap.get() != NULL && m_disasm_ap->IsValid());
+        return (m_disasm_sp.get() != NULL && m_disasm_sp->IsValid());
     }
     
+    static LLVMCDisassemblerSP
+    GetSharedLLVMCDisassembler (const char *triple, unsigned flavor);
+    
+    static LLVMCDisassemblerMap &
+    GetLLVMCDisassemblerMap ();
+    
+    static lldb_private::Mutex &
+    GetLLVMCDisassemblerMapMutex ();
+
+    static void
+    InitializeLLVMTargets ();
+    
     int OpInfo(uint64_t PC,
                uint64_t Offset,
                uint64_t Size,
@@ -139,27 +177,17 @@ protected:
                                             const char **ReferenceName);
     
     void Lock(InstructionLLVMC *inst, 
-              const lldb_private::ExecutionContext *exe_ctx)
-    {
-        m_mutex.Lock();
-        m_inst = inst;
-        m_exe_ctx = exe_ctx;
-    }
+              const lldb_private::ExecutionContext *exe_ctx);
     
-    void Unlock()
-    {
-        m_inst = NULL;
-        m_exe_ctx = NULL;
-        m_mutex.Unlock();
-    }
+    void Unlock();
     
     const lldb_private::ExecutionContext *m_exe_ctx;
     InstructionLLVMC *m_inst;
     lldb_private::Mutex m_mutex;
     bool m_data_from_file;
     
-    std::unique_ptr<LLVMCDisassembler> m_disasm_ap;
-    std::unique_ptr<LLVMCDisassembler> m_alternate_disasm_ap;
+    LLVMCDisassemblerSP m_disasm_sp;
+    LLVMCDisassemblerSP m_alternate_disasm_sp;
 };
 
 #endif  // liblldb_DisassemblerLLVM_h_
@@ -0,0 +1,1093 @@
+//===-- EmulateInstructionPatmos.cpp ----------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "EmulateInstructionPatmos.h"
+#include "EmulationStatePatmos.h"
+
+#include <string.h>
+
+#include "lldb/Core/ArchSpec.h"
+#include "lldb/Core/ConstString.h"
+#include "lldb/Core/PluginManager.h"
+#include "lldb/Core/Stream.h"
+#include "lldb/Interpreter/OptionValueDictionary.h"
+#include "lldb/Symbol/UnwindPlan.h"
+
+#include "Plugins/Process/Utility/InstructionUtils.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+static const char *g_gpr_names[] =
+{
+    "r0",  "r1",  "r2",  "r3",  "r4",  "r5",  "r6",  "r7",
+    "r8",  "r9",  "r10", "r11", "r12", "r13", "r14", "r15",
+    "r16", "r17", "r18", "r19", "r20", "r21", "r22", "r23",
+    "r24", "r25", "r26", "r27", "r28", "r29", "r30", "r31"
+};
+
+static const char *g_sreg_names[] =
+{
+    "s0",  "s1",  "s2",  "s3",  "s4",  "s5",  "s6",  "s7",
+    "s8",  "s9",  "s10", "s11", "s12", "s13", "s14", "s15"
+};
+
+static const char *g_sreg_alt_names[] =
+{
+    NULL,  NULL,  "sl",  "sh",  NULL,  "ss",  "st",  "srb",
+    "sro", "sxb", "sxo", NULL,  NULL,  NULL,  NULL,  NULL
+};
+
+static inline uint32_t
+SpecialRegister (uint32_t sreg)
+{
+    return patmos_s0 + sreg;
+}
+
+// The operations shared by ALUi, ALUl and the register ALU instructions
+static bool
+ALUOperation (uint32_t func, uint32_t a, uint32_t b, uint32_t &result)
+{
+    switch (func)
+    {
+    case PATMOS_ALU_ADD:    result = a + b; return true;
+    case PATMOS_ALU_SUB:    result = a - b; return true;
+    case PATMOS_ALU_XOR:    result = a ^ b; return true;
+    case PATMOS_ALU_SL:     result = a << (b & 31); return true;
+    case PATMOS_ALU_SR:     result = a >> (b & 31); return true;
+    case PATMOS_ALU_SRA:    result = (uint32_t)((int32_t)a >> (b & 31)); return true;
+    case PATMOS_ALU_OR:     result = a | b; return true;
+    case PATMOS_ALU_AND:    result = a & b; return true;
+    case PATMOS_ALU_RL:     result = Rotl32 (a, b & 31); return true;
+    case PATMOS_ALU_RR:     result = Rotr32 (a, b & 31); return true;
+    case PATMOS_ALU_NOR:    result = ~(a | b); return true;
+    case PATMOS_ALU_SHADD:  result = (a << 1) + b; return true;
+    case PATMOS_ALU_SHADD2: result = (a << 2) + b; return true;
+    }
+    return false;
+}
+
+//----------------------------------------------------------------------
+//
+// EmulateInstructionPatmos implementation
+//
+//----------------------------------------------------------------------
+
+void
+EmulateInstructionPatmos::Initialize ()
+{
+    PluginManager::RegisterPlugin (GetPluginNameStatic (),
+                                   GetPluginDescriptionStatic (),
+                                   CreateInstance);
+}
+
+void
+EmulateInstructionPatmos::Terminate ()
+{
+    PluginManager::UnregisterPlugin (CreateInstance);
+}
+
+ConstString
+EmulateInstructionPatmos::GetPluginNameStatic ()
+{
+    static ConstString g_name("patmos");
+    return g_name;
+}
+
+const char *
+EmulateInstructionPatmos::GetPluginDescriptionStatic ()
+{
+    return "Emulate instructions for the Patmos architecture.";
+}
+
+EmulateInstruction *
+EmulateInstructionPatmos::CreateInstance (const ArchSpec &arch, InstructionType inst_type)
+{
+    if (EmulateInstructionPatmos::SupportsEmulatingIntructionsOfTypeStatic(inst_type))
+    {
+        if (arch.GetTriple().getArch() == llvm::Triple::patmos)
+        {
+            std::unique_ptr<EmulateInstructionPatmos> emulate_insn_ap (new EmulateInstructionPatmos (arch));
+
+            if (emulate_insn_ap.get())
+                return emulate_insn_ap.release();
+        }
+    }
+
+    return NULL;
+}
+
+EmulateInstructionPatmos::EmulateInstructionPatmos (const ArchSpec &arch) :
+    EmulateInstruction (arch),
+    m_bundle_addr (LLDB_INVALID_ADDRESS),
+    m_bundle_size (0),
+    m_predicates (1),
+    m_new_predicates (1),
+    m_predicates_read (false),
+    m_predicates_valid (false),
+    m_ignore_conditions (false),
+    m_skip_conditional (false),
+    m_pending_writes (),
+    m_branch (),
+    m_branch_delay_slots (0),
+    m_pending_target (LLDB_INVALID_ADDRESS),
+    m_pending_delay_slots (0),
+    m_pending_context ()
+{
+}
+
+bool
+EmulateInstructionPatmos::SetTargetTriple (const ArchSpec &arch)
+{
+    return arch.GetTriple().getArch () == llvm::Triple::patmos;
+}
+
+bool
+EmulateInstructionPatmos::GetRegisterInfo (uint32_t reg_kind, uint32_t reg_num, RegisterInfo &reg_info)
+{
+    if (reg_kind == eRegisterKindGeneric)
+    {
+        switch (reg_num)
+        {
+            case LLDB_REGNUM_GENERIC_PC:    reg_kind = eRegisterKindDWARF; reg_num = patmos_pc; break;
+            case LLDB_REGNUM_GENERIC_SP:    reg_kind = eRegisterKindDWARF; reg_num = patmos_r31; break;
+            case LLDB_REGNUM_GENERIC_FP:    reg_kind = eRegisterKindDWARF; reg_num = patmos_r30; break;
+            case LLDB_REGNUM_GENERIC_FLAGS: reg_kind = eRegisterKindDWARF; reg_num = patmos_s0; break;
+            default: return false;
+        }
+    }
+
+    if (reg_kind != eRegisterKindDWARF || reg_num >= k_num_patmos_registers)
+        return false;
+
+    ::memset (&reg_info, 0, sizeof(RegisterInfo));
+    ::memset (reg_info.kinds, LLDB_INVALID_REGNUM, sizeof(reg_info.kinds));
+
+    reg_info.byte_size = 4;
+    reg_info.format = eFormatHex;
+    reg_info.encoding = eEncodingUint;
+    reg_info.kinds[eRegisterKindDWARF] = reg_num;
+
+    if (reg_num < patmos_s0)
+    {
+        reg_info.name = g_gpr_names[reg_num];
+        if (reg_num == patmos_r30)
+        {
+            reg_info.alt_name = "fp";
+            reg_info.kinds[eRegisterKindGeneric] = LLDB_REGNUM_GENERIC_FP;
+        }
+        else if (reg_num == patmos_r31)
+        {
+            reg_info.alt_name = "sp";
+            reg_info.kinds[eRegisterKindGeneric] = LLDB_REGNUM_GENERIC_SP;
+        }
+    }
+    else if (reg_num <= patmos_s15)
+    {
+        reg_info.name = g_sreg_names[reg_num - patmos_s0];
+        reg_info.alt_name = g_sreg_alt_names[reg_num - patmos_s0];
+        if (reg_num == patmos_s0)
+            reg_info.kinds[eRegisterKindGeneric] = LLDB_REGNUM_GENERIC_FLAGS;
+    }
+    else
+    {
+        reg_info.name = "pc";
+        reg_info.kinds[eRegisterKindGeneric] = LLDB_REGNUM_GENERIC_PC;
+    }
+    return true;
+}
+
+bool
+EmulateInstructionPatmos::ReadInstruction ()
+{
+    bool success = false;
+    addr_t pc = ReadRegisterUnsigned (eRegisterKindGeneric, LLDB_REGNUM_GENERIC_PC, LLDB_INVALID_ADDRESS, &success);
+    if (success)
+    {
+        Context read_inst_context;
+        read_inst_context.type = eContextReadOpcode;
+        read_inst_context.SetNoArgs ();
+
+        const uint32_t first = ReadMemoryUnsigned (read_inst_context, pc, 4, 0, &success);
+        if (success)
+        {
+            if (PatmosIsBundled (first))
+            {
+                const uint32_t second = ReadMemoryUnsigned (read_inst_context, pc + 4, 4, 0, &success);
+                if (success)
+                    m_opcode.SetOpcode64 (((uint64_t)first << 32) | second);
+            }
+            else
+                m_opcode.SetOpcode32 (first);
+        }
+    }
+    if (success)
+        m_addr = pc;
+    else
+        m_addr = LLDB_INVALID_ADDRESS;
+    return success;
+}
+
+// Split the current opcode into its instructions. Returns the size of the
+// bundle in bytes or zero if the opcode isn't a complete bundle.
+size_t
+EmulateInstructionPatmos::GetBundle (uint32_t *insns, size_t &num_insns, uint32_t &long_imm, bool &has_long_imm) const
+{
+    num_insns = 0;
+    long_imm = 0;
+    has_long_imm = false;
+
+    switch (m_opcode.GetType())
+    {
+    case Opcode::eType32:
+        insns[0] = m_opcode.GetOpcode32 ();
+        if (PatmosIsBundled (insns[0]))
+            return 0;
+        num_insns = 1;
+        return 4;
+
+    case Opcode::eType64:
+        {
+            const uint64_t bundle = m_opcode.GetOpcode64 ();
+            insns[0] = (uint32_t)(bundle >> 32);
+            if (!PatmosIsBundled (insns[0]))
+                return 0;
+            if (!PatmosIsALUi (insns[0]) && PatmosOpcode (insns[0]) == PATMOS_OPC_ALUL)
+            {
+                // The second word is the immediate of the first instruction
+                long_imm = (uint32_t)bundle;
+                has_long_imm = true;
+                num_insns = 1;
+            }
+            else
+            {
+                insns[1] = (uint32_t)bundle;
+                num_insns = 2;
+            }
+        }
+        return 8;
+
+    default:
+        break;
+    }
+    return 0;
+}
+
+// Read s0 once per bundle, and only if an instruction needs it.
+bool
+EmulateInstructionPatmos::ReadPredicates ()
+{
+    if (!m_predicates_read)
+    {
+        m_predicates_read = true;
+        const uint32_t s0 = ReadRegisterUnsigned (eRegisterKindDWARF, patmos_s0, 0, &m_predicates_valid);
+        // p0 always reads as true
+        m_predicates = m_new_predicates = s0 | 1u;
+    }
+    return m_predicates_valid;
+}
+
+void
+EmulateInstructionPatmos::SetPredicate (uint32_t pd, bool value)
+{
+    // Writes to p0 are ignored. If s0 couldn't be read we can't merge the
+    // new predicate into it, so it is left alone.
+    if (pd == 0 || !ReadPredicates ())
+        return;
+    if (value)
+        m_new_predicates |= (1u << pd);
+    else
+        m_new_predicates &= ~(1u << pd);
+}
+
+bool
+EmulateInstructionPatmos::ConditionPassed (uint32_t insn)
+{
+    if (PatmosIsUnconditional (insn) || m_ignore_conditions)
+        return true;
+    if (m_skip_conditional || !ReadPredicates ())
+        return false;
+    const bool value = ((m_predicates >> PatmosPredicate (insn)) & 1u) != 0;
+    return PatmosPredicateIsNegated (insn) ? !value : value;
+}
+
+uint32_t
+EmulateInstructionPatmos::ReadGPR (uint32_t reg, bool &success)
+{
+    if (reg == patmos_r0)
+    {
+        success = true;
+        return 0;
+    }
+    return ReadRegisterUnsigned (eRegisterKindDWARF, reg, 0, &success);
+}
+
+void
+EmulateInstructionPatmos::AddRegisterWrite (const Context &context, uint32_t reg_num, uint64_t value)
+{
+    // r0 is hardwired to zero
+    if (reg_num == patmos_r0)
+        return;
+    PendingWrite write;
+    write.context = context;
+    write.reg_num = reg_num;
+    write.addr = LLDB_INVALID_ADDRESS;
+    write.byte_size = 4;
+    write.value = value;
+    m_pending_writes.push_back (write);
+}
+
+void
+EmulateInstructionPatmos::AddMemoryWrite (const Context &context, addr_t addr, uint32_t byte_size, uint64_t value)
+{
+    PendingWrite write;
+    write.context = context;
+    write.reg_num = LLDB_INVALID_REGNUM;
+    write.addr = addr;
+    write.byte_size = byte_size;
+    write.value = value;
+    m_pending_writes.push_back (write);
+}
+
+// The address of the bundle num_bundles bundles after addr. Bundles are
+// four or eight bytes so their first words have to be read; if that isn't
+// possible single instruction bundles are assumed.
+addr_t
+EmulateInstructionPatmos::GetAddressAfterBundles (addr_t addr, uint32_t num_bundles)
+{
+    Context read_inst_context;
+    read_inst_context.type = eContextReadOpcode;
+    read_inst_context.SetNoArgs ();
+
+    for (uint32_t i = 0; i < num_bundles; ++i)
+    {
+        bool success = false;
+        const uint32_t insn = ReadMemoryUnsigned (read_inst_context, addr, 4, 0, &success);
+        addr += (success && PatmosIsBundled (insn)) ? 8 : 4;
+    }
+    return addr;
+}
+
+// ALUi and ALUl: rd = rs1 op imm
+bool
+EmulateInstructionPatmos::EmulateALUImmediate (uint32_t insn, bool has_long_imm, uint32_t long_imm)
+{
+    const bool is_alui = PatmosIsALUi (insn);
+    if (!is_alui && !has_long_imm)
+        return false;
+
+    const uint32_t func = is_alui ? Bits32 (insn, 24, 22) : Bits32 (insn, 3, 0);
+    const uint32_t rd = PatmosRd (insn);
+    const uint32_t rs1 = PatmosRs1 (insn);
+    const uint32_t imm = is_alui ? Bits32 (insn, 11, 0) : long_imm;
+
+    bool success = false;
+    const uint32_t op1 = ReadGPR (rs1, success);
+    if (!success)
+        return false;
+
+    uint32_t result;
+    if (!ALUOperation (func, op1, imm, result))
+        return false;
+
+    Context context;
+    const bool is_add_sub = func == PATMOS_ALU_ADD || func == PATMOS_ALU_SUB;
+    const int64_t signed_imm = func == PATMOS_ALU_SUB ? -(int64_t)(int32_t)imm : (int64_t)(int32_t)imm;
+    if (rd == patmos_r31 && rs1 == patmos_r31 && is_add_sub)
+    {
+        context.type = eContextAdjustStackPointer;
+        context.SetImmediateSigned (signed_imm);
+    }
+    else if (rd == patmos_r30 && rs1 == patmos_r31 && is_add_sub)
+    {
+        RegisterInfo sp_reg;
+        GetRegisterInfo (eRegisterKindDWARF, patmos_r31, sp_reg);
+        context.type = eContextSetFramePointer;
+        context.SetRegisterPlusOffset (sp_reg, signed_imm);
+    }
+    else if (rs1 == patmos_r0)
+    {
+        context.type = eContextImmediate;
+        context.SetImmediate (result);
+    }
+    else
+    {
+        RegisterInfo base_reg;
+        GetRegisterInfo (eRegisterKindDWARF, rs1, base_reg);
+        context.type = eContextArithmetic;
+        context.SetRegisterPlusOffset (base_reg, is_add_sub ? signed_imm : 0);
+    }
+    AddRegisterWrite (context, rd, result);
+    return true;
+}
+
+// Register ALU, multiply, compare and predicate instructions
+bool
+EmulateInstructionPatmos::EmulateALURegister (uint32_t insn)
+{
+    const uint32_t func = Bits32 (insn, 3, 0);
+    const uint32_t rd = PatmosRd (insn);
+    const uint32_t rs1 = PatmosRs1 (insn);
+    const uint32_t rs2 = PatmosRs2 (insn);
+
+    Context context;
+    context.type = eContextArithmetic;
+    context.SetNoArgs ();
+
+    bool success = false;
+    switch (Bits32 (insn, 6, 4))
+    {
+    case PATMOS_ALUR:
+        {
+            const uint32_t op1 = ReadGPR (rs1, success);
+            if (!success)
+                return false;
+            const uint32_t op2 = ReadGPR (rs2, success);
+            if (!success)
+                return false;
+            uint32_t result;
+            if (!ALUOperation (func, op1, op2, result))
+                return false;
+            AddRegisterWrite (context, rd, result);
+        }
+        return true;
+
+    case PATMOS_ALUU:
+        {
+            const uint32_t op1 = ReadGPR (rs1, success);
+            if (!success)
+                return false;
+            uint32_t result;
+            switch (func)
+            {
+            case PATMOS_ALUU_SEXT8:  result = (uint32_t)(int32_t)(int8_t)op1; break;
+            case PATMOS_ALUU_SEXT16: result = (uint32_t)(int32_t)(int16_t)op1; break;
+            case PATMOS_ALUU_ZEXT16: result = op1 & 0xffffu; break;
+            case PATMOS_ALUU_ABS:    result = (int32_t)op1 < 0 ? -op1 : op1; break;
+            default:
+                return false;
+            }
+            AddRegisterWrite (context, rd, result);
+        }
+        return true;
+
+    case PATMOS_ALUM:
+        {
+            const uint32_t op1 = ReadGPR (rs1, success);
+            if (!success)
+                return false;
+            const uint32_t op2 = ReadGPR (rs2, success);
+            if (!success)
+                return false;
+            uint64_t product;
+            if (func == PATMOS_ALUM_MUL)
+                product = (uint64_t)((int64_t)(int32_t)op1 * (int64_t)(int32_t)op2);
+            else if (func == PATMOS_ALUM_MULU)
+                product = (uint64_t)op1 * (uint64_t)op2;
+            else
+                return false;
+            AddRegisterWrite (context, SpecialRegister (PATMOS_SREG_SL), (uint32_t)product);
+            AddRegisterWrite (context, SpecialRegister (PATMOS_SREG_SH), (uint32_t)(product >> 32));
+        }
+        return true;
+
+    case PATMOS_ALUC:
+        {
+            const uint32_t op1 = ReadGPR (rs1, success);
+            if (!success)
+                return false;
+            const uint32_t op2 = ReadGPR (rs2, success);
+            if (!success)
+                return false;
+            bool result;
+            switch (func)
+            {
+            case PATMOS_ALUC_CMPEQ:  result = op1 == op2; break;
+            case PATMOS_ALUC_CMPNEQ: result = op1 != op2; break;
+            case PATMOS_ALUC_CMPLT:  result = (int32_t)op1 < (int32_t)op2; break;
+            case PATMOS_ALUC_CMPLE:  result = (int32_t)op1 <= (int32_t)op2; break;
+            case PATMOS_ALUC_CMPULT: result = op1 < op2; break;
+            case PATMOS_ALUC_CMPULE: result = op1 <= op2; break;
+            case PATMOS_ALUC_BTEST:  result = ((op1 >> (op2 & 31)) & 1u) != 0; break;
+            default:
+                return false;
+            }
+            SetPredicate (Bits32 (insn, 19, 17), result);
+        }
+        return true;
+
+    case PATMOS_ALUP:
+        {
+            if (!ReadPredicates ())
+                return true;
+            const bool ps1 = (((m_predicates >> Bits32 (insn, 14, 12)) & 1u) != 0) != (Bit32 (insn, 15) != 0);
+            const bool ps2 = (((m_predicates >> Bits32 (insn, 9, 7)) & 1u) != 0) != (Bit32 (insn, 10) != 0);
+            bool result;
+            switch (func)
+            {
+            case PATMOS_ALUP_POR:  result = ps1 || ps2; break;
+            case PATMOS_ALUP_PAND: result = ps1 && ps2; break;
+            case PATMOS_ALUP_PXOR: result = ps1 != ps2; break;
+            default:
+                return false;
+            }
+            SetPredicate (Bits32 (insn, 19, 17), result);
+        }
+        return true;
+    }
+    return false;
+}
+
+// mts/mfs
+bool
+EmulateInstructionPatmos::EmulateSPC (uint32_t insn)
+{
+    const uint32_t sreg = Bits32 (insn, 3, 0);
+    bool success = false;
+
+    Context context;
+    context.type = eContextRegisterPlusOffset;
+
+    switch (Bits32 (insn, 6, 4))
+    {
+    case PATMOS_SPC_MTS:
+        {
+            const uint32_t rs1 = PatmosRs1 (insn);
+            uint32_t value = ReadGPR (rs1, success);
+            if (!success)
+                return false;
+            if (sreg == PATMOS_SREG_S0)
+                value |= 1u;
+            RegisterInfo src_reg;
+            GetRegisterInfo (eRegisterKindDWARF, rs1, src_reg);
+            context.SetRegisterPlusOffset (src_reg, 0);
+            AddRegisterWrite (context, SpecialRegister (sreg), value);
+        }
+        return true;
+
+    case PATMOS_SPC_MFS:
+        {
+            const uint32_t value = ReadRegisterUnsigned (eRegisterKindDWARF, SpecialRegister (sreg), 0, &success);
+            if (!success)
+                return false;
+            RegisterInfo src_reg;
+            GetRegisterInfo (eRegisterKindDWARF, SpecialRegister (sreg), src_reg);
+            context.SetRegisterPlusOffset (src_reg, 0);
+            AddRegisterWrite (context, PatmosRd (insn), value);
+        }
+        return true;
+    }
+    return false;
+}
+
+static bool
+GetAccessByteSize (uint32_t type, uint32_t &byte_size, bool &is_signed)
+{
+    switch (type >> 2)
+    {
+    case PATMOS_MEM_WORD:   byte_size = 4; is_signed = false; return true;
+    case PATMOS_MEM_HALF:   byte_size = 2; is_signed = true;  return true;
+    case PATMOS_MEM_BYTE:   byte_size = 1; is_signed = true;  return true;
+    case PATMOS_MEM_HALF_U: byte_size = 2; is_signed = false; return true;
+    case PATMOS_MEM_BYTE_U: byte_size = 1; is_signed = false; return true;
+    }
+    return false;
+}
+
+// Typed loads: rd = [ra + imm], scaled by the access size. Stack cache
+// accesses are relative to st.
+bool
+EmulateInstructionPatmos::EmulateLoad (uint32_t insn)
+{
+    const uint32_t rd = PatmosRd (insn);
+    const uint32_t ra = PatmosRs1 (insn);
+    const uint32_t type = Bits32 (insn, 11, 7);
+    const bool stack_area = (type & 3) == PATMOS_MEM_STACK;
+
+    uint32_t byte_size;
+    bool is_signed;
+    if (!GetAccessByteSize (type, byte_size, is_signed))
+        return false;
+    const int64_t offset = Bits32 (insn, 6, 0) * byte_size;
+
+    bool success = false;
+    addr_t addr = ReadGPR (ra, success);
+    if (!success)
+        return false;
+    if (stack_area)
+    {
+        addr += ReadRegisterUnsigned (eRegisterKindDWARF, SpecialRegister (PATMOS_SREG_ST), 0, &success);
+        if (!success)
+            return false;
+    }
+    addr = (uint32_t)(addr + offset);
+
+    RegisterInfo base_reg;
+    const uint32_t base_reg_num = (stack_area && ra == patmos_r0) ? SpecialRegister (PATMOS_SREG_ST) : ra;
+    GetRegisterInfo (eRegisterKindDWARF, base_reg_num, base_reg);
+
+    Context context;
+    if (stack_area || ra == patmos_r30 || ra == patmos_r31)
+        context.type = eContextPopRegisterOffStack;
+    else
+        context.type = eContextRegisterLoad;
+    context.SetRegisterPlusOffset (base_reg, offset);
+
+    uint64_t value = ReadMemoryUnsigned (context, addr, byte_size, 0, &success);
+    if (!success)
+        return false;
+    if (is_signed)
+        value = (uint32_t)SignedBits (value, byte_size * 8 - 1, 0);
+    AddRegisterWrite (context, rd, value);
+    return true;
+}
+
+// Typed stores: [ra + imm] = rs, scaled by the access size
+bool
+EmulateInstructionPatmos::EmulateStore (uint32_t insn)
+{
+    const uint32_t type = Bits32 (insn, 21, 17);
+    const uint32_t ra = PatmosRs1 (insn);
+    const uint32_t rs = PatmosRs2 (insn);
+    const bool stack_area = (type & 3) == PATMOS_MEM_STACK;
+
+    uint32_t byte_size;
+    bool is_signed;
+    if (!GetAccessByteSize (type, byte_size, is_signed))
+        return false;
+    const int64_t offset = Bits32 (insn, 6, 0) * byte_size;
+
+    bool success = false;
+    const uint32_t value = ReadGPR (rs, success);
+    if (!success)
+        return false;
+    addr_t addr = ReadGPR (ra, success);
+    if (!success)
+        return false;
+    if (stack_area)
+    {
+        addr += ReadRegisterUnsigned (eRegisterKindDWARF, SpecialRegister (PATMOS_SREG_ST), 0, &success);
+        if (!success)
+            return false;
+    }
+    addr = (uint32_t)(addr + offset);
+
+    RegisterInfo data_reg;
+    RegisterInfo base_reg;
+    GetRegisterInfo (eRegisterKindDWARF, rs, data_reg);
+
+    Context context;
+    if (stack_area && ra == patmos_r0)
+    {
+        GetRegisterInfo (eRegisterKindDWARF, SpecialRegister (PATMOS_SREG_ST), base_reg);
+        context.type = eContextPushRegisterOnStack;
+    }
+    else
+    {
+        GetRegisterInfo (eRegisterKindDWARF, ra, base_reg);
+        if (!stack_area && (ra == patmos_r30 || ra == patmos_r31))
+            context.type = eContextPushRegisterOnStack;
+        else
+            context.type = eContextRegisterStore;
+    }
+    context.SetRegisterToRegisterPlusOffset (data_reg, base_reg, offset);
+
+    const uint64_t mask = byte_size == 4 ? 0xffffffffull : ((1ull << (byte_size * 8)) - 1);
+    AddMemoryWrite (context, addr, byte_size, value & mask);
+    return true;
+}
+
+// Stack cache control. Only the stack top pointer is modelled, the spill
+// pointer ss and the contents of the stack cache are left to the target.
+bool
+EmulateInstructionPatmos::EmulateStackControl (uint32_t insn)
+{
+    // The register forms only ensure or spill a number of words
+    if (Bits32 (insn, 19, 18) != 0)
+        return true;
+
+    const int64_t size = Bits32 (insn, 17, 0) * 4;
+    int64_t delta;
+    switch (Bits32 (insn, 21, 18))
+    {
+    case PATMOS_STC_SRES:   delta = -size; break;
+    case PATMOS_STC_SFREE:  delta = size; break;
+    case PATMOS_STC_SENS:
+    case PATMOS_STC_SSPILL:
+        return true;
+    default:
+        return false;
+    }
+
+    bool success = false;
+    const uint32_t st = ReadRegisterUnsigned (eRegisterKindDWARF, SpecialRegister (PATMOS_SREG_ST), 0, &success);
+    if (!success)
+        return false;
+
+    Context context;
+    context.type = eContextAdjustStackPointer;
+    context.SetImmediateSigned (delta);
+    AddRegisterWrite (context, SpecialRegister (PATMOS_SREG_ST), (uint32_t)(st + delta));
+    return true;
+}
+
+// call, br and brcf with an immediate target
+bool
+EmulateInstructionPatmos::EmulateControlFlowImmediate (uint32_t insn)
+{
+    const uint32_t op = Bits32 (insn, 24, 23);
+    const uint32_t imm = Bits32 (insn, 21, 0);
+
+    Context context;
+    context.type = eContextRelativeBranchImmediate;
+
+    switch (op)
+    {
+    case PATMOS_CFL_CALL:
+        {
+            // Calls take an absolute word address
+            m_branch.target = (addr_t)imm * 4;
+            m_branch.delay_slots = PATMOS_CALL_DELAY_SLOTS;
+
+            // The function base of the caller isn't known here, but srb + sro
+            // is all a return ever looks at.
+            Context link_context;
+            link_context.type = eContextArithmetic;
+            link_context.SetNoArgs ();
+            const addr_t return_addr = GetAddressAfterBundles (m_bundle_addr + m_bundle_size, m_branch.delay_slots);
+            AddRegisterWrite (link_context, SpecialRegister (PATMOS_SREG_SRB), 0);
+            AddRegisterWrite (link_context, SpecialRegister (PATMOS_SREG_SRO), (uint32_t)return_addr);
+        }
+        break;
+
+    case PATMOS_CFL_BR:
+    case PATMOS_CFL_BRCF:
+        m_branch.target = (uint32_t)(m_bundle_addr + SignedBits (imm, 21, 0) * 4);
+        m_branch.delay_slots = op == PATMOS_CFL_BR ? PATMOS_BR_DELAY_SLOTS : PATMOS_BRCF_DELAY_SLOTS;
+        break;
+
+    default:
+        // Traps go to the exception handler, which we don't know about
+        return false;
+    }
+
+    context.SetImmediateSigned ((int64_t)m_branch.target - (int64_t)m_bundle_addr);
+    m_branch.context = context;
+    m_branch.taken = true;
+    return true;
+}
+
+// ret, xret, callr, brr and brcfr
+bool
+EmulateInstructionPatmos::EmulateControlFlowRegister (uint32_t insn)
+{
+    const bool delayed = PatmosOpcode (insn) == PATMOS_OPC_CFLR;
+    const uint32_t rs1 = PatmosRs1 (insn);
+    const uint32_t rs2 = PatmosRs2 (insn);
+
+    uint32_t base_reg_num;
+    uint32_t offset_reg_num = LLDB_INVALID_REGNUM;
+    uint32_t delay_slots;
+    bool is_call = false;
+
+    Context context;
+    context.type = eContextAbsoluteBranchRegister;
+
+    switch (Bits32 (insn, 3, 0))
+    {
+    case PATMOS_CFLR_RET:
+        base_reg_num = SpecialRegister (PATMOS_SREG_SRB);
+        offset_reg_num = SpecialRegister (PATMOS_SREG_SRO);
+        delay_slots = PATMOS_RET_DELAY_SLOTS;
+        break;
+    case PATMOS_CFLR_XRET:
+        base_reg_num = SpecialRegister (PATMOS_SREG_SXB);
+        offset_reg_num = SpecialRegister (PATMOS_SREG_SXO);
+        delay_slots = PATMOS_RET_DELAY_SLOTS;
+        context.type = eContextReturnFromException;
+        break;
+    case PATMOS_CFLR_CALLR:
+        base_reg_num = rs1;
+        delay_slots = PATMOS_CALL_DELAY_SLOTS;
+        is_call = true;
+        break;
+    case PATMOS_CFLR_BRR:
+        base_reg_num = rs1;
+        delay_slots = PATMOS_BR_DELAY_SLOTS;
+        break;
+    case PATMOS_CFLR_BRCFR:
+        base_reg_num = rs1;
+        offset_reg_num = rs2;
+        delay_slots = PATMOS_BRCF_DELAY_SLOTS;
+        break;
+    default:
+        return false;
+    }
+    if (!delayed)
+        delay_slots = 0;
+
+    bool success = false;
+    RegisterInfo base_reg;
+    GetRegisterInfo (eRegisterKindDWARF, base_reg_num, base_reg);
+    addr_t target = base_reg_num < patmos_s0 ? ReadGPR (base_reg_num, success)
+                                             : ReadRegisterUnsigned (&base_reg, 0, &success);
+    if (!success)
+        return false;
+
+    if (offset_reg_num != LLDB_INVALID_REGNUM)
+    {
+        RegisterInfo offset_reg;
+        GetRegisterInfo (eRegisterKindDWARF, offset_reg_num, offset_reg);
+        target += offset_reg_num < patmos_s0 ? ReadGPR (offset_reg_num, success)
+                                             : ReadRegisterUnsigned (&offset_reg, 0, &success);
+        if (!success)
+            return false;
+        context.SetRegisterRegisterOperands (base_reg, offset_reg);
+    }
+    else
+        context.SetRegister (base_reg);
+
+    if (is_call)
+    {
+        Context link_context;
+        link_context.type = eContextArithmetic;
+        link_context.SetNoArgs ();
+        const addr_t return_addr = GetAddressAfterBundles (m_bundle_addr + m_bundle_size, delay_slots);
+        AddRegisterWrite (link_context, SpecialRegister (PATMOS_SREG_SRB), 0);
+        AddRegisterWrite (link_context, SpecialRegister (PATMOS_SREG_SRO), (uint32_t)return_addr);
+    }
+
+    m_branch.target = (uint32_t)target;
+    m_branch.delay_slots = delay_slots;
+    m_branch.context = context;
+    m_branch.taken = true;
+    return true;
+}
+
+bool
+EmulateInstructionPatmos::EvaluateInstruction (uint32_t evaluate_options)
+{
+    const bool auto_advance_pc = evaluate_options & eEmulateInstructionOptionAutoAdvancePC;
+    m_ignore_conditions = evaluate_options & eEmulateInstructionOptionIgnoreConditions;
+
+    uint32_t insns[2];
+    size_t num_insns;
+    uint32_t long_imm;
+    bool has_long_imm;
+    m_bundle_size = GetBundle (insns, num_insns, long_imm, has_long_imm);
+    if (m_bundle_size == 0)
+        return false;
+
+    bool success = false;
+    m_bundle_addr = m_addr;
+    if (m_bundle_addr == LLDB_INVALID_ADDRESS)
+    {
+        m_bundle_addr = ReadRegisterUnsigned (eRegisterKindDWARF, patmos_pc, LLDB_INVALID_ADDRESS, &success);
+        if (!success)
+            return false;
+    }
+
+    m_predicates_read = false;
+    m_predicates_valid = false;
+    m_pending_writes.clear();
+    m_branch = Branch();
+    m_branch_delay_slots = 0;
+
+    // Every instruction reads its operands here, the results are only
+    // written back below.
+    for (size_t i = 0; i < num_insns; ++i)
+    {
+        const uint32_t insn = insns[i];
+        if (!ConditionPassed (insn))
+            continue;
+
+        if (PatmosIsALUi (insn))
+            success = EmulateALUImmediate (insn, false, 0);
+        else if (PatmosIsCFLi (insn))
+            success = EmulateControlFlowImmediate (insn);
+        else
+        {
+            switch (PatmosOpcode (insn))
+            {
+            case PATMOS_OPC_ALUL:   success = EmulateALUImmediate (insn, i == 0 && has_long_imm, long_imm); break;
+            case PATMOS_OPC_ALU:    success = EmulateALURegister (insn); break;
+            case PATMOS_OPC_SPC:    success = EmulateSPC (insn); break;
+            case PATMOS_OPC_LDT:    success = EmulateLoad (insn); break;
+            case PATMOS_OPC_STT:    success = EmulateStore (insn); break;
+            case PATMOS_OPC_STC:    success = EmulateStackControl (insn); break;
+            case PATMOS_OPC_CFLR:
+            case PATMOS_OPC_CFLR_ND:
+                success = EmulateControlFlowRegister (insn);
+                break;
+            default:
+                success = false;
+                break;
+            }
+        }
+        if (!success)
+            return false;
+    }
+
+    // An mts to s0 in the same bundle wins over its compares
+    bool writes_s0 = false;
+    for (PendingWriteList::const_iterator pos = m_pending_writes.begin(), end = m_pending_writes.end(); pos != end; ++pos)
+        writes_s0 |= pos->reg_num == patmos_s0;
+
+    if (m_predicates_valid && m_new_predicates != m_predicates && !writes_s0)
+    {
+        Context context;
+        context.type = eContextArithmetic;
+        context.SetNoArgs ();
+        AddRegisterWrite (context, patmos_s0, m_new_predicates);
+    }
+
+    for (PendingWriteList::const_iterator pos = m_pending_writes.begin(), end = m_pending_writes.end(); pos != end; ++pos)
+    {
+        if (pos->reg_num != LLDB_INVALID_REGNUM)
+            success = WriteRegisterUnsigned (pos->context, eRegisterKindDWARF, pos->reg_num, pos->value);
+        else
+            success = WriteMemoryUnsigned (pos->context, pos->addr, pos->value, pos->byte_size);
+        if (!success)
+            return false;
+    }
+
+    if (m_branch.taken)
+    {
+        m_branch_delay_slots = m_branch.delay_slots;
+        if (!auto_advance_pc || m_branch.delay_slots == 0)
+        {
+            ClearPendingBranch ();
+            return WriteRegisterUnsigned (m_branch.context, eRegisterKindDWARF, patmos_pc, m_branch.target);
+        }
+        m_pending_target = m_branch.target;
+        m_pending_delay_slots = m_branch.delay_slots;
+        m_pending_context = m_branch.context;
+    }
+    else if (auto_advance_pc && m_pending_delay_slots > 0)
+    {
+        // This was a delay slot of an earlier branch
+        if (--m_pending_delay_slots == 0)
+        {
+            const addr_t target = m_pending_target;
+            ClearPendingBranch ();
+            return WriteRegisterUnsigned (m_pending_context, eRegisterKindDWARF, patmos_pc, target);
+        }
+    }
+
+    if (auto_advance_pc)
+    {
+        Context context;
+        context.type = eContextAdvancePC;
+        context.SetNoArgs ();
+        if (!WriteRegisterUnsigned (context, eRegisterKindDWARF, patmos_pc, m_bundle_addr + m_bundle_size))
+            return false;
+    }
+    return true;
+}
+
+uint32_t
+EmulateInstructionPatmos::GetMaxBranchDelaySlots ()
+{
+    uint32_t max_delay_slots = PATMOS_CALL_DELAY_SLOTS;
+    if (max_delay_slots < PATMOS_BR_DELAY_SLOTS)
+        max_delay_slots = PATMOS_BR_DELAY_SLOTS;
+    if (max_delay_slots < PATMOS_RET_DELAY_SLOTS)
+        max_delay_slots = PATMOS_RET_DELAY_SLOTS;
+    if (max_delay_slots < PATMOS_BRCF_DELAY_SLOTS)
+        max_delay_slots = PATMOS_BRCF_DELAY_SLOTS;
+    return max_delay_slots;
+}
+
+// The code to run is part of the "memory" of the before state and starts
+// at its pc. The branch there is evaluated together with its delay slots
+// the way ThreadPlanStepRange does it when stepping over a delayed branch,
+// so the after state has the pc at the branch target.
+bool
+EmulateInstructionPatmos::TestEmulation (Stream *out_stream, ArchSpec &arch, OptionValueDictionary *test_data)
+{
+    if (!test_data)
+    {
+        out_stream->Printf ("TestEmulation: Missing test data.\n");
+        return false;
+    }
+
+    static ConstString before_key ("before_state");
+    static ConstString after_key ("after_state");
+
+    EmulationStatePatmos state (arch.GetByteOrder());
+
+    OptionValueSP value_sp = test_data->GetValueForKey (before_key);
+    if ((value_sp.get() == NULL) || (value_sp->GetType() != OptionValue::eTypeDictionary))
+    {
+        out_stream->Printf ("TestEmulation:  Failed to find 'before' state.\n");
+        return false;
+    }
+    if (!state.LoadStateFromDictionary (*this, value_sp->GetAsDictionary ()))
+    {
+        out_stream->Printf ("TestEmulation:  Failed loading 'before' state.\n");
+        return false;
+    }
+
+    value_sp = test_data->GetValueForKey (after_key);
+    if ((value_sp.get() == NULL) || (value_sp->GetType() != OptionValue::eTypeDictionary))
+    {
+        out_stream->Printf ("TestEmulation:  Failed to find 'after' state.\n");
+        return false;
+    }
+    OptionValueDictionary *after_dictionary = value_sp->GetAsDictionary ();
+
+    SetBaton ((void *) &state);
+    SetCallbacks (&EmulationStatePatmos::ReadPseudoMemory,
+                  &EmulationStatePatmos::WritePseudoMemory,
+                  &EmulationStatePatmos::ReadPseudoRegister,
+                  &EmulationStatePatmos::WritePseudoRegister);
+
+    addr_t branch_target = LLDB_INVALID_ADDRESS;
+    if (!EvaluateDelayedBranch (branch_target))
+    {
+        out_stream->Printf ("TestEmulation:  EvaluateDelayedBranch() failed.\n");
+        return false;
+    }
+
+    bool success = false;
+    const addr_t pc = ReadRegisterUnsigned (eRegisterKindDWARF, patmos_pc, LLDB_INVALID_ADDRESS, &success);
+    if (!success || pc != branch_target)
+    {
+        out_stream->Printf ("TestEmulation:  Branch target 0x%" PRIx64 " is not the pc.\n", branch_target);
+        return false;
+    }
+
+    success = state.CompareState (*this, after_dictionary, out_stream);
+    if (!success)
+        out_stream->Printf ("TestEmulation:  'before' and 'after' states do not match.\n");
+    return success;
+}
+
+bool
+EmulateInstructionPatmos::CreateFunctionEntryUnwind (UnwindPlan &unwind_plan)
+{
+    unwind_plan.Clear();
+    unwind_plan.SetRegisterKind (eRegisterKindDWARF);
+
+    UnwindPlan::RowSP row(new UnwindPlan::Row);
+
+    // Nothing has been reserved in the stack cache yet, so the caller's
+    // stack top is ours
+    row->SetCFARegister (SpecialRegister (PATMOS_SREG_ST));
+    row->SetRegisterLocationToIsCFAPlusOffset (SpecialRegister (PATMOS_SREG_ST), 0, true);
+    unwind_plan.AppendRow (row);
+
+    // The return address is srb + sro which can't be expressed without a
+    // DWARF expression; UnwindAssembly_Patmos builds the complete rows.
+
+    unwind_plan.SetSourceName ("EmulateInstructionPatmos");
+    unwind_plan.SetSourcedFromCompiler (eLazyBoolNo);
+    unwind_plan.SetUnwindPlanValidAtAllInstructions (eLazyBoolYes);
+    return true;
+}
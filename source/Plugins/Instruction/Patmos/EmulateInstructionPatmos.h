@@ -0,0 +1,236 @@
+//===-- EmulateInstructionPatmos.h ------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef lldb_EmulateInstructionPatmos_h_
+#define lldb_EmulateInstructionPatmos_h_
+
+#include <vector>
+
+#include "lldb/Core/EmulateInstruction.h"
+#include "lldb/Core/ConstString.h"
+#include "lldb/Core/Error.h"
+#include "Plugins/Process/Utility/PatmosDefines.h"
+
+namespace lldb_private {
+
+//----------------------------------------------------------------------
+// Emulates one Patmos bundle at a time. Both instructions of a bundle
+// read their operands before either of them writes its results, and
+// instructions whose predicate is false have no effect.
+//
+// Control flow is delayed: the bundles in the delay slots of a branch,
+// call or return are executed before the target is reached. With
+// eEmulateInstructionOptionAutoAdvancePC the emulator remembers a taken
+// delayed branch and writes its target to the pc after the last delay
+// slot bundle was evaluated; without it the target is written to the pc
+// right away and GetBranchDelaySlots() says how many bundles still
+// belong to the current path.
+//----------------------------------------------------------------------
+class EmulateInstructionPatmos : public EmulateInstruction
+{
+public:
+    static void
+    Initialize ();
+
+    static void
+    Terminate ();
+
+    static lldb_private::ConstString
+    GetPluginNameStatic ();
+
+    static const char *
+    GetPluginDescriptionStatic ();
+
+    static lldb_private::EmulateInstruction *
+    CreateInstance (const lldb_private::ArchSpec &arch,
+                    InstructionType inst_type);
+
+    static bool
+    SupportsEmulatingIntructionsOfTypeStatic (InstructionType inst_type)
+    {
+        switch (inst_type)
+        {
+            case eInstructionTypeAny:
+            case eInstructionTypePCModifying:
+                return true;
+
+            // The return address lives in srb + sro which the generic
+            // UnwindAssemblyInstEmulation can't describe, UnwindAssembly_Patmos
+            // drives this emulator itself to build unwind plans.
+            case eInstructionTypePrologueEpilogue:
+            case eInstructionTypeAll:
+                return false;
+        }
+        return false;
+    }
+
+    virtual lldb_private::ConstString
+    GetPluginName()
+    {
+        return GetPluginNameStatic();
+    }
+
+    virtual uint32_t
+    GetPluginVersion()
+    {
+        return 1;
+    }
+
+    EmulateInstructionPatmos (const ArchSpec &arch);
+
+    virtual bool
+    SupportsEmulatingIntructionsOfType (InstructionType inst_type)
+    {
+        return SupportsEmulatingIntructionsOfTypeStatic (inst_type);
+    }
+
+    virtual bool
+    SetTargetTriple (const ArchSpec &arch);
+
+    virtual bool
+    ReadInstruction ();
+
+    virtual bool
+    EvaluateInstruction (uint32_t evaluate_options);
+
+    virtual bool
+    TestEmulation (Stream *out_stream, ArchSpec &arch, OptionValueDictionary *test_data);
+
+    virtual bool
+    GetRegisterInfo (uint32_t reg_kind, uint32_t reg_num, RegisterInfo &reg_info);
+
+    virtual bool
+    CreateFunctionEntryUnwind (UnwindPlan &unwind_plan);
+
+    virtual uint32_t
+    GetMaxBranchDelaySlots ();
+
+    // Number of delay slot bundles of the control flow instruction that was
+    // taken in the last evaluated bundle, zero if there was none.
+    uint32_t
+    GetBranchDelaySlots () const
+    {
+        return m_branch_delay_slots;
+    }
+
+    // True while a delayed branch is waiting for its delay slots to be
+    // evaluated (only with eEmulateInstructionOptionAutoAdvancePC).
+    bool
+    HasPendingBranch () const
+    {
+        return m_pending_delay_slots > 0;
+    }
+
+    // Treat every instruction guarded by a predicate other than p0 as not
+    // executed, for walking the path through a function on which the frame
+    // is set up and torn down unconditionally.
+    void
+    SetSkipConditionalInstructions (bool skip)
+    {
+        m_skip_conditional = skip;
+    }
+
+    void
+    ClearPendingBranch ()
+    {
+        m_pending_delay_slots = 0;
+        m_pending_target = LLDB_INVALID_ADDRESS;
+    }
+
+protected:
+
+    // Results of the instructions of a bundle, written back once the whole
+    // bundle has been evaluated.
+    struct PendingWrite
+    {
+        Context context;
+        uint32_t reg_num;       // LLDB_INVALID_REGNUM for memory writes
+        lldb::addr_t addr;
+        uint32_t byte_size;
+        uint64_t value;
+    };
+
+    typedef std::vector<PendingWrite> PendingWriteList;
+
+    // The control flow instruction of the current bundle
+    struct Branch
+    {
+        bool taken;
+        lldb::addr_t target;
+        uint32_t delay_slots;
+        Context context;
+    };
+
+    size_t
+    GetBundle (uint32_t *insns, size_t &num_insns, uint32_t &long_imm, bool &has_long_imm) const;
+
+    bool
+    ReadPredicates ();
+
+    void
+    SetPredicate (uint32_t pd, bool value);
+
+    bool
+    ConditionPassed (uint32_t insn);
+
+    uint32_t
+    ReadGPR (uint32_t reg, bool &success);
+
+    void
+    AddRegisterWrite (const Context &context, uint32_t reg_num, uint64_t value);
+
+    void
+    AddMemoryWrite (const Context &context, lldb::addr_t addr, uint32_t byte_size, uint64_t value);
+
+    lldb::addr_t
+    GetAddressAfterBundles (lldb::addr_t addr, uint32_t num_bundles);
+
+    bool
+    EmulateALUImmediate (uint32_t insn, bool has_long_imm, uint32_t long_imm);
+
+    bool
+    EmulateALURegister (uint32_t insn);
+
+    bool
+    EmulateSPC (uint32_t insn);
+
+    bool
+    EmulateLoad (uint32_t insn);
+
+    bool
+    EmulateStore (uint32_t insn);
+
+    bool
+    EmulateStackControl (uint32_t insn);
+
+    bool
+    EmulateControlFlowImmediate (uint32_t insn);
+
+    bool
+    EmulateControlFlowRegister (uint32_t insn);
+
+    lldb::addr_t m_bundle_addr;         // Address of the bundle being evaluated
+    uint32_t m_bundle_size;
+    uint32_t m_predicates;              // s0 at the start of the bundle
+    uint32_t m_new_predicates;          // s0 after the bundle's compares
+    bool m_predicates_read;
+    bool m_predicates_valid;
+    bool m_ignore_conditions;
+    bool m_skip_conditional;
+    PendingWriteList m_pending_writes;
+    Branch m_branch;
+    uint32_t m_branch_delay_slots;
+    lldb::addr_t m_pending_target;      // Target of a taken delayed branch
+    uint32_t m_pending_delay_slots;     // Delay slot bundles still to go
+    Context m_pending_context;
+};
+
+}   // namespace lldb_private
+
+#endif  // lldb_EmulateInstructionPatmos_h_
@@ -0,0 +1,269 @@
+//===-- EmulationStatePatmos.cpp --------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "EmulationStatePatmos.h"
+
+#include "lldb/Core/RegisterValue.h"
+#include "lldb/Core/Stream.h"
+#include "lldb/Interpreter/OptionValueArray.h"
+#include "lldb/Interpreter/OptionValueDictionary.h"
+
+#include "Plugins/Process/Utility/PatmosDefines.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+EmulationStatePatmos::EmulationStatePatmos (ByteOrder byte_order) :
+    m_byte_order (byte_order),
+    m_registers (),
+    m_memory ()
+{
+}
+
+bool
+EmulationStatePatmos::StorePseudoRegisterValue (uint32_t reg_num, uint64_t value)
+{
+    if (reg_num >= k_num_patmos_registers)
+        return false;
+    m_registers[reg_num] = value;
+    return true;
+}
+
+uint64_t
+EmulationStatePatmos::ReadPseudoRegisterValue (uint32_t reg_num, bool &success)
+{
+    success = reg_num < k_num_patmos_registers;
+    std::map<uint32_t, uint64_t>::const_iterator pos = m_registers.find (reg_num);
+    if (pos == m_registers.end())
+        return 0;
+    return pos->second;
+}
+
+// Reads a "memory" dictionary with the start "address" and an array of
+// 32 bit words as "data".
+bool
+EmulationStatePatmos::LoadMemory (OptionValueDictionary *mem_dict, WordMap &words)
+{
+    static ConstString address_key ("address");
+    static ConstString data_key ("data");
+
+    if (!mem_dict)
+        return false;
+
+    OptionValueSP value_sp = mem_dict->GetValueForKey (address_key);
+    if (value_sp.get() == NULL)
+        return false;
+    addr_t address = value_sp->GetUInt64Value ();
+
+    value_sp = mem_dict->GetValueForKey (data_key);
+    if (value_sp.get() == NULL)
+        return false;
+    OptionValueArray *mem_array = value_sp->GetAsArray();
+    if (!mem_array)
+        return false;
+
+    const size_t num_elts = mem_array->GetSize();
+    for (size_t i = 0; i < num_elts; ++i, address += 4)
+    {
+        value_sp = mem_array->GetValueAtIndex (i);
+        if (value_sp.get() == NULL)
+            return false;
+        words[address] = (uint32_t)value_sp->GetUInt64Value ();
+    }
+    return true;
+}
+
+bool
+EmulationStatePatmos::LoadStateFromDictionary (EmulateInstruction &emulator, OptionValueDictionary *test_data)
+{
+    static ConstString memory_key ("memory");
+    static ConstString registers_key ("registers");
+
+    if (!test_data)
+        return false;
+
+    OptionValueSP value_sp = test_data->GetValueForKey (memory_key);
+    if (value_sp.get() != NULL)
+    {
+        WordMap words;
+        if (!LoadMemory (value_sp->GetAsDictionary(), words))
+            return false;
+        for (WordMap::const_iterator pos = words.begin(), end = words.end(); pos != end; ++pos)
+        {
+            for (uint32_t i = 0; i < 4; ++i)
+            {
+                const uint32_t shift = m_byte_order == eByteOrderBig ? 24 - i * 8 : i * 8;
+                m_memory[pos->first + i] = (uint8_t)(pos->second >> shift);
+            }
+        }
+    }
+
+    value_sp = test_data->GetValueForKey (registers_key);
+    if (value_sp.get() == NULL)
+        return false;
+    OptionValueDictionary *reg_dict = value_sp->GetAsDictionary ();
+    if (!reg_dict)
+        return false;
+
+    for (uint32_t reg_num = 0; reg_num < k_num_patmos_registers; ++reg_num)
+    {
+        RegisterInfo reg_info;
+        if (!emulator.GetRegisterInfo (eRegisterKindDWARF, reg_num, reg_info))
+            return false;
+        value_sp = reg_dict->GetValueForKey (ConstString (reg_info.name));
+        if (value_sp.get() == NULL && reg_info.alt_name)
+            value_sp = reg_dict->GetValueForKey (ConstString (reg_info.alt_name));
+        if (value_sp.get() != NULL)
+            StorePseudoRegisterValue (reg_num, value_sp->GetUInt64Value());
+    }
+    return true;
+}
+
+bool
+EmulationStatePatmos::CompareState (EmulateInstruction &emulator, OptionValueDictionary *expected_data, Stream *out_stream)
+{
+    static ConstString memory_key ("memory");
+    static ConstString registers_key ("registers");
+
+    if (!expected_data)
+        return false;
+
+    bool match = true;
+    OptionValueSP value_sp = expected_data->GetValueForKey (registers_key);
+    OptionValueDictionary *reg_dict = value_sp.get() ? value_sp->GetAsDictionary () : NULL;
+    for (uint32_t reg_num = 0; reg_dict && reg_num < k_num_patmos_registers; ++reg_num)
+    {
+        RegisterInfo reg_info;
+        if (!emulator.GetRegisterInfo (eRegisterKindDWARF, reg_num, reg_info))
+            return false;
+        value_sp = reg_dict->GetValueForKey (ConstString (reg_info.name));
+        if (value_sp.get() == NULL && reg_info.alt_name)
+            value_sp = reg_dict->GetValueForKey (ConstString (reg_info.alt_name));
+        if (value_sp.get() == NULL)
+            continue;
+
+        bool success;
+        const uint64_t value = ReadPseudoRegisterValue (reg_num, success);
+        if (value != value_sp->GetUInt64Value())
+        {
+            out_stream->Printf ("TestEmulation: %s is 0x%" PRIx64 ", expected 0x%" PRIx64 ".\n",
+                                reg_info.name,
+                                value,
+                                value_sp->GetUInt64Value());
+            match = false;
+        }
+    }
+
+    value_sp = expected_data->GetValueForKey (memory_key);
+    if (value_sp.get() != NULL)
+    {
+        WordMap words;
+        if (!LoadMemory (value_sp->GetAsDictionary(), words))
+            return false;
+        for (WordMap::const_iterator pos = words.begin(), end = words.end(); pos != end; ++pos)
+        {
+            uint8_t bytes[4];
+            if (ReadPseudoMemory (&emulator, this, EmulateInstruction::Context(), pos->first, bytes, 4) != 4)
+            {
+                out_stream->Printf ("TestEmulation: memory at 0x%" PRIx64 " is unknown.\n", pos->first);
+                match = false;
+                continue;
+            }
+            uint32_t value = 0;
+            for (uint32_t i = 0; i < 4; ++i)
+            {
+                const uint32_t shift = m_byte_order == eByteOrderBig ? 24 - i * 8 : i * 8;
+                value |= (uint32_t)bytes[i] << shift;
+            }
+            if (value != pos->second)
+            {
+                out_stream->Printf ("TestEmulation: memory at 0x%" PRIx64 " is 0x%8.8x, expected 0x%8.8x.\n",
+                                    pos->first,
+                                    value,
+                                    pos->second);
+                match = false;
+            }
+        }
+    }
+    return match;
+}
+
+size_t
+EmulationStatePatmos::ReadPseudoMemory (EmulateInstruction *instruction,
+                                        void *baton,
+                                        const EmulateInstruction::Context &context,
+                                        lldb::addr_t addr,
+                                        void *dst,
+                                        size_t length)
+{
+    if (!baton)
+        return 0;
+
+    EmulationStatePatmos *pseudo_state = (EmulationStatePatmos *) baton;
+    uint8_t *dst_bytes = (uint8_t *) dst;
+    for (size_t i = 0; i < length; ++i)
+    {
+        std::map<lldb::addr_t, uint8_t>::const_iterator pos = pseudo_state->m_memory.find (addr + i);
+        if (pos == pseudo_state->m_memory.end())
+            return 0;
+        dst_bytes[i] = pos->second;
+    }
+    return length;
+}
+
+size_t
+EmulationStatePatmos::WritePseudoMemory (EmulateInstruction *instruction,
+                                         void *baton,
+                                         const EmulateInstruction::Context &context,
+                                         lldb::addr_t addr,
+                                         const void *dst,
+                                         size_t length)
+{
+    if (!baton)
+        return 0;
+
+    EmulationStatePatmos *pseudo_state = (EmulationStatePatmos *) baton;
+    const uint8_t *src_bytes = (const uint8_t *) dst;
+    for (size_t i = 0; i < length; ++i)
+        pseudo_state->m_memory[addr + i] = src_bytes[i];
+    return length;
+}
+
+bool
+EmulationStatePatmos::ReadPseudoRegister (EmulateInstruction *instruction,
+                                          void *baton,
+                                          const lldb_private::RegisterInfo *reg_info,
+                                          lldb_private::RegisterValue &reg_value)
+{
+    if (!baton || !reg_info)
+        return false;
+
+    bool success = true;
+    EmulationStatePatmos *pseudo_state = (EmulationStatePatmos *) baton;
+    const uint32_t dwarf_reg_num = reg_info->kinds[eRegisterKindDWARF];
+    const uint64_t reg_uval = pseudo_state->ReadPseudoRegisterValue (dwarf_reg_num, success);
+    if (success)
+        success = reg_value.SetUInt (reg_uval, reg_info->byte_size);
+    return success;
+}
+
+bool
+EmulationStatePatmos::WritePseudoRegister (EmulateInstruction *instruction,
+                                           void *baton,
+                                           const EmulateInstruction::Context &context,
+                                           const lldb_private::RegisterInfo *reg_info,
+                                           const lldb_private::RegisterValue &reg_value)
+{
+    if (!baton || !reg_info)
+        return false;
+
+    EmulationStatePatmos *pseudo_state = (EmulationStatePatmos *) baton;
+    const uint32_t dwarf_reg_num = reg_info->kinds[eRegisterKindDWARF];
+    return pseudo_state->StorePseudoRegisterValue (dwarf_reg_num, reg_value.GetAsUInt64());
+}
@@ -0,0 +1,86 @@
+//===-- EmulationStatePatmos.h ----------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef lldb_EmulationStatePatmos_h_
+#define lldb_EmulationStatePatmos_h_
+
+#include <map>
+
+#include "lldb/Core/EmulateInstruction.h"
+
+//----------------------------------------------------------------------
+// Registers and memory of a Patmos emulation test. Registers are kept by
+// their DWARF number and named as in the emulator's RegisterInfo; those a
+// test doesn't mention read as zero. Memory is filled with 32 bit words in
+// the byte order of the target.
+//----------------------------------------------------------------------
+class EmulationStatePatmos {
+public:
+
+    EmulationStatePatmos (lldb::ByteOrder byte_order);
+
+    bool
+    StorePseudoRegisterValue (uint32_t reg_num, uint64_t value);
+
+    uint64_t
+    ReadPseudoRegisterValue (uint32_t reg_num, bool &success);
+
+    bool
+    LoadStateFromDictionary (lldb_private::EmulateInstruction &emulator,
+                             lldb_private::OptionValueDictionary *test_data);
+
+    // Checks that every register and memory word listed in expected_data
+    // has the listed value in this state.
+    bool
+    CompareState (lldb_private::EmulateInstruction &emulator,
+                  lldb_private::OptionValueDictionary *expected_data,
+                  lldb_private::Stream *out_stream);
+
+    static size_t
+    ReadPseudoMemory (lldb_private::EmulateInstruction *instruction,
+                      void *baton,
+                      const lldb_private::EmulateInstruction::Context &context,
+                      lldb::addr_t addr,
+                      void *dst,
+                      size_t length);
+
+    static size_t
+    WritePseudoMemory (lldb_private::EmulateInstruction *instruction,
+                       void *baton,
+                       const lldb_private::EmulateInstruction::Context &context,
+                       lldb::addr_t addr,
+                       const void *dst,
+                       size_t length);
+
+    static bool
+    ReadPseudoRegister (lldb_private::EmulateInstruction *instruction,
+                        void *baton,
+                        const lldb_private::RegisterInfo *reg_info,
+                        lldb_private::RegisterValue &reg_value);
+
+    static bool
+    WritePseudoRegister (lldb_private::EmulateInstruction *instruction,
+                         void *baton,
+                         const lldb_private::EmulateInstruction::Context &context,
+                         const lldb_private::RegisterInfo *reg_info,
+                         const lldb_private::RegisterValue &reg_value);
+private:
+    typedef std::map<lldb::addr_t, uint32_t> WordMap;
+
+    bool
+    LoadMemory (lldb_private::OptionValueDictionary *mem_dict, WordMap &words);
+
+    lldb::ByteOrder m_byte_order;
+    std::map<uint32_t, uint64_t> m_registers;
+    std::map<lldb::addr_t, uint8_t> m_memory;
+
+    DISALLOW_COPY_AND_ASSIGN (EmulationStatePatmos);
+};
+
+#endif  // lldb_EmulationStatePatmos_h_
@@ -0,0 +1,220 @@
+//===-- PatmosDefines.h -----------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef lldb_PatmosDefines_h_
+#define lldb_PatmosDefines_h_
+
+#include "lldb/lldb-defines.h"
+#include "InstructionUtils.h"
+
+// Common definitions for the Patmos Instruction Set Architecture.
+//
+// Patmos instructions are 32 bits wide and stored big endian. Up to two
+// instructions are issued together as a bundle; bit 31 of the first word
+// of a bundle is set when a second word follows. Every instruction is
+// guarded by a predicate in bits 30-27 and the format is selected by the
+// opcode in bits 26-22.
+
+namespace lldb_private {
+
+// General purpose registers with a fixed role in the Patmos ABI
+#define PATMOS_REG_R0           0   // Always zero
+#define PATMOS_REG_RFP         30   // Frame pointer of the shadow stack
+#define PATMOS_REG_RSP         31   // Shadow stack pointer
+
+// Special registers (mts/mfs)
+#define PATMOS_SREG_S0          0   // Predicate registers
+#define PATMOS_SREG_SL          2   // Multiply low
+#define PATMOS_SREG_SH          3   // Multiply high
+#define PATMOS_SREG_SS          5   // Stack cache spill pointer
+#define PATMOS_SREG_ST          6   // Stack cache top pointer
+#define PATMOS_SREG_SRB         7   // Return base (function base of the caller)
+#define PATMOS_SREG_SRO         8   // Return offset (from the return base)
+#define PATMOS_SREG_SXB         9   // Exception return base
+#define PATMOS_SREG_SXO        10   // Exception return offset
+
+#define PATMOS_NUM_PREDICATES   8
+
+// Register numbers used by the Patmos instruction emulator
+enum
+{
+    patmos_r0 = 0,
+    patmos_r30 = 30,
+    patmos_r31 = 31,
+    patmos_s0 = 32,             // s0 - s15 follow the general purpose registers
+    patmos_s15 = 47,
+    patmos_pc = 48,
+    k_num_patmos_registers
+};
+
+// Instruction format opcodes (bits 26-22). ALUi uses only bits 26-25 and
+// CFLi only bits 26-25 with its operation in bits 24-23.
+#define PATMOS_OPC_ALUL      0x1f   // Long immediate ALU, followed by a 32 bit immediate word
+#define PATMOS_OPC_ALU       0x08   // Register ALU/MUL/CMP/PRED
+#define PATMOS_OPC_SPC       0x09   // Special register moves
+#define PATMOS_OPC_LDT       0x0a   // Typed loads
+#define PATMOS_OPC_STT       0x0b   // Typed stores
+#define PATMOS_OPC_STC       0x0c   // Stack cache control
+#define PATMOS_OPC_CFLR      0x18   // Register indirect control flow (delayed)
+#define PATMOS_OPC_CFLR_ND   0x19   // Register indirect control flow (non-delayed)
+
+// ALUi/ALUl functions
+#define PATMOS_ALU_ADD          0
+#define PATMOS_ALU_SUB          1
+#define PATMOS_ALU_XOR          2
+#define PATMOS_ALU_SL           3
+#define PATMOS_ALU_SR           4
+#define PATMOS_ALU_SRA          5
+#define PATMOS_ALU_OR           6
+#define PATMOS_ALU_AND          7
+
+// Register ALU operation classes (bits 6-4), the function is in bits 3-0
+#define PATMOS_ALUR             0   // rd = rs1 op rs2
+#define PATMOS_ALUU             1   // rd = op rs1
+#define PATMOS_ALUM             2   // sl/sh = rs1 * rs2
+#define PATMOS_ALUC             3   // pd = rs1 cmp rs2
+#define PATMOS_ALUP             4   // pd = ps1 op ps2
+
+// Register ALU functions beyond the ALUi ones
+#define PATMOS_ALU_RL           8
+#define PATMOS_ALU_RR           9
+#define PATMOS_ALU_NOR         11
+#define PATMOS_ALU_SHADD       12
+#define PATMOS_ALU_SHADD2      13
+
+// Unary functions
+#define PATMOS_ALUU_SEXT8       4
+#define PATMOS_ALUU_SEXT16      5
+#define PATMOS_ALUU_ZEXT16      6
+#define PATMOS_ALUU_ABS         7
+
+// Multiply functions
+#define PATMOS_ALUM_MUL         0
+#define PATMOS_ALUM_MULU        1
+
+// Compare functions
+#define PATMOS_ALUC_CMPEQ       0
+#define PATMOS_ALUC_CMPNEQ      1
+#define PATMOS_ALUC_CMPLT       2
+#define PATMOS_ALUC_CMPLE       3
+#define PATMOS_ALUC_CMPULT      4
+#define PATMOS_ALUC_CMPULE      5
+#define PATMOS_ALUC_BTEST       6
+
+// Predicate functions
+#define PATMOS_ALUP_POR         6
+#define PATMOS_ALUP_PAND        7
+#define PATMOS_ALUP_PXOR       10
+
+// SPC operations (bits 6-4)
+#define PATMOS_SPC_MTS          2
+#define PATMOS_SPC_MFS          3
+
+// STC operations (bits 21-18)
+#define PATMOS_STC_SRES         0x0
+#define PATMOS_STC_SENS         0x4
+#define PATMOS_STC_SFREE        0x8
+#define PATMOS_STC_SSPILL       0xc
+
+// CFLi operations (bits 24-23)
+#define PATMOS_CFL_CALL         0
+#define PATMOS_CFL_BR           1
+#define PATMOS_CFL_BRCF         2
+#define PATMOS_CFL_TRAP         3
+
+// CFLr operations (bits 3-0)
+#define PATMOS_CFLR_RET         0x0
+#define PATMOS_CFLR_XRET        0x1
+#define PATMOS_CFLR_CALLR       0x4
+#define PATMOS_CFLR_BRR         0x5
+#define PATMOS_CFLR_BRCFR       0x6
+
+// Memory areas of typed loads and stores (low two bits of the type)
+#define PATMOS_MEM_STACK        0   // Stack cache, relative to st
+#define PATMOS_MEM_LOCAL        1   // Local scratchpad
+#define PATMOS_MEM_CACHE        2   // Data cache
+#define PATMOS_MEM_MAIN         3   // Main memory, bypassing the data cache
+
+// Access sizes of typed loads and stores (high three bits of the type)
+#define PATMOS_MEM_WORD         0
+#define PATMOS_MEM_HALF         1
+#define PATMOS_MEM_BYTE         2
+#define PATMOS_MEM_HALF_U       3   // Zero extending loads
+#define PATMOS_MEM_BYTE_U       4
+
+// Number of delay slots of delayed control flow instructions
+#define PATMOS_CALL_DELAY_SLOTS 3
+#define PATMOS_BR_DELAY_SLOTS   2
+#define PATMOS_RET_DELAY_SLOTS  3
+#define PATMOS_BRCF_DELAY_SLOTS 3
+
+static inline bool
+PatmosIsBundled (uint32_t insn)
+{
+    return Bit32 (insn, 31) != 0;
+}
+
+static inline uint32_t
+PatmosPredicate (uint32_t insn)
+{
+    return Bits32 (insn, 29, 27);
+}
+
+static inline bool
+PatmosPredicateIsNegated (uint32_t insn)
+{
+    return Bit32 (insn, 30) != 0;
+}
+
+// True if the instruction is guarded by the always true predicate p0
+static inline bool
+PatmosIsUnconditional (uint32_t insn)
+{
+    return Bits32 (insn, 30, 27) == 0;
+}
+
+static inline uint32_t
+PatmosOpcode (uint32_t insn)
+{
+    return Bits32 (insn, 26, 22);
+}
+
+static inline bool
+PatmosIsALUi (uint32_t insn)
+{
+    return Bits32 (insn, 26, 25) == 0;
+}
+
+static inline bool
+PatmosIsCFLi (uint32_t insn)
+{
+    return Bits32 (insn, 26, 25) == 2;
+}
+
+static inline uint32_t
+PatmosRd (uint32_t insn)
+{
+    return Bits32 (insn, 21, 17);
+}
+
+static inline uint32_t
+PatmosRs1 (uint32_t insn)
+{
+    return Bits32 (insn, 16, 12);
+}
+
+static inline uint32_t
+PatmosRs2 (uint32_t insn)
+{
+    return Bits32 (insn, 11, 7);
+}
+
+}   // namespace lldb_private
+
+#endif  // lldb_PatmosDefines_h_
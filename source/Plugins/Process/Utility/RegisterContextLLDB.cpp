@@ -1411,6 +1411,41 @@ RegisterContextLLDB::GetCFA (addr_t& cfa)
     return true;
 }
 
+bool
+RegisterContextLLDB::GetSavedRegisterMemoryRange (addr_t& low_addr, addr_t& high_addr)
+{
+    if (!IsValid() || m_cfa == LLDB_INVALID_ADDRESS)
+        return false;
+
+    // Only look at the UnwindPlans we already have; computing a full
+    // UnwindPlan just to find out what to prefetch would cost more than
+    // the memory reads we are trying to save.
+    UnwindPlanSP unwind_plans[] = { m_fast_unwind_plan_sp, m_full_unwind_plan_sp };
+    bool found = false;
+    int32_t min_offset = 0;
+    int32_t max_offset = 0;
+    for (size_t i = 0; i < sizeof(unwind_plans)/sizeof(unwind_plans[0]); ++i)
+    {
+        if (!unwind_plans[i])
+            continue;
+        UnwindPlan::RowSP active_row = unwind_plans[i]->GetRowForFunctionOffset (m_current_offset);
+        int32_t row_min_offset, row_max_offset;
+        if (active_row && active_row->GetSavedRegisterOffsetRange (row_min_offset, row_max_offset))
+        {
+            if (!found || row_min_offset < min_offset)
+                min_offset = row_min_offset;
+            if (!found || row_max_offset > max_offset)
+                max_offset = row_max_offset;
+            found = true;
+        }
+    }
+    if (!found)
+        return false;
+
+    low_addr = m_cfa + min_offset;
+    high_addr = m_cfa + max_offset + m_thread.GetProcess()->GetAddressByteSize();
+    return true;
+}
 
 RegisterContextLLDB::SharedPtr
 RegisterContextLLDB::GetNextFrame () const
@@ -81,6 +81,11 @@ public:
     bool
     ReadPC (lldb::addr_t& start_pc);
 
+    // Get the range of memory [low_addr, high_addr) that holds the
+    // registers this frame's UnwindPlans say were saved on the stack.
+    bool
+    GetSavedRegisterMemoryRange (lldb::addr_t& low_addr, lldb::addr_t& high_addr);
+
 private:
 
     enum FrameType
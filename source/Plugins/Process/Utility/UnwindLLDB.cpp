@@ -26,7 +26,11 @@ using namespace lldb_private;
 UnwindLLDB::UnwindLLDB (Thread &thread) :
     Unwind (thread),
     m_frames(),
-    m_unwind_complete(false)
+    m_unwind_complete(false),
+    m_prefetch_addr(LLDB_INVALID_ADDRESS),
+    m_prefetch_end(LLDB_INVALID_ADDRESS),
+    m_prefetch_size(0),
+    m_prefetch_failed_stop_id(UINT32_MAX)
 {
 }
 
@@ -100,6 +104,86 @@ unwind_done:
     return false;
 }
 
+//----------------------------------------------------------------------
+// Reading a caller's registers takes a handful of small memory reads from
+// the stack slots the callee saved them in. Each of those would be a round
+// trip to a remote target, so read ahead a large block of the stack into
+// the process memory cache instead. The block starts at the lowest saved
+// register slot of frame_idx and grows each time the unwind walks off the
+// end of the previous one, so deep backtraces need only a few reads.
+//----------------------------------------------------------------------
+void
+UnwindLLDB::PrefetchStackForFrame (uint32_t frame_idx)
+{
+    if (frame_idx >= m_frames.size())
+        return;
+
+    ProcessSP process_sp (m_thread.GetProcess());
+    if (!process_sp)
+        return;
+
+    const uint64_t min_prefetch_size = process_sp->GetStackPrefetchSize();
+    if (min_prefetch_size == 0)
+        return;
+
+    RegisterContextLLDBSP reg_ctx_sp (m_frames[frame_idx]->reg_ctx_lldb_sp);
+    addr_t low_addr = LLDB_INVALID_ADDRESS;
+    addr_t high_addr = LLDB_INVALID_ADDRESS;
+    if (!reg_ctx_sp || !reg_ctx_sp->GetSavedRegisterMemoryRange (low_addr, high_addr))
+    {
+        // No registers saved on the stack that we know of; the caller's
+        // frame is still found relative to the CFA so read from there.
+        if (!reg_ctx_sp || !reg_ctx_sp->GetCFA (low_addr))
+            return;
+        high_addr = low_addr + process_sp->GetAddressByteSize();
+    }
+    if (high_addr <= low_addr)
+        return;
+
+    // Already prefetched?
+    if (m_prefetch_addr != LLDB_INVALID_ADDRESS && m_prefetch_addr <= low_addr && high_addr <= m_prefetch_end)
+        return;
+
+    // A prefetch already failed at this stop, the rest of this unwind would
+    // most likely fail the same way so leave it to the register reads
+    const uint32_t stop_id = process_sp->GetStopID();
+    if (m_prefetch_failed_stop_id == stop_id)
+        return;
+
+    static const size_t g_max_prefetch_size = 256 * 1024;
+    size_t prefetch_size = std::max<size_t> (min_prefetch_size, m_prefetch_size * 2);
+    if (prefetch_size > g_max_prefetch_size)
+        prefetch_size = std::max<size_t> (min_prefetch_size, g_max_prefetch_size);
+    if (prefetch_size < high_addr - low_addr)
+        prefetch_size = high_addr - low_addr;
+
+    Error error;
+    process_sp->PrefetchMemory (low_addr, prefetch_size, error);
+
+    Log *log(GetLogIfAllCategoriesSet (LIBLLDB_LOG_UNWIND));
+    if (error.Fail())
+    {
+        // Don't remember the range as prefetched, the next stop tries again.
+        // The individual register reads will report any errors.
+        m_prefetch_failed_stop_id = stop_id;
+        if (log)
+            log->Printf ("%*sFrame %u failed to prefetch stack [0x%" PRIx64 " - 0x%" PRIx64 "): %s",
+                         frame_idx < 100 ? frame_idx : 100, "", frame_idx,
+                         (uint64_t)low_addr, (uint64_t)(low_addr + prefetch_size),
+                         error.AsCString());
+        return;
+    }
+
+    m_prefetch_addr = low_addr;
+    m_prefetch_end = low_addr + prefetch_size;
+    m_prefetch_size = prefetch_size;
+
+    if (log)
+        log->Printf ("%*sFrame %u prefetched stack [0x%" PRIx64 " - 0x%" PRIx64 ")",
+                     frame_idx < 100 ? frame_idx : 100, "", frame_idx,
+                     (uint64_t)m_prefetch_addr, (uint64_t)m_prefetch_end);
+}
+
 // For adding a non-zero stack frame to m_frames.
 bool
 UnwindLLDB::AddOneMoreFrame (ABI *abi)
@@ -116,6 +200,11 @@ UnwindLLDB::AddOneMoreFrame (ABI *abi)
         return false;
 
     uint32_t cur_idx = m_frames.size ();
+
+    // The caller's registers are about to be read out of the stack slots
+    // the previous frame saved them in, make sure they're in the memory cache.
+    PrefetchStackForFrame (cur_idx - 1);
+
     RegisterContextLLDBSP reg_ctx_sp(new RegisterContextLLDB (m_thread, 
                                                               m_frames[cur_idx - 1]->reg_ctx_lldb_sp, 
                                                               cursor_sp->sctx, 
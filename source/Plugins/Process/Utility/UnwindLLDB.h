@@ -64,6 +64,9 @@ protected:
     {
         m_frames.clear();
         m_unwind_complete = false;
+        m_prefetch_addr = LLDB_INVALID_ADDRESS;
+        m_prefetch_end = LLDB_INVALID_ADDRESS;
+        m_prefetch_size = 0;
     }
 
     virtual uint32_t
@@ -109,6 +112,12 @@ private:
     bool m_unwind_complete; // If this is true, we've enumerated all the frames in the stack, and m_frames.size() is the 
                             // number of frames, etc.  Otherwise we've only gone as far as directly asked, and m_frames.size()
                             // is how far we've currently gone.
+    lldb::addr_t m_prefetch_addr;   // The range of stack memory [m_prefetch_addr, m_prefetch_end) we have already
+    lldb::addr_t m_prefetch_end;    // asked the process to prefetch into its memory cache while unwinding
+    size_t m_prefetch_size;         // How many bytes we asked for last time; doubles as the unwind walks up the stack
+    uint32_t m_prefetch_failed_stop_id; // The process stop ID at which a prefetch last failed
+
+    void PrefetchStackForFrame (uint32_t frame_idx);
  
 
     bool AddOneMoreFrame (ABI *abi);
@@ -138,6 +138,8 @@ GDBRemoteCommunication::GDBRemoteCommunication(const char *comm_name,
     m_public_is_running (false),
     m_private_is_running (false),
     m_history (512),
+    m_notification_mutex (Mutex::eMutexTypeNormal),
+    m_notifications (),
     m_send_acks (true),
     m_is_platform (is_platform)
 {
@@ -178,6 +180,7 @@ GDBRemoteCommunication::SendAck ()
     if (log)
         log->Printf ("<%4zu> send packet: %c", bytes_written, ch);
     m_history.AddPacket (ch, History::ePacketTypeSend, bytes_written);
+    m_packet_trace.Record (GDBRemotePacketTrace::ePacketTypeSend, &ch, bytes_written);
     return bytes_written;
 }
 
@@ -191,6 +194,7 @@ GDBRemoteCommunication::SendNack ()
     if (log)
         log->Printf ("<%4zu> send packet: %c", bytes_written, ch);
     m_history.AddPacket (ch, History::ePacketTypeSend, bytes_written);
+    m_packet_trace.Record (GDBRemotePacketTrace::ePacketTypeSend, &ch, bytes_written);
     return bytes_written;
 }
 
@@ -229,6 +233,7 @@ GDBRemoteCommunication::SendPacketNoLock (const char *payload, size_t payload_le
         }
 
         m_history.AddPacket (packet.GetString(), packet.GetSize(), History::ePacketTypeSend, bytes_written);
+        m_packet_trace.Record (GDBRemotePacketTrace::ePacketTypeSend, packet.GetData(), bytes_written);
 
 
         if (bytes_written == packet.GetSize())
@@ -253,11 +258,48 @@ GDBRemoteCommunication::SendPacketNoLock (const char *payload, size_t payload_le
     return 0;
 }
 
+size_t
+GDBRemoteCommunication::SendNotificationNoLock (const char *payload, size_t payload_length)
+{
+    if (IsConnected())
+    {
+        // Notifications are never acknowledged
+        StreamString packet(0, 4, eByteOrderBig);
+
+        packet.PutChar('%');
+        packet.Write (payload, payload_length);
+        packet.PutChar('#');
+        packet.PutHex8(CalculcateChecksum (payload, payload_length));
+
+        Log *log (ProcessGDBRemoteLog::GetLogIfAllCategoriesSet (GDBR_LOG_PACKETS));
+        ConnectionStatus status = eConnectionStatusSuccess;
+        size_t bytes_written = Write (packet.GetData(), packet.GetSize(), status, NULL);
+        if (log)
+            log->Printf ("<%4zu> send notification: %.*s", bytes_written, (int)packet.GetSize(), packet.GetData());
+
+        m_history.AddPacket (packet.GetString(), packet.GetSize(), History::ePacketTypeSend, bytes_written);
+        m_packet_trace.Record (GDBRemotePacketTrace::ePacketTypeSend, packet.GetData(), bytes_written);
+        return bytes_written;
+    }
+    return 0;
+}
+
+bool
+GDBRemoteCommunication::GetPendingNotification (std::string &notification)
+{
+    Mutex::Locker locker (m_notification_mutex);
+    if (m_notifications.empty())
+        return false;
+    notification.swap (m_notifications.front());
+    m_notifications.pop_front();
+    return true;
+}
+
 char
 GDBRemoteCommunication::GetAck ()
 {
     StringExtractorGDBRemote packet;
-    if (WaitForPacketWithTimeoutMicroSecondsNoLock (packet, GetPacketTimeoutInMicroSeconds ()) == 1)
+    if (WaitForResponseWithTimeoutMicroSecondsNoLock (packet, GetPacketTimeoutInMicroSeconds ()) == 1)
         return packet.GetChar();
     return 0;
 }
@@ -280,16 +322,23 @@ GDBRemoteCommunication::WaitForNotRunningPrivate (const TimeValue *timeout_ptr)
 }
 
 size_t
-GDBRemoteCommunication::WaitForPacketWithTimeoutMicroSecondsNoLock (StringExtractorGDBRemote &packet, uint32_t timeout_usec)
+GDBRemoteCommunication::WaitForPacketWithTimeoutMicroSecondsNoLock (StringExtractorGDBRemote &packet, uint32_t timeout_usec, bool *got_packet_ptr)
 {
     uint8_t buffer[8192];
     Error error;
 
     Log *log (ProcessGDBRemoteLog::GetLogIfAllCategoriesSet (GDBR_LOG_PACKETS | GDBR_LOG_VERBOSE));
 
+    if (got_packet_ptr)
+        *got_packet_ptr = false;
+
     // Check for a packet from our cache first without trying any reading...
     if (CheckForPacket (NULL, 0, packet))
+    {
+        if (got_packet_ptr)
+            *got_packet_ptr = true;
         return packet.GetStringRef().size();
+    }
 
     bool timed_out = false;
     while (IsConnected() && !timed_out)
@@ -308,7 +357,11 @@ GDBRemoteCommunication::WaitForPacketWithTimeoutMicroSecondsNoLock (StringExtrac
         if (bytes_read > 0)
         {
             if (CheckForPacket (buffer, bytes_read, packet))
+            {
+                if (got_packet_ptr)
+                    *got_packet_ptr = true;
                 return packet.GetStringRef().size();
+            }
         }
         else
         {
@@ -334,6 +387,24 @@ GDBRemoteCommunication::WaitForPacketWithTimeoutMicroSecondsNoLock (StringExtrac
     return 0;
 }
 
+size_t
+GDBRemoteCommunication::WaitForResponseWithTimeoutMicroSecondsNoLock (StringExtractorGDBRemote &response, uint32_t timeout_usec, bool *got_packet_ptr)
+{
+    while (1)
+    {
+        const size_t response_len = WaitForPacketWithTimeoutMicroSecondsNoLock (response, timeout_usec, got_packet_ptr);
+        if (response_len == 0 || !response.IsNotification())
+            return response_len;
+
+        Log *log (ProcessGDBRemoteLog::GetLogIfAllCategoriesSet (GDBR_LOG_PACKETS));
+        if (log)
+            log->Printf ("GDBRemoteCommunication::%s queuing notification: %s", __FUNCTION__, response.GetStringRef().c_str());
+        Mutex::Locker locker (m_notification_mutex);
+        m_notifications.push_back (response.GetStringRef());
+    }
+    return 0;
+}
+
 bool
 GDBRemoteCommunication::CheckForPacket (const uint8_t *src, size_t src_len, StringExtractorGDBRemote &packet)
 {
@@ -376,7 +447,8 @@ GDBRemoteCommunication::CheckForPacket (const uint8_t *src, size_t src_len, Stri
                 break;
 
             case '$':
-                // Look for a standard gdb packet?
+            case '%':
+                // Look for a standard gdb packet or a notification packet?
                 {
                     size_t hash_pos = m_bytes.find('#');
                     if (hash_pos != std::string::npos)
@@ -384,10 +456,12 @@ GDBRemoteCommunication::CheckForPacket (const uint8_t *src, size_t src_len, Stri
                         if (hash_pos + 2 < m_bytes.size())
                         {
                             checksum_idx = hash_pos + 1;
-                            // Skip the dollar sign
-                            content_start = 1; 
+                            // Skip the dollar sign, but keep the '%' of a
+                            // notification so it can't be mistaken for the
+                            // response to a packet we sent
+                            content_start = m_bytes[0] == '$' ? 1 : 0;
                             // Don't include the # in the content or the $ in the content length
-                            content_length = hash_pos - 1;  
+                            content_length = hash_pos - content_start;
                             
                             total_length = hash_pos + 3; // Skip the # and the two hex checksum bytes
                         }
@@ -418,6 +492,7 @@ GDBRemoteCommunication::CheckForPacket (const uint8_t *src, size_t src_len, Stri
                         case '-':
                         case '\x03':
                         case '$':
+                        case '%':
                             done = true;
                             break;
                                 
@@ -463,6 +538,7 @@ GDBRemoteCommunication::CheckForPacket (const uint8_t *src, size_t src_len, Stri
             }
 
             m_history.AddPacket (m_bytes.c_str(), total_length, History::ePacketTypeRecv, total_length);
+            m_packet_trace.Record (GDBRemotePacketTrace::ePacketTypeRecv, m_bytes.c_str(), total_length);
 
             packet_str.assign (m_bytes, content_start, content_length);
             
@@ -12,6 +12,7 @@
 
 // C Includes
 // C++ Includes
+#include <deque>
 #include <list>
 #include <string>
 
@@ -25,6 +26,7 @@
 #include "lldb/Host/TimeValue.h"
 
 #include "Utility/StringExtractorGDBRemote.h"
+#include "GDBRemotePacketTrace.h"
 
 class ProcessGDBRemote;
 
@@ -115,6 +117,24 @@ public:
 
     void
     DumpHistory(lldb_private::Stream &strm);
+
+    //------------------------------------------------------------------
+    // Record every packet sent and received, with timestamps, to a trace
+    // file (see GDBRemotePacketTrace).
+    //------------------------------------------------------------------
+    GDBRemotePacketTrace &
+    GetPacketTrace ()
+    {
+        return m_packet_trace;
+    }
+
+    //------------------------------------------------------------------
+    // Notification packets ("%Stop:T05..." in non-stop mode) that arrive
+    // while waiting for the response to another packet are queued. This
+    // returns the oldest one, including its leading '%'.
+    //------------------------------------------------------------------
+    bool
+    GetPendingNotification (std::string &notification);
     
 protected:
 
@@ -227,13 +247,27 @@ protected:
     SendPacket (const char *payload,
                 size_t payload_length);
 
-    size_t
+    virtual size_t
     SendPacketNoLock (const char *payload, 
                       size_t payload_length);
 
+    size_t
+    SendNotificationNoLock (const char *payload,
+                            size_t payload_length);
+
+    // If got_packet_ptr is given it is set to whether a packet arrived at
+    // all, which tells an empty packet apart from a timeout
     size_t
     WaitForPacketWithTimeoutMicroSecondsNoLock (StringExtractorGDBRemote &response, 
-                                                uint32_t timeout_usec);
+                                                uint32_t timeout_usec,
+                                                bool *got_packet_ptr = NULL);
+
+    // Like WaitForPacketWithTimeoutMicroSecondsNoLock(), but notification
+    // packets are queued instead of being returned as the response
+    size_t
+    WaitForResponseWithTimeoutMicroSecondsNoLock (StringExtractorGDBRemote &response,
+                                                  uint32_t timeout_usec,
+                                                  bool *got_packet_ptr = NULL);
 
     bool
     WaitForNotRunningPrivate (const lldb_private::TimeValue *timeout_ptr);
@@ -250,6 +284,9 @@ protected:
     lldb_private::Predicate<bool> m_public_is_running;
     lldb_private::Predicate<bool> m_private_is_running;
     History m_history;
+    GDBRemotePacketTrace m_packet_trace;
+    lldb_private::Mutex m_notification_mutex;
+    std::deque<std::string> m_notifications;
     bool m_send_acks;
     bool m_is_platform; // Set to true if this class represents a platform,
                         // false if this class represents a debug session for
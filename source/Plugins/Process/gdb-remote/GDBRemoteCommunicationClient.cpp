@@ -56,6 +56,9 @@ GDBRemoteCommunicationClient::GDBRemoteCommunicationClient(bool is_platform) :
     m_watchpoints_trigger_after_instruction(eLazyBoolCalculate),
     m_attach_or_wait_reply(eLazyBoolCalculate),
     m_prepare_for_reg_writing_reply (eLazyBoolCalculate),
+    m_qSupported_is_valid (eLazyBoolCalculate),
+    m_supports_QNonStop (eLazyBoolCalculate),
+    m_supports_qMultiThreadStopInfo (eLazyBoolCalculate),
     m_supports_qProcessInfoPID (true),
     m_supports_qfProcessInfo (true),
     m_supports_qUserName (true),
@@ -69,11 +72,17 @@ GDBRemoteCommunicationClient::GDBRemoteCommunicationClient(bool is_platform) :
     m_curr_tid (LLDB_INVALID_THREAD_ID),
     m_curr_tid_run (LLDB_INVALID_THREAD_ID),
     m_num_supported_hardware_watchpoints (0),
+    m_max_packet_size (0),
     m_async_mutex (Mutex::eMutexTypeRecursive),
     m_async_packet_predicate (false),
     m_async_packet (),
     m_async_response (),
     m_async_signal (-1),
+    m_non_stop_mode (false),
+    m_non_stop_running (false),
+    m_non_stop_mutex (Mutex::eMutexTypeNormal),
+    m_non_stop_requests (),
+    m_pending_stop_replies (),
     m_thread_id_to_used_usec_map (),
     m_host_arch(),
     m_process_arch(),
@@ -95,6 +104,14 @@ GDBRemoteCommunicationClient::~GDBRemoteCommunicationClient()
 bool
 GDBRemoteCommunicationClient::HandshakeWithServer (Error *error_ptr)
 {
+    // The qSupported features belong to the stub at the other end of the
+    // connection. ResetDiscoverableSettings() keeps them across an exec,
+    // but a new connection may be to a different stub.
+    m_qSupported_is_valid = eLazyBoolCalculate;
+    m_supports_QNonStop = eLazyBoolCalculate;
+    m_supports_qMultiThreadStopInfo = eLazyBoolCalculate;
+    m_max_packet_size = 0;
+
     // Start the read thread after we send the handshake ack since if we
     // fail to send the handshake ack, there is no reason to continue...
     if (SendAck())
@@ -214,6 +231,95 @@ GDBRemoteCommunicationClient::ResetDiscoverableSettings()
 }
 
 
+uint64_t
+GDBRemoteCommunicationClient::GetRemoteMaxPacketSize ()
+{
+    GetRemoteQSupported ();
+    return m_max_packet_size;
+}
+
+bool
+GDBRemoteCommunicationClient::GetNonStopModeSupported ()
+{
+    GetRemoteQSupported ();
+    return m_supports_QNonStop == eLazyBoolYes;
+}
+
+bool
+GDBRemoteCommunicationClient::SetNonStopMode (bool enable)
+{
+    StringExtractorGDBRemote response;
+    if (SendPacketAndWaitForResponse (enable ? "QNonStop:1" : "QNonStop:0", response, false))
+    {
+        if (response.IsOKResponse())
+        {
+            m_non_stop_mode = enable;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool
+GDBRemoteCommunicationClient::GetPendingStopReply (StringExtractorGDBRemote &response)
+{
+    Mutex::Locker non_stop_locker (m_non_stop_mutex);
+    if (m_pending_stop_replies.empty())
+        return false;
+    response.GetStringRef().swap (m_pending_stop_replies.front());
+    response.SetFilePos (0);
+    m_pending_stop_replies.pop_front();
+    return true;
+}
+
+void
+GDBRemoteCommunicationClient::GetRemoteQSupported ()
+{
+    if (m_qSupported_is_valid == eLazyBoolCalculate)
+    {
+        // SendPacketAndWaitForResponse() returns the same zero length for
+        // the empty "unsupported" reply of a stub without qSupported as for
+        // no reply at all, so wait for the response ourselves.
+        StringExtractorGDBRemote response;
+        bool got_response = false;
+        Mutex::Locker locker;
+        if (GetSequenceMutex (locker))
+        {
+            const char *payload = "qSupported";
+            if (SendPacketNoLock (payload, ::strlen (payload)))
+                WaitForResponseWithTimeoutMicroSecondsNoLock (response, GetPacketTimeoutInMicroSeconds (), &got_response);
+        }
+
+        if (got_response)
+        {
+            // We got an answer, even an error or empty one tells us all
+            // we will ever learn from this stub. If the packet didn't make
+            // it we stay in eLazyBoolCalculate and ask again next time.
+            m_qSupported_is_valid = eLazyBoolNo;
+            m_supports_QNonStop = eLazyBoolNo;
+            m_supports_qMultiThreadStopInfo = eLazyBoolNo;
+            m_max_packet_size = 0;
+
+            if (response.IsNormalResponse())
+            {
+                m_qSupported_is_valid = eLazyBoolYes;
+                // The response is a list of semicolon separated features
+                // of the form "name=value", "name+" or "name-".
+                const char *packet_size_cstr = ::strstr (response.GetStringRef().c_str(), "PacketSize=");
+                if (packet_size_cstr)
+                {
+                    StringExtractor packet_size_extractor (packet_size_cstr + strlen("PacketSize="));
+                    m_max_packet_size = packet_size_extractor.GetHexMaxU64 (false, 0);
+                }
+                if (::strstr (response.GetStringRef().c_str(), "QNonStop+"))
+                    m_supports_QNonStop = eLazyBoolYes;
+                if (::strstr (response.GetStringRef().c_str(), "qMultiThreadStopInfo+"))
+                    m_supports_qMultiThreadStopInfo = eLazyBoolYes;
+            }
+        }
+    }
+}
+
 bool
 GDBRemoteCommunicationClient::GetThreadSuffixSupported ()
 {
@@ -317,7 +423,7 @@ GDBRemoteCommunicationClient::SendPacketAndWaitForResponse
     if (GetSequenceMutex (locker))
     {
         if (SendPacketNoLock (payload, payload_length))
-           response_len = WaitForPacketWithTimeoutMicroSecondsNoLock (response, GetPacketTimeoutInMicroSeconds ());
+           response_len = WaitForResponseWithTimeoutMicroSecondsNoLock (response, GetPacketTimeoutInMicroSeconds ());
         else 
         {
             if (log)
@@ -328,7 +434,13 @@ GDBRemoteCommunicationClient::SendPacketAndWaitForResponse
     {
         if (send_async)
         {
-            if (IsRunning())
+            if (IsRunning() && m_non_stop_mode)
+            {
+                // The stub keeps accepting packets while threads run, no
+                // need to interrupt the target
+                response_len = SendNonStopAsyncPacket (payload, payload_length, response);
+            }
+            else if (IsRunning())
             {
                 Mutex::Locker async_locker (m_async_mutex);
                 m_async_packet.assign(payload, payload_length);
@@ -391,7 +503,7 @@ GDBRemoteCommunicationClient::SendPacketAndWaitForResponse
                             log->Printf ("async: got lock without sending interrupt");
                         // Send the packet normally since we got the lock
                         if (SendPacketNoLock (payload, payload_length))
-                            response_len = WaitForPacketWithTimeoutMicroSecondsNoLock (response, GetPacketTimeoutInMicroSeconds ());
+                            response_len = WaitForResponseWithTimeoutMicroSecondsNoLock (response, GetPacketTimeoutInMicroSeconds ());
                         else 
                         {
                             if (log)
@@ -527,6 +639,9 @@ GDBRemoteCommunicationClient::SendContinuePacketAndWaitForResponse
     StringExtractorGDBRemote &response
 )
 {
+    if (m_non_stop_mode)
+        return SendContinuePacketAndWaitForStopNotification (process, payload, packet_length, response);
+
     m_curr_tid = LLDB_INVALID_THREAD_ID;
     Log *log (ProcessGDBRemoteLog::GetLogIfAllCategoriesSet (GDBR_LOG_PROCESS));
     if (log)
@@ -806,9 +921,241 @@ GDBRemoteCommunicationClient::SendContinuePacketAndWaitForResponse
     return state;
 }
 
+//----------------------------------------------------------------------
+// Non-stop mode version of SendContinuePacketAndWaitForResponse(). The
+// stub answers the resume packet with "OK" right away and keeps answering
+// packets while threads run. The first thread to stop is reported with a
+// "%Stop:<stop reply>" notification, after which "vStopped" is sent until
+// the stub answers "OK" to collect the stop replies of any other threads
+// that stopped. Responses come back in the order the packets were sent,
+// which m_non_stop_requests keeps track of. An empty packet waits for
+// threads that are already running without resuming any.
+//----------------------------------------------------------------------
+StateType
+GDBRemoteCommunicationClient::SendContinuePacketAndWaitForStopNotification
+(
+    ProcessGDBRemote *process,
+    const char *payload,
+    size_t packet_length,
+    StringExtractorGDBRemote &response
+)
+{
+    m_curr_tid = LLDB_INVALID_THREAD_ID;
+    Log *log (ProcessGDBRemoteLog::GetLogIfAllCategoriesSet (GDBR_LOG_PROCESS));
+    if (log)
+        log->Printf ("GDBRemoteCommunicationClient::%s ()", __FUNCTION__);
+
+    Mutex::Locker locker(m_sequence_mutex);
+    StateType state = eStateRunning;
+
+    {
+        Mutex::Locker non_stop_locker (m_non_stop_mutex);
+        m_non_stop_requests.clear();
+        m_pending_stop_replies.clear();
+        m_non_stop_running = true;
+    }
+
+    BroadcastEvent(eBroadcastBitRunPacketSent, NULL);
+    m_public_is_running.SetValue (true, eBroadcastNever);
+
+    if (packet_length == 0)
+    {
+        m_private_is_running.SetValue (true, eBroadcastAlways);
+    }
+    else
+    {
+        if (log)
+            log->Printf ("GDBRemoteCommunicationClient::%s () sending continue packet: %.*s", __FUNCTION__, (int)packet_length, payload);
+        if (!SendNonStopRequestNoLock (payload, packet_length, eNonStopRequestResume))
+            state = eStateInvalid;
+    }
+
+    std::string stop_reply;
+    std::string notification;
+    std::vector<std::string> later_notifications;
+    while (1)
+    {
+        if (state != eStateRunning)
+        {
+            // Packets other threads sent while we were running still need
+            // their responses before we give up the connection
+            Mutex::Locker non_stop_locker (m_non_stop_mutex);
+            if (state == eStateInvalid || m_non_stop_requests.empty())
+            {
+                m_non_stop_running = false;
+                break;
+            }
+        }
+
+        // Threads that stopped while we weren't running were reported with
+        // notifications that got queued, handle those first
+        if (GetPendingNotification (notification))
+        {
+            response.GetStringRef().swap (notification);
+            response.SetFilePos (0);
+        }
+        else if (WaitForPacketWithTimeoutMicroSecondsNoLock (response, UINT32_MAX) == 0)
+        {
+            if (log)
+                log->Printf ("GDBRemoteCommunicationClient::%s () WaitForPacket(...) => false", __FUNCTION__);
+            state = eStateInvalid;
+            continue;
+        }
+
+        const std::string &packet_str = response.GetStringRef();
+        if (log)
+            log->Printf ("GDBRemoteCommunicationClient::%s () got packet: %s", __FUNCTION__, packet_str.c_str());
+
+        if (response.IsNotification())
+        {
+            if (packet_str.compare (0, 6, "%Stop:") == 0 && stop_reply.empty() && state == eStateRunning)
+            {
+                stop_reply.assign (packet_str, 6, std::string::npos);
+                if (!SendNonStopRequestNoLock ("vStopped", 8, eNonStopRequestStopped))
+                    state = eStateInvalid;
+            }
+            else
+            {
+                // The stub sends no new "%Stop" until "vStopped" returned
+                // "OK", so this one is for the next continue
+                later_notifications.push_back (packet_str);
+            }
+            continue;
+        }
+
+        NonStopRequest request;
+        {
+            Mutex::Locker non_stop_locker (m_non_stop_mutex);
+            if (m_non_stop_requests.empty())
+            {
+                if (log)
+                    log->Printf ("GDBRemoteCommunicationClient::%s () ignoring unrequested packet", __FUNCTION__);
+                continue;
+            }
+            request = m_non_stop_requests.front();
+            m_non_stop_requests.pop_front();
+        }
+
+        switch (request)
+        {
+        case eNonStopRequestResume:
+            if (response.IsOKResponse())
+                m_private_is_running.SetValue (true, eBroadcastAlways);
+            else
+                state = eStateInvalid;
+            break;
+
+        case eNonStopRequestAsync:
+            // Let the thread that sent the packet know its response is ready
+            m_async_response.GetStringRef().swap (response.GetStringRef());
+            m_async_packet_predicate.SetValue (false, eBroadcastAlways);
+            break;
+
+        case eNonStopRequestStopped:
+            if (!response.IsNormalResponse())
+            {
+                // "OK" once all stopped threads have been reported
+                if (stop_reply[0] == 'W' || stop_reply[0] == 'X')
+                    state = eStateExited;
+                else
+                    state = eStateStopped;
+            }
+            else
+            {
+                {
+                    Mutex::Locker non_stop_locker (m_non_stop_mutex);
+                    m_pending_stop_replies.push_back (packet_str);
+                }
+                if (!SendNonStopRequestNoLock ("vStopped", 8, eNonStopRequestStopped))
+                    state = eStateInvalid;
+            }
+            break;
+        }
+    }
+
+    if (!later_notifications.empty())
+    {
+        Mutex::Locker notification_locker (m_notification_mutex);
+        m_notifications.insert (m_notifications.end(), later_notifications.begin(), later_notifications.end());
+    }
+
+    if (log)
+        log->Printf ("GDBRemoteCommunicationClient::%s () => %s", __FUNCTION__, StateAsCString(state));
+    response.GetStringRef().swap (stop_reply);
+    response.SetFilePos(0);
+    m_private_is_running.SetValue (false, eBroadcastAlways);
+    m_public_is_running.SetValue (false, eBroadcastAlways);
+    return state;
+}
+
+bool
+GDBRemoteCommunicationClient::SendNonStopRequestNoLock (const char *payload,
+                                                        size_t payload_length,
+                                                        NonStopRequest request)
+{
+    // Hold the mutex across the send so that m_non_stop_requests stays in
+    // the order the packets went out, and so that no packet is sent after
+    // the continue stopped listening for responses
+    Mutex::Locker non_stop_locker (m_non_stop_mutex);
+    if (!m_non_stop_running)
+        return false;
+    if (SendPacketNoLock (payload, payload_length) == 0)
+        return false;
+    m_non_stop_requests.push_back (request);
+    return true;
+}
+
+size_t
+GDBRemoteCommunicationClient::SendNonStopAsyncPacket (const char *payload,
+                                                      size_t payload_length,
+                                                      StringExtractorGDBRemote &response)
+{
+    Log *log (ProcessGDBRemoteLog::GetLogIfAllCategoriesSet (GDBR_LOG_PACKETS));
+    Mutex::Locker async_locker (m_async_mutex);
+    m_async_packet.assign(payload, payload_length);
+    m_async_packet_predicate.SetValue (true, eBroadcastNever);
+
+    if (log)
+        log->Printf ("async: non-stop packet = %s", m_async_packet.c_str());
+
+    if (!SendNonStopRequestNoLock (payload, payload_length, eNonStopRequestAsync))
+    {
+        if (log)
+            log->Printf ("async: not running, async is ignored");
+        m_async_packet_predicate.SetValue (false, eBroadcastNever);
+        return 0;
+    }
+
+    TimeValue timeout_time;
+    timeout_time = TimeValue::Now();
+    timeout_time.OffsetWithSeconds (m_packet_timeout);
+    bool timed_out = false;
+    if (m_async_packet_predicate.WaitForValueEqualTo (false, &timeout_time, &timed_out))
+    {
+        // Swap the response buffer to avoid malloc and string copy
+        response.GetStringRef().swap (m_async_response.GetStringRef());
+        response.SetFilePos (0);
+        return response.GetStringRef().size();
+    }
+
+    if (log)
+        log->Printf ("async: timed out waiting for response");
+    return 0;
+}
+
 bool
 GDBRemoteCommunicationClient::SendAsyncSignal (int signo)
 {
+    if (m_non_stop_mode)
+    {
+        // Signals are delivered per thread in non-stop mode and there is
+        // no thread to deliver this one to
+        Log *log (ProcessGDBRemoteLog::GetLogIfAllCategoriesSet (GDBR_LOG_PROCESS));
+        if (log)
+            log->Printf ("async: can't send signal %i in non-stop mode", signo);
+        return false;
+    }
+
     Mutex::Locker async_locker (m_async_mutex);
     m_async_signal = signo;
     bool timed_out = false;
@@ -852,11 +1199,24 @@ GDBRemoteCommunicationClient::SendInterrupt
         {
             // Someone has the mutex locked waiting for a response or for the
             // inferior to stop, so send the interrupt on the down low...
-            char ctrl_c = '\x03';
-            ConnectionStatus status = eConnectionStatusSuccess;
-            size_t bytes_written = Write (&ctrl_c, 1, status, NULL);
-            if (log)
-                log->PutCString("send packet: \\x03");
+            size_t bytes_written = 0;
+            if (m_non_stop_mode)
+            {
+                // There is no interrupt character in non-stop mode, ask the
+                // stub to stop all threads instead
+                StringExtractorGDBRemote stop_response;
+                if (SendNonStopAsyncPacket ("vCont;t", 7, stop_response) && stop_response.IsOKResponse())
+                    bytes_written = stop_response.GetStringRef().size();
+            }
+            else
+            {
+                char ctrl_c = '\x03';
+                ConnectionStatus status = eConnectionStatusSuccess;
+                bytes_written = Write (&ctrl_c, 1, status, NULL);
+                if (log)
+                    log->PutCString("send packet: \\x03");
+                m_packet_trace.Record (GDBRemotePacketTrace::ePacketTypeSend, &ctrl_c, bytes_written);
+            }
             if (bytes_written > 0)
             {
                 m_interrupt_sent = true;
@@ -2237,6 +2597,52 @@ GDBRemoteCommunicationClient::GetThreadStopInfo (lldb::tid_t tid, StringExtracto
     return false;
 }
 
+bool
+GDBRemoteCommunicationClient::GetMultiThreadStopInfoSupported ()
+{
+    GetRemoteQSupported ();
+    return m_supports_qMultiThreadStopInfo == eLazyBoolYes;
+}
+
+size_t
+GDBRemoteCommunicationClient::GetThreadStopInfos (const std::vector<lldb::tid_t> &tids,
+                                                  std::vector<std::string> &stop_replies)
+{
+    stop_replies.clear();
+    if (tids.empty() || !GetMultiThreadStopInfoSupported ())
+        return 0;
+
+    StreamString packet;
+    packet.PutCString ("qMultiThreadStopInfo:");
+    for (size_t i = 0; i < tids.size(); ++i)
+        packet.Printf ("%s%" PRIx64, i > 0 ? "," : "", tids[i]);
+
+    StringExtractorGDBRemote response;
+    if (SendPacketAndWaitForResponse (packet.GetData(), packet.GetSize(), response, false))
+    {
+        if (response.IsUnsupportedResponse())
+        {
+            m_supports_qMultiThreadStopInfo = eLazyBoolNo;
+            return 0;
+        }
+        if (!response.IsNormalResponse())
+            return 0;
+
+        const std::string &response_str = response.GetStringRef();
+        size_t pos = 0;
+        while (pos < response_str.size())
+        {
+            size_t end_pos = response_str.find ('|', pos);
+            if (end_pos == std::string::npos)
+                end_pos = response_str.size();
+            if (end_pos > pos)
+                stop_replies.push_back (response_str.substr (pos, end_pos - pos));
+            pos = end_pos + 1;
+        }
+    }
+    return stop_replies.size();
+}
+
 
 uint8_t
 GDBRemoteCommunicationClient::SendGDBStoppointTypePacket (GDBStoppointType type, bool insert,  addr_t addr, uint32_t length)
@@ -2295,9 +2701,9 @@ GDBRemoteCommunicationClient::GetCurrentThreadIDs (std::vector<lldb::tid_t> &thr
         sequence_mutex_unavailable = false;
         StringExtractorGDBRemote response;
         
-        for (SendPacketNoLock ("qfThreadInfo", strlen("qfThreadInfo")) && WaitForPacketWithTimeoutMicroSecondsNoLock (response, GetPacketTimeoutInMicroSeconds ());
+        for (SendPacketNoLock ("qfThreadInfo", strlen("qfThreadInfo")) && WaitForResponseWithTimeoutMicroSecondsNoLock (response, GetPacketTimeoutInMicroSeconds ());
              response.IsNormalResponse();
-             SendPacketNoLock ("qsThreadInfo", strlen("qsThreadInfo")) && WaitForPacketWithTimeoutMicroSecondsNoLock (response, GetPacketTimeoutInMicroSeconds ()))
+             SendPacketNoLock ("qsThreadInfo", strlen("qsThreadInfo")) && WaitForResponseWithTimeoutMicroSecondsNoLock (response, GetPacketTimeoutInMicroSeconds ()))
         {
             char ch = response.GetChar();
             if (ch == 'l')
@@ -12,6 +12,7 @@
 
 // C Includes
 // C++ Includes
+#include <deque>
 #include <vector>
 
 // Other libraries and framework includes
@@ -233,6 +234,42 @@ public:
     void
     ResetDiscoverableSettings();
 
+    //------------------------------------------------------------------
+    /// Query the remote stub's features with the "qSupported" packet.
+    ///
+    /// @return
+    ///     The "PacketSize" the remote stub reported in its qSupported
+    ///     response, or zero if the stub didn't report one.
+    //------------------------------------------------------------------
+    uint64_t
+    GetRemoteMaxPacketSize ();
+
+    //------------------------------------------------------------------
+    // Non-stop mode ("QNonStop:1"): the stub stops and resumes threads
+    // individually, acknowledges resume packets with "OK" and reports
+    // each stopped thread with a "%Stop" notification. Requires no-ack
+    // mode since packets are sent from other threads while running.
+    //------------------------------------------------------------------
+    bool
+    GetNonStopModeSupported ();
+
+    bool
+    SetNonStopMode (bool enable);
+
+    bool
+    GetNonStopMode () const
+    {
+        return m_non_stop_mode;
+    }
+
+    //------------------------------------------------------------------
+    // In non-stop mode, returns the stop replies collected with
+    // "vStopped" for threads other than the one whose stop ended the
+    // last continue, one per call.
+    //------------------------------------------------------------------
+    bool
+    GetPendingStopReply (StringExtractorGDBRemote &response);
+
     bool
     GetHostInfo (bool force = false);
     
@@ -300,6 +337,23 @@ public:
     GetThreadStopInfo (lldb::tid_t tid, 
                        StringExtractorGDBRemote &response);
 
+    //------------------------------------------------------------------
+    // Multi-core targets report every core as a thread and usually stop
+    // all of them together. Stubs that advertise "qMultiThreadStopInfo+"
+    // in qSupported return the stop replies of many threads at once:
+    //
+    //   qMultiThreadStopInfo:TID[,TID...]
+    //
+    // is answered with the "T" stop replies of the listed threads,
+    // separated by '|'. Thread names must be sent with "hexname".
+    //------------------------------------------------------------------
+    bool
+    GetMultiThreadStopInfoSupported ();
+
+    size_t
+    GetThreadStopInfos (const std::vector<lldb::tid_t> &tids,
+                        std::vector<std::string> &stop_replies);
+
     bool
     SupportsGDBStoppointPacket (GDBStoppointType type)
     {
@@ -361,9 +415,36 @@ public:
     
 protected:
 
+    // Who a response received while running in non-stop mode is for
+    enum NonStopRequest
+    {
+        eNonStopRequestResume,  // The resume packet, answered with "OK"
+        eNonStopRequestAsync,   // A packet sent by another thread while running
+        eNonStopRequestStopped  // A "vStopped" packet
+    };
+
     bool
     GetCurrentProcessInfo ();
 
+    void
+    GetRemoteQSupported ();
+
+    lldb::StateType
+    SendContinuePacketAndWaitForStopNotification (ProcessGDBRemote *process,
+                                                  const char *packet_payload,
+                                                  size_t packet_length,
+                                                  StringExtractorGDBRemote &response);
+
+    bool
+    SendNonStopRequestNoLock (const char *payload,
+                              size_t payload_length,
+                              NonStopRequest request);
+
+    size_t
+    SendNonStopAsyncPacket (const char *payload,
+                            size_t payload_length,
+                            StringExtractorGDBRemote &response);
+
     //------------------------------------------------------------------
     // Classes that inherit from GDBRemoteCommunicationClient can see and modify these
     //------------------------------------------------------------------
@@ -385,6 +466,9 @@ protected:
     lldb_private::LazyBool m_watchpoints_trigger_after_instruction;
     lldb_private::LazyBool m_attach_or_wait_reply;
     lldb_private::LazyBool m_prepare_for_reg_writing_reply;
+    lldb_private::LazyBool m_qSupported_is_valid;
+    lldb_private::LazyBool m_supports_QNonStop;
+    lldb_private::LazyBool m_supports_qMultiThreadStopInfo;
     
     bool
         m_supports_qProcessInfoPID:1,
@@ -404,6 +488,7 @@ protected:
 
 
     uint32_t m_num_supported_hardware_watchpoints;
+    uint64_t m_max_packet_size;     // The "PacketSize" from the qSupported response, zero if unknown
 
     // If we need to send a packet while the target is running, the m_async_XXX
     // member variables take care of making this happen.
@@ -414,6 +499,14 @@ protected:
     int m_async_signal; // We were asked to deliver a signal to the inferior process.
     bool m_interrupt_sent;
     std::string m_partial_profile_data;
+
+    // Non-stop mode: m_non_stop_requests lists the packets sent while
+    // running that haven't been answered yet, in the order they were sent
+    bool m_non_stop_mode;
+    bool m_non_stop_running;
+    lldb_private::Mutex m_non_stop_mutex;
+    std::deque<NonStopRequest> m_non_stop_requests;
+    std::deque<std::string> m_pending_stop_replies;
     std::map<uint64_t, uint32_t> m_thread_id_to_used_usec_map;
     
     lldb_private::ArchSpec m_host_arch;
@@ -11,6 +11,9 @@
 #include "GDBRemoteCommunicationServer.h"
 
 // C Includes
+#include <sys/socket.h>
+#include <unistd.h>
+
 // C++ Includes
 // Other libraries and framework includes
 #include "llvm/ADT/Triple.h"
@@ -43,7 +46,10 @@ GDBRemoteCommunicationServer::GDBRemoteCommunicationServer(bool is_platform) :
     m_proc_infos (),
     m_proc_infos_index (0),
     m_lo_port_num (0),
-    m_hi_port_num (0)
+    m_hi_port_num (0),
+    m_in_process_thread (LLDB_INVALID_HOST_THREAD),
+    m_in_process_server_fd (-1),
+    m_in_process_client_fd (-1)
 {
 }
 
@@ -52,6 +58,88 @@ GDBRemoteCommunicationServer::GDBRemoteCommunicationServer(bool is_platform) :
 //----------------------------------------------------------------------
 GDBRemoteCommunicationServer::~GDBRemoteCommunicationServer()
 {
+    StopServingInProcess ();
+}
+
+Error
+GDBRemoteCommunicationServer::StartServingInProcess (std::string &client_url)
+{
+    Error error;
+    int fds[2];
+    if (::socketpair (AF_UNIX, SOCK_STREAM, 0, fds) != 0)
+    {
+        error.SetErrorToErrno ();
+        return error;
+    }
+    m_in_process_server_fd = fds[0];
+    m_in_process_client_fd = fds[1];
+    SetConnection (new ConnectionFileDescriptor (m_in_process_server_fd, true));
+
+    m_in_process_thread = Host::ThreadCreate ("<lldb.gdb-remote.in-process-server>",
+                                              GDBRemoteCommunicationServer::InProcessServerThread,
+                                              this,
+                                              &error);
+    if (!IS_VALID_LLDB_HOST_THREAD(m_in_process_thread))
+    {
+        StopServingInProcess ();
+        if (error.Success())
+            error.SetErrorString ("unable to start the server thread");
+        return error;
+    }
+
+    StreamString url;
+    url.Printf ("fd://%i", m_in_process_client_fd);
+    client_url = url.GetString();
+    return error;
+}
+
+void
+GDBRemoteCommunicationServer::StopServingInProcess ()
+{
+    if (IS_VALID_LLDB_HOST_THREAD(m_in_process_thread))
+    {
+        // Shutting the socket down makes the blocked read in the server
+        // thread return end of file
+        ::shutdown (m_in_process_server_fd, SHUT_RDWR);
+        Host::ThreadJoin (m_in_process_thread, NULL, NULL);
+        m_in_process_thread = LLDB_INVALID_HOST_THREAD;
+    }
+
+    if (m_in_process_server_fd >= 0)
+    {
+        // The connection owns the server side of the socket pair
+        Disconnect ();
+        m_in_process_server_fd = -1;
+    }
+
+    // Clients connect with "fd://" which never takes ownership
+    if (m_in_process_client_fd >= 0)
+    {
+        ::close (m_in_process_client_fd);
+        m_in_process_client_fd = -1;
+    }
+}
+
+void *
+GDBRemoteCommunicationServer::InProcessServerThread (void *arg)
+{
+    GDBRemoteCommunicationServer *server = (GDBRemoteCommunicationServer *)arg;
+    Error error;
+    if (server->HandshakeWithClient (&error))
+    {
+        bool interrupt = false;
+        bool done = false;
+        while (!done)
+        {
+            if (!server->GetPacketAndSendResponse (UINT32_MAX, error, interrupt, done))
+                break;
+        }
+    }
+
+    Log *log (ProcessGDBRemoteLog::GetLogIfAllCategoriesSet (GDBR_LOG_PROCESS));
+    if (log && error.Fail())
+        log->Printf ("GDBRemoteCommunicationServer::%s exiting: %s", __FUNCTION__, error.AsCString());
+    return NULL;
 }
 
 
@@ -86,92 +174,96 @@ GDBRemoteCommunicationServer::GetPacketAndSendResponse (uint32_t timeout_usec,
 {
     StringExtractorGDBRemote packet;
     if (WaitForPacketWithTimeoutMicroSecondsNoLock (packet, timeout_usec))
-    {
-        const StringExtractorGDBRemote::ServerPacketType packet_type = packet.GetServerPacketType ();
-        switch (packet_type)
-        {
-            case StringExtractorGDBRemote::eServerPacketType_nack:
-            case StringExtractorGDBRemote::eServerPacketType_ack:
-                break;
+        return HandlePacket (packet, error, interrupt, quit);
 
-            case StringExtractorGDBRemote::eServerPacketType_invalid:
-                error.SetErrorString("invalid packet");
-                quit = true;
-                break;
+    if (!IsConnected())
+        error.SetErrorString("lost connection");
+    else
+        error.SetErrorString("timeout");
+    return false;
+}
 
-            case StringExtractorGDBRemote::eServerPacketType_interrupt:
-                error.SetErrorString("interrupt received");
-                interrupt = true;
-                break;
+bool
+GDBRemoteCommunicationServer::HandlePacket (StringExtractorGDBRemote &packet,
+                                            Error &error,
+                                            bool &interrupt, 
+                                            bool &quit)
+{
+    const StringExtractorGDBRemote::ServerPacketType packet_type = packet.GetServerPacketType ();
+    switch (packet_type)
+    {
+        case StringExtractorGDBRemote::eServerPacketType_nack:
+        case StringExtractorGDBRemote::eServerPacketType_ack:
+            break;
+
+        case StringExtractorGDBRemote::eServerPacketType_invalid:
+            error.SetErrorString("invalid packet");
+            quit = true;
+            break;
+
+        case StringExtractorGDBRemote::eServerPacketType_interrupt:
+            error.SetErrorString("interrupt received");
+            interrupt = true;
+            break;
+        
+        case StringExtractorGDBRemote::eServerPacketType_unimplemented:
+            return SendUnimplementedResponse (packet.GetStringRef().c_str()) > 0;
+
+        case StringExtractorGDBRemote::eServerPacketType_A:
+            return Handle_A (packet);
+
+        case StringExtractorGDBRemote::eServerPacketType_qfProcessInfo:
+            return Handle_qfProcessInfo (packet);
             
-            case StringExtractorGDBRemote::eServerPacketType_unimplemented:
-                return SendUnimplementedResponse (packet.GetStringRef().c_str()) > 0;
-
-            case StringExtractorGDBRemote::eServerPacketType_A:
-                return Handle_A (packet);
-
-            case StringExtractorGDBRemote::eServerPacketType_qfProcessInfo:
-                return Handle_qfProcessInfo (packet);
-                
-            case StringExtractorGDBRemote::eServerPacketType_qsProcessInfo:
-                return Handle_qsProcessInfo (packet);
-                
-            case StringExtractorGDBRemote::eServerPacketType_qC:
-                return Handle_qC (packet);
-                
-            case StringExtractorGDBRemote::eServerPacketType_qHostInfo:
-                return Handle_qHostInfo (packet);
-                
-            case StringExtractorGDBRemote::eServerPacketType_qLaunchGDBServer:
-                return Handle_qLaunchGDBServer (packet);
-                
-            case StringExtractorGDBRemote::eServerPacketType_qLaunchSuccess:
-                return Handle_qLaunchSuccess (packet);
-                
-            case StringExtractorGDBRemote::eServerPacketType_qGroupName:
-                return Handle_qGroupName (packet);
-
-            case StringExtractorGDBRemote::eServerPacketType_qProcessInfoPID:
-                return Handle_qProcessInfoPID (packet);
-
-            case StringExtractorGDBRemote::eServerPacketType_qSpeedTest:
-                return Handle_qSpeedTest (packet);
-
-            case StringExtractorGDBRemote::eServerPacketType_qUserName:
-                return Handle_qUserName (packet);
-
-            case StringExtractorGDBRemote::eServerPacketType_QEnvironment:
-                return Handle_QEnvironment (packet);
+        case StringExtractorGDBRemote::eServerPacketType_qsProcessInfo:
+            return Handle_qsProcessInfo (packet);
             
-            case StringExtractorGDBRemote::eServerPacketType_QSetDisableASLR:
-                return Handle_QSetDisableASLR (packet);
+        case StringExtractorGDBRemote::eServerPacketType_qC:
+            return Handle_qC (packet);
             
-            case StringExtractorGDBRemote::eServerPacketType_QSetSTDIN:
-                return Handle_QSetSTDIN (packet);
+        case StringExtractorGDBRemote::eServerPacketType_qHostInfo:
+            return Handle_qHostInfo (packet);
             
-            case StringExtractorGDBRemote::eServerPacketType_QSetSTDOUT:
-                return Handle_QSetSTDOUT (packet);
+        case StringExtractorGDBRemote::eServerPacketType_qLaunchGDBServer:
+            return Handle_qLaunchGDBServer (packet);
             
-            case StringExtractorGDBRemote::eServerPacketType_QSetSTDERR:
-                return Handle_QSetSTDERR (packet);
+        case StringExtractorGDBRemote::eServerPacketType_qLaunchSuccess:
+            return Handle_qLaunchSuccess (packet);
             
-            case StringExtractorGDBRemote::eServerPacketType_QSetWorkingDir:
-                return Handle_QSetWorkingDir (packet);
-
-            case StringExtractorGDBRemote::eServerPacketType_QStartNoAckMode:
-                return Handle_QStartNoAckMode (packet);
-        }
-        return true;
-    }
-    else
-    {
-        if (!IsConnected())
-            error.SetErrorString("lost connection");
-        else
-            error.SetErrorString("timeout");
+        case StringExtractorGDBRemote::eServerPacketType_qGroupName:
+            return Handle_qGroupName (packet);
+
+        case StringExtractorGDBRemote::eServerPacketType_qProcessInfoPID:
+            return Handle_qProcessInfoPID (packet);
+
+        case StringExtractorGDBRemote::eServerPacketType_qSpeedTest:
+            return Handle_qSpeedTest (packet);
+
+        case StringExtractorGDBRemote::eServerPacketType_qUserName:
+            return Handle_qUserName (packet);
+
+        case StringExtractorGDBRemote::eServerPacketType_QEnvironment:
+            return Handle_QEnvironment (packet);
+        
+        case StringExtractorGDBRemote::eServerPacketType_QSetDisableASLR:
+            return Handle_QSetDisableASLR (packet);
+        
+        case StringExtractorGDBRemote::eServerPacketType_QSetSTDIN:
+            return Handle_QSetSTDIN (packet);
+        
+        case StringExtractorGDBRemote::eServerPacketType_QSetSTDOUT:
+            return Handle_QSetSTDOUT (packet);
+        
+        case StringExtractorGDBRemote::eServerPacketType_QSetSTDERR:
+            return Handle_QSetSTDERR (packet);
+        
+        case StringExtractorGDBRemote::eServerPacketType_QSetWorkingDir:
+            return Handle_QSetWorkingDir (packet);
+
+        case StringExtractorGDBRemote::eServerPacketType_QStartNoAckMode:
+            return Handle_QStartNoAckMode (packet);
     }
-
-    return false;
+    return true;
 }
 
 size_t
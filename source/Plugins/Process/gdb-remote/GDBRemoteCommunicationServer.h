@@ -62,6 +62,19 @@ public:
         m_hi_port_num = hi_port_num;
     }
 
+    //------------------------------------------------------------------
+    // Serve packets on a new thread over one end of a socket pair, for
+    // servers that run inside the debugger. On success "client_url" is
+    // set to the URL a GDBRemoteCommunicationClient should connect to.
+    // Subclasses must call StopServingInProcess() from their destructor
+    // since the server thread calls HandlePacket().
+    //------------------------------------------------------------------
+    lldb_private::Error
+    StartServingInProcess (std::string &client_url);
+
+    void
+    StopServingInProcess ();
+
 protected:
     //typedef std::map<uint16_t, lldb::pid_t> PortToPIDMap;
 
@@ -72,8 +85,22 @@ protected:
     uint32_t m_proc_infos_index;
     uint16_t m_lo_port_num;
     uint16_t m_hi_port_num;
+    lldb::thread_t m_in_process_thread;
+    int m_in_process_server_fd;
+    int m_in_process_client_fd;
     //PortToPIDMap m_port_to_pid_map;
 
+    //------------------------------------------------------------------
+    // Respond to a packet that GetPacketAndSendResponse() received.
+    // Subclasses that serve additional packets override this and defer
+    // to the base class for anything they don't handle.
+    //------------------------------------------------------------------
+    virtual bool
+    HandlePacket (StringExtractorGDBRemote &packet,
+                  lldb_private::Error &error,
+                  bool &interrupt, 
+                  bool &quit);
+
     size_t
     SendUnimplementedResponse (const char *packet);
 
@@ -136,6 +163,9 @@ protected:
 
     bool
     Handle_QSetSTDERR (StringExtractorGDBRemote &packet);
+
+    static void *
+    InProcessServerThread (void *arg);
     
 private:
     //------------------------------------------------------------------
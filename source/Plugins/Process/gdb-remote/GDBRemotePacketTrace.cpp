@@ -0,0 +1,403 @@
+//===-- GDBRemotePacketTrace.cpp --------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+
+#include "GDBRemotePacketTrace.h"
+
+// C Includes
+#include <string.h>
+
+// C++ Includes
+#include <algorithm>
+
+// Other libraries and framework includes
+#include "lldb/Core/DataBuffer.h"
+#include "lldb/Core/DataExtractor.h"
+#include "lldb/Core/Error.h"
+#include "lldb/Core/Stream.h"
+#include "lldb/Core/StreamString.h"
+#include "lldb/Host/FileSpec.h"
+#include "lldb/Host/TimeValue.h"
+
+// Project includes
+
+using namespace lldb;
+using namespace lldb_private;
+
+static const char g_trace_magic[] = "GDBTRACE";
+static const size_t g_trace_magic_size = 8;
+static const uint8_t g_trace_version = 1;
+static const size_t g_trace_header_size = g_trace_magic_size + 1 + 8;
+
+GDBRemotePacketTrace::GDBRemotePacketTrace () :
+    m_mutex (Mutex::eMutexTypeNormal),
+    m_file (NULL),
+    m_path (),
+    m_start_usec (0),
+    m_last_usec (0)
+{
+}
+
+GDBRemotePacketTrace::~GDBRemotePacketTrace ()
+{
+    StopRecording ();
+}
+
+bool
+GDBRemotePacketTrace::StartRecording (const char *path, Error &error)
+{
+    StopRecording ();
+
+    Mutex::Locker locker (m_mutex);
+    if (path == NULL || path[0] == '\0')
+    {
+        error.SetErrorString ("no trace file specified");
+        return false;
+    }
+
+    m_file = ::fopen (path, "wb");
+    if (m_file == NULL)
+    {
+        error.SetErrorToErrno ();
+        return false;
+    }
+    m_path = path;
+    m_start_usec = m_last_usec = TimeValue::Now().GetAsMicroSecondsSinceJan1_1970();
+
+    StreamString header (Stream::eBinary, 8, eByteOrderLittle);
+    header.Write (g_trace_magic, g_trace_magic_size);
+    header.PutHex8 (g_trace_version);
+    header.PutHex64 (m_start_usec, eByteOrderLittle);
+    ::fwrite (header.GetData(), 1, header.GetSize(), m_file);
+    return true;
+}
+
+void
+GDBRemotePacketTrace::StopRecording ()
+{
+    Mutex::Locker locker (m_mutex);
+    if (m_file)
+    {
+        ::fclose (m_file);
+        m_file = NULL;
+    }
+}
+
+void
+GDBRemotePacketTrace::Record (PacketType type, const char *packet, size_t packet_length)
+{
+    // Every packet comes through here, keep the common case cheap
+    if (m_file == NULL)
+        return;
+
+    Mutex::Locker locker (m_mutex);
+    if (m_file == NULL)
+        return;
+
+    // Packets are sent and received on different threads, so the clock
+    // can appear to go backwards by the time we get the lock
+    const uint64_t now_usec = std::max<uint64_t> (TimeValue::Now().GetAsMicroSecondsSinceJan1_1970(), m_last_usec);
+    StreamString record (Stream::eBinary, 8, eByteOrderLittle);
+    record.PutHex8 (type);
+    record.PutULEB128 (now_usec - m_last_usec);
+    record.PutULEB128 (packet_length);
+    record.Write (packet, packet_length);
+    ::fwrite (record.GetData(), 1, record.GetSize(), m_file);
+    m_last_usec = now_usec;
+}
+
+bool
+GDBRemotePacketTrace::ReadTrace (const char *path, collection &entries, Error &error)
+{
+    entries.clear();
+
+    FileSpec trace_file (path, true);
+    DataBufferSP data_sp (trace_file.ReadFileContents (0, SIZE_MAX, &error));
+    if (!data_sp || error.Fail())
+    {
+        if (error.Success())
+            error.SetErrorStringWithFormat ("unable to read '%s'", path);
+        return false;
+    }
+
+    DataExtractor data (data_sp, eByteOrderLittle, 8);
+    if (data.GetByteSize() < g_trace_header_size ||
+        ::memcmp (data.GetDataStart(), g_trace_magic, g_trace_magic_size) != 0)
+    {
+        error.SetErrorStringWithFormat ("'%s' is not a gdb-remote packet trace", path);
+        return false;
+    }
+
+    lldb::offset_t offset = g_trace_magic_size;
+    const uint8_t version = data.GetU8 (&offset);
+    if (version != g_trace_version)
+    {
+        error.SetErrorStringWithFormat ("unsupported packet trace version %u", version);
+        return false;
+    }
+    data.GetU64 (&offset);  // Start time
+
+    uint64_t usec = 0;
+    while (data.ValidOffset (offset))
+    {
+        Entry entry;
+        entry.type = (PacketType)data.GetU8 (&offset);
+        usec += data.GetULEB128 (&offset);
+        const uint64_t packet_length = data.GetULEB128 (&offset);
+        const char *packet = (const char *)data.GetData (&offset, packet_length);
+        if (packet == NULL || (entry.type != ePacketTypeSend && entry.type != ePacketTypeRecv))
+        {
+            // A truncated trace, most likely the debugger went away while
+            // recording. Keep what we have.
+            break;
+        }
+        entry.usec = usec;
+        entry.packet.assign (packet, packet_length);
+        entries.push_back (entry);
+    }
+    return true;
+}
+
+bool
+GDBRemotePacketTrace::GetPacketPayload (const std::string &packet, std::string &payload)
+{
+    if (packet.size() < 4 || packet[0] != '$')
+        return false;
+    const size_t hash_pos = packet.rfind ('#');
+    if (hash_pos == std::string::npos || hash_pos == 0)
+        return false;
+    payload.assign (packet, 1, hash_pos - 1);
+    return true;
+}
+
+namespace {
+
+    enum OperationKind
+    {
+        eOperationStop = 0,     // Resumes, halts and stop queries
+        eOperationStep,
+        eOperationMemory,
+        eOperationRegister,
+        eOperationBreakpoint,
+        eOperationThread,
+        eOperationOther,
+        kNumOperationKinds
+    };
+
+    const char *g_operation_names[kNumOperationKinds] =
+    {
+        "stop",
+        "step",
+        "memory",
+        "register",
+        "breakpoint",
+        "thread",
+        "other"
+    };
+
+    static bool
+    StartsWith (const std::string &s, const char *prefix)
+    {
+        return s.compare (0, ::strlen (prefix), prefix) == 0;
+    }
+
+    static OperationKind
+    GetOperationKind (const std::string &payload)
+    {
+        if (payload.empty())
+            return eOperationOther;
+
+        switch (payload[0])
+        {
+        case 's':
+        case 'S':
+            return eOperationStep;
+        case 'c':
+        case 'C':
+        case '?':
+        case 'k':
+        case 'D':
+            return eOperationStop;
+        case 'm':
+        case 'M':
+        case 'x':
+        case 'X':
+            return eOperationMemory;
+        case 'p':
+        case 'P':
+        case 'g':
+        case 'G':
+            return eOperationRegister;
+        case 'Z':
+        case 'z':
+            return eOperationBreakpoint;
+        case 'H':
+            return eOperationThread;
+        case '_':
+            return (payload.size() > 1 && (payload[1] == 'M' || payload[1] == 'm')) ? eOperationMemory : eOperationOther;
+        case 'v':
+            if (StartsWith (payload, "vCont;"))
+            {
+                // Any thread stepping makes the whole resume a step
+                for (size_t pos = payload.find (';'); pos != std::string::npos; pos = payload.find (';', pos + 1))
+                {
+                    if (pos + 1 < payload.size() && (payload[pos + 1] == 's' || payload[pos + 1] == 'S'))
+                        return eOperationStep;
+                }
+                return eOperationStop;
+            }
+            break;
+        case 'q':
+        case 'Q':
+            if (StartsWith (payload, "qMemoryRegionInfo"))
+                return eOperationMemory;
+            if (StartsWith (payload, "qRegisterInfo") || StartsWith (payload, "QSaveRegisterState") || StartsWith (payload, "QRestoreRegisterState"))
+                return eOperationRegister;
+            if (StartsWith (payload, "qThreadStopInfo") || StartsWith (payload, "qMultiThreadStopInfo"))
+                return eOperationStop;
+            if (StartsWith (payload, "qfThreadInfo") || StartsWith (payload, "qsThreadInfo") || StartsWith (payload, "qThreadExtraInfo") || payload.compare ("qC") == 0)
+                return eOperationThread;
+            break;
+        }
+        return eOperationOther;
+    }
+
+    // Round trip latencies are bucketed by powers of two microseconds
+    static const uint32_t k_num_histogram_buckets = 32;
+
+    struct OperationStats
+    {
+        OperationStats () :
+            count (0),
+            total_usec (0),
+            min_usec (UINT64_MAX),
+            max_usec (0),
+            bytes_sent (0),
+            bytes_received (0)
+        {
+            ::memset (histogram, 0, sizeof(histogram));
+        }
+
+        void
+        AddRoundTrip (uint64_t usec)
+        {
+            ++count;
+            total_usec += usec;
+            min_usec = std::min (min_usec, usec);
+            max_usec = std::max (max_usec, usec);
+            uint32_t bucket = 0;
+            while (bucket + 1 < k_num_histogram_buckets && (1ull << (bucket + 1)) <= usec)
+                ++bucket;
+            ++histogram[bucket];
+        }
+
+        uint64_t count;
+        uint64_t total_usec;
+        uint64_t min_usec;
+        uint64_t max_usec;
+        uint64_t bytes_sent;
+        uint64_t bytes_received;
+        uint64_t histogram[k_num_histogram_buckets];
+    };
+
+} // anonymous namespace
+
+void
+GDBRemotePacketTrace::DumpSummary (const collection &entries, Stream &strm)
+{
+    OperationStats stats[kNumOperationKinds];
+    uint64_t total_bytes_sent = 0;
+    uint64_t total_bytes_received = 0;
+    uint64_t unanswered_packets = 0;
+
+    // A round trip goes from a packet we sent to the first packet we
+    // received after it. Acks and packets the stub sends on its own (like
+    // inferior output) only add to the byte counts.
+    const Entry *request = NULL;
+    OperationKind request_kind = eOperationOther;
+    std::string payload;
+    for (collection::const_iterator pos = entries.begin(), end = entries.end(); pos != end; ++pos)
+    {
+        const bool has_payload = GetPacketPayload (pos->packet, payload);
+        if (pos->type == ePacketTypeSend)
+        {
+            total_bytes_sent += pos->packet.size();
+            if (!has_payload)
+                continue;
+            if (request)
+                ++unanswered_packets;
+            request = &*pos;
+            request_kind = GetOperationKind (payload);
+            stats[request_kind].bytes_sent += pos->packet.size();
+        }
+        else
+        {
+            total_bytes_received += pos->packet.size();
+            if (!has_payload || request == NULL)
+                continue;
+            // Console output while the inferior runs isn't the answer
+            if ((request_kind == eOperationStop || request_kind == eOperationStep) && payload.size() > 1 && payload[0] == 'O')
+                continue;
+            stats[request_kind].bytes_received += pos->packet.size();
+            stats[request_kind].AddRoundTrip (pos->usec - request->usec);
+            request = NULL;
+        }
+    }
+
+    const uint64_t duration_usec = entries.empty() ? 0 : entries.back().usec - entries.front().usec;
+    strm.Printf ("%" PRIu64 " packets in %.3f sec: %" PRIu64 " bytes sent, %" PRIu64 " bytes received",
+                 (uint64_t)entries.size(),
+                 duration_usec / 1000000.0,
+                 total_bytes_sent,
+                 total_bytes_received);
+    if (duration_usec > 0)
+        strm.Printf (", %.1f bytes/sec", (total_bytes_sent + total_bytes_received) * 1000000.0 / duration_usec);
+    strm.EOL();
+    if (unanswered_packets > 0)
+        strm.Printf ("%" PRIu64 " packets got no response\n", unanswered_packets);
+
+    strm.Printf ("\n%-10s %8s %12s %10s %10s %10s %12s %12s\n", "operation", "count", "total ms", "min us", "avg us", "max us", "bytes sent", "bytes recv");
+    for (uint32_t kind = 0; kind < kNumOperationKinds; ++kind)
+    {
+        const OperationStats &op = stats[kind];
+        if (op.count == 0)
+            continue;
+        strm.Printf ("%-10s %8" PRIu64 " %12.3f %10" PRIu64 " %10" PRIu64 " %10" PRIu64 " %12" PRIu64 " %12" PRIu64 "\n",
+                     g_operation_names[kind],
+                     op.count,
+                     op.total_usec / 1000.0,
+                     op.min_usec,
+                     op.total_usec / op.count,
+                     op.max_usec,
+                     op.bytes_sent,
+                     op.bytes_received);
+    }
+
+    for (uint32_t kind = 0; kind < kNumOperationKinds; ++kind)
+    {
+        const OperationStats &op = stats[kind];
+        if (op.count == 0)
+            continue;
+        strm.Printf ("\n%s round trip latency:\n", g_operation_names[kind]);
+        uint64_t max_bucket_count = 0;
+        for (uint32_t bucket = 0; bucket < k_num_histogram_buckets; ++bucket)
+            max_bucket_count = std::max (max_bucket_count, op.histogram[bucket]);
+        for (uint32_t bucket = 0; bucket < k_num_histogram_buckets; ++bucket)
+        {
+            if (op.histogram[bucket] == 0)
+                continue;
+            const uint32_t bar_length = (uint32_t)((op.histogram[bucket] * 40 + max_bucket_count - 1) / max_bucket_count);
+            strm.Printf ("  %10" PRIu64 " us - %10" PRIu64 " us: %8" PRIu64 " %s\n",
+                         bucket == 0 ? 0 : (1ull << bucket),
+                         (1ull << (bucket + 1)) - 1,
+                         op.histogram[bucket],
+                         std::string (bar_length, '*').c_str());
+        }
+    }
+}
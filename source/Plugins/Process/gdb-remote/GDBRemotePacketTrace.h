@@ -0,0 +1,122 @@
+//===-- GDBRemotePacketTrace.h ----------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_GDBRemotePacketTrace_h_
+#define liblldb_GDBRemotePacketTrace_h_
+
+// C Includes
+#include <stdio.h>
+
+// C++ Includes
+#include <string>
+#include <vector>
+
+// Other libraries and framework includes
+// Project includes
+#include "lldb/lldb-private.h"
+#include "lldb/Host/Mutex.h"
+
+//----------------------------------------------------------------------
+// GDBRemotePacketTrace
+//
+// Records every packet a GDBRemoteCommunication sends or receives,
+// together with the time it was sent or received, to a binary trace
+// file. Traces can be read back to summarize the round trips of a
+// session or to serve the session again with GDBRemoteReplayServer.
+//
+// A trace file starts with the 8 byte magic "GDBTRACE", a version byte
+// and the start time in microseconds since the epoch as a little endian
+// 64 bit value. Each packet follows as its PacketType byte, the ULEB128
+// microseconds since the previous packet, the ULEB128 packet length and
+// the packet bytes as they were sent or received.
+//----------------------------------------------------------------------
+class GDBRemotePacketTrace
+{
+public:
+    enum PacketType
+    {
+        ePacketTypeInvalid = 0,
+        ePacketTypeSend,
+        ePacketTypeRecv
+    };
+
+    struct Entry
+    {
+        Entry () :
+            type (ePacketTypeInvalid),
+            usec (0),
+            packet ()
+        {
+        }
+
+        PacketType type;
+        uint64_t usec;          // Microseconds since the start of the trace
+        std::string packet;     // Including the "$" and "#XX" framing
+    };
+
+    typedef std::vector<Entry> collection;
+
+    GDBRemotePacketTrace ();
+
+    ~GDBRemotePacketTrace ();
+
+    bool
+    StartRecording (const char *path, lldb_private::Error &error);
+
+    void
+    StopRecording ();
+
+    bool
+    IsRecording () const
+    {
+        return m_file != NULL;
+    }
+
+    const char *
+    GetPath () const
+    {
+        return m_path.empty() ? NULL : m_path.c_str();
+    }
+
+    void
+    Record (PacketType type, const char *packet, size_t packet_length);
+
+    //------------------------------------------------------------------
+    // Read a trace written by StartRecording()
+    //------------------------------------------------------------------
+    static bool
+    ReadTrace (const char *path, collection &entries, lldb_private::Error &error);
+
+    //------------------------------------------------------------------
+    // Returns the payload of a "$PAYLOAD#XX" packet, or false for acks
+    // and other packets that don't carry a payload.
+    //------------------------------------------------------------------
+    static bool
+    GetPacketPayload (const std::string &packet, std::string &payload);
+
+    //------------------------------------------------------------------
+    // Summarize the round trips in a trace recorded by a client: the
+    // count, latency and bytes of each kind of operation, a latency
+    // histogram for each and the overall throughput.
+    //------------------------------------------------------------------
+    static void
+    DumpSummary (const collection &entries, lldb_private::Stream &strm);
+
+protected:
+    lldb_private::Mutex m_mutex;
+    FILE *m_file;
+    std::string m_path;
+    uint64_t m_start_usec;
+    uint64_t m_last_usec;
+
+private:
+    DISALLOW_COPY_AND_ASSIGN (GDBRemotePacketTrace);
+};
+
+#endif  // liblldb_GDBRemotePacketTrace_h_
@@ -0,0 +1,216 @@
+//===-- GDBRemoteReplayServer.cpp -------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+
+#include "GDBRemoteReplayServer.h"
+
+// C Includes
+#include <unistd.h>
+
+// C++ Includes
+// Other libraries and framework includes
+#include "lldb/Core/Log.h"
+
+// Project includes
+#include "Utility/StringExtractorGDBRemote.h"
+#include "GDBRemotePacketTrace.h"
+#include "ProcessGDBRemoteLog.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+static const char *g_replay_url_prefix = "replay://";
+
+//----------------------------------------------------------------------
+// GDBRemoteReplayServer constructor
+//----------------------------------------------------------------------
+GDBRemoteReplayServer::GDBRemoteReplayServer (const Options &options) :
+    GDBRemoteCommunicationServer (false),
+    m_options (options),
+    m_requests (),
+    m_num_unmatched (0)
+{
+}
+
+//----------------------------------------------------------------------
+// Destructor
+//----------------------------------------------------------------------
+GDBRemoteReplayServer::~GDBRemoteReplayServer()
+{
+    StopServingInProcess ();
+}
+
+bool
+GDBRemoteReplayServer::IsReplayURL (const char *url)
+{
+    return url && ::strncmp (url, g_replay_url_prefix, ::strlen (g_replay_url_prefix)) == 0;
+}
+
+bool
+GDBRemoteReplayServer::ParseURL (const char *url, Options &options, Error &error)
+{
+    if (!IsReplayURL (url))
+    {
+        error.SetErrorStringWithFormat ("'%s' is not a replay URL", url ? url : "");
+        return false;
+    }
+
+    // replay://PATH[?timing=recorded]
+    std::string path (url + ::strlen (g_replay_url_prefix));
+    std::string option;
+    const size_t question_pos = path.find ('?');
+    if (question_pos != std::string::npos)
+    {
+        option = path.substr (question_pos + 1);
+        path.erase (question_pos);
+    }
+
+    if (path.empty())
+    {
+        error.SetErrorString ("replay URL doesn't specify a packet trace");
+        return false;
+    }
+    options.trace_path.swap (path);
+
+    if (option.compare ("timing=recorded") == 0)
+        options.recorded_timing = true;
+    else if (!option.empty() && option.compare ("timing=none") != 0)
+    {
+        error.SetErrorStringWithFormat ("unknown replay option '%s'", option.c_str());
+        return false;
+    }
+    return true;
+}
+
+Error
+GDBRemoteReplayServer::Start (std::string &client_url)
+{
+    Error error (LoadTrace ());
+    if (error.Fail())
+        return error;
+
+    error = StartServingInProcess (client_url);
+    if (error.Fail())
+        return error;
+
+    Log *log (ProcessGDBRemoteLog::GetLogIfAllCategoriesSet (GDBR_LOG_PROCESS));
+    if (log)
+        log->Printf ("GDBRemoteReplayServer::%s replaying '%s' (%zu distinct packets) on %s",
+                     __FUNCTION__,
+                     m_options.trace_path.c_str(),
+                     m_requests.size(),
+                     client_url.c_str());
+    return error;
+}
+
+Error
+GDBRemoteReplayServer::LoadTrace ()
+{
+    Error error;
+    GDBRemotePacketTrace::collection entries;
+    if (!GDBRemotePacketTrace::ReadTrace (m_options.trace_path.c_str(), entries, error))
+        return error;
+
+    // Group the packets the client sent with the packets it received up
+    // to its next request. Acks and interrupts carry no payload and are
+    // left out.
+    Exchange *exchange = NULL;
+    uint64_t request_usec = 0;
+    std::string payload;
+    for (GDBRemotePacketTrace::collection::const_iterator pos = entries.begin(), end = entries.end(); pos != end; ++pos)
+    {
+        if (!GDBRemotePacketTrace::GetPacketPayload (pos->packet, payload))
+        {
+            // Notifications of a non-stop session are replayed after the
+            // response they followed, keeping their '%' to tell them apart
+            const size_t hash_pos = pos->packet.rfind ('#');
+            if (exchange == NULL || pos->type != GDBRemotePacketTrace::ePacketTypeRecv ||
+                pos->packet.empty() || pos->packet[0] != '%' || hash_pos == std::string::npos)
+                continue;
+            payload.assign (pos->packet, 0, hash_pos);
+        }
+
+        if (pos->type == GDBRemotePacketTrace::ePacketTypeSend)
+        {
+            RecordedRequest &request = m_requests[payload];
+            request.exchanges.push_back (Exchange());
+            exchange = &request.exchanges.back();
+            exchange->latency_usec = 0;
+            request_usec = pos->usec;
+        }
+        else if (exchange)
+        {
+            if (exchange->responses.empty())
+                exchange->latency_usec = pos->usec - request_usec;
+            exchange->responses.push_back (payload);
+        }
+    }
+
+    if (m_requests.empty())
+        error.SetErrorStringWithFormat ("'%s' doesn't contain any requests", m_options.trace_path.c_str());
+    return error;
+}
+
+bool
+GDBRemoteReplayServer::HandlePacket (StringExtractorGDBRemote &packet,
+                                     Error &error,
+                                     bool &interrupt,
+                                     bool &quit)
+{
+    const std::string &packet_str = packet.GetStringRef();
+
+    // Acks, interrupts and the switch to no-ack mode change the state of
+    // the connection itself, so the base class handles those
+    switch (packet.GetServerPacketType())
+    {
+        case StringExtractorGDBRemote::eServerPacketType_ack:
+        case StringExtractorGDBRemote::eServerPacketType_nack:
+        case StringExtractorGDBRemote::eServerPacketType_interrupt:
+        case StringExtractorGDBRemote::eServerPacketType_invalid:
+        case StringExtractorGDBRemote::eServerPacketType_QStartNoAckMode:
+            return GDBRemoteCommunicationServer::HandlePacket (packet, error, interrupt, quit);
+        default:
+            break;
+    }
+
+    RequestMap::iterator pos = m_requests.find (packet_str);
+    if (pos == m_requests.end())
+    {
+        ++m_num_unmatched;
+        Log *log (ProcessGDBRemoteLog::GetLogIfAllCategoriesSet (GDBR_LOG_PACKETS));
+        if (log)
+            log->Printf ("GDBRemoteReplayServer::%s no recorded response for '%s'", __FUNCTION__, packet_str.c_str());
+        return SendUnimplementedResponse (packet_str.c_str()) > 0;
+    }
+
+    RecordedRequest &request = pos->second;
+    const Exchange &exchange = request.exchanges[std::min (request.next_idx, request.exchanges.size() - 1)];
+    ++request.next_idx;
+
+    if (m_options.recorded_timing && exchange.latency_usec > 0)
+        ::usleep (exchange.latency_usec);
+
+    bool success = true;
+    for (std::vector<std::string>::const_iterator response_pos = exchange.responses.begin(), response_end = exchange.responses.end();
+         response_pos != response_end;
+         ++response_pos)
+    {
+        size_t bytes_sent;
+        if (!response_pos->empty() && (*response_pos)[0] == '%')
+            bytes_sent = SendNotificationNoLock (response_pos->c_str() + 1, response_pos->size() - 1);
+        else
+            bytes_sent = SendPacketNoLock (response_pos->c_str(), response_pos->size());
+        if (bytes_sent == 0)
+            success = false;
+    }
+
+    if (packet_str[0] == 'k' || packet_str[0] == 'D')
+        quit = true;
+    return success;
+}
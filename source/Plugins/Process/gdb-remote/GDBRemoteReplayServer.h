@@ -0,0 +1,113 @@
+//===-- GDBRemoteReplayServer.h ---------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_GDBRemoteReplayServer_h_
+#define liblldb_GDBRemoteReplayServer_h_
+
+// C Includes
+// C++ Includes
+#include <map>
+#include <string>
+#include <vector>
+
+// Other libraries and framework includes
+// Project includes
+#include "GDBRemoteCommunicationServer.h"
+
+//----------------------------------------------------------------------
+// GDBRemoteReplayServer
+//
+// Serves a session recorded with GDBRemotePacketTrace back to a client.
+// Each packet the client sends is answered with the responses that were
+// recorded for the same packet. Packets that were sent several times are
+// answered in recorded order and the last recorded answer is repeated
+// once they run out, so a debugger that sends the same packets as the
+// recorded one sees the same session.
+//
+// Like the simulator, the replay server runs inside the debugger and is
+// reached with a "replay://" URL:
+//
+//   process connect replay:///tmp/session.trace?timing=recorded
+//
+// With "timing=recorded" each response is delayed by the latency it had
+// when it was recorded; by default responses are sent immediately.
+//----------------------------------------------------------------------
+class GDBRemoteReplayServer : public GDBRemoteCommunicationServer
+{
+public:
+    struct Options
+    {
+        Options () :
+            trace_path (),
+            recorded_timing (false)
+        {
+        }
+
+        std::string trace_path;
+        bool recorded_timing;
+    };
+
+    GDBRemoteReplayServer (const Options &options);
+
+    virtual
+    ~GDBRemoteReplayServer();
+
+    static bool
+    IsReplayURL (const char *url);
+
+    static bool
+    ParseURL (const char *url, Options &options, lldb_private::Error &error);
+
+    //------------------------------------------------------------------
+    // Load the trace and start serving it on a new thread. On success
+    // "client_url" is set to the URL a GDBRemoteCommunicationClient
+    // should connect to.
+    //------------------------------------------------------------------
+    lldb_private::Error
+    Start (std::string &client_url);
+
+protected:
+    struct Exchange
+    {
+        std::vector<std::string> responses;
+        uint64_t latency_usec;  // From the request to the first response
+    };
+
+    struct RecordedRequest
+    {
+        RecordedRequest () :
+            exchanges (),
+            next_idx (0)
+        {
+        }
+
+        std::vector<Exchange> exchanges;
+        size_t next_idx;
+    };
+
+    typedef std::map<std::string, RecordedRequest> RequestMap;
+
+    virtual bool
+    HandlePacket (StringExtractorGDBRemote &packet,
+                  lldb_private::Error &error,
+                  bool &interrupt,
+                  bool &quit);
+
+    lldb_private::Error
+    LoadTrace ();
+
+    Options m_options;
+    RequestMap m_requests;
+    uint32_t m_num_unmatched;
+
+private:
+    DISALLOW_COPY_AND_ASSIGN (GDBRemoteReplayServer);
+};
+
+#endif  // liblldb_GDBRemoteReplayServer_h_
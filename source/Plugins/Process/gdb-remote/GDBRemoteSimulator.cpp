@@ -0,0 +1,1056 @@
+//===-- GDBRemoteSimulator.cpp ----------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+
+#include "GDBRemoteSimulator.h"
+
+// C Includes
+#include <signal.h>
+#include <unistd.h>
+
+// C++ Includes
+#include <algorithm>
+#include <fstream>
+
+// Other libraries and framework includes
+#include "llvm/Support/ELF.h"
+#include "lldb/Core/DataExtractor.h"
+#include "lldb/Core/Log.h"
+#include "lldb/Core/Module.h"
+#include "lldb/Core/Section.h"
+#include "lldb/Core/StreamString.h"
+#include "lldb/Host/FileSpec.h"
+#include "lldb/Interpreter/Args.h"
+#include "lldb/Symbol/ObjectFile.h"
+
+// Project includes
+#include "Plugins/Process/Utility/PatmosDefines.h"
+#include "Utility/StringExtractorGDBRemote.h"
+#include "ProcessGDBRemoteLog.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+static const char *g_sim_url_prefix = "sim://";
+
+static const lldb::pid_t g_sim_pid = 1;
+
+// Memory reads are answered with at most this many bytes
+static const size_t g_max_memory_read_size = 0x4000;
+
+// Core N is reported as thread N + 1 since a thread ID of zero means
+// "any thread" in the protocol
+static inline lldb::tid_t
+CoreToThreadID (uint32_t core)
+{
+    return core + 1;
+}
+
+//----------------------------------------------------------------------
+// GDBRemoteSimulator constructor
+//----------------------------------------------------------------------
+GDBRemoteSimulator::GDBRemoteSimulator (const Options &options) :
+    GDBRemoteCommunicationServer (false),
+    m_options (options),
+    m_arch (),
+    m_entry_point (LLDB_INVALID_ADDRESS),
+    m_memory (),
+    m_reg_infos (),
+    m_reg_data (),
+    m_core_signals (),
+    m_pc_regnum (LLDB_INVALID_REGNUM),
+    m_sp_regnum (LLDB_INVALID_REGNUM),
+    m_breakpoints (),
+    m_stop_replies (),
+    m_last_stop_reply (),
+    m_curr_core (0),
+    m_run_core (0),
+    m_stop_core (0),
+    m_request_size (0),
+    m_non_stop (false)
+{
+}
+
+//----------------------------------------------------------------------
+// Destructor
+//----------------------------------------------------------------------
+GDBRemoteSimulator::~GDBRemoteSimulator()
+{
+    StopServingInProcess ();
+}
+
+bool
+GDBRemoteSimulator::IsSimulatorURL (const char *url)
+{
+    return url && ::strncmp (url, g_sim_url_prefix, ::strlen (g_sim_url_prefix)) == 0;
+}
+
+bool
+GDBRemoteSimulator::ParseURL (const char *url, Options &options, Error &error)
+{
+    if (!IsSimulatorURL (url))
+    {
+        error.SetErrorStringWithFormat ("'%s' is not a simulator URL", url ? url : "");
+        return false;
+    }
+
+    // sim://PATH[?NAME=VALUE[;NAME=VALUE...]]
+    std::string path (url + ::strlen (g_sim_url_prefix));
+    std::string option_string;
+    const size_t question_pos = path.find ('?');
+    if (question_pos != std::string::npos)
+    {
+        option_string = path.substr (question_pos + 1);
+        path.erase (question_pos);
+    }
+
+    if (path.empty())
+    {
+        error.SetErrorString ("simulator URL doesn't specify an ELF file");
+        return false;
+    }
+    options.elf_path.swap (path);
+
+    size_t pos = 0;
+    while (pos < option_string.size())
+    {
+        size_t end_pos = option_string.find (';', pos);
+        if (end_pos == std::string::npos)
+            end_pos = option_string.size();
+        const std::string option (option_string, pos, end_pos - pos);
+        pos = end_pos + 1;
+        if (option.empty())
+            continue;
+
+        const size_t equal_pos = option.find ('=');
+        const std::string name (option, 0, equal_pos);
+        const std::string value (equal_pos == std::string::npos ? std::string() : option.substr (equal_pos + 1));
+        bool success = false;
+        if (name.compare ("latency") == 0)
+            options.latency_usec = Args::StringToUInt32 (value.c_str(), 0, 0, &success);
+        else if (name.compare ("bandwidth") == 0)
+            options.bytes_per_second = Args::StringToUInt64 (value.c_str(), 0, 0, &success);
+        else if (name.compare ("stack-size") == 0)
+            options.stack_size = Args::StringToUInt32 (value.c_str(), 0, 0, &success);
+        else if (name.compare ("cores") == 0)
+        {
+            options.num_cores = Args::StringToUInt32 (value.c_str(), 0, 0, &success);
+            success = success && options.num_cores > 0;
+        }
+        else if (name.compare ("qsupported") == 0)
+            options.qsupported = Args::StringToBoolean (value.c_str(), false, &success);
+        else if (name.compare ("stop-replies") == 0)
+        {
+            options.stop_replies_path = value;
+            success = !value.empty();
+        }
+        else
+        {
+            error.SetErrorStringWithFormat ("unknown simulator option '%s'", name.c_str());
+            return false;
+        }
+
+        if (!success)
+        {
+            error.SetErrorStringWithFormat ("invalid value for simulator option '%s': '%s'", name.c_str(), value.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+Error
+GDBRemoteSimulator::Start (std::string &client_url)
+{
+    Error error (LoadMemoryImage ());
+    if (error.Fail())
+        return error;
+
+    error = LoadStopReplies ();
+    if (error.Fail())
+        return error;
+
+    BuildRegisterFile ();
+
+    // The initial stop is at the entry point. The simulated stack is split
+    // evenly between the cores and each starts with its stack pointer at
+    // the top of its part.
+    const uint32_t num_cores = m_reg_data.size();
+    for (uint32_t core = 0; core < num_cores; ++core)
+    {
+        if (m_entry_point != LLDB_INVALID_ADDRESS)
+            SetRegisterValue (core, m_pc_regnum, m_entry_point);
+        if (!m_memory.empty())
+        {
+            MemoryMap::const_reverse_iterator stack_pos = m_memory.rbegin();
+            const addr_t stack_top = stack_pos->first + stack_pos->second.bytes.size();
+            SetRegisterValue (core, m_sp_regnum, stack_top - core * (stack_pos->second.bytes.size() / num_cores));
+        }
+    }
+    m_core_signals[m_stop_core] = SIGTRAP;
+    UpdateStopReply ();
+
+    error = StartServingInProcess (client_url);
+    if (error.Fail())
+        return error;
+
+    Log *log (ProcessGDBRemoteLog::GetLogIfAllCategoriesSet (GDBR_LOG_PROCESS));
+    if (log)
+        log->Printf ("GDBRemoteSimulator::%s serving '%s' (%s) on %s, latency = %u usec, bandwidth = %" PRIu64 " bytes/sec",
+                     __FUNCTION__,
+                     m_options.elf_path.c_str(),
+                     m_arch.GetTriple().getTriple().c_str(),
+                     client_url.c_str(),
+                     m_options.latency_usec,
+                     m_options.bytes_per_second);
+    return error;
+}
+
+Error
+GDBRemoteSimulator::LoadMemoryImage ()
+{
+    Error error;
+    FileSpec file_spec (m_options.elf_path.c_str(), true);
+    if (!file_spec.Exists())
+    {
+        error.SetErrorStringWithFormat ("'%s' does not exist", m_options.elf_path.c_str());
+        return error;
+    }
+
+    ModuleSP module_sp (new Module (file_spec, ArchSpec()));
+    ObjectFile *objfile = module_sp->GetObjectFile();
+    SectionList *section_list = objfile ? objfile->GetSectionList() : NULL;
+    if (section_list == NULL)
+    {
+        error.SetErrorStringWithFormat ("'%s' is not an object file", m_options.elf_path.c_str());
+        return error;
+    }
+
+    m_arch = module_sp->GetArchitecture();
+    m_entry_point = objfile->GetEntryPointAddress().GetFileAddress();
+
+    // Map every allocated section at its link address. Sections that
+    // aren't loaded (debug info, symbol tables) have a size of zero.
+    addr_t image_end = 0;
+    const size_t num_sections = section_list->GetSize();
+    for (size_t i = 0; i < num_sections; ++i)
+    {
+        SectionSP section_sp (section_list->GetSectionAtIndex (i));
+        if (!section_sp || section_sp->GetByteSize() == 0 || section_sp->IsThreadSpecific())
+            continue;
+
+        const addr_t addr = section_sp->GetFileAddress();
+        MemoryRegion &region = m_memory[addr];
+        region.bytes.assign (section_sp->GetByteSize(), 0);
+        const size_t file_size = std::min<size_t> (section_sp->GetFileSize(), region.bytes.size());
+        if (file_size > 0)
+            objfile->ReadSectionData (section_sp.get(), 0, &region.bytes[0], file_size);
+
+        region.permissions = ePermissionsReadable;
+        if (section_sp->Test (llvm::ELF::SHF_WRITE))
+            region.permissions |= ePermissionsWritable;
+        if (section_sp->Test (llvm::ELF::SHF_EXECINSTR))
+            region.permissions |= ePermissionsExecutable;
+
+        image_end = std::max<addr_t> (image_end, addr + region.bytes.size());
+    }
+
+    if (m_memory.empty())
+    {
+        error.SetErrorStringWithFormat ("'%s' has no sections to load", m_options.elf_path.c_str());
+        return error;
+    }
+
+    // Place the stack after the image, leaving an unmapped gap so stray
+    // accesses past either end fail
+    const addr_t page_size = 0x10000;
+    const addr_t stack_addr = ((image_end + page_size - 1) & ~(page_size - 1)) + page_size;
+    MemoryRegion &stack_region = m_memory[stack_addr];
+    stack_region.bytes.assign (m_options.stack_size, 0);
+    stack_region.permissions = ePermissionsReadable | ePermissionsWritable;
+    return error;
+}
+
+Error
+GDBRemoteSimulator::LoadStopReplies ()
+{
+    Error error;
+    if (m_options.stop_replies_path.empty())
+        return error;
+
+    std::ifstream file (m_options.stop_replies_path.c_str());
+    if (!file)
+    {
+        error.SetErrorStringWithFormat ("unable to open stop replies file '%s'", m_options.stop_replies_path.c_str());
+        return error;
+    }
+
+    // One stop reply packet per line, lines starting with '#' are comments
+    std::string line;
+    while (std::getline (file, line))
+    {
+        const size_t end_pos = line.find_last_not_of (" \t\r");
+        if (end_pos == std::string::npos || line[0] == '#')
+            continue;
+        line.erase (end_pos + 1);
+        m_stop_replies.push_back (line);
+    }
+    return error;
+}
+
+void
+GDBRemoteSimulator::BuildRegisterFile ()
+{
+    m_reg_infos.clear();
+
+    RegisterInfo reg_info;
+    reg_info.offset = 0;
+    char name[16];
+
+    if (m_arch.GetMachine() == llvm::Triple::patmos)
+    {
+        // Same numbering as the Patmos instruction emulator and unwinder
+        static const char *g_sreg_names[] = { "", "", "sl", "sh", "", "ss", "st", "srb", "sro", "sxb", "sxo", "", "", "", "", "" };
+
+        reg_info.byte_size = 4;
+        for (uint32_t i = 0; i < 32; ++i)
+        {
+            ::snprintf (name, sizeof(name), "r%u", i);
+            reg_info.name = name;
+            reg_info.alt_name.clear();
+            reg_info.set_name = "General Purpose Registers";
+            reg_info.generic = i == PATMOS_REG_RSP ? "sp" : (i == PATMOS_REG_RFP ? "fp" : "");
+            reg_info.dwarf = patmos_r0 + i;
+            m_reg_infos.push_back (reg_info);
+            reg_info.offset += reg_info.byte_size;
+        }
+        for (uint32_t i = 0; i < 16; ++i)
+        {
+            ::snprintf (name, sizeof(name), "s%u", i);
+            reg_info.name = name;
+            reg_info.alt_name = g_sreg_names[i];
+            reg_info.set_name = "Special Registers";
+            reg_info.generic.clear();
+            reg_info.dwarf = patmos_s0 + i;
+            m_reg_infos.push_back (reg_info);
+            reg_info.offset += reg_info.byte_size;
+        }
+        reg_info.dwarf = patmos_pc;
+        m_sp_regnum = PATMOS_REG_RSP;
+    }
+    else
+    {
+        // Anything else gets a generic file of pointer sized registers, which
+        // is all the protocol traffic needs
+        reg_info.byte_size = m_arch.GetAddressByteSize() ? m_arch.GetAddressByteSize() : 4;
+        for (uint32_t i = 0; i < 32; ++i)
+        {
+            ::snprintf (name, sizeof(name), "r%u", i);
+            reg_info.name = name;
+            reg_info.alt_name.clear();
+            reg_info.set_name = "General Purpose Registers";
+            reg_info.generic = i == 31 ? "sp" : (i == 30 ? "fp" : "");
+            reg_info.dwarf = i;
+            m_reg_infos.push_back (reg_info);
+            reg_info.offset += reg_info.byte_size;
+        }
+        reg_info.dwarf = 32;
+        m_sp_regnum = 31;
+    }
+
+    reg_info.name = "pc";
+    reg_info.alt_name.clear();
+    reg_info.set_name = "General Purpose Registers";
+    reg_info.generic = "pc";
+    m_pc_regnum = m_reg_infos.size();
+    m_reg_infos.push_back (reg_info);
+    reg_info.offset += reg_info.byte_size;
+
+    m_reg_data.assign (m_options.num_cores, std::vector<uint8_t> (reg_info.offset, 0));
+    m_core_signals.assign (m_options.num_cores, 0);
+}
+
+uint64_t
+GDBRemoteSimulator::GetRegisterValue (uint32_t core, uint32_t reg) const
+{
+    if (reg >= m_reg_infos.size())
+        return 0;
+    const RegisterInfo &reg_info = m_reg_infos[reg];
+    DataExtractor data (&m_reg_data[core][reg_info.offset], reg_info.byte_size, m_arch.GetByteOrder(), reg_info.byte_size);
+    lldb::offset_t offset = 0;
+    return data.GetMaxU64 (&offset, reg_info.byte_size);
+}
+
+void
+GDBRemoteSimulator::SetRegisterValue (uint32_t core, uint32_t reg, uint64_t value)
+{
+    if (reg >= m_reg_infos.size())
+        return;
+    const RegisterInfo &reg_info = m_reg_infos[reg];
+    uint8_t *dst = &m_reg_data[core][reg_info.offset];
+    const bool big_endian = m_arch.GetByteOrder() == eByteOrderBig;
+    for (uint32_t i = 0; i < reg_info.byte_size; ++i)
+    {
+        const uint32_t shift = 8 * (big_endian ? reg_info.byte_size - 1 - i : i);
+        dst[i] = shift < 64 ? (uint8_t)(value >> shift) : 0;
+    }
+}
+
+GDBRemoteSimulator::MemoryMap::const_iterator
+GDBRemoteSimulator::FindRegion (addr_t addr) const
+{
+    MemoryMap::const_iterator pos = m_memory.upper_bound (addr);
+    if (pos == m_memory.begin())
+        return m_memory.end();
+    --pos;
+    if (addr - pos->first < pos->second.bytes.size())
+        return pos;
+    return m_memory.end();
+}
+
+size_t
+GDBRemoteSimulator::ReadMemory (addr_t addr, void *dst, size_t length) const
+{
+    uint8_t *dst_bytes = (uint8_t *)dst;
+    size_t bytes_read = 0;
+    while (bytes_read < length)
+    {
+        MemoryMap::const_iterator pos = FindRegion (addr + bytes_read);
+        if (pos == m_memory.end())
+            break;
+        const size_t region_offset = addr + bytes_read - pos->first;
+        const size_t count = std::min (length - bytes_read, pos->second.bytes.size() - region_offset);
+        ::memcpy (dst_bytes + bytes_read, &pos->second.bytes[region_offset], count);
+        bytes_read += count;
+    }
+    return bytes_read;
+}
+
+size_t
+GDBRemoteSimulator::WriteMemory (addr_t addr, const void *src, size_t length)
+{
+    const uint8_t *src_bytes = (const uint8_t *)src;
+    size_t bytes_written = 0;
+    while (bytes_written < length)
+    {
+        MemoryMap::const_iterator pos = FindRegion (addr + bytes_written);
+        if (pos == m_memory.end())
+            break;
+        MemoryRegion &region = m_memory[pos->first];
+        const size_t region_offset = addr + bytes_written - pos->first;
+        const size_t count = std::min (length - bytes_written, region.bytes.size() - region_offset);
+        ::memcpy (&region.bytes[region_offset], src_bytes + bytes_written, count);
+        bytes_written += count;
+    }
+    return bytes_written;
+}
+
+addr_t
+GDBRemoteSimulator::GetNextInstructionAddress (addr_t pc) const
+{
+    if (m_arch.GetMachine() == llvm::Triple::patmos)
+    {
+        // Bundles and long immediate instructions take two words
+        uint8_t bytes[4];
+        if (ReadMemory (pc, bytes, sizeof(bytes)) == sizeof(bytes))
+        {
+            const uint32_t insn = (bytes[0] << 24) | (bytes[1] << 16) | (bytes[2] << 8) | bytes[3];
+            if (PatmosIsBundled (insn) || PatmosOpcode (insn) == PATMOS_OPC_ALUL)
+                return pc + 8;
+        }
+        return pc + 4;
+    }
+    const uint32_t min_opcode_size = m_arch.GetMinimumOpcodeByteSize();
+    return pc + (min_opcode_size ? min_opcode_size : 1);
+}
+
+void
+GDBRemoteSimulator::ApplyStopReply (const std::string &stop_reply)
+{
+    // Expedited registers in a "T" stop reply ("NN:VALUE;" with NN the
+    // register number in hex) update the register file so later register
+    // reads agree with the stop. They belong to the core named by the
+    // "thread" key, or to the resumed core if there is none.
+    if (stop_reply.size() < 3 || stop_reply[0] != 'T')
+        return;
+
+    const char *thread_cstr = ::strstr (stop_reply.c_str(), "thread:");
+    if (thread_cstr)
+    {
+        StringExtractor tid_extractor (thread_cstr + strlen("thread:"));
+        const uint64_t tid = tid_extractor.GetHexMaxU64 (false, 0);
+        if (tid > 0 && tid <= m_reg_data.size())
+            m_stop_core = tid - 1;
+    }
+
+    StringExtractor extractor (stop_reply.c_str() + 1);
+    m_core_signals.assign (m_core_signals.size(), 0);
+    m_core_signals[m_stop_core] = extractor.GetHexU8();
+
+    std::string name;
+    std::string value;
+    while (extractor.GetNameColonValue (name, value))
+    {
+        if (name.empty() || name.find_first_not_of ("0123456789abcdefABCDEF") != std::string::npos)
+            continue;
+        const uint32_t reg = Args::StringToUInt32 (name.c_str(), UINT32_MAX, 16);
+        if (reg >= m_reg_infos.size())
+            continue;
+        StringExtractor value_extractor (value.c_str());
+        value_extractor.GetHexBytes (&m_reg_data[m_stop_core][m_reg_infos[reg].offset], m_reg_infos[reg].byte_size, 0);
+    }
+}
+
+bool
+GDBRemoteSimulator::IsExited () const
+{
+    return !m_last_stop_reply.empty() && (m_last_stop_reply[0] == 'W' || m_last_stop_reply[0] == 'X');
+}
+
+void
+GDBRemoteSimulator::UpdateStopReply ()
+{
+    // With several cores the stop reply lists all of them so the client
+    // doesn't have to ask for the thread list
+    m_last_stop_reply = GetThreadStopReply (m_stop_core, m_reg_data.size() > 1);
+}
+
+std::string
+GDBRemoteSimulator::GetThreadStopReply (uint32_t core, bool list_threads) const
+{
+    StreamString stop_reply;
+    stop_reply.Printf ("T%2.2xthread:%" PRIx64 ";", m_core_signals[core], CoreToThreadID (core));
+    if (m_reg_data.size() > 1)
+    {
+        StreamString core_name;
+        core_name.Printf ("core %u", core);
+        stop_reply.PutCString ("hexname:");
+        stop_reply.PutCStringAsRawHex8 (core_name.GetData());
+        stop_reply.PutChar (';');
+    }
+    if (list_threads)
+    {
+        stop_reply.PutCString ("threads:");
+        for (uint32_t i = 0; i < m_reg_data.size(); ++i)
+            stop_reply.Printf ("%s%" PRIx64, i > 0 ? "," : "", CoreToThreadID (i));
+        stop_reply.PutChar (';');
+    }
+    const uint32_t expedited_regs[] = { m_pc_regnum, m_sp_regnum };
+    for (size_t i = 0; i < sizeof(expedited_regs)/sizeof(expedited_regs[0]); ++i)
+    {
+        const RegisterInfo &reg_info = m_reg_infos[expedited_regs[i]];
+        stop_reply.Printf ("%2.2x:", expedited_regs[i]);
+        stop_reply.PutBytesAsRawHex8 (&m_reg_data[core][reg_info.offset], reg_info.byte_size);
+        stop_reply.PutChar (';');
+    }
+    return stop_reply.GetString();
+}
+
+uint32_t
+GDBRemoteSimulator::GetPacketCore (const StringExtractorGDBRemote &packet, uint32_t default_core) const
+{
+    // Packets sent with the thread suffix end with ";thread:TID;"
+    const size_t thread_pos = packet.GetStringRef().find (";thread:");
+    if (thread_pos == std::string::npos)
+        return default_core;
+    StringExtractor tid_extractor (packet.GetStringRef().c_str() + thread_pos + strlen(";thread:"));
+    const uint64_t tid = tid_extractor.GetHexMaxU64 (false, 0);
+    return tid > 0 && tid <= m_reg_data.size() ? tid - 1 : default_core;
+}
+
+bool
+GDBRemoteSimulator::SendStopReply ()
+{
+    return SendPacketNoLock (m_last_stop_reply.c_str(), m_last_stop_reply.size()) > 0;
+}
+
+bool
+GDBRemoteSimulator::ReportResumeStop ()
+{
+    // In non-stop mode the resume is acknowledged right away and the stop
+    // follows as a notification. Only the resumed core moves and it has
+    // always stopped again by then, so "vStopped" never has more to report.
+    if (m_non_stop)
+    {
+        if (SendOKResponse () == 0)
+            return false;
+        std::string notification ("Stop:");
+        notification.append (m_last_stop_reply);
+        return SendNotificationNoLock (notification.c_str(), notification.size()) > 0;
+    }
+    return SendStopReply ();
+}
+
+bool
+GDBRemoteSimulator::Resume (uint32_t core, bool step)
+{
+    // Once the process exited, "W" and "X" replies keep being reported
+    if (IsExited())
+        return ReportResumeStop ();
+
+    m_stop_core = core;
+    if (!m_stop_replies.empty())
+    {
+        m_last_stop_reply = m_stop_replies.front();
+        m_stop_replies.pop_front();
+        ApplyStopReply (m_last_stop_reply);
+        return ReportResumeStop ();
+    }
+
+    const addr_t pc = GetRegisterValue (core, m_pc_regnum);
+    if (step)
+    {
+        SetRegisterValue (core, m_pc_regnum, GetNextInstructionAddress (pc));
+    }
+    else
+    {
+        // Run to the next breakpoint after the pc, or exit if there is none
+        std::set<addr_t>::const_iterator pos = m_breakpoints.upper_bound (pc);
+        if (pos == m_breakpoints.end())
+        {
+            m_last_stop_reply = "W00";
+            return ReportResumeStop ();
+        }
+        SetRegisterValue (core, m_pc_regnum, *pos);
+    }
+    m_core_signals.assign (m_core_signals.size(), 0);
+    m_core_signals[core] = SIGTRAP;
+    UpdateStopReply ();
+    return ReportResumeStop ();
+}
+
+size_t
+GDBRemoteSimulator::SendPacketNoLock (const char *payload, size_t payload_length)
+{
+    // Charge the latency once per response and the bandwidth for both the
+    // request and the response, including the "$" and "#XX" framing
+    uint64_t delay_usec = m_options.latency_usec;
+    if (m_options.bytes_per_second > 0)
+        delay_usec += ((m_request_size + payload_length + 4) * 1000000ull) / m_options.bytes_per_second;
+    m_request_size = 0;
+    if (delay_usec > 0)
+        ::usleep (delay_usec);
+    return GDBRemoteCommunicationServer::SendPacketNoLock (payload, payload_length);
+}
+
+bool
+GDBRemoteSimulator::HandlePacket (StringExtractorGDBRemote &packet,
+                                  Error &error,
+                                  bool &interrupt,
+                                  bool &quit)
+{
+    const std::string &packet_str = packet.GetStringRef();
+    m_request_size = packet_str.size() + 4;
+    if (packet_str.empty())
+        return GDBRemoteCommunicationServer::HandlePacket (packet, error, interrupt, quit);
+
+    switch (packet_str[0])
+    {
+        case '?':
+            return SendStopReply ();
+
+        case 'c':
+        case 'C':
+            return Resume (m_run_core, false);
+
+        case 's':
+        case 'S':
+            return Resume (m_run_core, true);
+
+        case 'g':
+            return Handle_g (packet);
+
+        case 'G':
+            return Handle_G (packet);
+
+        case 'p':
+            return Handle_p (packet);
+
+        case 'P':
+            return Handle_P (packet);
+
+        case 'm':
+            return Handle_m (packet);
+
+        case 'M':
+            return Handle_M (packet);
+
+        case 'Z':
+            return Handle_Z (packet, true);
+
+        case 'z':
+            return Handle_Z (packet, false);
+
+        case 'H':
+            return Handle_H (packet);
+
+        case 'D':
+            quit = true;
+            return SendOKResponse ();
+
+        case 'k':
+            quit = true;
+            m_last_stop_reply = "X09";
+            return SendStopReply ();
+
+        case 'v':
+            if (packet_str.compare (0, 5, "vCont") == 0)
+                return Handle_vCont (packet);
+            if (packet_str.compare ("vStopped") == 0)
+                return SendOKResponse ();
+            break;
+
+        case 'q':
+            if (packet_str.compare ("qC") == 0)
+            {
+                StreamString response;
+                response.Printf ("QC%" PRIx64, g_sim_pid);
+                return SendPacketNoLock (response.GetData(), response.GetSize());
+            }
+            if (packet_str.compare ("qHostInfo") == 0)
+                return Handle_qHostInfo (packet);
+            if (packet_str.compare (0, 13, "qRegisterInfo") == 0)
+                return Handle_qRegisterInfo (packet);
+            if (packet_str.compare (0, 17, "qMemoryRegionInfo") == 0)
+                return Handle_qMemoryRegionInfo (packet);
+            if (packet_str.compare (0, 15, "qThreadStopInfo") == 0)
+                return Handle_qThreadStopInfo (packet);
+            if (packet_str.compare (0, 21, "qMultiThreadStopInfo:") == 0)
+                return Handle_qMultiThreadStopInfo (packet);
+            if (packet_str.compare ("qfThreadInfo") == 0)
+            {
+                StreamString response;
+                response.PutChar ('m');
+                for (uint32_t core = 0; core < m_reg_data.size(); ++core)
+                    response.Printf ("%s%" PRIx64, core > 0 ? "," : "", CoreToThreadID (core));
+                return SendPacketNoLock (response.GetData(), response.GetSize());
+            }
+            if (packet_str.compare ("qsThreadInfo") == 0)
+                return SendPacketNoLock ("l", 1);
+            if (packet_str.compare (0, 10, "qSupported") == 0 && m_options.qsupported)
+            {
+                const char *features = "PacketSize=20000;QNonStop+;qMultiThreadStopInfo+";
+                return SendPacketNoLock (features, strlen(features));
+            }
+            break;
+
+        case 'Q':
+            if (packet_str.compare ("QThreadSuffixSupported") == 0 ||
+                packet_str.compare ("QListThreadsInStopReply") == 0)
+                return SendOKResponse ();
+            if (packet_str.compare (0, 9, "QNonStop:") == 0)
+            {
+                m_non_stop = packet_str.compare (9, std::string::npos, "0") != 0;
+                return SendOKResponse ();
+            }
+            break;
+    }
+    return GDBRemoteCommunicationServer::HandlePacket (packet, error, interrupt, quit);
+}
+
+bool
+GDBRemoteSimulator::Handle_qHostInfo (StringExtractorGDBRemote &packet)
+{
+    StreamString response;
+    response.PutCString ("triple:");
+    response.PutCStringAsRawHex8 (m_arch.GetTriple().getTriple().c_str());
+    response.Printf (";ptrsize:%u;", m_arch.GetAddressByteSize());
+    response.PutCString ("watchpoint_exceptions_received:after;");
+    switch (m_arch.GetByteOrder())
+    {
+    case eByteOrderBig:     response.PutCString ("endian:big;"); break;
+    case eByteOrderLittle:  response.PutCString ("endian:little;"); break;
+    default:                response.PutCString ("endian:unknown;"); break;
+    }
+    return SendPacketNoLock (response.GetData(), response.GetSize());
+}
+
+bool
+GDBRemoteSimulator::Handle_qRegisterInfo (StringExtractorGDBRemote &packet)
+{
+    packet.SetFilePos (::strlen ("qRegisterInfo"));
+    const uint32_t reg = packet.GetHexMaxU32 (false, UINT32_MAX);
+    if (reg >= m_reg_infos.size())
+        return SendErrorResponse (0x45);
+
+    const RegisterInfo &reg_info = m_reg_infos[reg];
+    StreamString response;
+    response.Printf ("name:%s;", reg_info.name.c_str());
+    if (!reg_info.alt_name.empty())
+        response.Printf ("alt-name:%s;", reg_info.alt_name.c_str());
+    response.Printf ("bitsize:%u;offset:%u;encoding:uint;format:hex;set:%s;dwarf:%u;",
+                     reg_info.byte_size * 8,
+                     reg_info.offset,
+                     reg_info.set_name.c_str(),
+                     reg_info.dwarf);
+    if (!reg_info.generic.empty())
+        response.Printf ("generic:%s;", reg_info.generic.c_str());
+    return SendPacketNoLock (response.GetData(), response.GetSize());
+}
+
+bool
+GDBRemoteSimulator::Handle_qMemoryRegionInfo (StringExtractorGDBRemote &packet)
+{
+    packet.SetFilePos (::strlen ("qMemoryRegionInfo:"));
+    const addr_t addr = packet.GetHexMaxU64 (false, LLDB_INVALID_ADDRESS);
+    if (addr == LLDB_INVALID_ADDRESS)
+        return SendErrorResponse (0x16);
+
+    StreamString response;
+    MemoryMap::const_iterator pos = FindRegion (addr);
+    if (pos != m_memory.end())
+    {
+        response.Printf ("start:%" PRIx64 ";size:%" PRIx64 ";permissions:%s%s%s;",
+                         pos->first,
+                         (uint64_t)pos->second.bytes.size(),
+                         pos->second.permissions & ePermissionsReadable ? "r" : "",
+                         pos->second.permissions & ePermissionsWritable ? "w" : "",
+                         pos->second.permissions & ePermissionsExecutable ? "x" : "");
+    }
+    else
+    {
+        // Describe the unmapped gap up to the next region
+        pos = m_memory.upper_bound (addr);
+        const addr_t end_addr = pos == m_memory.end() ? LLDB_INVALID_ADDRESS : pos->first;
+        response.Printf ("start:%" PRIx64 ";size:%" PRIx64 ";", addr, end_addr - addr);
+    }
+    return SendPacketNoLock (response.GetData(), response.GetSize());
+}
+
+bool
+GDBRemoteSimulator::Handle_g (StringExtractorGDBRemote &packet)
+{
+    const std::vector<uint8_t> &reg_data = m_reg_data[GetPacketCore (packet, m_curr_core)];
+    StreamString response;
+    response.PutBytesAsRawHex8 (&reg_data[0], reg_data.size());
+    return SendPacketNoLock (response.GetData(), response.GetSize());
+}
+
+bool
+GDBRemoteSimulator::Handle_G (StringExtractorGDBRemote &packet)
+{
+    const uint32_t core = GetPacketCore (packet, m_curr_core);
+    packet.SetFilePos (1);
+    std::vector<uint8_t> reg_data (m_reg_data[core].size());
+    if (packet.GetHexBytes (&reg_data[0], reg_data.size(), 0) != reg_data.size())
+        return SendErrorResponse (0x47);
+    m_reg_data[core].swap (reg_data);
+    return SendOKResponse ();
+}
+
+bool
+GDBRemoteSimulator::Handle_p (StringExtractorGDBRemote &packet)
+{
+    // "pNN" optionally followed by ";thread:TID;"
+    packet.SetFilePos (1);
+    const uint32_t reg = packet.GetHexMaxU32 (false, UINT32_MAX);
+    if (reg >= m_reg_infos.size())
+        return SendErrorResponse (0x15);
+
+    const uint32_t core = GetPacketCore (packet, m_curr_core);
+    StreamString response;
+    response.PutBytesAsRawHex8 (&m_reg_data[core][m_reg_infos[reg].offset], m_reg_infos[reg].byte_size);
+    return SendPacketNoLock (response.GetData(), response.GetSize());
+}
+
+bool
+GDBRemoteSimulator::Handle_P (StringExtractorGDBRemote &packet)
+{
+    // "PNN=VALUE" optionally followed by ";thread:TID;"
+    packet.SetFilePos (1);
+    const uint32_t reg = packet.GetHexMaxU32 (false, UINT32_MAX);
+    if (reg >= m_reg_infos.size() || packet.GetChar() != '=')
+        return SendErrorResponse (0x15);
+
+    const RegisterInfo &reg_info = m_reg_infos[reg];
+    uint8_t value[16];
+    if (reg_info.byte_size > sizeof(value) || packet.GetHexBytes (value, reg_info.byte_size, 0) != reg_info.byte_size)
+        return SendErrorResponse (0x32);
+    ::memcpy (&m_reg_data[GetPacketCore (packet, m_curr_core)][reg_info.offset], value, reg_info.byte_size);
+    return SendOKResponse ();
+}
+
+bool
+GDBRemoteSimulator::Handle_m (StringExtractorGDBRemote &packet)
+{
+    // "mADDR,LENGTH"
+    packet.SetFilePos (1);
+    const addr_t addr = packet.GetHexMaxU64 (false, LLDB_INVALID_ADDRESS);
+    if (addr == LLDB_INVALID_ADDRESS || packet.GetChar() != ',')
+        return SendErrorResponse (0x08);
+    const size_t length = std::min<size_t> (packet.GetHexMaxU64 (false, 0), g_max_memory_read_size);
+
+    uint8_t bytes[g_max_memory_read_size];
+    const size_t bytes_read = ReadMemory (addr, bytes, length);
+    if (bytes_read == 0)
+        return SendErrorResponse (0x08);
+
+    StreamString response;
+    response.PutBytesAsRawHex8 (bytes, bytes_read);
+    return SendPacketNoLock (response.GetData(), response.GetSize());
+}
+
+bool
+GDBRemoteSimulator::Handle_M (StringExtractorGDBRemote &packet)
+{
+    // "MADDR,LENGTH:BYTES"
+    packet.SetFilePos (1);
+    const addr_t addr = packet.GetHexMaxU64 (false, LLDB_INVALID_ADDRESS);
+    if (addr == LLDB_INVALID_ADDRESS || packet.GetChar() != ',')
+        return SendErrorResponse (0x09);
+    const size_t length = packet.GetHexMaxU64 (false, 0);
+    if (packet.GetChar() != ':')
+        return SendErrorResponse (0x09);
+
+    std::vector<uint8_t> bytes (length);
+    if (length > 0 && packet.GetHexBytes (&bytes[0], length, 0) != length)
+        return SendErrorResponse (0x09);
+    if (WriteMemory (addr, bytes.empty() ? NULL : &bytes[0], length) != length)
+        return SendErrorResponse (0x09);
+    return SendOKResponse ();
+}
+
+bool
+GDBRemoteSimulator::Handle_Z (StringExtractorGDBRemote &packet, bool insert)
+{
+    // "Z0,ADDR,KIND" and "Z1,ADDR,KIND", watchpoints aren't simulated
+    packet.SetFilePos (1);
+    const uint32_t type = packet.GetHexMaxU32 (false, UINT32_MAX);
+    if (type > 1)
+        return SendUnimplementedResponse (packet.GetStringRef().c_str()) > 0;
+    if (packet.GetChar() != ',')
+        return SendErrorResponse (0x0a);
+    const addr_t addr = packet.GetHexMaxU64 (false, LLDB_INVALID_ADDRESS);
+    if (addr == LLDB_INVALID_ADDRESS)
+        return SendErrorResponse (0x0a);
+
+    if (insert)
+        m_breakpoints.insert (addr);
+    else
+        m_breakpoints.erase (addr);
+    return SendOKResponse ();
+}
+
+bool
+GDBRemoteSimulator::Handle_H (StringExtractorGDBRemote &packet)
+{
+    // "HgTID" selects the core for register accesses and "HcTID" the core
+    // that resumes. Zero and -1 stand for any core and keep the selection.
+    const std::string &packet_str = packet.GetStringRef();
+    if (packet_str.size() < 3 || (packet_str[1] != 'g' && packet_str[1] != 'c'))
+        return SendErrorResponse (0x10);
+    if (packet_str[2] == '-')
+        return SendOKResponse ();
+
+    packet.SetFilePos (2);
+    const uint64_t tid = packet.GetHexMaxU64 (false, 0);
+    if (tid > m_reg_data.size())
+        return SendErrorResponse (0x10);
+    if (tid > 0)
+    {
+        if (packet_str[1] == 'g')
+            m_curr_core = tid - 1;
+        else
+            m_run_core = tid - 1;
+    }
+    return SendOKResponse ();
+}
+
+bool
+GDBRemoteSimulator::Handle_qThreadStopInfo (StringExtractorGDBRemote &packet)
+{
+    packet.SetFilePos (::strlen ("qThreadStopInfo"));
+    const uint64_t tid = packet.GetHexMaxU64 (false, 0);
+    if (tid == 0 || tid > m_reg_data.size())
+        return SendErrorResponse (0x10);
+    if (IsExited() || tid - 1 == m_stop_core)
+        return SendStopReply ();
+
+    const std::string stop_reply (GetThreadStopReply (tid - 1, false));
+    return SendPacketNoLock (stop_reply.c_str(), stop_reply.size()) > 0;
+}
+
+bool
+GDBRemoteSimulator::Handle_qMultiThreadStopInfo (StringExtractorGDBRemote &packet)
+{
+    // "qMultiThreadStopInfo:TID[,TID...]" is answered with the stop
+    // replies of all listed threads separated by '|'
+    if (IsExited())
+        return SendStopReply ();
+
+    packet.SetFilePos (::strlen ("qMultiThreadStopInfo:"));
+    std::string response;
+    while (packet.GetBytesLeft() > 0)
+    {
+        const uint64_t tid = packet.GetHexMaxU64 (false, 0);
+        if (tid == 0 || tid > m_reg_data.size())
+            return SendErrorResponse (0x10);
+        if (!response.empty())
+            response.push_back ('|');
+        if (tid - 1 == m_stop_core)
+            response.append (m_last_stop_reply);
+        else
+            response.append (GetThreadStopReply (tid - 1, false));
+        if (packet.GetBytesLeft() > 0 && packet.GetChar() != ',')
+            return SendErrorResponse (0x10);
+    }
+    return SendPacketNoLock (response.c_str(), response.size()) > 0;
+}
+
+bool
+GDBRemoteSimulator::Handle_vCont (StringExtractorGDBRemote &packet)
+{
+    const std::string &packet_str = packet.GetStringRef();
+    if (packet_str.compare ("vCont?") == 0)
+        return SendPacketNoLock ("vCont;c;C;s;S;t", 15);
+
+    // Resumes finish before they are acknowledged, so there is never a
+    // running thread to stop
+    if (packet_str.compare (0, 7, "vCont;t") == 0)
+        return SendOKResponse ();
+
+    // "vCont;ACTION[:TID][;ACTION[:TID]]...". Only one core moves: the
+    // first stepping core, else the first core an action names, else the
+    // core selected with "Hc".
+    if (packet_str.size() < 7 || packet_str[5] != ';')
+        return SendErrorResponse (0x0b);
+    uint32_t core = m_run_core;
+    bool step = false;
+    bool core_named = false;
+    for (size_t pos = 5; pos != std::string::npos; pos = packet_str.find (';', pos + 1))
+    {
+        const char action = pos + 1 < packet_str.size() ? packet_str[pos + 1] : '\0';
+        const bool action_steps = action == 's' || action == 'S';
+        if (step && !action_steps)
+            continue;
+
+        uint64_t tid = 0;
+        const size_t colon_pos = packet_str.find (':', pos + 1);
+        if (colon_pos != std::string::npos && colon_pos < packet_str.find (';', pos + 1))
+        {
+            StringExtractor tid_extractor (packet_str.c_str() + colon_pos + 1);
+            tid = tid_extractor.GetHexMaxU64 (false, 0);
+        }
+        const bool names_core = tid > 0 && tid <= m_reg_data.size();
+
+        if (action_steps && !step)
+        {
+            step = true;
+            core_named = names_core;
+            if (names_core)
+                core = tid - 1;
+        }
+        else if (names_core && !core_named)
+        {
+            core_named = true;
+            core = tid - 1;
+        }
+    }
+    return Resume (core, step);
+}
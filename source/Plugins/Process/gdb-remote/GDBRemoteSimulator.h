@@ -0,0 +1,253 @@
+//===-- GDBRemoteSimulator.h ------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_GDBRemoteSimulator_h_
+#define liblldb_GDBRemoteSimulator_h_
+
+// C Includes
+// C++ Includes
+#include <deque>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+// Other libraries and framework includes
+// Project includes
+#include "lldb/Core/ArchSpec.h"
+
+#include "GDBRemoteCommunicationServer.h"
+
+//----------------------------------------------------------------------
+// GDBRemoteSimulator
+//
+// A gdb-remote server that stands in for a real target so the traffic
+// between ProcessGDBRemote and a stub can be timed reproducibly. The
+// simulated target consists of the allocated sections of an ELF file
+// mapped at their link addresses, a stack and one or more cores, each
+// with its own register file and reported as a thread. Nothing is
+// executed: single steps advance the pc of the resumed core by one
+// instruction, continues run it to the next breakpoint after its pc,
+// and a file of canned stop replies can override both. The other cores
+// stop along without a stop reason. Every response can be delayed by a
+// fixed latency and by its size over a given bandwidth.
+//
+// The simulator runs on its own thread inside the debugger and is
+// reached with a "sim://" URL, for example:
+//
+//   process connect sim:///path/to/a.out?latency=500;bandwidth=115200
+//
+// Options following the '?' are separated by ';':
+//   latency=USEC           delay every response by USEC microseconds
+//   bandwidth=BYTES        additionally delay responses by their size
+//                          at BYTES bytes per second
+//   stop-replies=PATH      file with one stop reply packet per line that
+//                          is consumed by each resume
+//   stack-size=BYTES       size of the simulated stack
+//   cores=COUNT            number of simulated cores, all running the
+//                          same image
+//   qsupported=BOOL        answer qSupported, on by default; off makes
+//                          the simulator look like a stub without it
+//----------------------------------------------------------------------
+class GDBRemoteSimulator : public GDBRemoteCommunicationServer
+{
+public:
+    struct Options
+    {
+        Options () :
+            elf_path (),
+            stop_replies_path (),
+            latency_usec (0),
+            bytes_per_second (0),
+            stack_size (0x10000),
+            num_cores (1),
+            qsupported (true)
+        {
+        }
+
+        std::string elf_path;
+        std::string stop_replies_path;
+        uint32_t latency_usec;
+        uint64_t bytes_per_second;  // Zero means unlimited bandwidth
+        uint32_t stack_size;
+        uint32_t num_cores;
+        bool qsupported;
+    };
+
+    GDBRemoteSimulator (const Options &options);
+
+    virtual
+    ~GDBRemoteSimulator();
+
+    static bool
+    IsSimulatorURL (const char *url);
+
+    static bool
+    ParseURL (const char *url, Options &options, lldb_private::Error &error);
+
+    //------------------------------------------------------------------
+    // Load the ELF image and the canned stop replies, then start serving
+    // packets on a new thread. On success "client_url" is set to the
+    // URL a GDBRemoteCommunicationClient should connect to.
+    //------------------------------------------------------------------
+    lldb_private::Error
+    Start (std::string &client_url);
+
+    const lldb_private::ArchSpec &
+    GetArchitecture () const
+    {
+        return m_arch;
+    }
+
+protected:
+    struct RegisterInfo
+    {
+        std::string name;
+        std::string alt_name;
+        std::string set_name;
+        std::string generic;
+        uint32_t byte_size;
+        uint32_t offset;
+        uint32_t dwarf;
+    };
+
+    struct MemoryRegion
+    {
+        std::vector<uint8_t> bytes;
+        uint32_t permissions;   // ePermissions bits
+    };
+
+    typedef std::map<lldb::addr_t, MemoryRegion> MemoryMap;
+
+    virtual bool
+    HandlePacket (StringExtractorGDBRemote &packet,
+                  lldb_private::Error &error,
+                  bool &interrupt,
+                  bool &quit);
+
+    virtual size_t
+    SendPacketNoLock (const char *payload,
+                      size_t payload_length);
+
+    bool
+    Handle_qHostInfo (StringExtractorGDBRemote &packet);
+
+    bool
+    Handle_qRegisterInfo (StringExtractorGDBRemote &packet);
+
+    bool
+    Handle_qMemoryRegionInfo (StringExtractorGDBRemote &packet);
+
+    bool
+    Handle_g (StringExtractorGDBRemote &packet);
+
+    bool
+    Handle_G (StringExtractorGDBRemote &packet);
+
+    bool
+    Handle_p (StringExtractorGDBRemote &packet);
+
+    bool
+    Handle_P (StringExtractorGDBRemote &packet);
+
+    bool
+    Handle_m (StringExtractorGDBRemote &packet);
+
+    bool
+    Handle_M (StringExtractorGDBRemote &packet);
+
+    bool
+    Handle_Z (StringExtractorGDBRemote &packet, bool insert);
+
+    bool
+    Handle_H (StringExtractorGDBRemote &packet);
+
+    bool
+    Handle_qThreadStopInfo (StringExtractorGDBRemote &packet);
+
+    bool
+    Handle_qMultiThreadStopInfo (StringExtractorGDBRemote &packet);
+
+    bool
+    Handle_vCont (StringExtractorGDBRemote &packet);
+
+    bool
+    Resume (uint32_t core, bool step);
+
+    bool
+    ReportResumeStop ();
+
+    bool
+    IsExited () const;
+
+    void
+    UpdateStopReply ();
+
+    std::string
+    GetThreadStopReply (uint32_t core, bool list_threads) const;
+
+    uint32_t
+    GetPacketCore (const StringExtractorGDBRemote &packet, uint32_t default_core) const;
+
+    bool
+    SendStopReply ();
+
+    lldb_private::Error
+    LoadMemoryImage ();
+
+    lldb_private::Error
+    LoadStopReplies ();
+
+    void
+    BuildRegisterFile ();
+
+    void
+    ApplyStopReply (const std::string &stop_reply);
+
+    size_t
+    ReadMemory (lldb::addr_t addr, void *dst, size_t length) const;
+
+    size_t
+    WriteMemory (lldb::addr_t addr, const void *src, size_t length);
+
+    MemoryMap::const_iterator
+    FindRegion (lldb::addr_t addr) const;
+
+    uint64_t
+    GetRegisterValue (uint32_t core, uint32_t reg) const;
+
+    void
+    SetRegisterValue (uint32_t core, uint32_t reg, uint64_t value);
+
+    lldb::addr_t
+    GetNextInstructionAddress (lldb::addr_t pc) const;
+
+    Options m_options;
+    lldb_private::ArchSpec m_arch;
+    lldb::addr_t m_entry_point;
+    MemoryMap m_memory;
+    std::vector<RegisterInfo> m_reg_infos;
+    std::vector< std::vector<uint8_t> > m_reg_data;    // Register file of each core
+    std::vector<uint8_t> m_core_signals;        // Stop signal of each core, zero for cores that stopped along
+    uint32_t m_pc_regnum;
+    uint32_t m_sp_regnum;
+    std::set<lldb::addr_t> m_breakpoints;
+    std::deque<std::string> m_stop_replies;
+    std::string m_last_stop_reply;
+    uint32_t m_curr_core;       // Selected with "Hg"
+    uint32_t m_run_core;        // Selected with "Hc"
+    uint32_t m_stop_core;       // The core whose stop ended the last resume
+    size_t m_request_size;      // Size of the packet being answered, for the bandwidth delay
+    bool m_non_stop;            // Set by "QNonStop:1"
+
+private:
+    DISALLOW_COPY_AND_ASSIGN (GDBRemoteSimulator);
+};
+
+#endif  // liblldb_GDBRemoteSimulator_h_
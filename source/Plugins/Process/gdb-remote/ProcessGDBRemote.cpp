@@ -60,6 +60,8 @@
 #include "Plugins/Platform/MacOSX/PlatformRemoteiOS.h"
 #include "Utility/StringExtractorGDBRemote.h"
 #include "GDBRemoteRegisterContext.h"
+#include "GDBRemoteReplayServer.h"
+#include "GDBRemoteSimulator.h"
 #include "ProcessGDBRemote.h"
 #include "ProcessGDBRemoteLog.h"
 #include "ThreadGDBRemote.h"
@@ -185,6 +187,7 @@ ProcessGDBRemote::ProcessGDBRemote(Target& target, Listener &listener) :
     m_flags (0),
     m_gdb_comm(false),
     m_debugserver_pid (LLDB_INVALID_PROCESS_ID),
+    m_local_server_ap (),
     m_last_stop_packet (),
     m_last_stop_packet_mutex (Mutex::eMutexTypeNormal),
     m_register_info (),
@@ -197,6 +200,7 @@ ProcessGDBRemote::ProcessGDBRemote(Target& target, Listener &listener) :
     m_continue_C_tids (),
     m_continue_s_tids (),
     m_continue_S_tids (),
+    m_non_stop_running_tids (),
     m_dispatch_queue_offsets_addr (LLDB_INVALID_ADDRESS),
     m_max_memory_size (512),
     m_addr_to_mmap_size (),
@@ -480,7 +484,14 @@ ProcessGDBRemote::DoConnectRemote (Stream *strm, const char *remote_url)
     if (error.Fail())
         return error;
 
-    error = ConnectToDebugserver (remote_url);
+    // "sim://" and "replay://" URLs start a server inside this process
+    // and connect to it instead of a remote stub
+    std::string connect_url (remote_url ? remote_url : "");
+    error = StartLocalServer (remote_url, connect_url);
+    if (error.Fail())
+        return error;
+
+    error = ConnectToDebugserver (connect_url.c_str());
 
     if (error.Fail())
         return error;
@@ -760,6 +771,20 @@ ProcessGDBRemote::ConnectToDebugserver (const char *connect_url)
         return error;
     }
 
+    // Record the whole session, starting with the handshake, when asked
+    // to through the environment
+    const char *env_packet_trace_path = getenv("LLDB_GDB_REMOTE_PACKET_TRACE");
+    if (env_packet_trace_path && env_packet_trace_path[0] && !m_gdb_comm.GetPacketTrace().IsRecording())
+    {
+        Error trace_error;
+        if (!m_gdb_comm.GetPacketTrace().StartRecording (env_packet_trace_path, trace_error))
+        {
+            Log *log (ProcessGDBRemoteLog::GetLogIfAllCategoriesSet (GDBR_LOG_PROCESS));
+            if (log)
+                log->Printf ("ProcessGDBRemote::%s failed to record packets to '%s': %s", __FUNCTION__, env_packet_trace_path, trace_error.AsCString());
+        }
+    }
+
     // We always seem to be able to open a connection to a local port
     // so we need to make sure we can then send data to it. If we can't
     // then we aren't actually connected to anything, so try and do the
@@ -779,6 +804,15 @@ ProcessGDBRemote::ConnectToDebugserver (const char *connect_url)
     m_gdb_comm.GetHostInfo ();
     m_gdb_comm.GetVContSupported ('c');
     m_gdb_comm.GetVAttachOrWaitSupported();
+
+    // If the remote stub tells us how large a packet it can handle, size our
+    // memory reads and writes accordingly so that bulk reads like the stack
+    // prefetch done while backtracing take as few round trips as possible.
+    // Memory is hex encoded, so each byte takes two characters, and we
+    // leave room for the packet header, address and length.
+    const uint64_t max_packet_size = m_gdb_comm.GetRemoteMaxPacketSize();
+    if (max_packet_size > 128)
+        m_max_memory_size = (max_packet_size - 64) / 2;
     
     size_t num_cmds = GetExtraStartupCommands().GetArgumentCount();
     for (size_t idx = 0; idx < num_cmds; idx++)
@@ -856,9 +890,50 @@ ProcessGDBRemote::DidLaunchOrAttach ()
                 target_arch = gdb_remote_arch;
             }
         }
+
+        EnableNonStopModeIfRequested ();
+    }
+}
+
+void
+ProcessGDBRemote::EnableNonStopModeIfRequested ()
+{
+    // Non-stop mode lets the threads (the cores of a multi-core target)
+    // stop and resume individually instead of all at once. It changes
+    // what a stop means, so it is only used when asked for.
+    const char *env_non_stop = getenv("LLDB_GDB_REMOTE_NON_STOP");
+    if (env_non_stop == NULL || env_non_stop[0] == '\0' || ::strcmp (env_non_stop, "0") == 0)
+        return;
+    if (m_gdb_comm.GetNonStopMode())
+        return;
+
+    Log *log (ProcessGDBRemoteLog::GetLogIfAllCategoriesSet (GDBR_LOG_PROCESS));
+    const char *reason = NULL;
+    if (!m_gdb_comm.GetNonStopModeSupported())
+        reason = "the remote stub doesn't support QNonStop";
+    else if (m_gdb_comm.GetSendAcks())
+        reason = "the remote stub doesn't support no-ack mode";
+    else if (!m_gdb_comm.GetVContSupported ('c') || !m_gdb_comm.GetVContSupported ('s'))
+        reason = "the remote stub doesn't support vCont";
+    else if (!m_gdb_comm.SetNonStopMode (true))
+        reason = "QNonStop:1 failed";
+
+    m_non_stop_running_tids.clear();
+    if (log)
+    {
+        if (reason)
+            log->Printf ("ProcessGDBRemote::%s not using non-stop mode: %s", __FUNCTION__, reason);
+        else
+            log->Printf ("ProcessGDBRemote::%s using non-stop mode", __FUNCTION__);
     }
 }
 
+bool
+ProcessGDBRemote::NonStopThreadIsRunning (lldb::tid_t tid) const
+{
+    return std::find (m_non_stop_running_tids.begin(), m_non_stop_running_tids.end(), tid) != m_non_stop_running_tids.end();
+}
+
 void
 ProcessGDBRemote::DidLaunch ()
 {
@@ -1033,7 +1108,57 @@ ProcessGDBRemote::DoResume ()
 
         StreamString continue_packet;
         bool continue_packet_error = false;
-        if (m_gdb_comm.HasAnyVContSupport ())
+        if (m_gdb_comm.GetNonStopMode ())
+        {
+            // Only resume the threads that are stopped at the stub, threads
+            // that kept running after the last stop are left alone. There is
+            // no "c" shortcut either since that would resume every thread.
+            continue_packet.PutCString ("vCont");
+            for (tid_collection::const_iterator t_pos = m_continue_c_tids.begin(), t_end = m_continue_c_tids.end(); t_pos != t_end; ++t_pos)
+            {
+                if (!NonStopThreadIsRunning (*t_pos))
+                {
+                    continue_packet.Printf(";c:%4.4" PRIx64, *t_pos);
+                    m_non_stop_running_tids.push_back (*t_pos);
+                }
+            }
+            for (tid_sig_collection::const_iterator s_pos = m_continue_C_tids.begin(), s_end = m_continue_C_tids.end(); s_pos != s_end; ++s_pos)
+            {
+                if (!NonStopThreadIsRunning (s_pos->first))
+                {
+                    continue_packet.Printf(";C%2.2x:%4.4" PRIx64, s_pos->second, s_pos->first);
+                    m_non_stop_running_tids.push_back (s_pos->first);
+                }
+            }
+            for (tid_collection::const_iterator t_pos = m_continue_s_tids.begin(), t_end = m_continue_s_tids.end(); t_pos != t_end; ++t_pos)
+            {
+                if (!NonStopThreadIsRunning (*t_pos))
+                {
+                    continue_packet.Printf(";s:%4.4" PRIx64, *t_pos);
+                    m_non_stop_running_tids.push_back (*t_pos);
+                }
+            }
+            for (tid_sig_collection::const_iterator s_pos = m_continue_S_tids.begin(), s_end = m_continue_S_tids.end(); s_pos != s_end; ++s_pos)
+            {
+                if (!NonStopThreadIsRunning (s_pos->first))
+                {
+                    continue_packet.Printf(";S%2.2x:%4.4" PRIx64, s_pos->second, s_pos->first);
+                    m_non_stop_running_tids.push_back (s_pos->first);
+                }
+            }
+
+            // With nothing left to resume, just wait for a running thread
+            // to stop
+            if (continue_packet.GetSize() == strlen("vCont"))
+            {
+                continue_packet.Clear();
+                if (m_non_stop_running_tids.empty())
+                    error.SetErrorString ("no threads to resume");
+            }
+            if (error.Fail())
+                return error;
+        }
+        else if (m_gdb_comm.HasAnyVContSupport ())
         {
             if (m_continue_c_tids.size() == num_threads)
             {
@@ -1625,10 +1750,106 @@ ProcessGDBRemote::SetThreadStopInfo (StringExtractor& stop_packet)
     return eStateInvalid;
 }
 
+static lldb::tid_t
+GetStopPacketThreadID (const StringExtractor &stop_packet)
+{
+    const char *thread_cstr = ::strstr (stop_packet.GetStringRef().c_str(), "thread:");
+    if (thread_cstr)
+    {
+        // The thread ID is followed by the rest of the packet
+        StringExtractor tid_extractor (thread_cstr + strlen("thread:"));
+        return tid_extractor.GetHexMaxU64 (false, LLDB_INVALID_THREAD_ID);
+    }
+    return LLDB_INVALID_THREAD_ID;
+}
+
+lldb::tid_t
+ProcessGDBRemote::SetNonStopThreadStopInfo (StringExtractorGDBRemote &stop_packet)
+{
+    // The thread that stopped is no longer running and might be one we
+    // haven't seen before. Mark it stopped before parsing the packet so its
+    // expedited registers have a register context to go into.
+    const lldb::tid_t tid = GetStopPacketThreadID (stop_packet);
+    if (tid != LLDB_INVALID_THREAD_ID)
+    {
+        m_non_stop_running_tids.erase (std::remove (m_non_stop_running_tids.begin(), m_non_stop_running_tids.end(), tid),
+                                       m_non_stop_running_tids.end());
+        if (!m_thread_ids.empty() && std::find (m_thread_ids.begin(), m_thread_ids.end(), tid) == m_thread_ids.end())
+            m_thread_ids.push_back (tid);
+    }
+
+    SetThreadStopInfo (stop_packet);
+    return tid;
+}
+
+void
+ProcessGDBRemote::UpdateThreadStopInfos (const tid_collection &reported_tids)
+{
+    // Every other stopped thread would otherwise ask for its stop info
+    // with its own "qThreadStopInfo" packet once the thread list looks at
+    // it. Multi-core targets report each core as a thread and stop all of
+    // them together, so fetch their stop replies, and with them the
+    // expedited registers, in a single packet instead.
+    if (m_thread_ids.size() <= reported_tids.size() || !m_gdb_comm.GetMultiThreadStopInfoSupported())
+        return;
+
+    tid_collection tids;
+    for (tid_collection::const_iterator pos = m_thread_ids.begin(), end = m_thread_ids.end(); pos != end; ++pos)
+    {
+        if (std::find (reported_tids.begin(), reported_tids.end(), *pos) == reported_tids.end() &&
+            !NonStopThreadIsRunning (*pos))
+            tids.push_back (*pos);
+    }
+
+    std::vector<std::string> stop_replies;
+    if (m_gdb_comm.GetThreadStopInfos (tids, stop_replies) == 0)
+        return;
+
+    StringExtractor stop_packet;
+    for (std::vector<std::string>::iterator pos = stop_replies.begin(), end = stop_replies.end(); pos != end; ++pos)
+    {
+        stop_packet.GetStringRef().swap (*pos);
+        SetThreadStopInfo (stop_packet);
+    }
+}
+
 void
 ProcessGDBRemote::RefreshStateAfterStop ()
 {
     Mutex::Locker locker(m_thread_list_real.GetMutex());
+    if (m_gdb_comm.GetNonStopMode())
+    {
+        // Only the threads that reported a stop changed, so keep the thread
+        // ID list instead of asking for all threads after every stop. The
+        // other threads keep running and report their own stops later.
+        tid_collection reported_tids;
+        reported_tids.push_back (SetNonStopThreadStopInfo (m_last_stop_packet));
+        StringExtractorGDBRemote stop_reply;
+        while (m_gdb_comm.GetPendingStopReply (stop_reply))
+            reported_tids.push_back (SetNonStopThreadStopInfo (stop_reply));
+        if (m_thread_ids.empty())
+            UpdateThreadIDList();
+        UpdateThreadStopInfos (reported_tids);
+        m_thread_list_real.RefreshStateAfterStop();
+
+        // Don't leave a thread that is still running selected, it has no
+        // frames to show. Pick the first thread that reported a stop. The
+        // refresh above already brought m_thread_list up to this stop.
+        ThreadSP selected_thread_sp (m_thread_list.GetSelectedThread());
+        if (!selected_thread_sp || NonStopThreadIsRunning (selected_thread_sp->GetProtocolID()))
+        {
+            for (tid_collection::const_iterator pos = reported_tids.begin(), end = reported_tids.end(); pos != end; ++pos)
+            {
+                if (*pos == LLDB_INVALID_THREAD_ID)
+                    continue;
+                ThreadSP thread_sp (m_thread_list.FindThreadByProtocolID (*pos, false));
+                if (thread_sp && m_thread_list.SetSelectedThreadByID (thread_sp->GetID()))
+                    break;
+            }
+        }
+        return;
+    }
+
     m_thread_ids.clear();
     // Set the thread stop info. It might have a "threads" key whose value is
     // a list of all thread IDs in the current process, so m_thread_ids might
@@ -1640,6 +1861,9 @@ ProcessGDBRemote::RefreshStateAfterStop ()
         // No, we need to fetch the thread list manually
         UpdateThreadIDList();
     }
+    const lldb::tid_t stop_tid = GetStopPacketThreadID (m_last_stop_packet);
+    if (stop_tid != LLDB_INVALID_THREAD_ID)
+        UpdateThreadStopInfos (tid_collection (1, stop_tid));
 
     // Let all threads recover from stopping and do any clean up based
     // on the previous thread state (if any).
@@ -1897,6 +2121,8 @@ ProcessGDBRemote::SetLastStopPacket (const StringExtractorGDBRemote &response)
 
         m_thread_list_real.Clear();
         m_thread_list.Clear();
+        m_thread_ids.clear();
+        m_non_stop_running_tids.clear();
         BuildDynamicRegisterInfo (true);
         m_gdb_comm.ResetDiscoverableSettings();
     }
@@ -2600,6 +2826,42 @@ ProcessGDBRemote::KillDebugserverProcess ()
         ::kill (m_debugserver_pid, SIGINT);
         m_debugserver_pid = LLDB_INVALID_PROCESS_ID;
     }
+
+    if (m_local_server_ap.get())
+    {
+        // The client side of the connection doesn't own the socket the
+        // local server handed out, so disconnect before the server closes it
+        m_gdb_comm.Disconnect();
+        m_local_server_ap.reset();
+    }
+}
+
+Error
+ProcessGDBRemote::StartLocalServer (const char *remote_url, std::string &connect_url)
+{
+    Error error;
+    if (GDBRemoteSimulator::IsSimulatorURL (remote_url))
+    {
+        GDBRemoteSimulator::Options options;
+        if (!GDBRemoteSimulator::ParseURL (remote_url, options, error))
+            return error;
+        GDBRemoteSimulator *simulator = new GDBRemoteSimulator (options);
+        m_local_server_ap.reset (simulator);
+        error = simulator->Start (connect_url);
+    }
+    else if (GDBRemoteReplayServer::IsReplayURL (remote_url))
+    {
+        GDBRemoteReplayServer::Options options;
+        if (!GDBRemoteReplayServer::ParseURL (remote_url, options, error))
+            return error;
+        GDBRemoteReplayServer *replay_server = new GDBRemoteReplayServer (options);
+        m_local_server_ap.reset (replay_server);
+        error = replay_server->Start (connect_url);
+    }
+
+    if (error.Fail())
+        m_local_server_ap.reset();
+    return error;
 }
 
 void
@@ -2732,9 +2994,11 @@ ProcessGDBRemote::AsyncThread (void *arg)
                                     const char *continue_cstr = (const char *)continue_packet->GetBytes ();
                                     const size_t continue_cstr_len = continue_packet->GetByteSize ();
                                     if (log)
-                                        log->Printf ("ProcessGDBRemote::%s (arg = %p, pid = %" PRIu64 ") got eBroadcastBitAsyncContinue: %s", __FUNCTION__, arg, process->GetID(), continue_cstr);
+                                        log->Printf ("ProcessGDBRemote::%s (arg = %p, pid = %" PRIu64 ") got eBroadcastBitAsyncContinue: %s", __FUNCTION__, arg, process->GetID(), continue_cstr ? continue_cstr : "");
 
-                                    if (::strstr (continue_cstr, "vAttach") == NULL)
+                                    // An empty continue packet waits for threads that are
+                                    // still running in non-stop mode
+                                    if (continue_cstr == NULL || ::strstr (continue_cstr, "vAttach") == NULL)
                                         process->SetPrivateState(eStateRunning);
                                     StringExtractorGDBRemote response;
                                     StateType stop_state = process->GetGDBRemote().SendContinuePacketAndWaitForResponse (process, continue_cstr, continue_cstr_len, response);
@@ -2742,8 +3006,10 @@ ProcessGDBRemote::AsyncThread (void *arg)
                                     // We need to immediately clear the thread ID list so we are sure to get a valid list of threads.
                                     // The thread ID list might be contained within the "response", or the stop reply packet that
                                     // caused the stop. So clear it now before we give the stop reply packet to the process
-                                    // using the process->SetLastStopPacket()...
-                                    process->ClearThreadIDList ();
+                                    // using the process->SetLastStopPacket()... In non-stop mode only the threads
+                                    // that stopped are updated and the list is kept.
+                                    if (!process->GetGDBRemote().GetNonStopMode())
+                                        process->ClearThreadIDList ();
 
                                     switch (stop_state)
                                     {
@@ -3140,6 +3406,176 @@ public:
     }
 };
 
+class CommandObjectProcessGDBRemotePacketTraceStart : public CommandObjectParsed
+{
+private:
+    
+public:
+    CommandObjectProcessGDBRemotePacketTraceStart(CommandInterpreter &interpreter) :
+        CommandObjectParsed (interpreter,
+                             "process plugin packet trace start",
+                             "Start recording every packet sent to and received from the GDB remote server, with timestamps, to a trace file.",
+                             "process plugin packet trace start <path>")
+    {
+    }
+    
+    ~CommandObjectProcessGDBRemotePacketTraceStart ()
+    {
+    }
+    
+    bool
+    DoExecute (Args& command, CommandReturnObject &result)
+    {
+        if (command.GetArgumentCount() != 1)
+        {
+            result.AppendErrorWithFormat ("'%s' takes a trace file path argument", m_cmd_name.c_str());
+            result.SetStatus (eReturnStatusFailed);
+            return false;
+        }
+
+        ProcessGDBRemote *process = (ProcessGDBRemote *)m_interpreter.GetExecutionContext().GetProcessPtr();
+        if (process)
+        {
+            Error error;
+            if (process->GetGDBRemote().GetPacketTrace().StartRecording (command.GetArgumentAtIndex(0), error))
+            {
+                result.SetStatus (eReturnStatusSuccessFinishNoResult);
+                return true;
+            }
+            result.AppendError (error.AsCString());
+        }
+        result.SetStatus (eReturnStatusFailed);
+        return false;
+    }
+};
+
+class CommandObjectProcessGDBRemotePacketTraceStop : public CommandObjectParsed
+{
+private:
+    
+public:
+    CommandObjectProcessGDBRemotePacketTraceStop(CommandInterpreter &interpreter) :
+        CommandObjectParsed (interpreter,
+                             "process plugin packet trace stop",
+                             "Stop recording GDB remote packets.",
+                             NULL)
+    {
+    }
+    
+    ~CommandObjectProcessGDBRemotePacketTraceStop ()
+    {
+    }
+    
+    bool
+    DoExecute (Args& command, CommandReturnObject &result)
+    {
+        const size_t argc = command.GetArgumentCount();
+        if (argc == 0)
+        {
+            ProcessGDBRemote *process = (ProcessGDBRemote *)m_interpreter.GetExecutionContext().GetProcessPtr();
+            if (process)
+            {
+                process->GetGDBRemote().GetPacketTrace().StopRecording();
+                result.SetStatus (eReturnStatusSuccessFinishNoResult);
+                return true;
+            }
+        }
+        else
+        {
+            result.AppendErrorWithFormat ("'%s' takes no arguments", m_cmd_name.c_str());
+        }
+        result.SetStatus (eReturnStatusFailed);
+        return false;
+    }
+};
+
+class CommandObjectProcessGDBRemotePacketTraceSummary : public CommandObjectParsed
+{
+private:
+    
+public:
+    CommandObjectProcessGDBRemotePacketTraceSummary(CommandInterpreter &interpreter) :
+        CommandObjectParsed (interpreter,
+                             "process plugin packet trace summary",
+                             "Summarize the round trips in a GDB remote packet trace: the count, latency and bytes of each kind of operation, "
+                             "with a latency histogram. Without a path the trace being recorded is summarized and recording stops.",
+                             "process plugin packet trace summary [<path>]")
+    {
+    }
+    
+    ~CommandObjectProcessGDBRemotePacketTraceSummary ()
+    {
+    }
+    
+    bool
+    DoExecute (Args& command, CommandReturnObject &result)
+    {
+        const size_t argc = command.GetArgumentCount();
+        std::string path;
+        if (argc == 1)
+        {
+            path = command.GetArgumentAtIndex(0);
+        }
+        else if (argc == 0)
+        {
+            // The trace file is only complete once recording has stopped
+            ProcessGDBRemote *process = (ProcessGDBRemote *)m_interpreter.GetExecutionContext().GetProcessPtr();
+            if (process)
+            {
+                GDBRemotePacketTrace &packet_trace = process->GetGDBRemote().GetPacketTrace();
+                if (packet_trace.GetPath())
+                    path = packet_trace.GetPath();
+                packet_trace.StopRecording();
+            }
+            if (path.empty())
+            {
+                result.AppendError ("no packet trace has been recorded, specify a trace file path");
+                result.SetStatus (eReturnStatusFailed);
+                return false;
+            }
+        }
+        else
+        {
+            result.AppendErrorWithFormat ("'%s' takes at most one trace file path argument", m_cmd_name.c_str());
+            result.SetStatus (eReturnStatusFailed);
+            return false;
+        }
+
+        Error error;
+        GDBRemotePacketTrace::collection entries;
+        if (!GDBRemotePacketTrace::ReadTrace (path.c_str(), entries, error))
+        {
+            result.AppendError (error.AsCString());
+            result.SetStatus (eReturnStatusFailed);
+            return false;
+        }
+        GDBRemotePacketTrace::DumpSummary (entries, result.GetOutputStream());
+        result.SetStatus (eReturnStatusSuccessFinishResult);
+        return true;
+    }
+};
+
+class CommandObjectProcessGDBRemotePacketTrace : public CommandObjectMultiword
+{
+private:
+    
+public:
+    CommandObjectProcessGDBRemotePacketTrace(CommandInterpreter &interpreter) :
+        CommandObjectMultiword (interpreter,
+                                "process plugin packet trace",
+                                "Commands that record GDB remote packets and analyze the recordings.",
+                                NULL)
+    {
+        LoadSubCommand ("start", CommandObjectSP (new CommandObjectProcessGDBRemotePacketTraceStart (interpreter)));
+        LoadSubCommand ("stop", CommandObjectSP (new CommandObjectProcessGDBRemotePacketTraceStop (interpreter)));
+        LoadSubCommand ("summary", CommandObjectSP (new CommandObjectProcessGDBRemotePacketTraceSummary (interpreter)));
+    }
+    
+    ~CommandObjectProcessGDBRemotePacketTrace ()
+    {
+    }    
+};
+
 class CommandObjectProcessGDBRemotePacket : public CommandObjectMultiword
 {
 private:
@@ -3154,6 +3590,7 @@ public:
         LoadSubCommand ("history", CommandObjectSP (new CommandObjectProcessGDBRemotePacketHistory (interpreter)));
         LoadSubCommand ("send", CommandObjectSP (new CommandObjectProcessGDBRemotePacketSend (interpreter)));
         LoadSubCommand ("monitor", CommandObjectSP (new CommandObjectProcessGDBRemotePacketMonitor (interpreter)));
+        LoadSubCommand ("trace", CommandObjectSP (new CommandObjectProcessGDBRemotePacketTrace (interpreter)));
     }
     
     ~CommandObjectProcessGDBRemotePacket ()
@@ -29,6 +29,7 @@
 #include "lldb/Target/Thread.h"
 
 #include "GDBRemoteCommunicationClient.h"
+#include "GDBRemoteCommunicationServer.h"
 #include "Utility/StringExtractor.h"
 #include "GDBRemoteRegisterContext.h"
 
@@ -282,6 +283,9 @@ protected:
     void
     KillDebugserverProcess ();
 
+    lldb_private::Error
+    StartLocalServer (const char *remote_url, std::string &connect_url);
+
     void
     BuildDynamicRegisterInfo (bool force);
 
@@ -308,6 +312,7 @@ protected:
     lldb_private::Flags m_flags;            // Process specific flags (see eFlags enums)
     GDBRemoteCommunicationClient m_gdb_comm;
     lldb::pid_t m_debugserver_pid;
+    std::unique_ptr<GDBRemoteCommunicationServer> m_local_server_ap;  // In-process server for "sim://" and "replay://" connections
     StringExtractorGDBRemote m_last_stop_packet;
     lldb_private::Mutex m_last_stop_packet_mutex;
     GDBRemoteDynamicRegisterInfo m_register_info;
@@ -323,6 +328,7 @@ protected:
     tid_sig_collection m_continue_C_tids; // 'C' for continue with signal
     tid_collection m_continue_s_tids;                  // 's' for step
     tid_sig_collection m_continue_S_tids; // 'S' for step with signal
+    tid_collection m_non_stop_running_tids; // Threads that kept running at the stub after the last stop in non-stop mode
     lldb::addr_t m_dispatch_queue_offsets_addr;
     size_t m_max_memory_size;       // The maximum number of bytes to read/write when reading and writing memory
     MMapMap m_addr_to_mmap_size;
@@ -356,6 +362,18 @@ protected:
     bool
     UpdateThreadIDList ();
 
+    void
+    UpdateThreadStopInfos (const tid_collection &reported_tids);
+
+    void
+    EnableNonStopModeIfRequested ();
+
+    bool
+    NonStopThreadIsRunning (lldb::tid_t tid) const;
+
+    lldb::tid_t
+    SetNonStopThreadStopInfo (StringExtractorGDBRemote &stop_packet);
+
     void
     DidLaunchOrAttach ();
 
@@ -131,10 +131,32 @@ ThreadGDBRemote::RefreshStateAfterStop()
     // which registers are valid by putting hooks in the register read and 
     // register supply functions where they check the process stop ID and do
     // the right thing.
+    //
+    // In non-stop mode a thread that didn't report a stop keeps running at
+    // the stub, so it has no registers or stop reason to refresh until its
+    // own stop reply arrives.
+    if (IsRunningInNonStopMode ())
+    {
+        SetState (eStateRunning);
+        SetStopInfo (StopInfoSP());
+        return;
+    }
     const bool force = false;
     GetRegisterContext()->InvalidateIfNeeded (force);
 }
 
+bool
+ThreadGDBRemote::IsRunningInNonStopMode ()
+{
+    ProcessSP process_sp (GetProcess());
+    if (process_sp)
+    {
+        ProcessGDBRemote *gdb_process = static_cast<ProcessGDBRemote *>(process_sp.get());
+        return gdb_process->NonStopThreadIsRunning (GetProtocolID());
+    }
+    return false;
+}
+
 bool
 ThreadGDBRemote::ThreadIDIsValid (lldb::tid_t thread)
 {
@@ -155,6 +177,10 @@ ThreadGDBRemote::ShouldStop (bool &step_more)
 lldb::RegisterContextSP
 ThreadGDBRemote::GetRegisterContext ()
 {
+    // A running thread's registers can't be read, so don't hand out a
+    // register context that would make it look stopped
+    if (IsRunningInNonStopMode ())
+        return lldb::RegisterContextSP();
     if (m_reg_context_sp.get() == NULL)
         m_reg_context_sp = CreateRegisterContextForFrame (NULL);
     return m_reg_context_sp;
@@ -205,6 +231,10 @@ ThreadGDBRemote::CalculateStopInfo ()
     {
         StringExtractorGDBRemote stop_packet;
         ProcessGDBRemote *gdb_process = static_cast<ProcessGDBRemote *>(process_sp.get());
+        // A thread that is still running in non-stop mode has no stop info
+        // to ask the stub for
+        if (IsRunningInNonStopMode ())
+            return false;
         if (gdb_process->GetGDBRemote().GetThreadStopInfo(GetProtocolID(), stop_packet))
             return gdb_process->SetThreadStopInfo (stop_packet) == eStateStopped;
     }
@@ -84,6 +84,9 @@ protected:
     bool
     PrivateSetRegisterValue (uint32_t reg, 
                              StringExtractor &response);
+
+    bool
+    IsRunningInNonStopMode ();
                              
     //------------------------------------------------------------------
     // Member variables.
@@ -383,50 +383,103 @@ DWARFCompileUnit::BuildAddressRangeTable (SymbolFileDWARF* dwarf2Data,
                                           DWARFDebugAranges* debug_aranges,
                                           bool clear_dies_if_already_not_parsed)
 {
+    const size_t num_ranges = BuildAddressRangeTableFromDIEs (dwarf2Data, debug_aranges, clear_dies_if_already_not_parsed, false);
+    if (num_ranges == 0)
+        BuildAddressRangeTableFromLineTable (dwarf2Data, debug_aranges);
+}
+
+//----------------------------------------------------------------------
+// BuildAddressRangeTableFromDIEs
+//
+// Append the address ranges for this compile unit to "debug_aranges"
+// using only the DWARF DIEs. If the compile unit DIE has a
+// DW_AT_low_pc/DW_AT_high_pc pair or a DW_AT_ranges attribute, those
+// ranges are used as is and the rest of the DIE tree doesn't need to be
+// parsed. Otherwise all DW_TAG_subprogram DIEs are visited, unless
+// "cu_die_only" is true.
+//
+// This only touches the state of this compile unit, so it can be called
+// for different compile units on different threads as long as the
+// .debug_info, .debug_abbrev and .debug_ranges data has already been
+// loaded by the caller.
+//
+// Returns the number of ranges that were appended.
+//----------------------------------------------------------------------
+size_t
+DWARFCompileUnit::BuildAddressRangeTableFromDIEs (SymbolFileDWARF* dwarf2Data,
+                                                  DWARFDebugAranges* debug_aranges,
+                                                  bool clear_dies_if_already_not_parsed,
+                                                  bool cu_die_only)
+{
+    const size_t initial_num_ranges = debug_aranges->GetNumRanges();
+    const DWARFDebugInfoEntry* cu_die = GetCompileUnitDIEOnly();
+    if (cu_die)
+    {
+        DWARFDebugRanges::RangeList cu_ranges;
+        const size_t num_cu_ranges = cu_die->GetAttributeAddressRanges (dwarf2Data, this, cu_ranges);
+        for (size_t i=0; i<num_cu_ranges; ++i)
+        {
+            const DWARFDebugRanges::Range &range = cu_ranges.GetEntryRef(i);
+            debug_aranges->AppendRange (GetOffset(), range.GetRangeBase(), range.GetRangeEnd());
+        }
+    }
+
+    if (cu_die_only || debug_aranges->GetNumRanges() > initial_num_ranges)
+        return debug_aranges->GetNumRanges() - initial_num_ranges;
+
     // This function is usually called if there in no .debug_aranges section
     // in order to produce a compile unit level set of address ranges that
     // is accurate. If the DIEs weren't parsed, then we don't want all dies for
     // all compile units to stay loaded when they weren't needed. So we can end
     // up parsing the DWARF and then throwing them all away to keep memory usage
     // down.
-    const bool clear_dies = ExtractDIEsIfNeeded (false) > 1;
+    const bool clear_dies = ExtractDIEsIfNeeded (false) > 1 && clear_dies_if_already_not_parsed;
     
     const DWARFDebugInfoEntry* die = DIE();
     if (die)
         die->BuildAddressRangeTable(dwarf2Data, this, debug_aranges);
     
-    if (debug_aranges->IsEmpty())
-    {
-        // We got nothing from the functions, maybe we have a line tables only
-        // situation. Check the line tables and build the arange table from this.
-        SymbolContext sc;
-        sc.comp_unit = dwarf2Data->GetCompUnitForDWARFCompUnit(this);
-        if (sc.comp_unit)
-        {
-            LineTable *line_table = sc.comp_unit->GetLineTable();
-
-            if (line_table)
-            {
-                LineTable::FileAddressRanges file_ranges;
-                const bool append = true;
-                const size_t num_ranges = line_table->GetContiguousFileAddressRanges (file_ranges, append);
-                for (uint32_t idx=0; idx<num_ranges; ++idx)
-                {
-                    const LineTable::FileAddressRanges::Entry &range = file_ranges.GetEntryRef(idx);
-                    debug_aranges->AppendRange(GetOffset(), range.GetRangeBase(), range.GetRangeEnd());
-                    printf ("0x%8.8x: [0x%16.16" PRIx64 " - 0x%16.16" PRIx64 ")\n", GetOffset(), range.GetRangeBase(), range.GetRangeEnd());
-                }
-            }
-        }
-    }
-    
     // Keep memory down by clearing DIEs if this generate function
     // caused them to be parsed
     if (clear_dies)
         ClearDIEs (true);
 
+    return debug_aranges->GetNumRanges() - initial_num_ranges;
 }
 
+//----------------------------------------------------------------------
+// BuildAddressRangeTableFromLineTable
+//
+// We got nothing from the DIEs, maybe we have a line tables only
+// situation. Check the line tables and build the arange table from
+// them. This creates the lldb_private::CompileUnit for this compile unit
+// so it must not be called from multiple threads.
+//----------------------------------------------------------------------
+size_t
+DWARFCompileUnit::BuildAddressRangeTableFromLineTable (SymbolFileDWARF* dwarf2Data,
+                                                       DWARFDebugAranges* debug_aranges)
+{
+    size_t num_ranges = 0;
+    SymbolContext sc;
+    sc.comp_unit = dwarf2Data->GetCompUnitForDWARFCompUnit(this);
+    if (sc.comp_unit)
+    {
+        LineTable *line_table = sc.comp_unit->GetLineTable();
+
+        if (line_table)
+        {
+            LineTable::FileAddressRanges file_ranges;
+            const bool append = true;
+            num_ranges = line_table->GetContiguousFileAddressRanges (file_ranges, append);
+            for (uint32_t idx=0; idx<num_ranges; ++idx)
+            {
+                const LineTable::FileAddressRanges::Entry &range = file_ranges.GetEntryRef(idx);
+                debug_aranges->AppendRange(GetOffset(), range.GetRangeBase(), range.GetRangeEnd());
+            }
+        }
+    }
+    return num_ranges;
+}
 
 const DWARFDebugAranges &
 DWARFCompileUnit::GetFunctionAranges ()
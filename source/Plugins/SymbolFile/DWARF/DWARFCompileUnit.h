@@ -57,6 +57,12 @@ public:
     void        BuildAddressRangeTable (SymbolFileDWARF* dwarf2Data,
                                         DWARFDebugAranges* debug_aranges,
                                         bool clear_dies_if_already_not_parsed);
+    size_t      BuildAddressRangeTableFromDIEs (SymbolFileDWARF* dwarf2Data,
+                                                DWARFDebugAranges* debug_aranges,
+                                                bool clear_dies_if_already_not_parsed,
+                                                bool cu_die_only);
+    size_t      BuildAddressRangeTableFromLineTable (SymbolFileDWARF* dwarf2Data,
+                                                     DWARFDebugAranges* debug_aranges);
 
     void
     SetBaseAddress(dw_addr_t base_addr)
@@ -17,6 +17,7 @@
 #include "lldb/Core/Log.h"
 #include "lldb/Core/Stream.h"
 #include "lldb/Core/Timer.h"
+#include "lldb/Host/Host.h"
 
 #include "LogChannelDWARF.h"
 #include "SymbolFileDWARF.h"
@@ -93,19 +94,135 @@ DWARFDebugAranges::Generate(SymbolFileDWARF* dwarf2Data)
     DWARFDebugInfo* debug_info = dwarf2Data->DebugInfo();
     if (debug_info)
     {
-        const bool clear_dies_if_already_not_parsed = true;
-        uint32_t cu_idx = 0;
+        CompileUnitCollection compile_units;
         const uint32_t num_compile_units = dwarf2Data->GetNumCompileUnits();
-        for (cu_idx = 0; cu_idx < num_compile_units; ++cu_idx)
+        compile_units.reserve (num_compile_units);
+        for (uint32_t cu_idx = 0; cu_idx < num_compile_units; ++cu_idx)
         {
             DWARFCompileUnit* cu = debug_info->GetCompileUnitAtIndex(cu_idx);
             if (cu)
-                cu->BuildAddressRangeTable(dwarf2Data, this, clear_dies_if_already_not_parsed);
+                compile_units.push_back (cu);
         }
+        const bool cu_die_only = false;
+        AppendCompileUnitRanges (dwarf2Data, compile_units, cu_die_only);
     }
     return !IsEmpty();
 }
 
+//----------------------------------------------------------------------
+// Worker state for AppendCompileUnitRanges. Each worker thread handles
+// every "num_workers"th compile unit starting at "worker_idx" and
+// appends to a per compile unit table, so no locking is needed.
+//----------------------------------------------------------------------
+namespace {
+    struct CompileUnitRangesWorker
+    {
+        SymbolFileDWARF *dwarf2Data;
+        const DWARFDebugAranges::CompileUnitCollection *compile_units;
+        std::vector<DWARFDebugAranges> *cu_aranges;
+        size_t worker_idx;
+        size_t num_workers;
+        bool cu_die_only;
+    };
+}
+
+static lldb::thread_result_t
+CompileUnitRangesWorkerThread (lldb::thread_arg_t arg)
+{
+    CompileUnitRangesWorker *worker = (CompileUnitRangesWorker *)arg;
+    const bool clear_dies_if_already_not_parsed = true;
+    const size_t num_compile_units = worker->compile_units->size();
+    for (size_t idx = worker->worker_idx; idx < num_compile_units; idx += worker->num_workers)
+    {
+        (*worker->compile_units)[idx]->BuildAddressRangeTableFromDIEs (worker->dwarf2Data,
+                                                                       &(*worker->cu_aranges)[idx],
+                                                                       clear_dies_if_already_not_parsed,
+                                                                       worker->cu_die_only);
+    }
+    return NULL;
+}
+
+//----------------------------------------------------------------------
+// AppendCompileUnitRanges
+//
+// Append the address ranges for all compile units in "compile_units".
+// The ranges for each compile unit are extracted in parallel. If
+// "cu_die_only" is false, compile units whose DIEs didn't produce any
+// ranges fall back to using their line tables, which is done serially
+// after all worker threads have finished.
+//----------------------------------------------------------------------
+void
+DWARFDebugAranges::AppendCompileUnitRanges (SymbolFileDWARF* dwarf2Data,
+                                            const CompileUnitCollection &compile_units,
+                                            bool cu_die_only)
+{
+    const size_t num_compile_units = compile_units.size();
+    if (num_compile_units == 0)
+        return;
+
+    Timer scoped_timer(__PRETTY_FUNCTION__, "%s this = %p, %" PRIu64 " compile units",
+                       __PRETTY_FUNCTION__, this, (uint64_t)num_compile_units);
+
+    // Make sure all of the lazily loaded section data and tables that
+    // the workers might touch are loaded before we spawn any threads.
+    dwarf2Data->get_debug_info_data();
+    dwarf2Data->get_debug_abbrev_data();
+    dwarf2Data->get_debug_str_data();
+    dwarf2Data->DebugRanges();
+
+    std::vector<DWARFDebugAranges> cu_aranges (num_compile_units);
+
+    size_t num_workers = Host::GetNumberCPUS();
+    if (num_workers > num_compile_units)
+        num_workers = num_compile_units;
+    if (num_workers == 0)
+        num_workers = 1;
+
+    std::vector<CompileUnitRangesWorker> workers (num_workers);
+    std::vector<lldb::thread_t> threads;
+    for (size_t i = 0; i < num_workers; ++i)
+    {
+        CompileUnitRangesWorker &worker = workers[i];
+        worker.dwarf2Data = dwarf2Data;
+        worker.compile_units = &compile_units;
+        worker.cu_aranges = &cu_aranges;
+        worker.worker_idx = i;
+        worker.num_workers = num_workers;
+        worker.cu_die_only = cu_die_only;
+    }
+
+    // Worker zero runs on the current thread. If we fail to spawn a thread
+    // for any of the other workers, just run that worker here as well.
+    for (size_t i = 1; i < num_workers; ++i)
+    {
+        lldb::thread_t thread = Host::ThreadCreate ("<lldb.dwarf.aranges>",
+                                                    CompileUnitRangesWorkerThread,
+                                                    &workers[i],
+                                                    NULL);
+        if (IS_VALID_LLDB_HOST_THREAD(thread))
+            threads.push_back (thread);
+        else
+            CompileUnitRangesWorkerThread (&workers[i]);
+    }
+    CompileUnitRangesWorkerThread (&workers[0]);
+    for (size_t i = 0; i < threads.size(); ++i)
+        Host::ThreadJoin (threads[i], NULL, NULL);
+
+    for (size_t idx = 0; idx < num_compile_units; ++idx)
+    {
+        const DWARFDebugAranges &aranges = cu_aranges[idx];
+        const size_t num_ranges = aranges.GetNumRanges();
+        if (num_ranges > 0)
+        {
+            for (size_t i = 0; i < num_ranges; ++i)
+                m_aranges.Append (*aranges.RangeAtIndex(i));
+        }
+        else if (!cu_die_only)
+        {
+            compile_units[idx]->BuildAddressRangeTableFromLineTable (dwarf2Data, this);
+        }
+    }
+}
 
 void
 DWARFDebugAranges::Dump (Log *log) const
@@ -12,9 +12,11 @@
 
 #include "DWARFDebugArangeSet.h"
 #include <list>
+#include <vector>
 
 #include "lldb/Core/RangeMap.h"
 
+class DWARFCompileUnit;
 class SymbolFileDWARF;
 
 class DWARFDebugAranges
@@ -25,6 +27,7 @@ protected:
 public:
     typedef RangeToDIE::Entry Range;
     typedef std::vector<RangeToDIE::Entry> RangeColl;
+    typedef std::vector<DWARFCompileUnit *> CompileUnitCollection;
 
     DWARFDebugAranges();
 
@@ -39,6 +42,11 @@ public:
 
     bool
     Generate(SymbolFileDWARF* dwarf2Data);
+
+    void
+    AppendCompileUnitRanges (SymbolFileDWARF* dwarf2Data,
+                             const CompileUnitCollection &compile_units,
+                             bool cu_die_only);
     
                 // Use append range multiple times and then call sort
     void
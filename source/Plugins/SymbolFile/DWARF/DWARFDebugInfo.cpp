@@ -64,21 +64,45 @@ DWARFDebugInfo::GetCompileUnitAranges ()
                 log->Printf ("DWARFDebugInfo::GetCompileUnitAranges() for \"%s\" from .debug_aranges",
                              m_dwarf2Data->GetObjectFile()->GetFileSpec().GetPath().c_str());
             m_cu_aranges_ap->Extract (debug_aranges_data);
-            
+
+            // The .debug_aranges section is often incomplete: some
+            // producers don't emit sets for every compile unit (hand written
+            // assembly, some linker generated code). Any compile unit that
+            // didn't get a set gets its ranges from its compile unit DIE
+            // only, which is cheap and avoids parsing the full DIE tree for
+            // compile units that contain no code.
+            std::vector<dw_offset_t> cu_offsets_with_aranges;
+            const size_t num_aranges = m_cu_aranges_ap->GetNumRanges();
+            cu_offsets_with_aranges.reserve (num_aranges);
+            for (size_t idx = 0; idx < num_aranges; ++idx)
+                cu_offsets_with_aranges.push_back (m_cu_aranges_ap->OffsetAtIndex(idx));
+            std::sort (cu_offsets_with_aranges.begin(), cu_offsets_with_aranges.end());
+
+            DWARFDebugAranges::CompileUnitCollection compile_units_without_aranges;
+            const size_t num_compile_units = GetNumCompileUnits();
+            for (size_t idx = 0; idx < num_compile_units; ++idx)
+            {
+                DWARFCompileUnit* cu = GetCompileUnitAtIndex(idx);
+                if (cu && !std::binary_search (cu_offsets_with_aranges.begin(), cu_offsets_with_aranges.end(), cu->GetOffset()))
+                    compile_units_without_aranges.push_back (cu);
+            }
+
+            if (!compile_units_without_aranges.empty())
+            {
+                if (log)
+                    log->Printf ("DWARFDebugInfo::GetCompileUnitAranges() for \"%s\" adding %" PRIu64 " compile units missing from .debug_aranges",
+                                 m_dwarf2Data->GetObjectFile()->GetFileSpec().GetPath().c_str(),
+                                 (uint64_t)compile_units_without_aranges.size());
+                const bool cu_die_only = true;
+                m_cu_aranges_ap->AppendCompileUnitRanges (m_dwarf2Data, compile_units_without_aranges, cu_die_only);
+            }
         }
         else
         {
             if (log)
                 log->Printf ("DWARFDebugInfo::GetCompileUnitAranges() for \"%s\" by parsing", 
                              m_dwarf2Data->GetObjectFile()->GetFileSpec().GetPath().c_str());
-            const size_t num_compile_units = GetNumCompileUnits();
-            const bool clear_dies_if_already_not_parsed = true;
-            for (size_t idx = 0; idx < num_compile_units; ++idx)
-            {
-                DWARFCompileUnit* cu = GetCompileUnitAtIndex(idx);
-                if (cu)
-                    cu->BuildAddressRangeTable (m_dwarf2Data, m_cu_aranges_ap.get(), clear_dies_if_already_not_parsed);
-            }
+            m_cu_aranges_ap->Generate (m_dwarf2Data);
         }
 
         const bool minimize = true;
@@ -1751,6 +1751,55 @@ DWARFDebugInfoEntry::BuildAddressRangeTable
     }
 }
 
+//----------------------------------------------------------------------
+// GetAttributeAddressRanges
+//
+// Get the address ranges described by the DW_AT_low_pc/DW_AT_high_pc
+// pair and/or the DW_AT_ranges attribute of this DIE only. Unlike
+// GetDIENamesAndRanges() this doesn't follow DW_AT_abstract_origin or
+// DW_AT_specification, so it is cheap enough to call on a compile unit
+// DIE without parsing any of its children. The DWARFDebugRanges for
+// "dwarf2Data" must already have been parsed if this is called from
+// multiple threads.
+//----------------------------------------------------------------------
+size_t
+DWARFDebugInfoEntry::GetAttributeAddressRanges
+(
+    SymbolFileDWARF* dwarf2Data,
+    const DWARFCompileUnit* cu,
+    DWARFDebugRanges::RangeList &ranges
+) const
+{
+    const size_t initial_size = ranges.GetSize();
+    if (m_tag)
+    {
+        const dw_addr_t lo_pc = GetAttributeValueAsUnsigned(dwarf2Data, cu, DW_AT_low_pc, LLDB_INVALID_ADDRESS);
+        if (lo_pc != LLDB_INVALID_ADDRESS)
+        {
+            const dw_addr_t hi_pc = GetAttributeValueAsUnsigned(dwarf2Data, cu, DW_AT_high_pc, LLDB_INVALID_ADDRESS);
+            if (hi_pc != LLDB_INVALID_ADDRESS && hi_pc > lo_pc)
+                ranges.Append(DWARFDebugRanges::Range (lo_pc, hi_pc - lo_pc));
+        }
+
+        const dw_offset_t debug_ranges_offset = GetAttributeValueAsUnsigned(dwarf2Data, cu, DW_AT_ranges, DW_INVALID_OFFSET);
+        if (debug_ranges_offset != DW_INVALID_OFFSET)
+        {
+            const DWARFDebugRanges* debug_ranges = dwarf2Data->DebugRanges();
+            DWARFDebugRanges::RangeList die_ranges;
+            if (debug_ranges && debug_ranges->FindRanges(debug_ranges_offset, die_ranges))
+            {
+                // All DW_AT_ranges are relative to the base address of the
+                // compile unit.
+                die_ranges.Slide(cu->GetBaseAddress());
+                const size_t num_die_ranges = die_ranges.GetSize();
+                for (size_t i=0; i<num_die_ranges; ++i)
+                    ranges.Append(die_ranges.GetEntryRef(i));
+            }
+        }
+    }
+    return ranges.GetSize() - initial_size;
+}
+
 //----------------------------------------------------------------------
 // BuildFunctionAddressRangeTable
 //
@@ -141,6 +141,11 @@ public:
                     const DWARFCompileUnit* cu,
                     DWARFDebugAranges* debug_aranges) const;
 
+    size_t      GetAttributeAddressRanges(
+                    SymbolFileDWARF* dwarf2Data,
+                    const DWARFCompileUnit* cu,
+                    DWARFDebugRanges::RangeList &ranges) const;
+
     bool        FastExtract(
                     const lldb_private::DataExtractor& debug_info_data,
                     const DWARFCompileUnit* cu,
@@ -0,0 +1,948 @@
+//===-- UnwindAssembly-Patmos.cpp -------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "UnwindAssembly-Patmos.h"
+
+#include <assert.h>
+#include <string.h>
+
+#include <set>
+#include <string>
+
+#include "lldb/Core/Address.h"
+#include "lldb/Core/ArchSpec.h"
+#include "lldb/Core/DataBufferHeap.h"
+#include "lldb/Core/DataExtractor.h"
+#include "lldb/Core/dwarf.h"
+#include "lldb/Core/Error.h"
+#include "lldb/Core/Log.h"
+#include "lldb/Core/PluginManager.h"
+#include "lldb/Core/StreamString.h"
+#include "lldb/Host/Mutex.h"
+#include "lldb/Symbol/UnwindPlan.h"
+#include "lldb/Target/ExecutionContext.h"
+#include "lldb/Target/RegisterContext.h"
+#include "lldb/Target/Target.h"
+#include "lldb/Target/Thread.h"
+
+#include "Plugins/Instruction/Patmos/EmulateInstructionPatmos.h"
+#include "Plugins/Process/Utility/PatmosDefines.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+//-----------------------------------------------------------------------------------------------
+//  AssemblyParse_Patmos local-file class definition & implementation functions
+//-----------------------------------------------------------------------------------------------
+
+namespace {
+
+// Where the value a register had on entry to the function can be found
+struct SavedLocation
+{
+    enum Kind
+    {
+        eUnchanged,         // Still in the register itself
+        eInRegister,        // Copied into a general purpose register
+        eInStackCache,      // Stored in the stack cache at CFA + offset
+        eInShadowStack      // Stored in main memory at entry r31 + offset
+    };
+
+    SavedLocation () :
+        kind (eUnchanged),
+        reg (LLDB_INVALID_REGNUM),
+        offset (0)
+    {
+    }
+
+    bool
+    operator == (const SavedLocation &rhs) const
+    {
+        return kind == rhs.kind && reg == rhs.reg && offset == rhs.offset;
+    }
+
+    Kind kind;
+    uint32_t reg;
+    int32_t offset;
+};
+
+struct FrameState
+{
+    enum { kNumGPRs = 32 };
+
+    FrameState () :
+        stack_cache_size (0),
+        shadow_stack_size (0),
+        ss_written (false),
+        srb (),
+        sro ()
+    {
+        for (uint32_t i = 0; i < kNumGPRs; ++i)
+            gpr_copy_of_sreg[i] = LLDB_INVALID_REGNUM;
+    }
+
+    // Only the parts of the state that end up in an UnwindPlan row
+    bool
+    SameRow (const FrameState &rhs) const
+    {
+        if (stack_cache_size != rhs.stack_cache_size ||
+            shadow_stack_size != rhs.shadow_stack_size ||
+            ss_written != rhs.ss_written ||
+            !(srb == rhs.srb) ||
+            !(sro == rhs.sro))
+            return false;
+        for (uint32_t i = 0; i < kNumGPRs; ++i)
+        {
+            if (!(gprs[i] == rhs.gprs[i]))
+                return false;
+        }
+        return true;
+    }
+
+    int32_t stack_cache_size;           // Bytes reserved with sres
+    int32_t shadow_stack_size;          // Bytes r31 was moved down by
+    bool ss_written;                    // An mts replaced the spill pointer
+    SavedLocation srb;
+    SavedLocation sro;
+    SavedLocation gprs[kNumGPRs];       // Callee saved registers
+    uint32_t gpr_copy_of_sreg[kNumGPRs];// Special register each GPR holds a copy of, if any
+};
+
+} // anonymous namespace
+
+class AssemblyParse_Patmos
+{
+public:
+
+    AssemblyParse_Patmos (const ExecutionContext &exe_ctx, const ArchSpec &arch, const AddressRange &func);
+
+    bool get_unwind_plan (UnwindPlan &unwind_plan);
+
+    bool find_first_non_prologue_insn (Address &address);
+
+private:
+    // We only look at the prologue if the function size is unknown
+    enum { kDefaultScanByteSize = 256 };
+
+    bool read_function_bytes ();
+    bool resolve_register_numbers ();
+    uint32_t get_word (lldb::offset_t offset) const;
+    size_t get_bundle (lldb::offset_t offset, uint32_t *insns, size_t &num_insns, uint32_t &long_imm, bool &has_long_imm) const;
+    bool is_prologue_insn (uint32_t insn, bool has_long_imm, uint32_t long_imm) const;
+    void emulate_bundle (lldb::offset_t offset, size_t bundle_size, const FrameState &cur, FrameState &next, bool &is_return, uint32_t &delay_slots);
+    void start_epilogue ();
+    UnwindPlan::RowSP make_row (const FrameState &state, lldb::addr_t offset) const;
+    void append_saved_value (StreamString &expr, const SavedLocation &loc, uint32_t sreg_lldb_regnum, const FrameState &state) const;
+
+    static SavedLocation *
+    get_saved_location (FrameState &state, uint32_t sreg);
+
+    static const uint8_t *
+    intern_expression (const StreamString &expr);
+
+    // EmulateInstruction callbacks; the emulator tells us through the
+    // context of each write how the frame changes.
+    static size_t
+    read_memory (EmulateInstruction *instruction, void *baton, const EmulateInstruction::Context &context,
+                 lldb::addr_t addr, void *dst, size_t length);
+
+    static size_t
+    write_memory (EmulateInstruction *instruction, void *baton, const EmulateInstruction::Context &context,
+                  lldb::addr_t addr, const void *dst, size_t length);
+
+    static bool
+    read_register (EmulateInstruction *instruction, void *baton, const RegisterInfo *reg_info, RegisterValue &reg_value);
+
+    static bool
+    write_register (EmulateInstruction *instruction, void *baton, const EmulateInstruction::Context &context,
+                    const RegisterInfo *reg_info, const RegisterValue &reg_value);
+
+    void saw_memory_write (const EmulateInstruction::Context &context, size_t length);
+    void saw_register_write (const EmulateInstruction::Context &context, const RegisterInfo *reg_info);
+
+    const ExecutionContext m_exe_ctx;
+    ArchSpec m_arch;
+    AddressRange m_func_bounds;
+    DataExtractor m_data;
+    lldb::addr_t m_func_addr;           // Address the emulator sees the function at
+    std::unique_ptr<EmulateInstructionPatmos> m_inst_emulator_ap;
+
+    uint32_t m_lldb_gpr_regnums[FrameState::kNumGPRs];
+    uint32_t m_lldb_st_regnum;
+    uint32_t m_lldb_ss_regnum;
+    uint32_t m_lldb_srb_regnum;
+    uint32_t m_lldb_sro_regnum;
+    uint32_t m_lldb_pc_regnum;
+
+    // The bundle being emulated reads from m_cur and writes to m_next
+    const FrameState *m_cur;
+    FrameState *m_next;
+    FrameState m_body_state;
+    bool m_in_prologue;
+    bool m_in_epilogue;
+    bool m_is_return;
+
+    DISALLOW_COPY_AND_ASSIGN (AssemblyParse_Patmos);
+};
+
+AssemblyParse_Patmos::AssemblyParse_Patmos (const ExecutionContext &exe_ctx, const ArchSpec &arch, const AddressRange &func) :
+    m_exe_ctx (exe_ctx),
+    m_arch (arch),
+    m_func_bounds (func),
+    m_data (),
+    m_func_addr (LLDB_INVALID_ADDRESS),
+    m_inst_emulator_ap (),
+    m_lldb_st_regnum (LLDB_INVALID_REGNUM),
+    m_lldb_ss_regnum (LLDB_INVALID_REGNUM),
+    m_lldb_srb_regnum (LLDB_INVALID_REGNUM),
+    m_lldb_sro_regnum (LLDB_INVALID_REGNUM),
+    m_lldb_pc_regnum (LLDB_INVALID_REGNUM),
+    m_cur (NULL),
+    m_next (NULL),
+    m_body_state (),
+    m_in_prologue (true),
+    m_in_epilogue (false),
+    m_is_return (false)
+{
+    for (uint32_t i = 0; i < FrameState::kNumGPRs; ++i)
+        m_lldb_gpr_regnums[i] = LLDB_INVALID_REGNUM;
+
+    if (m_func_bounds.GetByteSize() == 0)
+        m_func_bounds.SetByteSize (kDefaultScanByteSize);
+}
+
+// Read the whole function with one memory read, we will look at every
+// instruction of it anyway.
+bool
+AssemblyParse_Patmos::read_function_bytes ()
+{
+    Target *target = m_exe_ctx.GetTargetPtr();
+    if (target == NULL || !m_func_bounds.GetBaseAddress().IsValid())
+        return false;
+
+    const size_t func_size = m_func_bounds.GetByteSize() & ~3ull;
+    if (func_size == 0)
+        return false;
+
+    DataBufferSP data_sp (new DataBufferHeap (func_size, 0));
+    Error error;
+    const bool prefer_file_cache = true;
+    const size_t bytes_read = target->ReadMemory (m_func_bounds.GetBaseAddress(),
+                                                  prefer_file_cache,
+                                                  data_sp->GetBytes(),
+                                                  data_sp->GetByteSize(),
+                                                  error);
+    if (bytes_read < 4)
+        return false;
+
+    m_data.SetData (data_sp, 0, bytes_read & ~3ull);
+    m_data.SetByteOrder (eByteOrderBig);
+    m_data.SetAddressByteSize (4);
+
+    // The same address EmulateInstruction::SetInstruction will use
+    m_func_addr = m_func_bounds.GetBaseAddress().GetLoadAddress (target);
+    if (m_func_addr == LLDB_INVALID_ADDRESS)
+        m_func_addr = m_func_bounds.GetBaseAddress().GetFileAddress ();
+    return true;
+}
+
+bool
+AssemblyParse_Patmos::resolve_register_numbers ()
+{
+    Thread *thread = m_exe_ctx.GetThreadPtr();
+    if (thread == NULL)
+        return false;
+    RegisterContext *reg_ctx = thread->GetRegisterContext().get();
+    if (reg_ctx == NULL)
+        return false;
+
+    const RegisterInfo *reg_info;
+    for (uint32_t i = 0; i < FrameState::kNumGPRs; ++i)
+    {
+        char reg_name[8];
+        ::snprintf (reg_name, sizeof(reg_name), "r%u", i);
+        reg_info = reg_ctx->GetRegisterInfoByName (reg_name);
+        if (reg_info)
+            m_lldb_gpr_regnums[i] = reg_info->kinds[eRegisterKindLLDB];
+    }
+
+    // Special registers go by their role or their number depending on the stub
+    struct SpecialRegister
+    {
+        const char *name;
+        const char *alt_name;
+        uint32_t *lldb_regnum;
+    } special_regs[] =
+    {
+        { "st",  "s6", &m_lldb_st_regnum  },
+        { "srb", "s7", &m_lldb_srb_regnum },
+        { "sro", "s8", &m_lldb_sro_regnum }
+    };
+    for (size_t i = 0; i < sizeof(special_regs)/sizeof(special_regs[0]); ++i)
+    {
+        reg_info = reg_ctx->GetRegisterInfoByName (special_regs[i].name);
+        if (reg_info == NULL)
+            reg_info = reg_ctx->GetRegisterInfoByName (special_regs[i].alt_name);
+        if (reg_info == NULL)
+            return false;
+        *special_regs[i].lldb_regnum = reg_info->kinds[eRegisterKindLLDB];
+    }
+
+    // Not every stub exposes the spill pointer, we can unwind without it
+    reg_info = reg_ctx->GetRegisterInfoByName ("ss");
+    if (reg_info == NULL)
+        reg_info = reg_ctx->GetRegisterInfoByName ("s5");
+    if (reg_info)
+        m_lldb_ss_regnum = reg_info->kinds[eRegisterKindLLDB];
+
+    m_lldb_pc_regnum = reg_ctx->ConvertRegisterKindToRegisterNumber (eRegisterKindGeneric, LLDB_REGNUM_GENERIC_PC);
+    return m_lldb_pc_regnum != LLDB_INVALID_REGNUM && m_lldb_gpr_regnums[PATMOS_REG_RSP] != LLDB_INVALID_REGNUM;
+}
+
+uint32_t
+AssemblyParse_Patmos::get_word (lldb::offset_t offset) const
+{
+    return m_data.GetU32 (&offset);
+}
+
+// Decode the bundle at offset. Returns the size of the bundle in bytes,
+// or zero if there isn't a complete bundle left.
+size_t
+AssemblyParse_Patmos::get_bundle (lldb::offset_t offset,
+                                  uint32_t *insns,
+                                  size_t &num_insns,
+                                  uint32_t &long_imm,
+                                  bool &has_long_imm) const
+{
+    if (offset + 4 > m_data.GetByteSize())
+        return 0;
+
+    insns[0] = get_word (offset);
+    num_insns = 1;
+    has_long_imm = false;
+    long_imm = 0;
+    if (!PatmosIsBundled (insns[0]))
+        return 4;
+
+    if (offset + 8 > m_data.GetByteSize())
+        return 0;
+    if (!PatmosIsALUi (insns[0]) && PatmosOpcode (insns[0]) == PATMOS_OPC_ALUL)
+    {
+        // The second word is the immediate of the first instruction
+        long_imm = get_word (offset + 4);
+        has_long_imm = true;
+    }
+    else
+    {
+        insns[1] = get_word (offset + 4);
+        num_insns = 2;
+    }
+    return 8;
+}
+
+// Instructions that only build up the frame: reserve stack cache space,
+// move the shadow stack pointer down, copy out srb/sro and store
+// registers. nop is "sub r0 = r0, 0" so it falls in here too.
+bool
+AssemblyParse_Patmos::is_prologue_insn (uint32_t insn, bool has_long_imm, uint32_t long_imm) const
+{
+    if (PatmosIsALUi (insn))
+    {
+        const uint32_t rd = PatmosRd (insn);
+        const uint32_t func = Bits32 (insn, 24, 22);
+        if (rd == PATMOS_REG_R0)
+            return true;
+        if (rd == PATMOS_REG_RSP && PatmosRs1 (insn) == PATMOS_REG_RSP && func == PATMOS_ALU_SUB)
+            return true;
+        if (rd == PATMOS_REG_RFP && PatmosRs1 (insn) == PATMOS_REG_RSP && func == PATMOS_ALU_ADD)
+            return true;
+        return false;
+    }
+
+    switch (PatmosOpcode (insn))
+    {
+    case PATMOS_OPC_ALUL:
+        return has_long_imm &&
+               PatmosRd (insn) == PATMOS_REG_RSP &&
+               PatmosRs1 (insn) == PATMOS_REG_RSP &&
+               Bits32 (insn, 3, 0) == PATMOS_ALU_SUB;
+
+    case PATMOS_OPC_SPC:
+        if (Bits32 (insn, 6, 4) == PATMOS_SPC_MFS)
+        {
+            const uint32_t sreg = Bits32 (insn, 3, 0);
+            return sreg == PATMOS_SREG_SRB || sreg == PATMOS_SREG_SRO || sreg == PATMOS_SREG_S0;
+        }
+        return false;
+
+    case PATMOS_OPC_STT:
+        return true;
+
+    case PATMOS_OPC_STC:
+        return Bits32 (insn, 21, 18) == PATMOS_STC_SRES;
+    }
+    return false;
+}
+
+SavedLocation *
+AssemblyParse_Patmos::get_saved_location (FrameState &state, uint32_t sreg)
+{
+    if (sreg == PATMOS_SREG_SRB)
+        return &state.srb;
+    if (sreg == PATMOS_SREG_SRO)
+        return &state.sro;
+    return NULL;
+}
+
+// Remember the frame of the function body when the frame starts to be
+// torn down so we can pick it up again after a return in the middle of
+// the function.
+void
+AssemblyParse_Patmos::start_epilogue ()
+{
+    if (!m_in_epilogue)
+    {
+        m_body_state = *m_cur;
+        m_in_epilogue = true;
+    }
+}
+
+// Instruction fetches are served from the function bytes we already read
+// (a call looks at its delay slots to work out the return address), all
+// other memory reads as zero.
+size_t
+AssemblyParse_Patmos::read_memory (EmulateInstruction *instruction,
+                                   void *baton,
+                                   const EmulateInstruction::Context &context,
+                                   lldb::addr_t addr,
+                                   void *dst,
+                                   size_t length)
+{
+    AssemblyParse_Patmos *parser = (AssemblyParse_Patmos *)baton;
+    if (parser == NULL || dst == NULL)
+        return 0;
+
+    const DataExtractor &data = parser->m_data;
+    if (addr >= parser->m_func_addr && addr + length <= parser->m_func_addr + data.GetByteSize())
+        ::memcpy (dst, data.GetDataStart() + (addr - parser->m_func_addr), length);
+    else
+        ::memset (dst, 0, length);
+    return length;
+}
+
+size_t
+AssemblyParse_Patmos::write_memory (EmulateInstruction *instruction,
+                                    void *baton,
+                                    const EmulateInstruction::Context &context,
+                                    lldb::addr_t addr,
+                                    const void *dst,
+                                    size_t length)
+{
+    if (baton)
+        ((AssemblyParse_Patmos *)baton)->saw_memory_write (context, length);
+    return length;
+}
+
+// Register values don't matter, everything we need is in the contexts.
+// Instructions with a predicate other than p0 are skipped by the emulator.
+bool
+AssemblyParse_Patmos::read_register (EmulateInstruction *instruction,
+                                     void *baton,
+                                     const RegisterInfo *reg_info,
+                                     RegisterValue &reg_value)
+{
+    return reg_info && reg_value.SetUInt (0, reg_info->byte_size);
+}
+
+bool
+AssemblyParse_Patmos::write_register (EmulateInstruction *instruction,
+                                      void *baton,
+                                      const EmulateInstruction::Context &context,
+                                      const RegisterInfo *reg_info,
+                                      const RegisterValue &reg_value)
+{
+    if (baton && reg_info)
+        ((AssemblyParse_Patmos *)baton)->saw_register_write (context, reg_info);
+    return true;
+}
+
+// Stores of a callee saved register or a copy of srb/sro in the prologue
+void
+AssemblyParse_Patmos::saw_memory_write (const EmulateInstruction::Context &context, size_t length)
+{
+    if (!m_in_prologue ||
+        context.type != EmulateInstruction::eContextPushRegisterOnStack ||
+        context.info_type != EmulateInstruction::eInfoTypeRegisterToRegisterPlusOffset ||
+        length != 4)
+        return;
+
+    const uint32_t rs = context.info.RegisterToRegisterPlusOffset.data_reg.kinds[eRegisterKindDWARF];
+    const uint32_t base = context.info.RegisterToRegisterPlusOffset.base_reg.kinds[eRegisterKindDWARF];
+    const int32_t offset = (int32_t)context.info.RegisterToRegisterPlusOffset.offset;
+    if (rs == patmos_r0 || rs >= FrameState::kNumGPRs)
+        return;
+
+    SavedLocation slot;
+    if (base == patmos_s0 + PATMOS_SREG_ST)
+    {
+        // Stack cache accesses are relative to st
+        slot.kind = SavedLocation::eInStackCache;
+        slot.offset = offset - m_cur->stack_cache_size;
+    }
+    else if (base == patmos_r31)
+    {
+        slot.kind = SavedLocation::eInShadowStack;
+        slot.offset = offset - m_cur->shadow_stack_size;
+    }
+    else
+        return;
+
+    SavedLocation *loc = get_saved_location (*m_next, m_cur->gpr_copy_of_sreg[rs]);
+    if (loc == NULL && rs != patmos_r31 && m_cur->gprs[rs].kind == SavedLocation::eUnchanged)
+        loc = &m_next->gprs[rs];
+    if (loc == NULL || loc->kind == SavedLocation::eInStackCache || loc->kind == SavedLocation::eInShadowStack)
+        return;
+    *loc = slot;
+}
+
+void
+AssemblyParse_Patmos::saw_register_write (const EmulateInstruction::Context &context, const RegisterInfo *reg_info)
+{
+    const uint32_t reg = reg_info->kinds[eRegisterKindDWARF];
+    if (reg < FrameState::kNumGPRs)
+    {
+        if (reg == patmos_r31 && context.type == EmulateInstruction::eContextAdjustStackPointer)
+            m_next->shadow_stack_size = m_cur->shadow_stack_size - (int32_t)context.info.signed_immediate;
+
+        // mfs copies a special register
+        m_next->gpr_copy_of_sreg[reg] = LLDB_INVALID_REGNUM;
+        if (context.type == EmulateInstruction::eContextRegisterPlusOffset &&
+            context.info_type == EmulateInstruction::eInfoTypeRegisterPlusOffset)
+        {
+            const uint32_t src = context.info.RegisterPlusOffset.reg.kinds[eRegisterKindDWARF];
+            if (src >= patmos_s0 && src <= patmos_s15)
+            {
+                m_next->gpr_copy_of_sreg[reg] = src - patmos_s0;
+                SavedLocation *loc = get_saved_location (*m_next, src - patmos_s0);
+                if (loc && loc->kind == SavedLocation::eUnchanged)
+                {
+                    loc->kind = SavedLocation::eInRegister;
+                    loc->reg = reg;
+                }
+            }
+        }
+    }
+    else if (reg == patmos_s0 + PATMOS_SREG_ST)
+    {
+        if (context.type == EmulateInstruction::eContextAdjustStackPointer)
+        {
+            // sres moves st down, sfree moves it back up
+            if (context.info.signed_immediate > 0)
+                start_epilogue ();
+            m_next->stack_cache_size = m_cur->stack_cache_size - (int32_t)context.info.signed_immediate;
+        }
+    }
+    else if (reg == patmos_s0 + PATMOS_SREG_SS)
+    {
+        // sres/sfree/sens move ss as a side effect, which the row accounts
+        // for. An mts loads an arbitrary value and loses the caller's ss.
+        if (context.type == EmulateInstruction::eContextRegisterPlusOffset)
+            m_next->ss_written = true;
+    }
+    else if (reg == patmos_s0 + PATMOS_SREG_SRB || reg == patmos_s0 + PATMOS_SREG_SRO)
+    {
+        // mts restores srb/sro in the epilogue. Calls clobber them as well,
+        // but the caller's values stay where the prologue put them.
+        if (context.type == EmulateInstruction::eContextRegisterPlusOffset)
+        {
+            start_epilogue ();
+            SavedLocation *loc = get_saved_location (*m_next, reg - patmos_s0);
+            if (loc->kind != SavedLocation::eUnchanged)
+                *loc = SavedLocation();
+        }
+    }
+    else if (reg == patmos_pc)
+    {
+        if (context.type == EmulateInstruction::eContextAbsoluteBranchRegister &&
+            context.info_type == EmulateInstruction::eInfoTypeRegisterRegisterOperands &&
+            context.info.RegisterRegisterOperands.operand1.kinds[eRegisterKindDWARF] == patmos_s0 + PATMOS_SREG_SRB)
+            m_is_return = true;
+    }
+}
+
+// Feed the bundle at offset to the emulator. Reads come from cur and
+// writes go to next so that both instructions of a bundle see the state
+// from before the bundle.
+void
+AssemblyParse_Patmos::emulate_bundle (lldb::offset_t offset,
+                                      size_t bundle_size,
+                                      const FrameState &cur,
+                                      FrameState &next,
+                                      bool &is_return,
+                                      uint32_t &delay_slots)
+{
+    m_cur = &cur;
+    m_next = &next;
+    m_is_return = false;
+
+    Opcode opcode;
+    if (bundle_size == 8)
+        opcode.SetOpcode64 (((uint64_t)get_word (offset) << 32) | get_word (offset + 4));
+    else
+        opcode.SetOpcode32 (get_word (offset));
+
+    Address insn_addr (m_func_bounds.GetBaseAddress());
+    insn_addr.SetOffset (insn_addr.GetOffset() + offset);
+
+    delay_slots = 0;
+    if (m_inst_emulator_ap->SetInstruction (opcode, insn_addr, m_exe_ctx.GetTargetPtr()) &&
+        m_inst_emulator_ap->EvaluateInstruction (0))
+    {
+        delay_slots = m_inst_emulator_ap->GetBranchDelaySlots ();
+    }
+    else
+    {
+        Log *log(GetLogIfAllCategoriesSet (LIBLLDB_LOG_UNWIND));
+        if (log)
+            log->Printf ("AssemblyParse_Patmos: unable to emulate the bundle at offset 0x%" PRIx64 " of the function at 0x%" PRIx64,
+                         (uint64_t)offset, m_func_addr);
+    }
+    is_return = m_is_return;
+
+    m_cur = NULL;
+    m_next = NULL;
+}
+
+// Intern the bytes of a DWARF expression; UnwindPlan rows only point at
+// their expression bytes so they have to outlive every plan. There are
+// only a handful of distinct expressions (one per frame layout) so these
+// are kept for the lifetime of the debugger.
+const uint8_t *
+AssemblyParse_Patmos::intern_expression (const StreamString &expr)
+{
+    static Mutex g_mutex (Mutex::eMutexTypeNormal);
+    static std::set<std::string> g_expressions;
+    Mutex::Locker locker (g_mutex);
+    std::set<std::string>::const_iterator pos = g_expressions.insert (std::string (expr.GetData(), expr.GetSize())).first;
+    return (const uint8_t *)pos->data();
+}
+
+// Append a DWARF expression that pushes the value the special register
+// had on entry to the function.
+void
+AssemblyParse_Patmos::append_saved_value (StreamString &expr, const SavedLocation &loc, uint32_t sreg_lldb_regnum, const FrameState &state) const
+{
+    expr.PutHex8 (DW_OP_bregx);
+    switch (loc.kind)
+    {
+    case SavedLocation::eUnchanged:
+        expr.PutULEB128 (sreg_lldb_regnum);
+        expr.PutSLEB128 (0);
+        break;
+    case SavedLocation::eInRegister:
+        expr.PutULEB128 (m_lldb_gpr_regnums[loc.reg]);
+        expr.PutSLEB128 (0);
+        break;
+    case SavedLocation::eInStackCache:
+        expr.PutULEB128 (m_lldb_st_regnum);
+        expr.PutSLEB128 (state.stack_cache_size + loc.offset);
+        expr.PutHex8 (DW_OP_deref);
+        break;
+    case SavedLocation::eInShadowStack:
+        expr.PutULEB128 (m_lldb_gpr_regnums[PATMOS_REG_RSP]);
+        expr.PutSLEB128 (state.shadow_stack_size + loc.offset);
+        expr.PutHex8 (DW_OP_deref);
+        break;
+    }
+}
+
+UnwindPlan::RowSP
+AssemblyParse_Patmos::make_row (const FrameState &state, lldb::addr_t offset) const
+{
+    UnwindPlan::RowSP row (new UnwindPlan::Row);
+    row->SetOffset (offset);
+
+    // The CFA is the caller's stack cache top
+    row->SetCFARegister (m_lldb_st_regnum);
+    row->SetCFAOffset (state.stack_cache_size);
+    row->SetRegisterLocationToIsCFAPlusOffset (m_lldb_st_regnum, 0, true);
+
+    const uint32_t lldb_sp_regnum = m_lldb_gpr_regnums[PATMOS_REG_RSP];
+    UnwindPlan::Row::RegisterLocation regloc;
+    if (state.shadow_stack_size != 0)
+    {
+        StreamString expr (Stream::eBinary, m_arch.GetAddressByteSize(), m_arch.GetByteOrder());
+        expr.PutHex8 (DW_OP_bregx);
+        expr.PutULEB128 (lldb_sp_regnum);
+        expr.PutSLEB128 (state.shadow_stack_size);
+        regloc.SetIsDWARFExpression (intern_expression (expr), expr.GetSize());
+        row->SetRegisterInfo (lldb_sp_regnum, regloc);
+    }
+
+    for (uint32_t i = 0; i < FrameState::kNumGPRs; ++i)
+    {
+        const SavedLocation &loc = state.gprs[i];
+        if (m_lldb_gpr_regnums[i] == LLDB_INVALID_REGNUM)
+            continue;
+        if (loc.kind == SavedLocation::eInStackCache)
+        {
+            row->SetRegisterLocationToAtCFAPlusOffset (m_lldb_gpr_regnums[i], loc.offset, true);
+        }
+        else if (loc.kind == SavedLocation::eInShadowStack)
+        {
+            StreamString expr (Stream::eBinary, m_arch.GetAddressByteSize(), m_arch.GetByteOrder());
+            expr.PutHex8 (DW_OP_bregx);
+            expr.PutULEB128 (lldb_sp_regnum);
+            expr.PutSLEB128 (state.shadow_stack_size + loc.offset);
+            regloc.SetAtDWARFExpression (intern_expression (expr), expr.GetSize());
+            row->SetRegisterInfo (m_lldb_gpr_regnums[i], regloc);
+        }
+    }
+
+    // The caller resumes at srb + sro
+    StreamString expr (Stream::eBinary, m_arch.GetAddressByteSize(), m_arch.GetByteOrder());
+    append_saved_value (expr, state.srb, m_lldb_srb_regnum, state);
+    append_saved_value (expr, state.sro, m_lldb_sro_regnum, state);
+    expr.PutHex8 (DW_OP_plus);
+    regloc.SetIsDWARFExpression (intern_expression (expr), expr.GetSize());
+    row->SetRegisterInfo (m_lldb_pc_regnum, regloc);
+
+    // srb and sro themselves are clobbered by every call
+    row->SetRegisterLocationToUndefined (m_lldb_srb_regnum, true, false);
+    row->SetRegisterLocationToUndefined (m_lldb_sro_regnum, true, false);
+
+    // Spilling only ever moves ss down towards st and the sfree of the
+    // return brings it back up to at least the caller's st (the CFA), so
+    // the caller sees ss = max (ss, CFA) once this frame is gone.
+    if (m_lldb_ss_regnum != LLDB_INVALID_REGNUM)
+    {
+        if (state.ss_written)
+        {
+            row->SetRegisterLocationToUndefined (m_lldb_ss_regnum, true, false);
+        }
+        else
+        {
+            StreamString ss_expr (Stream::eBinary, m_arch.GetAddressByteSize(), m_arch.GetByteOrder());
+            ss_expr.PutHex8 (DW_OP_bregx);
+            ss_expr.PutULEB128 (m_lldb_ss_regnum);
+            ss_expr.PutSLEB128 (0);
+            ss_expr.PutHex8 (DW_OP_bregx);
+            ss_expr.PutULEB128 (m_lldb_st_regnum);
+            ss_expr.PutSLEB128 (state.stack_cache_size);
+            ss_expr.PutHex8 (DW_OP_over);
+            ss_expr.PutHex8 (DW_OP_over);
+            ss_expr.PutHex8 (DW_OP_gt);
+            ss_expr.PutHex8 (DW_OP_bra);    // ss > CFA: keep ss
+            ss_expr.PutHex16 (1);
+            ss_expr.PutHex8 (DW_OP_swap);
+            ss_expr.PutHex8 (DW_OP_drop);
+            regloc.SetIsDWARFExpression (intern_expression (ss_expr), ss_expr.GetSize());
+            row->SetRegisterInfo (m_lldb_ss_regnum, regloc);
+        }
+    }
+    return row;
+}
+
+bool
+AssemblyParse_Patmos::get_unwind_plan (UnwindPlan &unwind_plan)
+{
+    if (!resolve_register_numbers () || !read_function_bytes ())
+        return false;
+
+    m_inst_emulator_ap.reset (new EmulateInstructionPatmos (m_arch));
+    m_inst_emulator_ap->SetBaton (this);
+    m_inst_emulator_ap->SetCallbacks (read_memory, write_memory, read_register, write_register);
+    // Predicated frame setup or tear down only happens on one path through
+    // the function (e.g. an if-converted early return); the rows describe
+    // the path where the predicate is false.
+    m_inst_emulator_ap->SetSkipConditionalInstructions (true);
+
+    unwind_plan.SetRegisterKind (eRegisterKindLLDB);
+
+    FrameState state;
+    m_in_epilogue = false;
+    m_in_prologue = true;
+    uint32_t return_delay_slots = 0;
+
+    unwind_plan.AppendRow (make_row (state, 0));
+
+    lldb::offset_t offset = 0;
+    uint32_t insns[2];
+    size_t num_insns;
+    uint32_t long_imm;
+    bool has_long_imm;
+    size_t bundle_size;
+    while ((bundle_size = get_bundle (offset, insns, num_insns, long_imm, has_long_imm)) > 0)
+    {
+        // Control flow, taken or not, ends the prologue
+        bool is_branch = false;
+        for (size_t i = 0; i < num_insns; ++i)
+        {
+            const uint32_t opcode = PatmosOpcode (insns[i]);
+            if (PatmosIsCFLi (insns[i]) || (!PatmosIsALUi (insns[i]) && (opcode == PATMOS_OPC_CFLR || opcode == PATMOS_OPC_CFLR_ND)))
+                is_branch = true;
+        }
+
+        FrameState next (state);
+        bool is_return = false;
+        uint32_t delay_slots = 0;
+        emulate_bundle (offset, bundle_size, state, next, is_return, delay_slots);
+        offset += bundle_size;
+
+        if (is_branch)
+            m_in_prologue = false;
+
+        bool return_completed = false;
+        if (return_delay_slots > 0 && --return_delay_slots == 0)
+            return_completed = true;
+        if (is_return)
+        {
+            return_delay_slots = delay_slots;
+            return_completed = return_delay_slots == 0;
+        }
+        if (return_completed)
+        {
+            // Whatever follows the return is reached with the body's frame
+            if (m_in_epilogue)
+                next = m_body_state;
+            m_in_epilogue = false;
+        }
+
+        if (!state.SameRow (next))
+            unwind_plan.AppendRow (make_row (next, offset));
+        state = next;
+    }
+
+    unwind_plan.SetPlanValidAddressRange (m_func_bounds);
+    unwind_plan.SetSourceName ("patmos stack cache insn profiling");
+    unwind_plan.SetSourcedFromCompiler (eLazyBoolNo);
+    unwind_plan.SetUnwindPlanValidAtAllInstructions (eLazyBoolYes);
+    return true;
+}
+
+bool
+AssemblyParse_Patmos::find_first_non_prologue_insn (Address &address)
+{
+    if (!read_function_bytes ())
+        return false;
+
+    lldb::offset_t offset = 0;
+    uint32_t insns[2];
+    size_t num_insns;
+    uint32_t long_imm;
+    bool has_long_imm;
+    size_t bundle_size;
+    while ((bundle_size = get_bundle (offset, insns, num_insns, long_imm, has_long_imm)) > 0)
+    {
+        bool prologue_bundle = true;
+        for (size_t i = 0; i < num_insns && prologue_bundle; ++i)
+            prologue_bundle = is_prologue_insn (insns[i], i == 0 && has_long_imm, long_imm);
+        if (!prologue_bundle)
+            break;
+        offset += bundle_size;
+    }
+
+    address = m_func_bounds.GetBaseAddress();
+    address.SetOffset (address.GetOffset() + offset);
+    return true;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+//  UnwindAssembly_Patmos method definitions
+//-----------------------------------------------------------------------------------------------
+
+UnwindAssembly_Patmos::UnwindAssembly_Patmos (const ArchSpec &arch) :
+    lldb_private::UnwindAssembly(arch),
+    m_arch(arch)
+{
+}
+
+
+UnwindAssembly_Patmos::~UnwindAssembly_Patmos ()
+{
+}
+
+bool
+UnwindAssembly_Patmos::GetNonCallSiteUnwindPlanFromAssembly (AddressRange& func, Thread& thread, UnwindPlan& unwind_plan)
+{
+    ExecutionContext exe_ctx (thread.shared_from_this());
+    AssemblyParse_Patmos asm_parse (exe_ctx, m_arch, func);
+    return asm_parse.get_unwind_plan (unwind_plan);
+}
+
+// The plan is exact at every instruction so it serves as the fast plan as well
+bool
+UnwindAssembly_Patmos::GetFastUnwindPlan (AddressRange& func, Thread& thread, UnwindPlan &unwind_plan)
+{
+    ExecutionContext exe_ctx (thread.shared_from_this());
+    AssemblyParse_Patmos asm_parse (exe_ctx, m_arch, func);
+    return asm_parse.get_unwind_plan (unwind_plan);
+}
+
+bool
+UnwindAssembly_Patmos::FirstNonPrologueInsn (AddressRange& func, const ExecutionContext &exe_ctx, Address& first_non_prologue_insn)
+{
+    AssemblyParse_Patmos asm_parse (exe_ctx, m_arch, func);
+    return asm_parse.find_first_non_prologue_insn (first_non_prologue_insn);
+}
+
+UnwindAssembly *
+UnwindAssembly_Patmos::CreateInstance (const ArchSpec &arch)
+{
+    if (arch.GetMachine () == llvm::Triple::patmos)
+        return new UnwindAssembly_Patmos (arch);
+    return NULL;
+}
+
+
+//------------------------------------------------------------------
+// PluginInterface protocol in UnwindAssembly_Patmos
+//------------------------------------------------------------------
+
+ConstString
+UnwindAssembly_Patmos::GetPluginName()
+{
+    return GetPluginNameStatic();
+}
+
+
+uint32_t
+UnwindAssembly_Patmos::GetPluginVersion()
+{
+    return 1;
+}
+
+void
+UnwindAssembly_Patmos::Initialize()
+{
+    PluginManager::RegisterPlugin (GetPluginNameStatic(),
+                                   GetPluginDescriptionStatic(),
+                                   CreateInstance);
+}
+
+void
+UnwindAssembly_Patmos::Terminate()
+{
+    PluginManager::UnregisterPlugin (CreateInstance);
+}
+
+
+lldb_private::ConstString
+UnwindAssembly_Patmos::GetPluginNameStatic()
+{
+    static ConstString g_name("patmos");
+    return g_name;
+}
+
+const char *
+UnwindAssembly_Patmos::GetPluginDescriptionStatic()
+{
+    return "Patmos stack cache aware assembly language profiler plugin.";
+}
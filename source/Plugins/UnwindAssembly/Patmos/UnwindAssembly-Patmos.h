@@ -0,0 +1,83 @@
+//===-- UnwindAssembly-Patmos.h ---------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_UnwindAssembly_Patmos_h_
+#define liblldb_UnwindAssembly_Patmos_h_
+
+#include "lldb/lldb-private.h"
+#include "lldb/Target/UnwindAssembly.h"
+
+//----------------------------------------------------------------------
+// Patmos keeps every frame in two places: the stack cache, which is
+// managed with sres/sens/sfree and addressed relative to the stack top
+// pointer st, and the shadow stack in main memory addressed through r31.
+// The return address is not stored as such; call sets the return base
+// and offset registers srb/sro which a non-leaf function copies into its
+// stack cache frame.
+//
+// This profiler walks a function's instructions to build UnwindPlans
+// whose CFA is the caller's stack top (st plus the size of the stack
+// cache frame) and which know where srb, sro, r31 and the callee saved
+// registers of the caller live at each instruction.
+//----------------------------------------------------------------------
+class UnwindAssembly_Patmos : public lldb_private::UnwindAssembly
+{
+public:
+
+    ~UnwindAssembly_Patmos ();
+
+    virtual bool
+    GetNonCallSiteUnwindPlanFromAssembly (lldb_private::AddressRange& func,
+                                          lldb_private::Thread& thread,
+                                          lldb_private::UnwindPlan& unwind_plan);
+
+    virtual bool
+    GetFastUnwindPlan (lldb_private::AddressRange& func,
+                       lldb_private::Thread& thread,
+                       lldb_private::UnwindPlan &unwind_plan);
+
+    // thread may be NULL in which case we only use the Target (e.g. if this is called pre-process-launch).
+    virtual bool
+    FirstNonPrologueInsn (lldb_private::AddressRange& func,
+                          const lldb_private::ExecutionContext &exe_ctx,
+                          lldb_private::Address& first_non_prologue_insn);
+
+    static lldb_private::UnwindAssembly *
+    CreateInstance (const lldb_private::ArchSpec &arch);
+
+
+    //------------------------------------------------------------------
+    // PluginInterface protocol
+    //------------------------------------------------------------------
+    static void
+    Initialize();
+
+    static void
+    Terminate();
+
+    static lldb_private::ConstString
+    GetPluginNameStatic();
+
+    static const char *
+    GetPluginDescriptionStatic();
+
+    virtual lldb_private::ConstString
+    GetPluginName();
+
+    virtual uint32_t
+    GetPluginVersion();
+
+private:
+    UnwindAssembly_Patmos (const lldb_private::ArchSpec &arch);
+
+    lldb_private::ArchSpec m_arch;
+};
+
+
+#endif // liblldb_UnwindAssembly_Patmos_h_
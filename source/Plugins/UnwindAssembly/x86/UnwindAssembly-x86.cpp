@@ -242,6 +242,8 @@ AssemblyParse_x86::AssemblyParse_x86 (const ExecutionContext &exe_ctx, int cpu,
            m_lldb_ip_regnum = lldb_regno;
    }
 
+   // The LLVM targets are registered on first use
+   PluginManager::RunDeferredInitializer (PluginManager::GetLLVMTargetsInitializerName());
    m_disasm_context = ::LLVMCreateDisasm(m_arch.GetTriple().getTriple().c_str(), 
                                           (void*)this, 
                                           /*TagType=*/1,
@@ -473,7 +475,7 @@ AssemblyParse_x86::instruction_length (Address addr, int &length)
     llvm::SmallVector <uint8_t, 32> opcode_data;
     opcode_data.resize (max_op_byte_size);
 
-    if (!addr.IsValid())
+    if (!addr.IsValid() || m_disasm_context == NULL)
         return false;
 
     const bool prefer_file_cache = true;
@@ -260,7 +260,12 @@ CompileUnit::SetLineTable(LineTable* line_table)
     if (line_table == NULL)
         m_flags.Clear(flagsParsedLineTable);
     else
+    {
         m_flags.Set(flagsParsedLineTable);
+        // The line table is fully populated by now, so pack it to keep
+        // our memory footprint down.
+        line_table->Compact();
+    }
     m_line_table_ap.reset(line_table);
 }
 
@@ -23,7 +23,11 @@ using namespace lldb_private;
 //----------------------------------------------------------------------
 LineTable::LineTable(CompileUnit* comp_unit) :
     m_comp_unit(comp_unit),
-    m_entries()
+    m_entries(),
+    m_num_packed_entries(0),
+    m_packed_data(),
+    m_checkpoints(),
+    m_sequences()
 {
 }
 
@@ -48,6 +52,8 @@ LineTable::InsertLineEntry
     bool is_terminal_entry
 )
 {
+    Unpack ();
+
     Entry entry(file_addr, line, column, file_idx, is_start_of_statement, is_start_of_basic_block, is_prologue_end, is_epilogue_begin, is_terminal_entry);
 
     entry_collection::iterator begin_pos = m_entries.begin();
@@ -106,6 +112,7 @@ LineTable::InsertSequence (LineSequence* sequence)
     LineSequenceImpl* seq = reinterpret_cast<LineSequenceImpl*>(sequence);
     if (seq->m_entries.empty())
         return;
+    Unpack ();
     Entry& entry = seq->m_entries.front();
     
     // If the first entry address in this sequence is greater than or equal to
@@ -160,18 +167,311 @@ LineTable::Entry::LessThanBinaryPredicate::operator() (const LineTable::Entry& a
     #undef LT_COMPARE
 }
 
+//----------------------------------------------------------------------
+// Packed line entry encoding.
+//
+// Each row that isn't stored in a checkpoint is encoded relative to the
+// row before it as a flags byte followed by the SLEB128 address delta,
+// the SLEB128 line delta, and the ULEB128 column and file index if they
+// differ from the previous row.
+//----------------------------------------------------------------------
+enum
+{
+    ePackedIsStartOfStatement   = (1u << 0),
+    ePackedIsStartOfBasicBlock  = (1u << 1),
+    ePackedIsPrologueEnd        = (1u << 2),
+    ePackedIsEpilogueBegin      = (1u << 3),
+    ePackedIsTerminalEntry      = (1u << 4),
+    ePackedHasColumn            = (1u << 5),
+    ePackedHasFileIndex         = (1u << 6)
+};
+
+static void
+AppendULEB128 (std::vector<uint8_t> &data, uint64_t value)
+{
+    do
+    {
+        uint8_t byte = value & 0x7f;
+        value >>= 7;
+        if (value != 0)
+            byte |= 0x80;
+        data.push_back (byte);
+    } while (value != 0);
+}
+
+static void
+AppendSLEB128 (std::vector<uint8_t> &data, int64_t value)
+{
+    bool more = true;
+    while (more)
+    {
+        uint8_t byte = value & 0x7f;
+        value >>= 7;
+        if ((value == 0 && (byte & 0x40) == 0) || (value == -1 && (byte & 0x40) != 0))
+            more = false;
+        else
+            byte |= 0x80;
+        data.push_back (byte);
+    }
+}
+
+static uint64_t
+DecodeULEB128 (const uint8_t *data, uint32_t &offset)
+{
+    uint64_t result = 0;
+    uint32_t shift = 0;
+    uint8_t byte;
+    do
+    {
+        byte = data[offset++];
+        result |= (uint64_t)(byte & 0x7f) << shift;
+        shift += 7;
+    } while (byte & 0x80);
+    return result;
+}
+
+static int64_t
+DecodeSLEB128 (const uint8_t *data, uint32_t &offset)
+{
+    int64_t result = 0;
+    uint32_t shift = 0;
+    uint8_t byte;
+    do
+    {
+        byte = data[offset++];
+        result |= (int64_t)(byte & 0x7f) << shift;
+        shift += 7;
+    } while (byte & 0x80);
+    if (shift < 64 && (byte & 0x40))
+        result |= -((int64_t)1 << shift);
+    return result;
+}
+
+void
+LineTable::Compact ()
+{
+    if (IsPacked() || m_entries.empty())
+        return;
+
+    const size_t count = m_entries.size();
+    std::vector<uint8_t> packed_data;
+    checkpoint_collection checkpoints;
+    sequence_collection sequences;
+    // Most rows take three bytes: the flags, an address delta and a line delta
+    packed_data.reserve (count * 3);
+    checkpoints.reserve ((count + kNumEntriesPerCheckpoint - 1) / kNumEntriesPerCheckpoint);
+
+    Sequence sequence = { LLDB_INVALID_ADDRESS, LLDB_INVALID_ADDRESS, 0, 0 };
+    for (size_t idx = 0; idx < count; ++idx)
+    {
+        const Entry &entry = m_entries[idx];
+        if (idx % kNumEntriesPerCheckpoint == 0)
+        {
+            Checkpoint checkpoint;
+            checkpoint.entry = entry;
+            checkpoint.data_offset = packed_data.size();
+            checkpoints.push_back (checkpoint);
+        }
+        else
+        {
+            const Entry &prev_entry = m_entries[idx - 1];
+            uint8_t flags = 0;
+            if (entry.is_start_of_statement)    flags |= ePackedIsStartOfStatement;
+            if (entry.is_start_of_basic_block)  flags |= ePackedIsStartOfBasicBlock;
+            if (entry.is_prologue_end)          flags |= ePackedIsPrologueEnd;
+            if (entry.is_epilogue_begin)        flags |= ePackedIsEpilogueBegin;
+            if (entry.is_terminal_entry)        flags |= ePackedIsTerminalEntry;
+            if (entry.column != prev_entry.column)
+                flags |= ePackedHasColumn;
+            if (entry.file_idx != prev_entry.file_idx)
+                flags |= ePackedHasFileIndex;
+            packed_data.push_back (flags);
+            AppendSLEB128 (packed_data, (int64_t)(entry.file_addr - prev_entry.file_addr));
+            AppendSLEB128 (packed_data, (int64_t)entry.line - (int64_t)prev_entry.line);
+            if (flags & ePackedHasColumn)
+                AppendULEB128 (packed_data, entry.column);
+            if (flags & ePackedHasFileIndex)
+                AppendULEB128 (packed_data, entry.file_idx);
+        }
+
+        if (sequence.num_entries == 0)
+        {
+            sequence.base_addr = entry.file_addr;
+            sequence.first_entry_idx = idx;
+        }
+        ++sequence.num_entries;
+        if (entry.is_terminal_entry)
+        {
+            sequence.end_addr = entry.file_addr;
+            sequences.push_back (sequence);
+            sequence.num_entries = 0;
+        }
+    }
+
+    // Use the swap technique so the packed collections are exactly sized
+    // and the memory for the unpacked entries is released.
+    std::vector<uint8_t> (packed_data.begin(), packed_data.end()).swap (m_packed_data);
+    checkpoint_collection (checkpoints.begin(), checkpoints.end()).swap (m_checkpoints);
+    sequence_collection (sequences.begin(), sequences.end()).swap (m_sequences);
+    entry_collection().swap (m_entries);
+    m_num_packed_entries = count;
+}
+
+void
+LineTable::Unpack ()
+{
+    if (!IsPacked())
+        return;
+
+    entry_collection entries;
+    entries.reserve (m_num_packed_entries);
+    for (EntryIterator pos (*this); pos.IsValid(); pos.Next())
+        entries.push_back (pos.GetEntry());
+
+    m_num_packed_entries = 0;
+    std::vector<uint8_t>().swap (m_packed_data);
+    checkpoint_collection().swap (m_checkpoints);
+    sequence_collection().swap (m_sequences);
+    m_entries.swap (entries);
+}
+
+void
+LineTable::DumpStatistics (Stream *s) const
+{
+    const uint64_t num_entries = GetSize();
+    const uint64_t unpacked_byte_size = num_entries * sizeof(Entry);
+    uint64_t byte_size = m_entries.capacity() * sizeof(Entry);
+    byte_size += m_packed_data.capacity();
+    byte_size += m_checkpoints.capacity() * sizeof(Checkpoint);
+    byte_size += m_sequences.capacity() * sizeof(Sequence);
+
+    s->Printf ("%" PRIu64 " line entries", num_entries);
+    if (IsPacked())
+        s->Printf (" in %" PRIu64 " sequences", (uint64_t)m_sequences.size());
+    s->Printf (" using %" PRIu64 " bytes", byte_size);
+    if (IsPacked() && unpacked_byte_size > 0)
+        s->Printf (" (%" PRIu64 " bytes unpacked, %.1f%% saved)",
+                   unpacked_byte_size,
+                   100.0 * ((double)unpacked_byte_size - (double)byte_size) / (double)unpacked_byte_size);
+    s->EOL();
+}
+
+//----------------------------------------------------------------------
+// EntryIterator
+//----------------------------------------------------------------------
+LineTable::EntryIterator::EntryIterator (const LineTable &line_table, uint32_t idx) :
+    m_line_table (line_table),
+    m_idx (idx),
+    m_data_offset (0),
+    m_entry ()
+{
+    if (!IsValid())
+        return;
+
+    if (m_line_table.IsPacked())
+    {
+        // Start at the closest checkpoint and decode forward from there
+        const Checkpoint &checkpoint = m_line_table.m_checkpoints[m_idx / kNumEntriesPerCheckpoint];
+        m_entry = checkpoint.entry;
+        m_data_offset = checkpoint.data_offset;
+        const uint32_t checkpoint_idx = m_idx - (m_idx % kNumEntriesPerCheckpoint);
+        for (m_idx = checkpoint_idx; m_idx < idx; )
+            Next();
+    }
+    else
+    {
+        m_entry = m_line_table.m_entries[m_idx];
+    }
+}
+
+void
+LineTable::EntryIterator::Next ()
+{
+    ++m_idx;
+    if (!IsValid())
+        return;
+
+    if (!m_line_table.IsPacked())
+    {
+        m_entry = m_line_table.m_entries[m_idx];
+        return;
+    }
+
+    if (m_idx % kNumEntriesPerCheckpoint == 0)
+    {
+        const Checkpoint &checkpoint = m_line_table.m_checkpoints[m_idx / kNumEntriesPerCheckpoint];
+        m_entry = checkpoint.entry;
+        m_data_offset = checkpoint.data_offset;
+        return;
+    }
+
+    const uint8_t *data = &m_line_table.m_packed_data[0];
+    const uint8_t flags = data[m_data_offset++];
+    m_entry.file_addr += DecodeSLEB128 (data, m_data_offset);
+    m_entry.line = (uint32_t)((int64_t)m_entry.line + DecodeSLEB128 (data, m_data_offset));
+    if (flags & ePackedHasColumn)
+        m_entry.column = DecodeULEB128 (data, m_data_offset);
+    if (flags & ePackedHasFileIndex)
+        m_entry.file_idx = DecodeULEB128 (data, m_data_offset);
+    m_entry.is_start_of_statement = (flags & ePackedIsStartOfStatement) != 0;
+    m_entry.is_start_of_basic_block = (flags & ePackedIsStartOfBasicBlock) != 0;
+    m_entry.is_prologue_end = (flags & ePackedIsPrologueEnd) != 0;
+    m_entry.is_epilogue_begin = (flags & ePackedIsEpilogueBegin) != 0;
+    m_entry.is_terminal_entry = (flags & ePackedIsTerminalEntry) != 0;
+}
+
+bool
+LineTable::GetEntryAtIndex (uint32_t idx, Entry &entry) const
+{
+    EntryIterator pos (*this, idx);
+    if (pos.IsValid())
+    {
+        entry = pos.GetEntry();
+        return true;
+    }
+    return false;
+}
 
+//----------------------------------------------------------------------
+// Returns the index of the first line entry whose file address is
+// greater than or equal to "file_addr", or GetSize() if there is none.
+//----------------------------------------------------------------------
+uint32_t
+LineTable::LowerBoundFileAddress (lldb::addr_t file_addr) const
+{
+    if (!IsPacked())
+    {
+        Entry search_entry;
+        search_entry.file_addr = file_addr;
+        entry_collection::const_iterator pos = std::lower_bound (m_entries.begin(), m_entries.end(), search_entry, Entry::EntryAddressLessThan);
+        return std::distance (m_entries.begin(), pos);
+    }
+
+    // Find the last checkpoint whose address is less than "file_addr", the
+    // answer is then within the next kNumEntriesPerCheckpoint entries.
+    checkpoint_collection::const_iterator pos = std::lower_bound (m_checkpoints.begin(), m_checkpoints.end(), file_addr, Checkpoint::FileAddressLessThan);
+    uint32_t start_idx = 0;
+    if (pos != m_checkpoints.begin())
+        start_idx = std::distance (m_checkpoints.begin(), pos - 1) * kNumEntriesPerCheckpoint;
+
+    EntryIterator entry_pos (*this, start_idx);
+    while (entry_pos.IsValid() && entry_pos.GetEntry().file_addr < file_addr)
+        entry_pos.Next();
+    return entry_pos.GetIndex();
+}
 
 uint32_t
 LineTable::GetSize() const
 {
+    if (IsPacked())
+        return m_num_packed_entries;
     return m_entries.size();
 }
 
 bool
 LineTable::GetLineEntryAtIndex(uint32_t idx, LineEntry& line_entry)
 {
-    if (idx < m_entries.size())
+    if (idx < GetSize())
     {
         ConvertEntryAtIndexToLineEntry (idx, line_entry);
         return true;
@@ -190,49 +490,57 @@ LineTable::FindLineEntryByAddress (const Address &so_addr, LineEntry& line_entry
 
     if (so_addr.GetModule().get() == m_comp_unit->GetModule().get())
     {
-        Entry search_entry;
-        search_entry.file_addr = so_addr.GetFileAddress();
-        if (search_entry.file_addr != LLDB_INVALID_ADDRESS)
+        const lldb::addr_t file_addr = so_addr.GetFileAddress();
+        if (file_addr != LLDB_INVALID_ADDRESS)
         {
-            entry_collection::const_iterator begin_pos = m_entries.begin();
-            entry_collection::const_iterator end_pos = m_entries.end();
-            entry_collection::const_iterator pos = lower_bound(begin_pos, end_pos, search_entry, Entry::EntryAddressLessThan);
-            if (pos != end_pos)
+            const uint32_t count = GetSize();
+            uint32_t idx = LowerBoundFileAddress (file_addr);
+            Entry entry;
+            if (idx < count)
             {
-                if (pos != begin_pos)
+                GetEntryAtIndex (idx, entry);
+                if (idx > 0)
                 {
-                    if (pos->file_addr != search_entry.file_addr)
-                        --pos;
-                    else if (pos->file_addr == search_entry.file_addr)
+                    if (entry.file_addr != file_addr)
+                    {
+                        --idx;
+                        GetEntryAtIndex (idx, entry);
+                    }
+                    else
                     {
                         // If this is a termination entry, it should't match since
                         // entries with the "is_terminal_entry" member set to true 
                         // are termination entries that define the range for the 
                         // previous entry.
-                        if (pos->is_terminal_entry)
+                        if (entry.is_terminal_entry)
                         {
                             // The matching entry is a terminal entry, so we skip
                             // ahead to the next entry to see if there is another
                             // entry following this one whose section/offset matches.
-                            ++pos;
-                            if (pos != end_pos)
+                            ++idx;
+                            if (idx < count)
                             {
-                                if (pos->file_addr != search_entry.file_addr)
-                                    pos = end_pos;
+                                GetEntryAtIndex (idx, entry);
+                                if (entry.file_addr != file_addr)
+                                    idx = count;
                             }
                         }
                         
-                        if (pos != end_pos)
+                        if (idx < count)
                         {
                             // While in the same section/offset backup to find the first
                             // line entry that matches the address in case there are 
                             // multiple
-                            while (pos != begin_pos)
+                            Entry prev_entry;
+                            while (idx > 0)
                             {
-                                entry_collection::const_iterator prev_pos = pos - 1;
-                                if (prev_pos->file_addr == search_entry.file_addr &&
-                                    prev_pos->is_terminal_entry == false)
-                                    --pos;
+                                GetEntryAtIndex (idx - 1, prev_entry);
+                                if (prev_entry.file_addr == file_addr &&
+                                    prev_entry.is_terminal_entry == false)
+                                {
+                                    --idx;
+                                    entry = prev_entry;
+                                }
                                 else
                                     break;
                             }
@@ -243,12 +551,13 @@ LineTable::FindLineEntryByAddress (const Address &so_addr, LineEntry& line_entry
                 
                 // Make sure we have a valid match and that the match isn't a terminating
                 // entry for a previous line...
-                if (pos != end_pos && pos->is_terminal_entry == false)
+                if (idx < count && entry.is_terminal_entry == false)
                 {
-                    uint32_t match_idx = std::distance (begin_pos, pos);
-                    success = ConvertEntryAtIndexToLineEntry(match_idx, line_entry);
+                    EntryIterator next_pos (*this, idx);
+                    next_pos.Next();
+                    success = ConvertEntryToLineEntry (entry, next_pos.IsValid() ? &next_pos.GetEntry() : NULL, line_entry);
                     if (index_ptr != NULL && success)
-                        *index_ptr = match_idx;
+                        *index_ptr = idx;
                 }
             }
         }
@@ -260,27 +569,36 @@ LineTable::FindLineEntryByAddress (const Address &so_addr, LineEntry& line_entry
 bool
 LineTable::ConvertEntryAtIndexToLineEntry (uint32_t idx, LineEntry &line_entry)
 {
-    if (idx < m_entries.size())
+    EntryIterator pos (*this, idx);
+    if (pos.IsValid())
     {
-        const Entry& entry = m_entries[idx];
-        ModuleSP module_sp (m_comp_unit->GetModule());
-        if (module_sp && module_sp->ResolveFileAddress(entry.file_addr, line_entry.range.GetBaseAddress()))
-        {
-            if (!entry.is_terminal_entry && idx + 1 < m_entries.size())
-                line_entry.range.SetByteSize(m_entries[idx+1].file_addr - entry.file_addr);
-            else
-                line_entry.range.SetByteSize(0);
-
-            line_entry.file = m_comp_unit->GetSupportFiles().GetFileSpecAtIndex (entry.file_idx);
-            line_entry.line = entry.line;
-            line_entry.column = entry.column;
-            line_entry.is_start_of_statement = entry.is_start_of_statement;
-            line_entry.is_start_of_basic_block = entry.is_start_of_basic_block;
-            line_entry.is_prologue_end = entry.is_prologue_end;
-            line_entry.is_epilogue_begin = entry.is_epilogue_begin;
-            line_entry.is_terminal_entry = entry.is_terminal_entry;
-            return true;
-        }
+        const Entry entry (pos.GetEntry());
+        pos.Next();
+        return ConvertEntryToLineEntry (entry, pos.IsValid() ? &pos.GetEntry() : NULL, line_entry);
+    }
+    return false;
+}
+
+bool
+LineTable::ConvertEntryToLineEntry (const Entry &entry, const Entry *next_entry, LineEntry &line_entry)
+{
+    ModuleSP module_sp (m_comp_unit->GetModule());
+    if (module_sp && module_sp->ResolveFileAddress(entry.file_addr, line_entry.range.GetBaseAddress()))
+    {
+        if (!entry.is_terminal_entry && next_entry)
+            line_entry.range.SetByteSize(next_entry->file_addr - entry.file_addr);
+        else
+            line_entry.range.SetByteSize(0);
+
+        line_entry.file = m_comp_unit->GetSupportFiles().GetFileSpecAtIndex (entry.file_idx);
+        line_entry.line = entry.line;
+        line_entry.column = entry.column;
+        line_entry.is_start_of_statement = entry.is_start_of_statement;
+        line_entry.is_start_of_basic_block = entry.is_start_of_basic_block;
+        line_entry.is_prologue_end = entry.is_prologue_end;
+        line_entry.is_epilogue_begin = entry.is_epilogue_begin;
+        line_entry.is_terminal_entry = entry.is_terminal_entry;
+        return true;
     }
     return false;
 }
@@ -296,18 +614,20 @@ LineTable::FindLineEntryIndexByFileIndex
 )
 {
 
-    const size_t count = m_entries.size();
     std::vector<uint32_t>::const_iterator begin_pos = file_indexes.begin();
     std::vector<uint32_t>::const_iterator end_pos = file_indexes.end();
     size_t best_match = UINT32_MAX;
+    uint32_t best_match_line = UINT32_MAX;
 
-    for (size_t idx = start_idx; idx < count; ++idx)
+    for (EntryIterator pos (*this, start_idx); pos.IsValid(); pos.Next())
     {
+        const Entry &entry = pos.GetEntry();
+
         // Skip line table rows that terminate the previous row (is_terminal_entry is non-zero)
-        if (m_entries[idx].is_terminal_entry)
+        if (entry.is_terminal_entry)
             continue;
 
-        if (find (begin_pos, end_pos, m_entries[idx].file_idx) == end_pos)
+        if (find (begin_pos, end_pos, entry.file_idx) == end_pos)
             continue;
 
         // Exact match always wins.  Otherwise try to find the closest line > the desired
@@ -315,22 +635,23 @@ LineTable::FindLineEntryIndexByFileIndex
         // FIXME: Maybe want to find the line closest before and the line closest after and
         // if they're not in the same function, don't return a match.
 
-        if (m_entries[idx].line < line)
+        if (entry.line < line)
         {
             continue;
         }
-        else if (m_entries[idx].line == line)
+        else if (entry.line == line)
         {
             if (line_entry_ptr)
-                ConvertEntryAtIndexToLineEntry (idx, *line_entry_ptr);
-            return idx;
+                ConvertEntryAtIndexToLineEntry (pos.GetIndex(), *line_entry_ptr);
+            return pos.GetIndex();
         }
         else if (!exact)
         {
-            if (best_match == UINT32_MAX)
-                best_match = idx;
-            else if (m_entries[idx].line < m_entries[best_match].line)
-                best_match = idx;
+            if (best_match == UINT32_MAX || entry.line < best_match_line)
+            {
+                best_match = pos.GetIndex();
+                best_match_line = entry.line;
+            }
         }
     }
 
@@ -346,16 +667,18 @@ LineTable::FindLineEntryIndexByFileIndex
 uint32_t
 LineTable::FindLineEntryIndexByFileIndex (uint32_t start_idx, uint32_t file_idx, uint32_t line, bool exact, LineEntry* line_entry_ptr)
 {
-    const size_t count = m_entries.size();
     size_t best_match = UINT32_MAX;
+    uint32_t best_match_line = UINT32_MAX;
 
-    for (size_t idx = start_idx; idx < count; ++idx)
+    for (EntryIterator pos (*this, start_idx); pos.IsValid(); pos.Next())
     {
+        const Entry &entry = pos.GetEntry();
+
         // Skip line table rows that terminate the previous row (is_terminal_entry is non-zero)
-        if (m_entries[idx].is_terminal_entry)
+        if (entry.is_terminal_entry)
             continue;
 
-        if (m_entries[idx].file_idx != file_idx)
+        if (entry.file_idx != file_idx)
             continue;
 
         // Exact match always wins.  Otherwise try to find the closest line > the desired
@@ -363,22 +686,23 @@ LineTable::FindLineEntryIndexByFileIndex (uint32_t start_idx, uint32_t file_idx,
         // FIXME: Maybe want to find the line closest before and the line closest after and
         // if they're not in the same function, don't return a match.
 
-        if (m_entries[idx].line < line)
+        if (entry.line < line)
         {
             continue;
         }
-        else if (m_entries[idx].line == line)
+        else if (entry.line == line)
         {
             if (line_entry_ptr)
-                ConvertEntryAtIndexToLineEntry (idx, *line_entry_ptr);
-            return idx;
+                ConvertEntryAtIndexToLineEntry (pos.GetIndex(), *line_entry_ptr);
+            return pos.GetIndex();
         }
         else if (!exact)
         {
-            if (best_match == UINT32_MAX)
-                best_match = idx;
-            else if (m_entries[idx].line < m_entries[best_match].line)
-                best_match = idx;
+            if (best_match == UINT32_MAX || entry.line < best_match_line)
+            {
+                best_match = pos.GetIndex();
+                best_match_line = entry.line;
+            }
         }
     }
 
@@ -401,20 +725,23 @@ LineTable::FineLineEntriesForFileIndex (uint32_t file_idx,
         sc_list.Clear();
 
     size_t num_added = 0;
-    const size_t count = m_entries.size();
-    if (count > 0)
+    if (GetSize() > 0)
     {
         SymbolContext sc (m_comp_unit);
 
-        for (size_t idx = 0; idx < count; ++idx)
+        EntryIterator pos (*this);
+        while (pos.IsValid())
         {
+            const Entry entry (pos.GetEntry());
+            pos.Next();
+
             // Skip line table rows that terminate the previous row (is_terminal_entry is non-zero)
-            if (m_entries[idx].is_terminal_entry)
+            if (entry.is_terminal_entry)
                 continue;
             
-            if (m_entries[idx].file_idx == file_idx)
+            if (entry.file_idx == file_idx)
             {
-                if (ConvertEntryAtIndexToLineEntry (idx, sc.line_entry))
+                if (ConvertEntryToLineEntry (entry, pos.IsValid() ? &pos.GetEntry() : NULL, sc.line_entry))
                 {
                     ++num_added;
                     sc_list.Append(sc);
@@ -429,12 +756,14 @@ LineTable::FineLineEntriesForFileIndex (uint32_t file_idx,
 void
 LineTable::Dump (Stream *s, Target *target, Address::DumpStyle style, Address::DumpStyle fallback_style, bool show_line_ranges)
 {
-    const size_t count = m_entries.size();
     LineEntry line_entry;
     FileSpec prev_file;
-    for (size_t idx = 0; idx < count; ++idx)
+    EntryIterator pos (*this);
+    while (pos.IsValid())
     {
-        ConvertEntryAtIndexToLineEntry (idx, line_entry);
+        const Entry entry (pos.GetEntry());
+        pos.Next();
+        ConvertEntryToLineEntry (entry, pos.IsValid() ? &pos.GetEntry() : NULL, line_entry);
         line_entry.Dump (s, target, prev_file != line_entry.file, style, fallback_style, show_line_ranges);
         s->EOL();
         prev_file = line_entry.file;
@@ -445,11 +774,13 @@ LineTable::Dump (Stream *s, Target *target, Address::DumpStyle style, Address::D
 void
 LineTable::GetDescription (Stream *s, Target *target, DescriptionLevel level)
 {
-    const size_t count = m_entries.size();
     LineEntry line_entry;
-    for (size_t idx = 0; idx < count; ++idx)
+    EntryIterator pos (*this);
+    while (pos.IsValid())
     {
-        ConvertEntryAtIndexToLineEntry (idx, line_entry);
+        const Entry entry (pos.GetEntry());
+        pos.Next();
+        ConvertEntryToLineEntry (entry, pos.IsValid() ? &pos.GetEntry() : NULL, line_entry);
         line_entry.GetDescription (s, level, m_comp_unit, target, true);
         s->EOL();
     }
@@ -461,9 +792,20 @@ LineTable::GetContiguousFileAddressRanges (FileAddressRanges &file_ranges, bool
     if (!append)
         file_ranges.Clear();
     const size_t initial_count = file_ranges.GetSize();
+
+    if (IsPacked())
+    {
+        // Each sequence is a contiguous range
+        sequence_collection::const_iterator pos, end = m_sequences.end();
+        for (pos = m_sequences.begin(); pos != end; ++pos)
+        {
+            if (pos->num_entries > 1)
+                file_ranges.Append(FileAddressRanges::Entry (pos->base_addr, pos->end_addr - pos->base_addr));
+        }
+        return file_ranges.GetSize() - initial_count;
+    }
     
     const size_t count = m_entries.size();
-    LineEntry line_entry;
     FileAddressRanges::Entry range (LLDB_INVALID_ADDRESS, 0);
     for (size_t idx = 0; idx < count; ++idx)
     {
@@ -491,16 +833,14 @@ LineTable::LinkLineTable (const FileRangeMap &file_range_map)
 {
     std::unique_ptr<LineTable> line_table_ap (new LineTable (m_comp_unit));
     LineSequenceImpl sequence;
-    const size_t count = m_entries.size();
-    LineEntry line_entry;
     const FileRangeMap::Entry *file_range_entry = NULL;
     const FileRangeMap::Entry *prev_file_range_entry = NULL;
     lldb::addr_t prev_file_addr = LLDB_INVALID_ADDRESS;
     bool prev_entry_was_linked = false;
     bool range_changed = false;
-    for (size_t idx = 0; idx < count; ++idx)
+    for (EntryIterator pos (*this); pos.IsValid(); pos.Next())
     {
-        const Entry& entry = m_entries[idx];
+        const Entry& entry = pos.GetEntry();
         
         const bool end_sequence = entry.is_terminal_entry;
         const lldb::addr_t lookup_file_addr = entry.file_addr - (end_sequence ? 1 : 0);
@@ -578,7 +918,7 @@ LineTable::LinkLineTable (const FileRangeMap &file_range_map)
         prev_file_addr = entry.file_addr;
         range_changed = false;
     }
-    if (line_table_ap->m_entries.empty())
+    if (line_table_ap->GetSize() == 0)
         return NULL;
     return line_table_ap.release();
 }
@@ -213,6 +213,25 @@ UnwindPlan::Row::SetRegisterInfo (uint32_t reg_num, const UnwindPlan::Row::Regis
     m_register_locations[reg_num] = register_location;
 }
 
+bool
+UnwindPlan::Row::GetSavedRegisterOffsetRange (int32_t &min_offset, int32_t &max_offset) const
+{
+    bool found = false;
+    collection::const_iterator pos, end = m_register_locations.end();
+    for (pos = m_register_locations.begin(); pos != end; ++pos)
+    {
+        if (!pos->second.IsAtCFAPlusOffset())
+            continue;
+        const int32_t offset = pos->second.GetOffset();
+        if (!found || offset < min_offset)
+            min_offset = offset;
+        if (!found || offset > max_offset)
+            max_offset = offset;
+        found = true;
+    }
+    return found;
+}
+
 bool
 UnwindPlan::Row::SetRegisterLocationToAtCFAPlusOffset (uint32_t reg_num, int32_t offset, bool can_replace)
 {
@@ -203,6 +203,67 @@ MemoryCache::Read (addr_t addr,
     return dst_len - bytes_left;
 }
 
+//----------------------------------------------------------------------
+// Read all cache lines that overlap [addr, addr + size) that aren't
+// already in the cache from the process with a single memory read.
+// Returns the number of bytes that were added to the cache.
+//----------------------------------------------------------------------
+size_t
+MemoryCache::Prefetch (addr_t addr, size_t size, Error &error)
+{
+    if (size == 0)
+        return 0;
+
+    const uint32_t cache_line_byte_size = m_cache_line_byte_size;
+    Mutex::Locker locker (m_mutex);
+
+    // Trim the range so it starts and ends at the first and last cache
+    // lines we don't already have
+    addr_t first_line_addr = addr - (addr % cache_line_byte_size);
+    addr_t end_line_addr = addr + size;
+    if (end_line_addr % cache_line_byte_size)
+        end_line_addr += cache_line_byte_size - (end_line_addr % cache_line_byte_size);
+    if (end_line_addr <= first_line_addr)
+        return 0; // Wrapped around the end of the address space
+
+    while (first_line_addr < end_line_addr && m_cache.find (first_line_addr) != m_cache.end())
+        first_line_addr += cache_line_byte_size;
+    while (end_line_addr > first_line_addr && m_cache.find (end_line_addr - cache_line_byte_size) != m_cache.end())
+        end_line_addr -= cache_line_byte_size;
+    if (first_line_addr >= end_line_addr)
+        return 0;
+
+    // Don't read anything that overlaps a range we know to be unreadable
+    const size_t num_invalid_ranges = m_invalid_ranges.GetSize();
+    for (size_t i = 0; i < num_invalid_ranges; ++i)
+    {
+        const InvalidRanges::Entry &range = m_invalid_ranges.GetEntryRef(i);
+        if (range.GetRangeBase() < end_line_addr && first_line_addr < range.GetRangeEnd())
+            return 0;
+    }
+
+    const size_t read_size = end_line_addr - first_line_addr;
+    DataBufferHeap data (read_size, 0);
+    const size_t bytes_read = m_process.ReadMemoryFromInferior (first_line_addr,
+                                                                data.GetBytes(),
+                                                                data.GetByteSize(),
+                                                                error);
+    // Only cache the lines we got all of. A short read may just mean the
+    // process gave up part way through a large request, and a partial line
+    // in the cache would cut every later read of that line short.
+    size_t bytes_cached = 0;
+    for (size_t offset = 0; offset + cache_line_byte_size <= bytes_read; offset += cache_line_byte_size)
+    {
+        const addr_t line_addr = first_line_addr + offset;
+        // Leave any lines we already have alone, they might have been
+        // filled in from a read that was done in between
+        if (m_cache.find (line_addr) != m_cache.end())
+            continue;
+        m_cache[line_addr] = DataBufferSP (new DataBufferHeap (data.GetBytes() + offset, cache_line_byte_size));
+        bytes_cached += cache_line_byte_size;
+    }
+    return bytes_cached;
+}
 
 
 AllocatedBlock::AllocatedBlock (lldb::addr_t addr, 
@@ -11,6 +11,8 @@
 
 #include "lldb/Target/Process.h"
 
+#include <algorithm>
+
 #include "lldb/lldb-private-log.h"
 
 #include "lldb/Breakpoint/StoppointCallbackContext.h"
@@ -102,6 +104,7 @@ g_properties[] =
     { "python-os-plugin-path", OptionValue::eTypeFileSpec, false, true, NULL, NULL, "A path to a python OS plug-in module file that contains a OperatingSystemPlugIn class." },
     { "stop-on-sharedlibrary-events" , OptionValue::eTypeBoolean, true, false, NULL, NULL, "If true, stop when a shared library is loaded or unloaded." },
     { "detach-keeps-stopped" , OptionValue::eTypeBoolean, true, false, NULL, NULL, "If true, detach will attempt to keep the process stopped." },
+    { "stack-prefetch-size"  , OptionValue::eTypeUInt64 , false, 4096, NULL, NULL, "The minimum number of bytes of stack memory to read from the process at once when unwinding.  A value of zero disables stack prefetching." },
     {  NULL                  , OptionValue::eTypeInvalid, false, 0, NULL, NULL, NULL  }
 };
 
@@ -112,7 +115,8 @@ enum {
     ePropertyUnwindOnErrorInExpressions,
     ePropertyPythonOSPluginPath,
     ePropertyStopOnSharedLibraryEvents,
-    ePropertyDetachKeepsStopped
+    ePropertyDetachKeepsStopped,
+    ePropertyStackPrefetchSize
 };
 
 ProcessProperties::ProcessProperties (bool is_global) :
@@ -215,6 +219,13 @@ ProcessProperties::SetStopOnSharedLibraryEvents (bool stop)
     m_collection_sp->SetPropertyAtIndexAsBoolean(NULL, idx, stop);
 }
 
+uint64_t
+ProcessProperties::GetStackPrefetchSize () const
+{
+    const uint32_t idx = ePropertyStackPrefetchSize;
+    return m_collection_sp->GetPropertyAtIndexAsUInt64(NULL, idx, g_properties[idx].default_uint_value);
+}
+
 bool
 ProcessProperties::GetDetachKeepsStopped () const
 {
@@ -2373,6 +2384,69 @@ Process::ReadMemory (addr_t addr, void *buf, size_t size, Error &error)
     }
 }
     
+size_t
+Process::PrefetchMemory (addr_t addr, size_t size, Error &error)
+{
+    // Without a memory cache there is nowhere to keep the bytes
+    if (GetDisableMemoryCache())
+        return 0;
+    return m_memory_cache.Prefetch (addr, size, error);
+}
+
+size_t
+Process::PrefetchStringsFromMemory (const std::vector<addr_t> &addrs, size_t max_bytes)
+{
+    if (GetDisableMemoryCache() || addrs.empty() || max_bytes == 0)
+        return 0;
+
+    // Two lines that are this close are read together, the extra bytes
+    // are cheaper than another round trip to the process
+    const addr_t cache_line_size = m_memory_cache.GetMemoryCacheLineSize();
+    const addr_t max_gap = 4 * cache_line_size;
+    const addr_t max_read_size = 64 * cache_line_size;
+
+    // Only the first line's worth of each string is fetched, most strings
+    // that end up in summaries are shorter than that and the longer ones
+    // just read the rest on their own. That start can still straddle two
+    // lines.
+    const addr_t prefetch_size = std::min<addr_t> (max_bytes, cache_line_size);
+
+    std::vector<addr_t> line_addrs;
+    line_addrs.reserve (addrs.size());
+    for (std::vector<addr_t>::const_iterator pos = addrs.begin(), end = addrs.end(); pos != end; ++pos)
+    {
+        if (*pos == 0 || *pos == LLDB_INVALID_ADDRESS)
+            continue;
+        const addr_t first_line = *pos - (*pos % cache_line_size);
+        const addr_t last_byte = *pos + prefetch_size - 1;
+        line_addrs.push_back (first_line);
+        if (last_byte - (last_byte % cache_line_size) != first_line)
+            line_addrs.push_back (first_line + cache_line_size);
+    }
+    std::sort (line_addrs.begin(), line_addrs.end());
+    line_addrs.erase (std::unique (line_addrs.begin(), line_addrs.end()), line_addrs.end());
+
+    size_t bytes_cached = 0;
+    size_t idx = 0;
+    while (idx < line_addrs.size())
+    {
+        const addr_t range_base = line_addrs[idx];
+        addr_t range_end = range_base + cache_line_size;
+        for (++idx; idx < line_addrs.size(); ++idx)
+        {
+            const addr_t line_end = line_addrs[idx] + cache_line_size;
+            if (line_addrs[idx] - range_end > max_gap || line_end - range_base > max_read_size)
+                break;
+            range_end = line_end;
+        }
+        // If the merged range runs into unreadable memory nothing gets
+        // cached and each string falls back to reading its own lines
+        Error error;
+        bytes_cached += m_memory_cache.Prefetch (range_base, range_end - range_base, error);
+    }
+    return bytes_cached;
+}
+
 size_t
 Process::ReadCStringFromMemory (addr_t addr, std::string &out_str, Error &error)
 {
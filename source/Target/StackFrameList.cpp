@@ -108,6 +108,8 @@ StackFrameList::ResetCurrentInlinedDepth ()
     if (m_show_inlined_frames)
     {        
         GetFramesUpTo(0);
+        if (m_frames.empty())
+            return;
         if (!m_frames[0]->IsInlined())
         {
             m_current_inlined_depth = UINT32_MAX;
@@ -257,6 +259,11 @@ StackFrameList::GetFramesUpTo(uint32_t end_idx)
     if (m_thread.IsValid() == false)
         return;
 
+    // A thread that keeps running while others are stopped (non-stop mode)
+    // has no register context and so no frames yet
+    if (!m_thread.GetRegisterContext())
+        return;
+
     // We've already gotten more frames than asked for, or we've already finished unwinding, return.
     if (m_frames.size() > end_idx || GetAllFramesFetched())
         return;
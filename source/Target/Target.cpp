@@ -80,6 +80,7 @@ Target::Target(Debugger &debugger, const ArchSpec &target_arch, const lldb::Plat
     m_scratch_ast_source_ap (),
     m_ast_importer_ap (),
     m_persistent_variables (),
+    m_user_expression_cache_ap (),
     m_source_manager_ap(),
     m_stop_hooks (),
     m_stop_hook_next_id (0),
@@ -158,6 +159,7 @@ Target::DeleteCurrentProcess ()
 {
     if (m_process_sp.get())
     {
+        ClearUserExpressionCache ();
         m_section_load_list.Clear();
         if (m_process_sp->IsAlive())
             m_process_sp->Destroy();
@@ -205,6 +207,7 @@ Target::Destroy()
     m_scratch_ast_source_ap.reset();
     m_ast_importer_ap.reset();
     m_persistent_variables.Clear();
+    m_user_expression_cache_ap.reset();
     m_stop_hooks.clear();
     m_stop_hook_next_id = 0;
     m_suppress_stop_hooks = false;
@@ -1128,6 +1131,7 @@ void
 Target::ModuleUpdated (const ModuleList& module_list, const ModuleSP &old_module_sp, const ModuleSP &new_module_sp)
 {
     // A module is replacing an already added module
+    ClearUserExpressionCache ();
     m_breakpoint_list.UpdateBreakpointsWhenModuleIsReplaced(old_module_sp, new_module_sp);
 }
 
@@ -1136,6 +1140,7 @@ Target::ModulesDidLoad (ModuleList &module_list)
 {
     if (module_list.GetSize())
     {
+        ClearUserExpressionCache ();
         m_breakpoint_list.UpdateBreakpoints (module_list, true);
         // TODO: make event data that packages up the module_list
         BroadcastEvent (eBroadcastBitModulesLoaded, NULL);
@@ -1147,6 +1152,7 @@ Target::SymbolsDidLoad (ModuleList &module_list)
 {
     if (module_list.GetSize())
     {
+        ClearUserExpressionCache ();
         if (m_process_sp)
         {
             LanguageRuntime* runtime = m_process_sp->GetLanguageRuntime(lldb::eLanguageTypeObjC);
@@ -1167,12 +1173,28 @@ Target::ModulesDidUnload (ModuleList &module_list)
 {
     if (module_list.GetSize())
     {
+        ClearUserExpressionCache ();
         m_breakpoint_list.UpdateBreakpoints (module_list, false);
         // TODO: make event data that packages up the module_list
         BroadcastEvent (eBroadcastBitModulesUnloaded, NULL);
     }
 }
 
+ClangUserExpressionCache &
+Target::GetUserExpressionCache ()
+{
+    if (m_user_expression_cache_ap.get() == NULL)
+        m_user_expression_cache_ap.reset (new ClangUserExpressionCache());
+    return *m_user_expression_cache_ap;
+}
+
+void
+Target::ClearUserExpressionCache ()
+{
+    if (m_user_expression_cache_ap.get())
+        m_user_expression_cache_ap->Clear();
+}
+
 bool
 Target::ModuleIsExcludedForNonModuleSpecificSearches (const FileSpec &module_file_spec)
 {
@@ -2320,6 +2342,8 @@ g_properties[] =
     { "x86-disassembly-flavor"             , OptionValue::eTypeEnum      , false, eX86DisFlavorDefault,       NULL, g_x86_dis_flavor_value_types, "The default disassembly flavor to use for x86 or x86-64 targets." },
     { "use-fast-stepping"                  , OptionValue::eTypeBoolean   , false, true,                       NULL, NULL, "Use a fast stepping algorithm based on running from branch to branch rather than instruction single-stepping." },
     { "load-script-from-symbol-file"       , OptionValue::eTypeEnum   ,    false, eLoadScriptFromSymFileWarn, NULL, g_load_script_from_sym_file_values, "Allow LLDB to load scripting resources embedded in symbol files when available." },
+    { "incremental-value-updates"          , OptionValue::eTypeBoolean   , false, false,                      NULL, NULL, "Keep the summaries and synthetic children of values whose bytes did not change since the last stop instead of computing them again. "
+        "Formatters that look at memory outside the value itself (e.g. through pointers) can show stale results when this is enabled." },
     { NULL                                 , OptionValue::eTypeInvalid   , false, 0                         , NULL, NULL, NULL }
 };
 enum
@@ -2348,6 +2372,7 @@ enum
     ePropertyDisassemblyFlavor,
     ePropertyUseFastStepping,
     ePropertyLoadScriptFromSymbolFile,
+    ePropertyIncrementalValueUpdates
 };
 
 
@@ -2714,6 +2739,13 @@ TargetProperties::GetLoadScriptFromSymbolFile () const
     return (LoadScriptFromSymFile)m_collection_sp->GetPropertyAtIndexAsEnumeration(NULL, idx, g_properties[idx].default_uint_value);
 }
 
+bool
+TargetProperties::GetIncrementalValueUpdates () const
+{
+    const uint32_t idx = ePropertyIncrementalValueUpdates;
+    return m_collection_sp->GetPropertyAtIndexAsBoolean (NULL, idx, g_properties[idx].default_uint_value != 0);
+}
+
 const TargetPropertiesSP &
 Target::GetGlobalProperties()
 {
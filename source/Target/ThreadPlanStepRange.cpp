@@ -11,6 +11,8 @@
 
 // C Includes
 // C++ Includes
+#include <map>
+
 // Other libraries and framework includes
 // Project includes
 
@@ -18,7 +20,9 @@
 #include "lldb/Breakpoint/BreakpointLocation.h"
 #include "lldb/Breakpoint/BreakpointSite.h"
 #include "lldb/Core/Disassembler.h"
+#include "lldb/Core/EmulateInstruction.h"
 #include "lldb/Core/Log.h"
+#include "lldb/Core/RegisterValue.h"
 #include "lldb/Core/Stream.h"
 #include "lldb/Symbol/Function.h"
 #include "lldb/Symbol/Symbol.h"
@@ -52,7 +56,8 @@ ThreadPlanStepRange::ThreadPlanStepRange (ThreadPlanKind kind,
     m_stack_id (),
     m_no_more_plans (false),
     m_first_run_event (true),
-    m_use_fast_step(false)
+    m_use_fast_step(false),
+    m_has_delayed_branches(eLazyBoolCalculate)
 {
     m_use_fast_step = GetTarget().GetUseFastStepping();
     AddRange(range);
@@ -344,10 +349,23 @@ ThreadPlanStepRange::SetNextBranchBreakpoint ()
             branch_index = instructions->GetSize() - 1;
         }
         
+        lldb::addr_t branch_target = LLDB_INVALID_ADDRESS;
         if (branch_index - pc_index > 1)
         {
-            const bool is_internal = true;
             run_to_address = instructions->GetInstructionAtIndex(branch_index)->GetAddress();
+        }
+        else if (branch_index == pc_index
+                 && instructions->GetInstructionAtIndex(pc_index)->DoesBranch()
+                 && GetBranchTargetByEmulation (branch_target))
+        {
+            // We are sitting on a delayed branch, run straight to where it goes instead of
+            // single stepping through its delay slots.
+            run_to_address.SetLoadAddress (branch_target, &GetTarget());
+        }
+
+        if (run_to_address.IsValid())
+        {
+            const bool is_internal = true;
             m_next_branch_bp_sp = GetTarget().CreateBreakpoint(run_to_address, is_internal);
             if (m_next_branch_bp_sp)
             {
@@ -379,6 +397,139 @@ ThreadPlanStepRange::SetNextBranchBreakpoint ()
     return false;
 }
 
+namespace {
+
+// Register writes made while emulating the next branch are kept here instead of
+// going to the thread, memory writes are dropped.
+struct BranchEmulationState
+{
+    RegisterContext *reg_ctx;
+    Process *process;
+    std::map<uint32_t, uint64_t> registers;     // Keyed by lldb register number
+};
+
+}
+
+static uint32_t
+GetEmulatedRegisterNumber (RegisterContext *reg_ctx, const RegisterInfo *reg_info)
+{
+    uint32_t reg_num = EmulateInstruction::GetInternalRegisterNumber (reg_ctx, *reg_info);
+    if (reg_num == LLDB_INVALID_REGNUM)
+    {
+        // The stub's register numbering may not match the emulator's, fall back to the names
+        const RegisterInfo *ctx_reg_info = reg_ctx->GetRegisterInfoByName (reg_info->name);
+        if (ctx_reg_info == NULL && reg_info->alt_name)
+            ctx_reg_info = reg_ctx->GetRegisterInfoByName (reg_info->alt_name);
+        if (ctx_reg_info)
+            reg_num = ctx_reg_info->kinds[eRegisterKindLLDB];
+    }
+    return reg_num;
+}
+
+static size_t
+BranchEmulationReadMemory (EmulateInstruction *instruction,
+                           void *baton,
+                           const EmulateInstruction::Context &context,
+                           lldb::addr_t addr,
+                           void *dst,
+                           size_t length)
+{
+    BranchEmulationState *state = (BranchEmulationState *)baton;
+    Error error;
+    return state->process->ReadMemory (addr, dst, length, error);
+}
+
+static size_t
+BranchEmulationWriteMemory (EmulateInstruction *instruction,
+                            void *baton,
+                            const EmulateInstruction::Context &context,
+                            lldb::addr_t addr,
+                            const void *dst,
+                            size_t length)
+{
+    return length;
+}
+
+static bool
+BranchEmulationReadRegister (EmulateInstruction *instruction,
+                             void *baton,
+                             const RegisterInfo *reg_info,
+                             RegisterValue &reg_value)
+{
+    BranchEmulationState *state = (BranchEmulationState *)baton;
+    const uint32_t reg_num = GetEmulatedRegisterNumber (state->reg_ctx, reg_info);
+    if (reg_num == LLDB_INVALID_REGNUM)
+        return false;
+
+    std::map<uint32_t, uint64_t>::const_iterator pos = state->registers.find (reg_num);
+    if (pos != state->registers.end())
+        return reg_value.SetUInt (pos->second, reg_info->byte_size);
+
+    const RegisterInfo *ctx_reg_info = state->reg_ctx->GetRegisterInfoAtIndex (reg_num);
+    return ctx_reg_info && state->reg_ctx->ReadRegister (ctx_reg_info, reg_value);
+}
+
+static bool
+BranchEmulationWriteRegister (EmulateInstruction *instruction,
+                              void *baton,
+                              const EmulateInstruction::Context &context,
+                              const RegisterInfo *reg_info,
+                              const RegisterValue &reg_value)
+{
+    BranchEmulationState *state = (BranchEmulationState *)baton;
+    const uint32_t reg_num = GetEmulatedRegisterNumber (state->reg_ctx, reg_info);
+    if (reg_num == LLDB_INVALID_REGNUM)
+        return false;
+
+    bool success = false;
+    const uint64_t value = reg_value.GetAsUInt64 (0, &success);
+    if (success)
+        state->registers[reg_num] = value;
+    return success;
+}
+
+bool
+ThreadPlanStepRange::GetBranchTargetByEmulation (lldb::addr_t &branch_target)
+{
+    if (m_has_delayed_branches == eLazyBoolNo)
+        return false;
+
+    Target &target = GetTarget();
+    std::unique_ptr<EmulateInstruction> emulator_ap (EmulateInstruction::FindPlugin (target.GetArchitecture(),
+                                                                                      eInstructionTypePCModifying,
+                                                                                      NULL));
+    // Branches that take effect right away, like on ARM, are stepped over just as well
+    // by a single step, don't emulate them
+    if (!emulator_ap.get() || emulator_ap->GetMaxBranchDelaySlots() == 0)
+    {
+        m_has_delayed_branches = eLazyBoolNo;
+        return false;
+    }
+    m_has_delayed_branches = eLazyBoolYes;
+
+    BranchEmulationState state;
+    state.reg_ctx = m_thread.GetRegisterContext().get();
+    state.process = m_thread.GetProcess().get();
+    if (state.reg_ctx == NULL || state.process == NULL)
+        return false;
+
+    emulator_ap->SetBaton (&state);
+    emulator_ap->SetCallbacks (BranchEmulationReadMemory,
+                               BranchEmulationWriteMemory,
+                               BranchEmulationReadRegister,
+                               BranchEmulationWriteRegister);
+
+    if (!emulator_ap->EvaluateDelayedBranch (branch_target))
+        return false;
+
+    Log *log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_STEP));
+    if (log)
+        log->Printf ("ThreadPlanStepRange::GetBranchTargetByEmulation - branch at 0x%" PRIx64 " goes to 0x%" PRIx64 " after its delay slots",
+                     state.reg_ctx->GetPC(),
+                     branch_target);
+    return true;
+}
+
 bool
 ThreadPlanStepRange::NextRangeBreakpointExplainsStop (lldb::StopInfoSP stop_info_sp)
 {
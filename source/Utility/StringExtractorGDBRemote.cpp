@@ -46,6 +46,9 @@ StringExtractorGDBRemote::GetResponseType () const
         if (m_packet.size() == 1)
             return eNack;
         break;
+
+    case '%':
+        return eNotification;
     }
     return eResponse;
 }
@@ -161,6 +164,12 @@ StringExtractorGDBRemote::IsNormalResponse() const
     return GetResponseType () == eResponse;
 }
 
+bool
+StringExtractorGDBRemote::IsNotification() const
+{
+    return GetResponseType () == eNotification;
+}
+
 bool
 StringExtractorGDBRemote::IsErrorResponse() const
 {
@@ -76,7 +76,8 @@ public:
         eNack,
         eError,
         eOK,
-        eResponse
+        eResponse,
+        eNotification   // A "%name:data" notification, sent unrequested in non-stop mode
     };
 
     ResponseType
@@ -94,6 +95,9 @@ public:
     bool
     IsErrorResponse() const;
 
+    bool
+    IsNotification() const;
+
     // Returns zero if the packet isn't a EXX packet where XX are two hex
     // digits. Otherwise the error encoded in XX is returned.
     uint8_t
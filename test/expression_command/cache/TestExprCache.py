@@ -0,0 +1,109 @@
+"""
+Test that user expressions evaluated again in the same scope reuse the parsed
+and JIT'ed code, and that loading or unloading a module parses them anew.
+"""
+
+import os
+import unittest2
+import lldb
+import lldbutil
+from lldbtest import *
+
+class ExprCacheTestCase(TestBase):
+
+    mydir = os.path.join("expression_command", "cache")
+
+    def setUp(self):
+        # Call super's setUp().
+        TestBase.setUp(self)
+        # Find the line number to break for main.c.
+        self.line = line_number('main.c', '// Set break point at this line.')
+        self.log_file = os.path.join(os.getcwd(), "expr-cache.log")
+
+    @unittest2.skipUnless(sys.platform.startswith("darwin"), "requires Darwin")
+    @dsym_test
+    def test_with_dsym(self):
+        """Test that repeated expressions are reused until modules change."""
+        self.buildDsym()
+        self.expression_cache()
+
+    @dwarf_test
+    def test_with_dwarf(self):
+        """Test that repeated expressions are reused until modules change."""
+        self.buildDwarf()
+        self.expression_cache()
+
+    def evaluate(self, frame, expr, expected_value, expect_reuse):
+        """Evaluate 'expr' and check its value and whether the cached expression was used."""
+        if os.path.exists(self.log_file):
+            os.remove(self.log_file)
+        self.runCmd("log enable -f %s lldb expr" % self.log_file)
+        value = frame.EvaluateExpression(expr)
+        self.runCmd("log disable lldb expr")
+
+        self.assertTrue(value.IsValid() and value.GetError().Success(), "'%s' evaluated" % expr)
+        self.assertTrue(value.GetValueAsSigned() == expected_value,
+                        "'%s' == %d" % (expr, expected_value))
+
+        with open(self.log_file, "r") as f:
+            log = f.read()
+        if expect_reuse:
+            self.assertTrue("Reusing parsed expression" in log and not "Parsing expression" in log,
+                            "'%s' reused the parsed expression" % expr)
+        else:
+            self.assertTrue("Parsing expression" in log and not "Reusing parsed expression" in log,
+                            "'%s' was parsed again" % expr)
+
+    def expression_cache(self):
+        exe = os.path.join(os.getcwd(), "a.out")
+        target = self.dbg.CreateTarget(exe)
+        self.assertTrue(target, VALID_TARGET)
+
+        breakpoint = target.BreakpointCreateByLocation("main.c", self.line)
+        self.assertTrue(breakpoint, VALID_BREAKPOINT)
+
+        process = target.LaunchSimple(None, None, os.getcwd())
+        self.assertTrue(process, PROCESS_IS_VALID)
+
+        def cleanup():
+            self.runCmd("log disable lldb expr", check=False)
+            if os.path.exists(self.log_file):
+                os.remove(self.log_file)
+        self.addTearDownHook(cleanup)
+
+        threads = lldbutil.get_threads_stopped_at_breakpoint(process, breakpoint)
+        self.assertTrue(len(threads) == 1)
+        frame = threads[0].GetFrameAtIndex(0)
+
+        # The first evaluation parses, the next one in the same scope doesn't
+        self.evaluate(frame, "counter + 10", 10, False)
+        self.evaluate(frame, "counter + 10", 10, True)
+
+        # Expressions using persistent variables are never reused
+        self.runCmd("expression int $cache_test = 5")
+        self.evaluate(frame, "$cache_test + counter", 5, False)
+        self.evaluate(frame, "$cache_test + counter", 5, False)
+
+        # The reused expression reads the variables of the new stop
+        process.Continue()
+        threads = lldbutil.get_threads_stopped_at_breakpoint(process, breakpoint)
+        self.assertTrue(len(threads) == 1)
+        frame = threads[0].GetFrameAtIndex(0)
+        self.evaluate(frame, "counter + 10", 11, True)
+
+        # Adding a module may change what the expression refers to
+        module = target.AddModule(os.path.join(os.getcwd(), "main.o"), None, None)
+        self.assertTrue(module.IsValid(), "Added main.o as a module")
+        self.evaluate(frame, "counter + 10", 11, False)
+        self.evaluate(frame, "counter + 10", 11, True)
+
+        # And so does removing one
+        self.assertTrue(target.RemoveModule(module), "Removed main.o")
+        self.evaluate(frame, "counter + 10", 11, False)
+
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
@@ -0,0 +1,9 @@
+#include <stdio.h>
+
+int main (int argc, char const *argv[])
+{
+    int counter;
+    for (counter = 0; counter < 5; ++counter)
+        printf ("counter = %d\n", counter); // Set break point at this line.
+    return 0;
+}
@@ -0,0 +1,136 @@
+"""
+Test expressions that the IR interpreter evaluates, both without a process
+and for an expression that is interpreted again in the same scope.
+"""
+
+import os
+import unittest2
+import lldb
+import lldbutil
+from lldbtest import *
+
+class ExprInterpreterTestCase(TestBase):
+
+    mydir = os.path.join("expression_command", "interpreter")
+
+    def setUp(self):
+        # Call super's setUp().
+        TestBase.setUp(self)
+        # Find the line number to break for main.c.
+        self.line = line_number('main.c', '// Set break point at this line.')
+        self.log_file = os.path.join(os.getcwd(), "expr-interpreter.log")
+
+    @unittest2.skipUnless(sys.platform.startswith("darwin"), "requires Darwin")
+    @dsym_test
+    def test_without_process_with_dsym(self):
+        """Test casts and over-aligned locals interpreted without a process."""
+        self.buildDsym()
+        self.interpret_without_process()
+
+    @dwarf_test
+    def test_without_process_with_dwarf(self):
+        """Test casts and over-aligned locals interpreted without a process."""
+        self.buildDwarf()
+        self.interpret_without_process()
+
+    @unittest2.skipUnless(sys.platform.startswith("darwin"), "requires Darwin")
+    @dsym_test
+    def test_reuse_with_dsym(self):
+        """Test that an expression interpreted twice is only decoded once."""
+        self.buildDsym()
+        self.interpret_twice()
+
+    @dwarf_test
+    def test_reuse_with_dwarf(self):
+        """Test that an expression interpreted twice is only decoded once."""
+        self.buildDwarf()
+        self.interpret_twice()
+
+    def evaluate(self, scope, expr, expected_value):
+        """Evaluate 'expr' in 'scope' (a target or a frame) and return the expression log."""
+        if os.path.exists(self.log_file):
+            os.remove(self.log_file)
+        self.runCmd("log enable -f %s lldb expr" % self.log_file)
+        value = scope.EvaluateExpression(expr, lldb.SBExpressionOptions())
+        self.runCmd("log disable lldb expr")
+
+        self.assertTrue(value.IsValid() and value.GetError().Success(), "'%s' evaluated" % expr)
+        self.assertTrue(value.GetValueAsSigned() == expected_value,
+                        "'%s' == %d, got %d" % (expr, expected_value, value.GetValueAsSigned()))
+
+        with open(self.log_file, "r") as f:
+            log = f.read()
+        # Only the interpreter is available without a process
+        self.assertTrue("IRInterpreter::Interpret" in log, "'%s' was interpreted" % expr)
+        return log
+
+    def interpret_without_process(self):
+        exe = os.path.join(os.getcwd(), "a.out")
+        target = self.dbg.CreateTarget(exe)
+        self.assertTrue(target, VALID_TARGET)
+        self.assertFalse(target.GetProcess().IsValid(), "No process")
+
+        def cleanup():
+            self.runCmd("log disable lldb expr", check=False)
+            if os.path.exists(self.log_file):
+                os.remove(self.log_file)
+        self.addTearDownHook(cleanup)
+
+        # Constant casts, and the same casts on locals so they are actually
+        # sign extended at run time instead of folded by the compiler
+        self.evaluate(target, "(long long)(signed char)-1", -1)
+        self.evaluate(target, "(int)(short)-2", -2)
+        self.evaluate(target, "signed char c = -1; (long long)c", -1)
+        self.evaluate(target, "short s = -2; (int)s", -2)
+        self.evaluate(target, "signed char c = -128; (short)c", -128)
+        self.evaluate(target, "unsigned char u = 255; (long long)u", 255)
+
+        # The alignment of an alloca used to be truncated to a byte
+        self.evaluate(target, "struct Aligned a; a.c = 7; (int)a.c", 7)
+        self.evaluate(target, "struct Aligned a; (int)(((unsigned long long)&a) % 256)", 0)
+        self.evaluate(target, "struct Aligned a[2]; a[1].c = 3; (int)(((char *)&a[1].c) - ((char *)&a[0].c))", 256)
+
+    def interpret_twice(self):
+        exe = os.path.join(os.getcwd(), "a.out")
+        target = self.dbg.CreateTarget(exe)
+        self.assertTrue(target, VALID_TARGET)
+
+        breakpoint = target.BreakpointCreateByLocation("main.c", self.line)
+        self.assertTrue(breakpoint, VALID_BREAKPOINT)
+
+        process = target.LaunchSimple(None, None, os.getcwd())
+        self.assertTrue(process, PROCESS_IS_VALID)
+
+        def cleanup():
+            self.runCmd("log disable lldb expr", check=False)
+            if os.path.exists(self.log_file):
+                os.remove(self.log_file)
+        self.addTearDownHook(cleanup)
+
+        threads = lldbutil.get_threads_stopped_at_breakpoint(process, breakpoint)
+        self.assertTrue(len(threads) == 1)
+        frame = threads[0].GetFrameAtIndex(0)
+
+        # Simple enough to be interpreted even with a process around. The
+        # second evaluation reuses the expression and its decoded IR.
+        expr = "(long long)minus_one + (int)minus_two"
+        log = self.evaluate(frame, expr, -3)
+        self.assertTrue("Parsing expression" in log and "Decoded" in log,
+                        "The first evaluation parses and decodes")
+
+        log = self.evaluate(frame, expr, -3)
+        self.assertTrue("Reusing parsed expression" in log and not "Decoded" in log,
+                        "The second evaluation neither parses nor decodes")
+
+        # A run starts from the decoded constants, not from the values the
+        # last run left behind
+        self.runCmd("expression minus_one = -5")
+        log = self.evaluate(frame, expr, -7)
+        self.assertTrue(not "Decoded" in log, "The third evaluation doesn't decode either")
+
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
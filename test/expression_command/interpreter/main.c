@@ -0,0 +1,17 @@
+#include <stdio.h>
+
+// An alignment that doesn't fit in a byte
+struct Aligned
+{
+    char c;
+} __attribute__((aligned(256)));
+
+struct Aligned g_aligned = { 9 };
+
+int main (int argc, char const *argv[])
+{
+    signed char minus_one = -1;
+    short minus_two = -2;
+    printf ("%d %d %d\n", minus_one, minus_two, g_aligned.c); // Set break point at this line.
+    return 0;
+}
@@ -0,0 +1,136 @@
+"""
+Test that source regex breakpoints over several files find the same lines
+whether or not the search is narrowed down by a literal the expression
+requires, and that they see a source file that changed on disk.
+"""
+
+import os, re
+import unittest2
+import lldb
+from lldbtest import *
+import lldbutil
+
+class SourceRegexBreakpointsTestCase(TestBase):
+
+    mydir = os.path.join("functionalities", "breakpoint", "source_regexp")
+
+    source_files = ["main.c", "foo.c", "bar.c"]
+
+    @unittest2.skipUnless(sys.platform.startswith("darwin"), "requires Darwin")
+    @dsym_test
+    def test_with_dsym(self):
+        """Test source regex breakpoints over several files."""
+        self.buildDsym()
+        self.source_regex_breakpoints()
+
+    @dwarf_test
+    def test_with_dwarf(self):
+        """Test source regex breakpoints over several files."""
+        self.buildDwarf()
+        self.source_regex_breakpoints()
+
+    @unittest2.skipUnless(sys.platform.startswith("darwin"), "requires Darwin")
+    @dsym_test
+    def test_edited_file_with_dsym(self):
+        """Test that a source regex search sees a file edited since the last search."""
+        self.buildDsym()
+        self.edited_source_file()
+
+    @dwarf_test
+    def test_edited_file_with_dwarf(self):
+        """Test that a source regex search sees a file edited since the last search."""
+        self.buildDwarf()
+        self.edited_source_file()
+
+    def create_target(self):
+        exe = os.path.join(os.getcwd(), "a.out")
+        self.runCmd("file " + exe, CURRENT_EXECUTABLE_SET)
+        return self.dbg.GetSelectedTarget()
+
+    def breakpoint_lines(self, target, pattern):
+        """Set a source regex breakpoint on all the source files and return the set of (file, line) of its locations."""
+        files = " ".join(["-f " + name for name in self.source_files])
+        self.runCmd("breakpoint set -p '%s' %s" % (pattern, files))
+        bkpt = target.GetBreakpointAtIndex(target.GetNumBreakpoints() - 1)
+        self.assertTrue(bkpt.IsValid(), "Breakpoint for '%s' is valid" % pattern)
+
+        lines = set()
+        for i in range(bkpt.GetNumLocations()):
+            line_entry = bkpt.GetLocationAtIndex(i).GetAddress().GetLineEntry()
+            lines.add((line_entry.GetFileSpec().GetFilename(), line_entry.GetLine()))
+        target.BreakpointDelete(bkpt.GetID())
+        if self.TraceOn():
+            print "%s: %s" % (pattern, sorted(lines))
+        return lines
+
+    def statement_lines(self, pattern):
+        """Return the set of (file, line) of the statements whose text matches pattern."""
+        regex = re.compile(pattern)
+        lines = set()
+        for name in self.source_files:
+            with open(name) as f:
+                for line_no, text in enumerate(f, 1):
+                    if text.rstrip().endswith(";") or "; //" in text:
+                        if regex.search(text):
+                            lines.add((name, line_no))
+        return lines
+
+    def check_pattern(self, target, pattern):
+        # Inside a group nothing is a required literal, so the parenthesized
+        # expression matches the same lines but searches every line.
+        filtered = self.breakpoint_lines(target, pattern)
+        unfiltered = self.breakpoint_lines(target, "(%s)" % pattern)
+        self.assertTrue(filtered == unfiltered,
+                        "'%s' found %s, every line finds %s" % (pattern, sorted(filtered), sorted(unfiltered)))
+
+        expected = self.statement_lines(pattern)
+        self.assertTrue(len(expected) > 0, "'%s' matches some statement" % pattern)
+        self.assertTrue(expected.issubset(filtered),
+                        "'%s' found all of %s" % (pattern, sorted(expected)))
+
+    def source_regex_breakpoints(self):
+        """Test source regex breakpoints over several files."""
+        target = self.create_target()
+
+        # Optional atoms, bounded repetition, a bracket expression starting
+        # with ']', an escaped character and alternatives inside and outside
+        # of a group.
+        for pattern in ["ab*c", "x{0,2}y", "[]a]bc", "\\.foo", "(a|b)c", "a|b"]:
+            self.check_pattern(target, pattern)
+
+    def edited_source_file(self):
+        """Test that a source regex search sees a file edited since the last search."""
+        target = self.create_target()
+
+        foo_c = os.path.join(os.getcwd(), "foo.c")
+        with open(foo_c) as f:
+            original = f.read()
+        original_stat = os.stat(foo_c)
+
+        def cleanup():
+            with open(foo_c, "w") as f:
+                f.write(original)
+            os.utime(foo_c, (original_stat.st_atime, original_stat.st_mtime))
+        self.addTearDownHook(cleanup)
+
+        edit_line = line_number("foo.c", "// Edited by the test.")
+        self.assertTrue(len(self.breakpoint_lines(target, "qq_edit")) == 0,
+                        "Nothing matches before the edit")
+
+        # Same number of lines, so the line table still fits. Move the time
+        # stamp on so the change isn't lost in the time stamp resolution.
+        with open(foo_c, "w") as f:
+            f.write(original.replace("// Edited by the test.", "// Edited by the test. qq_edit"))
+        os.utime(foo_c, (original_stat.st_atime, original_stat.st_mtime + 2))
+
+        self.assertTrue(self.breakpoint_lines(target, "qq_edit") == set([("foo.c", edit_line)]),
+                        "The edited line matches")
+        self.assertTrue(self.breakpoint_lines(target, "(qq_edit)") == set([("foo.c", edit_line)]),
+                        "The edited line matches without the literal search")
+
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
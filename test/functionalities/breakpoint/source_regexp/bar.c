@@ -0,0 +1,8 @@
+int bar (int input)
+{
+    int result = input;
+    result *= 2; // abcabc
+    result *= 3; // y
+    result *= 4; // _foo
+    return result; // ]]bc
+}
@@ -0,0 +1,9 @@
+int foo (int input)
+{
+    int result = input;
+    result += 1; // xxxy
+    result += 2; // .foo
+    result += 3; // ebc
+    result += 4; // zz
+    return result; // Edited by the test.
+}
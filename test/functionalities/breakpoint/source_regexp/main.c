@@ -0,0 +1,17 @@
+#include <stdio.h>
+
+int foo (int input);
+int bar (int input);
+
+int main (int argc, char const *argv[])
+{
+    int value = argc;
+    value += 1; // abbbc
+    value += 2; // ac
+    value += 3; // xxy
+    value += 4; // ]bc
+    value += foo (value); // x.foo
+    value += bar (value); // bc
+    printf ("%d\n", value);
+    return 0;
+}
@@ -0,0 +1,127 @@
+"""
+Test that cached summary lookups are only reused while the categories they
+depended on are unchanged.
+"""
+
+import os, re
+import unittest2
+import lldb
+from lldbtest import *
+import lldbutil
+
+class CacheDataFormatterTestCase(TestBase):
+
+    mydir = os.path.join("functionalities", "data-formatter", "data-formatter-cache")
+
+    @unittest2.skipUnless(sys.platform.startswith("darwin"), "requires Darwin")
+    @dsym_test
+    def test_with_dsym_and_run_command(self):
+        """Test that the summary cache follows category changes."""
+        self.buildDsym()
+        self.data_formatter_commands()
+
+    @dwarf_test
+    def test_with_dwarf_and_run_command(self):
+        """Test that the summary cache follows category changes."""
+        self.buildDwarf()
+        self.data_formatter_commands()
+
+    def setUp(self):
+        # Call super's setUp().
+        TestBase.setUp(self)
+        # Find the line number to break at.
+        self.line = line_number('main.cpp', '// Set break point at this line.')
+        self.log_file = os.path.join(os.getcwd(), "types.log")
+
+    def summary_lookups(self, var_name, type_name, substrs):
+        """Print var_name, check its summary and return how many times its summary wasn't found in the cache."""
+        if os.path.exists(self.log_file):
+            os.remove(self.log_file)
+        self.runCmd("log enable lldb types -f " + self.log_file)
+        self.expect("frame variable " + var_name, substrs = substrs)
+        self.runCmd("log disable lldb types")
+
+        caching = re.compile(r"\[FormatManager::GetSummaryFormat\] Caching .* for type %s$" % type_name)
+        with open(self.log_file) as f:
+            lookups = len([line for line in f if caching.search(line.rstrip())])
+        if self.TraceOn():
+            print "%s: %d lookups" % (var_name, lookups)
+        return lookups
+
+    def data_formatter_commands(self):
+        """Test that the summary cache follows category changes."""
+        self.runCmd("file a.out", CURRENT_EXECUTABLE_SET)
+
+        lldbutil.run_break_set_by_file_and_line (self, "main.cpp", self.line, num_expected_locations=1, loc_exact=True)
+
+        self.runCmd("run", RUN_SUCCEEDED)
+
+        # The stop reason of the thread should be breakpoint.
+        self.expect("thread list", STOPPED_DUE_TO_BREAKPOINT,
+            substrs = ['stopped',
+                       'stop reason = breakpoint'])
+
+        # This is the function to remove the custom formats in order to have a
+        # clean slate for the next test case.
+        def cleanup():
+            self.runCmd('log disable lldb types', check=False)
+            self.runCmd('type category delete cache_high', check=False)
+            self.runCmd('type category delete cache_low', check=False)
+            if os.path.exists(self.log_file):
+                os.remove(self.log_file)
+
+        # Execute the cleanup function during test case tear down.
+        self.addTearDownHook(cleanup)
+
+        # Categories enabled later go in front, so cache_high is consulted
+        # before cache_low.
+        self.runCmd('type summary add -w cache_low -s "low ${var.x}" Point')
+        self.runCmd('type summary add -w cache_high -s "unrelated" Unrelated')
+        self.runCmd('type category enable cache_low')
+        self.runCmd('type category enable cache_high')
+
+        self.assertTrue(self.summary_lookups("point", "Point", ['low 1']) > 0,
+                        "The first lookup isn't cached")
+        self.assertTrue(self.summary_lookups("point", "Point", ['low 1']) == 0,
+                        "The second lookup is served from the cache")
+
+        # A summary added to a category in front of the one that matched
+        # replaces the cached one
+        self.runCmd('type summary add -w cache_high -s "high ${var.y}" Point')
+        self.assertTrue(self.summary_lookups("point", "Point", ['high 2']) > 0,
+                        "A change in front of the match is looked up again")
+
+        # Behind the match, changes don't matter
+        self.runCmd('type summary add -w cache_low -s "low ${var.z}" Plain')
+        self.runCmd('type summary delete -w cache_low Point')
+        self.assertTrue(self.summary_lookups("point", "Point", ['high 2']) == 0,
+                        "A change behind the match keeps the cached lookup")
+
+        # Enabling, disabling and deleting categories
+        self.runCmd('type summary add -w cache_low -s "low ${var.x}" Point')
+        self.runCmd('type category disable cache_high')
+        self.assertTrue(self.summary_lookups("point", "Point", ['low 1']) > 0,
+                        "Disabling the matching category is looked up again")
+        self.runCmd('type category enable cache_high')
+        self.assertTrue(self.summary_lookups("point", "Point", ['high 2']) > 0,
+                        "Enabling a category in front of the match is looked up again")
+        self.runCmd('type category delete cache_high')
+        self.assertTrue(self.summary_lookups("point", "Point", ['low 1']) > 0,
+                        "Deleting the matching category is looked up again")
+
+        # Types without a summary are cached too, until one shows up
+        self.runCmd('type summary delete -w cache_low Plain')
+        self.expect("frame variable plain", matching=False,
+            substrs = ['low 3'])
+        self.assertTrue(self.summary_lookups("plain", "Plain", ['z = 3']) == 0,
+                        "Not having a summary is cached")
+        self.runCmd('type summary add -w cache_low -s "low ${var.z}" Plain')
+        self.assertTrue(self.summary_lookups("plain", "Plain", ['low 3']) > 0,
+                        "A cached miss is looked up again once a summary matches")
+
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
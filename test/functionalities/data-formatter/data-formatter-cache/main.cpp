@@ -0,0 +1,18 @@
+//===-- main.cpp ------------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+struct Point { int x; int y; };
+struct Plain { int z; };
+
+int main (int argc, const char * argv[])
+{
+    Point point = { 1, 2 };
+    Plain plain = { 3 };
+    return 0; // Set break point at this line.
+}
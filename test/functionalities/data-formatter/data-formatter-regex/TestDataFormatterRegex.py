@@ -0,0 +1,127 @@
+"""
+Test that regex type summaries are matched through the combined expression
+of their category with first-match-wins semantics, and that a set the
+combined expression can't handle falls back to trying each one.
+"""
+
+import os, re
+import unittest2
+import lldb
+from lldbtest import *
+import lldbutil
+
+class RegexDataFormatterTestCase(TestBase):
+
+    mydir = os.path.join("functionalities", "data-formatter", "data-formatter-regex")
+
+    @unittest2.skipUnless(sys.platform.startswith("darwin"), "requires Darwin")
+    @dsym_test
+    def test_with_dsym_and_run_command(self):
+        """Test regex summaries matched through a combined expression."""
+        self.buildDsym()
+        self.data_formatter_commands()
+
+    @dwarf_test
+    def test_with_dwarf_and_run_command(self):
+        """Test regex summaries matched through a combined expression."""
+        self.buildDwarf()
+        self.data_formatter_commands()
+
+    def setUp(self):
+        # Call super's setUp().
+        TestBase.setUp(self)
+        # Find the line number to break at.
+        self.line = line_number('main.cpp', '// Set break point at this line.')
+
+    # Variables of main.cpp and the names of their types
+    variables = [("alpha_1", "Alpha_1"),
+                 ("alpha_22", "Alpha_22"),
+                 ("omega_5", "Omega_5"),
+                 ("beta", "Beta"),
+                 ("beta_beta", "BetaBeta"),
+                 ("do_do", "DoDo"),
+                 ("gamma", "Gamma")]
+
+    def add_summary(self, category, regex, summary):
+        self.assertTrue(category.AddTypeSummary(lldb.SBTypeNameSpecifier(regex, True),
+                                                lldb.SBTypeSummary.CreateWithSummaryString(summary)),
+                        "Added summary for " + regex)
+        self.summaries[regex] = summary
+
+    def check_summaries(self, category):
+        """Check every variable against the first expression, in the order the category tries them, that matches its type."""
+        regexes = []
+        for i in range(category.GetNumSummaries()):
+            regexes.append(category.GetTypeNameSpecifierForSummaryAtIndex(i).GetName())
+        self.assertTrue(sorted(regexes) == sorted(self.summaries.keys()), "All summaries are in the category")
+
+        for var_name, type_name in self.variables:
+            frame_var = self.frame().FindVariable(var_name)
+            self.assertTrue(frame_var.IsValid(), "Found " + var_name)
+            expected = None
+            for regex in regexes:
+                if re.search(regex, type_name):
+                    expected = self.summaries[regex]
+                    break
+            summary = frame_var.GetSummary()
+            if self.TraceOn():
+                print "%s: expected %s, got %s" % (type_name, expected, summary)
+            self.assertTrue(summary == expected,
+                            "%s has summary %s" % (type_name, expected))
+
+    def data_formatter_commands(self):
+        """Test regex summaries matched through a combined expression."""
+        self.runCmd("file a.out", CURRENT_EXECUTABLE_SET)
+
+        lldbutil.run_break_set_by_file_and_line (self, "main.cpp", self.line, num_expected_locations=1, loc_exact=True)
+
+        self.runCmd("run", RUN_SUCCEEDED)
+
+        # The stop reason of the thread should be breakpoint.
+        self.expect("thread list", STOPPED_DUE_TO_BREAKPOINT,
+            substrs = ['stopped',
+                       'stop reason = breakpoint'])
+
+        # This is the function to remove the custom formats in order to have a
+        # clean slate for the next test case.
+        def cleanup():
+            self.dbg.DeleteCategory("regex_test")
+        self.addTearDownHook(cleanup)
+
+        category = self.dbg.CreateCategory("regex_test")
+        self.assertTrue(category.IsValid(), "Created category regex_test")
+        category.SetEnabled(True)
+        self.summaries = {}
+
+        # Alpha_1 and Omega_5 match the first and one other expression each,
+        # which also checks that the groups inside an expression don't throw
+        # off which one of the combined alternatives matched. Both Beta
+        # expressions match BetaBeta, and the longest match POSIX reports for
+        # the combined expression is the second one's.
+        self.add_summary(category, "^(Alpha|Omega)_[0-9]$", "alpha or omega digit")
+        self.add_summary(category, "^Alpha_[0-9]+$", "alpha number")
+        self.add_summary(category, "Omega", "omega")
+        self.add_summary(category, "^Beta", "beta prefix")
+        self.add_summary(category, "^(Beta)+$", "beta repeat")
+        self.check_summaries(category)
+
+        # A changed set is picked up by the next lookup
+        self.assertTrue(category.DeleteTypeSummary(lldb.SBTypeNameSpecifier("^Beta", True)), "Deleted ^Beta")
+        del self.summaries["^Beta"]
+        self.check_summaries(category)
+
+        # A back reference can't be combined, so the expressions are tried
+        # one by one
+        self.add_summary(category, "^(Do)\\1$", "do do")
+        self.check_summaries(category)
+
+        self.assertTrue(category.DeleteTypeSummary(lldb.SBTypeNameSpecifier("^(Do)\\1$", True)), "Deleted ^(Do)\\1$")
+        del self.summaries["^(Do)\\1$"]
+        self.check_summaries(category)
+
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
@@ -0,0 +1,28 @@
+//===-- main.cpp ------------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+struct Alpha_1 { int x; };
+struct Alpha_22 { int x; };
+struct Omega_5 { int x; };
+struct Beta { int x; };
+struct BetaBeta { int x; };
+struct DoDo { int x; };
+struct Gamma { int x; };
+
+int main (int argc, const char * argv[])
+{
+    Alpha_1 alpha_1 = { 1 };
+    Alpha_22 alpha_22 = { 22 };
+    Omega_5 omega_5 = { 5 };
+    Beta beta = { 2 };
+    BetaBeta beta_beta = { 3 };
+    DoDo do_do = { 4 };
+    Gamma gamma = { 6 };
+    return 0; // Set break point at this line.
+}
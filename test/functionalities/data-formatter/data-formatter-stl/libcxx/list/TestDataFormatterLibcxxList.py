@@ -145,6 +145,15 @@ class LibcxxListDataFormatterTestCase(TestBase):
         # check that MightHaveChildren() gets it right
         self.assertTrue(self.frame().FindVariable("numbers_list").MightHaveChildren(), "numbers_list.MightHaveChildren() says False for non empty!")
 
+        # check that a page of children matches the children one by one
+        numbers_list = self.frame().FindVariable("numbers_list")
+        page = numbers_list.GetChildrenAtIndexRange(1, 2)
+        self.assertTrue(page.GetSize() == 2, "numbers_list.GetChildrenAtIndexRange(1, 2) didn't return 2 children")
+        self.assertTrue(page.GetValueAtIndex(0).GetValueAsUnsigned() == 2, "numbers_list[1] in the page is wrong")
+        self.assertTrue(page.GetValueAtIndex(1).GetValueAsUnsigned() == 3, "numbers_list[2] in the page is wrong")
+        page = numbers_list.GetChildrenAtIndexRange(3, 10)
+        self.assertTrue(page.GetSize() == 1, "numbers_list.GetChildrenAtIndexRange(3, 10) didn't stop at the end")
+
         self.runCmd("type format delete int")
 
         self.runCmd("c")
@@ -172,6 +181,25 @@ class LibcxxListDataFormatterTestCase(TestBase):
         self.expect("frame variable text_list[3]",
                     substrs = ['!!!']);
 
+        # make the third node of numbers_list point back to the first one, the
+        # list still claims 4 items but only has 3 distinct nodes
+        self.runCmd("expr numbers_list.__end_.__next_->__next_->__next_->__next_ = numbers_list.__end_.__next_")
+
+        self.expect("frame variable numbers_list",
+                    substrs = ['list has 3 items',
+                               '[0] = 1',
+                               '[1] = 2',
+                               '[2] = 3'])
+        self.expect("frame variable numbers_list", matching=False,
+                    substrs = ['[3] = '])
+
+        # the child count and the children agree on where the loop cuts the list
+        numbers_list = self.frame().FindVariable("numbers_list")
+        self.assertTrue(numbers_list.GetNumChildren() == 3, "looping numbers_list doesn't have 3 children")
+        self.assertTrue(numbers_list.GetChildAtIndex(2).GetValueAsUnsigned() == 3, "numbers_list[2] is wrong after the loop was made")
+        self.assertFalse(numbers_list.GetChildAtIndex(3).IsValid(), "looping numbers_list has a child past its count")
+        self.assertTrue(numbers_list.GetChildrenAtIndexRange(0, 10).GetSize() == 3, "a page of the looping numbers_list doesn't stop at the loop")
+
 if __name__ == '__main__':
     import atexit
     lldb.SBDebugger.Initialize()
@@ -0,0 +1,226 @@
+"""
+Test stepping, memory and register traffic against the in-process sim://
+gdb-remote simulator, recording and replaying such a session, and the stop
+info of a multi-core target.
+"""
+
+import os, sys
+import unittest2
+import lldb
+from lldbtest import *
+import lldbutil
+
+class GDBRemoteSimTestCase(TestBase):
+
+    mydir = os.path.join("functionalities", "gdb_remote_sim")
+
+    @unittest2.skipUnless(sys.platform.startswith("linux"), "the simulator loads ELF images only")
+    def test_step_memory_registers(self):
+        """Test stepping, memory and register accesses served by the simulator."""
+        self.buildDefault()
+        self.step_memory_registers()
+
+    @unittest2.skipUnless(sys.platform.startswith("linux"), "the simulator loads ELF images only")
+    def test_packet_trace_record_and_replay(self):
+        """Test recording a simulator session, summarizing it and replaying it."""
+        self.buildDefault()
+        self.packet_trace_record_and_replay()
+
+    @unittest2.skipUnless(sys.platform.startswith("linux"), "the simulator loads ELF images only")
+    def test_multi_core_stop_info(self):
+        """Test that the stop info of all cores of a stop comes in one packet."""
+        self.buildDefault()
+        self.multi_core_stop_info()
+
+    @unittest2.skipUnless(sys.platform.startswith("linux"), "the simulator loads ELF images only")
+    def test_unsupported_qsupported_asked_once(self):
+        """Test that a stub's empty reply to qSupported is remembered for the connection."""
+        self.buildDefault()
+        self.unsupported_qsupported_asked_once()
+
+    def connect_to_simulator(self, options = ""):
+        """Connect to a simulator for a.out, 'options' are appended to the sim:// URL."""
+        exe = os.path.join(os.getcwd(), "a.out")
+        target = self.dbg.CreateTarget(exe)
+        self.assertTrue(target, VALID_TARGET)
+
+        url = "sim://" + exe
+        if options:
+            url += "?" + options
+        return self.connect_to_url(target, url)
+
+    def connect_to_url(self, target, url):
+        """Connect 'target' to the gdb-remote server at 'url' and check that its process stopped."""
+        self.runCmd('process connect -p gdb-remote "%s"' % url)
+        process = target.GetProcess()
+        self.assertTrue(process and process.GetState() == lldb.eStateStopped, PROCESS_STOPPED)
+        return (target, process)
+
+    def step_memory_registers(self):
+        (target, process) = self.connect_to_simulator()
+        thread = process.GetSelectedThread()
+        self.assertTrue(thread.IsValid(), "The simulated core is a thread")
+        frame = thread.GetFrameAtIndex(0)
+        pc = frame.GetPC()
+        sp = frame.GetSP()
+        self.assertTrue(pc != lldb.LLDB_INVALID_ADDRESS and sp != lldb.LLDB_INVALID_ADDRESS,
+                        "The stop reply has the pc and sp")
+
+        # Memory is served from the sections of the image
+        error = lldb.SBError()
+        code = process.ReadMemory(pc, 16, error)
+        self.assertTrue(error.Success(), "Read the code at the pc")
+        address = target.ResolveLoadAddress(pc)
+        section_data = address.GetSection().GetSectionData(address.GetOffset(), 16)
+        self.assertTrue(code == section_data.ReadRawData(error, 0, 16), "The code at the pc matches the image")
+
+        # The stack can be written and read back
+        pattern = "\x01\x23\x45\x67\x89\xab\xcd\xef"
+        self.assertTrue(process.WriteMemory(sp - 16, pattern, error) == len(pattern), "Wrote to the stack")
+        self.assertTrue(process.ReadMemory(sp - 16, len(pattern), error) == pattern, "Read the stack back")
+
+        # A register write sticks across a stop, which refetches it
+        self.runCmd("register write r5 0x1234")
+        self.expect("register read r5", substrs = ["r5 = 0x", "1234"])
+
+        # A single step moves the pc by one instruction
+        thread.StepInstruction(False)
+        self.assertTrue(process.GetState() == lldb.eStateStopped, PROCESS_STOPPED)
+        step_pc = thread.GetFrameAtIndex(0).GetPC()
+        self.assertTrue(step_pc > pc, "The step moved the pc forward")
+        self.expect("register read r5", substrs = ["r5 = 0x", "1234"])
+
+        # Continuing runs to the next breakpoint after the pc
+        breakpoint = target.BreakpointCreateByName("sum", "a.out")
+        self.assertTrue(breakpoint.GetNumLocations() == 1, VALID_BREAKPOINT)
+        process.Continue()
+        threads = lldbutil.get_threads_stopped_at_breakpoint(process, breakpoint)
+        self.assertTrue(len(threads) == 1, "Stopped at the breakpoint in sum")
+        self.assertTrue(threads[0].GetFrameAtIndex(0).GetPC() == breakpoint.GetLocationAtIndex(0).GetLoadAddress(),
+                        "The pc is at the breakpoint")
+
+        # With no breakpoint left after the pc the simulated process exits
+        breakpoint.SetEnabled(False)
+        process.Continue()
+        self.assertTrue(process.GetState() == lldb.eStateExited, "The process exited")
+
+    def step_and_read(self, process, num_steps):
+        """Step the selected thread 'num_steps' times and return the pc of each stop, the code and r5 at the last one."""
+        thread = process.GetSelectedThread()
+        pcs = [thread.GetFrameAtIndex(0).GetPC()]
+        for i in range(num_steps):
+            thread.StepInstruction(False)
+            self.assertTrue(process.GetState() == lldb.eStateStopped, PROCESS_STOPPED)
+            pcs.append(thread.GetFrameAtIndex(0).GetPC())
+        error = lldb.SBError()
+        code = process.ReadMemory(pcs[-1], 16, error)
+        self.assertTrue(error.Success(), "Read the code at the pc")
+        # r5 isn't expedited, so this asks for it
+        self.runCmd("register read r5")
+        return (pcs, code, self.res.GetOutput())
+
+    def packet_trace_record_and_replay(self):
+        trace_path = os.path.join(os.getcwd(), "session.trace")
+
+        # Record the whole session, handshake included, so it can be replayed
+        os.environ["LLDB_GDB_REMOTE_PACKET_TRACE"] = trace_path
+        def cleanup():
+            if "LLDB_GDB_REMOTE_PACKET_TRACE" in os.environ:
+                del os.environ["LLDB_GDB_REMOTE_PACKET_TRACE"]
+            if os.path.exists(trace_path):
+                os.remove(trace_path)
+        self.addTearDownHook(cleanup)
+
+        (target, process) = self.connect_to_simulator()
+        del os.environ["LLDB_GDB_REMOTE_PACKET_TRACE"]
+        (recorded_pcs, recorded_code, recorded_r5) = self.step_and_read(process, 2)
+        self.runCmd("process plugin packet trace stop")
+        self.assertTrue(os.path.exists(trace_path), "The session was recorded")
+
+        # Every kind of operation the session did shows up in the summary
+        self.expect("process plugin packet trace summary " + trace_path,
+                    substrs = ["packets in", "bytes sent", "stop", "step", "memory", "register"])
+        process.Kill()
+
+        # Replaying the trace hands a new debugger session the same answers
+        exe = os.path.join(os.getcwd(), "a.out")
+        target = self.dbg.CreateTarget(exe)
+        self.assertTrue(target, VALID_TARGET)
+        (target, process) = self.connect_to_url(target, "replay://" + trace_path)
+        (replayed_pcs, replayed_code, replayed_r5) = self.step_and_read(process, 2)
+        self.assertTrue(replayed_pcs == recorded_pcs, "The replayed steps stop at the recorded pcs")
+        self.assertTrue(replayed_code == recorded_code, "The replayed memory read returns the recorded bytes")
+        self.assertTrue(replayed_r5 == recorded_r5, "The replayed register read returns the recorded value")
+
+    def multi_core_stop_info(self):
+        num_cores = 4
+        (target, process) = self.connect_to_simulator("cores=%d" % num_cores)
+        self.assertTrue(process.GetNumThreads() == num_cores, "Each core is reported as a thread")
+        names = sorted([process.GetThreadAtIndex(i).GetName() for i in range(num_cores)])
+        self.assertTrue(names == ["core %d" % i for i in range(num_cores)], "The threads are named after their cores")
+
+        thread = process.GetSelectedThread()
+        pc = thread.GetFrameAtIndex(0).GetPC()
+
+        log_file = os.path.join(os.getcwd(), "multi-core-packets.log")
+        def cleanup():
+            self.runCmd("log disable gdb-remote packets", check=False)
+            if os.path.exists(log_file):
+                os.remove(log_file)
+        self.addTearDownHook(cleanup)
+
+        # Step one core, the others stay where they are
+        self.runCmd("log enable -f %s gdb-remote packets" % log_file)
+        thread.StepInstruction(False)
+        self.assertTrue(process.GetState() == lldb.eStateStopped, PROCESS_STOPPED)
+        stack_pointers = set()
+        for i in range(num_cores):
+            frame = process.GetThreadAtIndex(i).GetFrameAtIndex(0)
+            self.assertTrue(frame.IsValid(), "Every core has a frame")
+            if process.GetThreadAtIndex(i).GetThreadID() == thread.GetThreadID():
+                self.assertTrue(frame.GetPC() > pc, "The stepped core moved")
+            else:
+                self.assertTrue(frame.GetPC() == pc, "The other cores didn't move")
+            stack_pointers.add(frame.GetSP())
+        self.assertTrue(len(stack_pointers) == num_cores, "Each core has its own stack")
+        self.runCmd("log disable gdb-remote packets")
+
+        # The stop info of the cores that didn't report the stop came in a
+        # single packet, not one per core
+        with open(log_file, "r") as f:
+            sent = [line for line in f.readlines() if "send packet: $" in line]
+        self.assertTrue(len([line for line in sent if "$qMultiThreadStopInfo:" in line]) == 1,
+                        "One qMultiThreadStopInfo packet was sent")
+        self.assertTrue(len([line for line in sent if "$qThreadStopInfo" in line]) == 0,
+                        "No qThreadStopInfo packets were sent")
+
+    def unsupported_qsupported_asked_once(self):
+        log_file = os.path.join(os.getcwd(), "qsupported-packets.log")
+        def cleanup():
+            self.runCmd("log disable gdb-remote packets", check=False)
+            if os.path.exists(log_file):
+                os.remove(log_file)
+        self.addTearDownHook(cleanup)
+
+        # Without qSupported, a multi-core stop asks whether the stub has
+        # qMultiThreadStopInfo, which must not send qSupported again
+        self.runCmd("log enable -f %s gdb-remote packets" % log_file)
+        (target, process) = self.connect_to_simulator("cores=2;qsupported=0")
+        thread = process.GetSelectedThread()
+        for i in range(2):
+            thread.StepInstruction(False)
+            self.assertTrue(process.GetState() == lldb.eStateStopped, PROCESS_STOPPED)
+            self.assertTrue(process.GetThreadAtIndex(1).GetFrameAtIndex(0).IsValid(), "The other core has a frame")
+        self.runCmd("log disable gdb-remote packets")
+
+        with open(log_file, "r") as f:
+            sent = [line for line in f.readlines() if "send packet: $" in line]
+        self.assertTrue(len([line for line in sent if "$qSupported" in line]) == 1,
+                        "qSupported was sent once for the connection")
+
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
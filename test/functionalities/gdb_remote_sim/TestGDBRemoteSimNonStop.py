@@ -0,0 +1,78 @@
+"""
+Test that in non-stop mode a thread that keeps running at the stub has no
+frames or stop reason and isn't selected until its own stop reply arrives.
+"""
+
+import os, sys
+import unittest2
+import lldb
+from lldbtest import *
+
+class GDBRemoteSimNonStopTestCase(TestBase):
+
+    mydir = os.path.join("functionalities", "gdb_remote_sim")
+
+    @unittest2.skipUnless(sys.platform.startswith("linux"), "the simulator loads ELF images only")
+    def test_non_stop_running_threads(self):
+        """Test that a %Stop notification only stops the thread it names."""
+        self.buildDefault()
+        self.non_stop_running_threads()
+
+    def connect_to_simulator(self, stop_replies):
+        """Connect to a two core simulator that answers each resume with the next of 'stop_replies'."""
+        exe = os.path.join(os.getcwd(), "a.out")
+        target = self.dbg.CreateTarget(exe)
+        self.assertTrue(target, VALID_TARGET)
+
+        stop_replies_path = os.path.join(os.getcwd(), "stop-replies.txt")
+        with open(stop_replies_path, "w") as f:
+            f.write("\n".join(stop_replies) + "\n")
+
+        # ProcessGDBRemote only asks for non-stop mode when told to
+        os.environ["LLDB_GDB_REMOTE_NON_STOP"] = "1"
+        def cleanup():
+            del os.environ["LLDB_GDB_REMOTE_NON_STOP"]
+            os.remove(stop_replies_path)
+        self.addTearDownHook(cleanup)
+
+        self.runCmd('process connect -p gdb-remote "sim://%s?cores=2;stop-replies=%s"' % (exe, stop_replies_path))
+        process = target.GetProcess()
+        self.assertTrue(process and process.GetState() == lldb.eStateStopped, PROCESS_STOPPED)
+        self.assertTrue(process.GetNumThreads() == 2, "Both cores are reported as threads")
+        return process
+
+    def non_stop_running_threads(self):
+        process = self.connect_to_simulator(["T05thread:1;", "T05thread:2;"])
+
+        # Both threads resume, only the first one reports a stop
+        self.runCmd("process continue")
+        self.assertTrue(process.GetState() == lldb.eStateStopped, PROCESS_STOPPED)
+        stopped = process.GetThreadByID(1)
+        running = process.GetThreadByID(2)
+        self.assertTrue(stopped.GetStopReason() == lldb.eStopReasonSignal, STOPPED_DUE_TO_SIGNAL)
+        self.assertTrue(stopped.GetNumFrames() > 0, "The stopped thread can be unwound")
+        self.assertTrue(running.GetStopReason() in [lldb.eStopReasonInvalid, lldb.eStopReasonNone],
+                        "The running thread has no stop reason")
+        self.assertTrue(running.GetNumFrames() == 0, "The running thread has no frames")
+        self.assertTrue(process.GetSelectedThread().GetThreadID() == 1, "The stopped thread is selected")
+
+        # Backtraces skip the running thread instead of reading its registers
+        self.runCmd("thread backtrace all")
+
+        # Resuming only moves the stopped thread, the running one now reports
+        # its stop while the first keeps running
+        self.runCmd("process continue")
+        self.assertTrue(process.GetState() == lldb.eStateStopped, PROCESS_STOPPED)
+        stopped = process.GetThreadByID(2)
+        running = process.GetThreadByID(1)
+        self.assertTrue(stopped.GetStopReason() == lldb.eStopReasonSignal, STOPPED_DUE_TO_SIGNAL)
+        self.assertTrue(stopped.GetNumFrames() > 0, "The stopped thread can be unwound")
+        self.assertTrue(running.GetNumFrames() == 0, "The running thread has no frames")
+        self.assertTrue(process.GetSelectedThread().GetThreadID() == 2, "The selection moves to the stopped thread")
+
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
@@ -0,0 +1,26 @@
+//===-- main.c --------------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+#include <stdio.h>
+
+// The simulator never runs this code, it only maps the image and moves the
+// pc of each core from instruction to instruction.
+int
+sum (int a, int b)
+{
+    return a + b;
+}
+
+int main (int argc, char const *argv[])
+{
+    int total = 0;
+    for (int i = 0; i < 10; ++i)
+        total = sum (total, i);
+    printf ("total = %d\n", total);
+    return 0;
+}
@@ -0,0 +1,98 @@
+"""
+Test target.incremental-value-updates: a value whose own bytes didn't change
+but whose summary depends on memory it points to.
+"""
+
+import os
+import unittest2
+import lldb
+from lldbtest import *
+import lldbutil
+
+class IncrementalValueUpdatesTestCase(TestBase):
+
+    mydir = os.path.join("functionalities", "incremental_value_updates")
+
+    @unittest2.skipUnless(sys.platform.startswith("darwin"), "requires Darwin")
+    @dsym_test
+    def test_setting_off_with_dsym(self):
+        """Test that summaries follow the pointee with the setting off."""
+        self.buildDsym()
+        self.value_updates(False)
+
+    @dwarf_test
+    def test_setting_off_with_dwarf(self):
+        """Test that summaries follow the pointee with the setting off."""
+        self.buildDwarf()
+        self.value_updates(False)
+
+    @unittest2.skipUnless(sys.platform.startswith("darwin"), "requires Darwin")
+    @dsym_test
+    def test_setting_on_with_dsym(self):
+        """Test that summaries of unchanged values are kept with the setting on."""
+        self.buildDsym()
+        self.value_updates(True)
+
+    @dwarf_test
+    def test_setting_on_with_dwarf(self):
+        """Test that summaries of unchanged values are kept with the setting on."""
+        self.buildDwarf()
+        self.value_updates(True)
+
+    def setUp(self):
+        # Call super's setUp().
+        TestBase.setUp(self)
+        # Find the line number to break at.
+        self.line = line_number('main.c', '// Set break point at this line.')
+
+    def step_and_check(self, thread, text, expected):
+        thread.StepOver()
+        self.assertTrue(thread.GetStopReason() == lldb.eStopReasonPlanComplete, "Stepped over a line")
+        summary = text.GetSummary()
+        if self.TraceOn():
+            print "line %d: %s" % (thread.GetFrameAtIndex(0).GetLineEntry().GetLine(), summary)
+        self.assertTrue(summary == expected, "Summary is %s, got %s" % (expected, summary))
+
+    def value_updates(self, incremental):
+        """Test a pointer whose pointee changes and then the pointer itself."""
+        exe = os.path.join(os.getcwd(), "a.out")
+        target = self.dbg.CreateTarget(exe)
+        self.assertTrue(target, VALID_TARGET)
+
+        def cleanup():
+            self.runCmd("settings clear target.incremental-value-updates", check=False)
+        self.addTearDownHook(cleanup)
+        self.runCmd("settings set target.incremental-value-updates %s" % ("true" if incremental else "false"))
+
+        breakpoint = target.BreakpointCreateByLocation("main.c", self.line)
+        self.assertTrue(breakpoint, VALID_BREAKPOINT)
+
+        process = target.LaunchSimple(None, None, os.getcwd())
+        self.assertTrue(process, PROCESS_IS_VALID)
+
+        threads = lldbutil.get_threads_stopped_at_breakpoint(process, breakpoint)
+        self.assertTrue(len(threads) == 1)
+        thread = threads[0]
+
+        # Keep the same value across the stops
+        text = thread.GetFrameAtIndex(0).FindVariable("text")
+        self.assertTrue(text.IsValid(), "Found text")
+        self.assertTrue(text.GetSummary() == '"before"', "text starts out as \"before\"")
+
+        # The pointer stays the same but the string it points to changes.
+        # Without the setting the summary is computed again. With it, the
+        # summary of the unchanged pointer is kept, as the setting documents.
+        if incremental:
+            self.step_and_check(thread, text, '"before"')
+        else:
+            self.step_and_check(thread, text, '"after"')
+
+        # Once the pointer itself changes, the summary is always recomputed
+        self.step_and_check(thread, text, '"other"')
+
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
@@ -0,0 +1,14 @@
+#include <stdio.h>
+#include <string.h>
+
+int main (int argc, char const *argv[])
+{
+    char buffer[16];
+    char other[16] = "other";
+    char *text = buffer;
+    strcpy (buffer, "before");
+    strcpy (buffer, "after"); // Set break point at this line.
+    text = other; // The pointee has changed.
+    printf ("%s %s\n", buffer, text); // The pointer has changed.
+    return 0;
+}
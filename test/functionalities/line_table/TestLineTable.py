@@ -0,0 +1,129 @@
+"""
+Test that a packed line table dumps all of its rows with its statistics and
+resolves addresses to the same lines as the rows it dumped, on both sides of
+a checkpoint and at the end of each sequence.
+"""
+
+import os, re
+import unittest2
+import lldb
+from lldbtest import *
+import lldbutil
+
+class LineTableTestCase(TestBase):
+
+    mydir = os.path.join("functionalities", "line_table")
+
+    # Rows the line table keeps fully decoded, see LineTable.h
+    checkpoint_interval = 16
+
+    @unittest2.skipUnless(sys.platform.startswith("darwin"), "requires Darwin")
+    @dsym_test
+    def test_with_dsym(self):
+        """Test dumping a packed line table and resolving its addresses."""
+        self.buildDsym()
+        self.line_table()
+
+    @dwarf_test
+    def test_with_dwarf(self):
+        """Test dumping a packed line table and resolving its addresses."""
+        self.buildDwarf()
+        self.line_table()
+
+    def dump_line_table(self):
+        """Return the rows of main.c's line table as (file address, file name, line, is end of sequence) and its statistics."""
+        self.runCmd("target modules dump line-table main.c")
+        output = self.res.GetOutput().splitlines()
+
+        row_regex = re.compile(r'^(0x[0-9a-fA-F]+): (.*):(\d+)(:\d+)?$')
+        rows = []
+        for i in range(len(output)):
+            m = row_regex.match(output[i])
+            if m:
+                # The last row of a sequence is followed by an empty line
+                end_of_sequence = i + 1 < len(output) and output[i + 1].strip() == ""
+                rows.append((int(m.group(1), 16), os.path.basename(m.group(2)), int(m.group(3)), end_of_sequence))
+
+        stats = None
+        for text in output:
+            m = re.search(r'Line table statistics: (\d+) line entries in (\d+) sequences using (\d+) bytes', text)
+            if m:
+                stats = (int(m.group(1)), int(m.group(2)))
+        self.assertTrue(stats, "The dump ends with the statistics of the packed table")
+        if self.TraceOn():
+            print "%d rows, statistics: %s" % (len(rows), stats)
+        return rows, stats
+
+    def check_address(self, module, file_addr, file_name, line):
+        addr = module.ResolveFileAddress(file_addr)
+        line_entry = addr.GetLineEntry()
+        self.assertTrue(line_entry.IsValid(), "0x%x has a line entry" % file_addr)
+        self.assertTrue(line_entry.GetFileSpec().GetFilename() == file_name and line_entry.GetLine() == line,
+                        "0x%x is at %s:%d, got %s:%d" % (file_addr, file_name, line,
+                                                         line_entry.GetFileSpec().GetFilename(), line_entry.GetLine()))
+
+    def check_row(self, module, rows, idx):
+        """Resolve the first and the last address covered by row idx."""
+        file_addr, file_name, line, end_of_sequence = rows[idx]
+        if end_of_sequence or idx + 1 >= len(rows):
+            return False
+        # Rows sharing an address with a neighbour don't cover any bytes of
+        # their own
+        if idx > 0 and rows[idx - 1][0] == file_addr and not rows[idx - 1][3]:
+            return False
+        next_addr = rows[idx + 1][0]
+        if next_addr <= file_addr:
+            return False
+        self.check_address(module, file_addr, file_name, line)
+        self.check_address(module, next_addr - 1, file_name, line)
+        return True
+
+    def line_table(self):
+        exe = os.path.join(os.getcwd(), "a.out")
+        target = self.dbg.CreateTarget(exe)
+        self.assertTrue(target, VALID_TARGET)
+        module = target.FindModule(target.GetExecutable())
+        self.assertTrue(module.IsValid(), "Found the executable module")
+
+        rows, stats = self.dump_line_table()
+        num_sequences = len([row for row in rows if row[3]])
+        self.assertTrue(stats[0] == len(rows), "All %d rows were dumped, got %d" % (stats[0], len(rows)))
+        self.assertTrue(stats[1] == num_sequences, "%d sequences, got %d" % (stats[1], num_sequences))
+        # other() is in a section of its own
+        self.assertTrue(num_sequences >= 2, "main.c has more than one sequence")
+        self.assertTrue(len(rows) > 2 * self.checkpoint_interval + 1, "main.c has rows past the second checkpoint")
+
+        # Rows on both sides of each checkpoint
+        num_checked = 0
+        checkpoint = self.checkpoint_interval
+        while checkpoint < len(rows):
+            for idx in range(checkpoint - 2, min(checkpoint + 2, len(rows))):
+                if self.check_row(module, rows, idx):
+                    num_checked += 1
+            checkpoint += self.checkpoint_interval
+        self.assertTrue(num_checked > 0, "Checked rows around the checkpoints")
+
+        # The last rows of each sequence, and the end of each sequence
+        for idx in range(len(rows)):
+            if not rows[idx][3]:
+                continue
+            self.assertTrue(idx > 0 and not rows[idx - 1][3], "A sequence has rows before its end")
+            self.assertTrue(self.check_row(module, rows, idx - 1), "Checked the last row of a sequence")
+
+            end_addr = rows[idx][0]
+            line_entry = module.ResolveFileAddress(end_addr).GetLineEntry()
+            if line_entry.IsValid():
+                self.assertTrue(line_entry.GetStartAddress().GetFileAddress() >= end_addr,
+                                "0x%x past the end of a sequence isn't covered by it" % end_addr)
+
+        # The last lines of both functions have rows
+        for function in ["other", "compute"]:
+            line = line_number("main.c", "// Last line of %s." % function)
+            self.assertTrue(len([row for row in rows if row[2] == line]) > 0, "main.c:%d has a row" % line)
+
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
@@ -0,0 +1,69 @@
+#include <stdio.h>
+
+// Code in another section gets a line table sequence of its own
+#if defined(__APPLE__)
+#define OTHER_SECTION __attribute__((section("__TEXT,__text_other")))
+#else
+#define OTHER_SECTION __attribute__((section(".text.other")))
+#endif
+
+OTHER_SECTION int
+other (int value)
+{
+    value += 1;
+    value *= 3;
+    return value; // Last line of other.
+}
+
+// Enough statements for the rows to cross several checkpoints
+int
+compute (int value)
+{
+    value = value * 3 + 1;
+    value = value * 4 + 2;
+    value = value * 5 + 3;
+    value = value * 6 + 4;
+    value = value * 7 + 5;
+    value = value * 8 + 6;
+    value = value * 2 + 7;
+    value = value * 3 + 8;
+    value = value * 4 + 9;
+    value = value * 5 + 10;
+    value = value * 6 + 11;
+    value = value * 7 + 12;
+    value = value * 8 + 13;
+    value = value * 2 + 14;
+    value = value * 3 + 15;
+    value = value * 4 + 16;
+    value = value * 5 + 17;
+    value = value * 6 + 18;
+    value = value * 7 + 19;
+    value = value * 8 + 20;
+    value = value * 2 + 21;
+    value = value * 3 + 22;
+    value = value * 4 + 23;
+    value = value * 5 + 24;
+    value = value * 6 + 25;
+    value = value * 7 + 26;
+    value = value * 8 + 27;
+    value = value * 2 + 28;
+    value = value * 3 + 29;
+    value = value * 4 + 30;
+    value = value * 5 + 31;
+    value = value * 6 + 32;
+    value = value * 7 + 33;
+    value = value * 8 + 34;
+    value = value * 2 + 35;
+    value = value * 3 + 36;
+    value = value * 4 + 37;
+    value = value * 5 + 38;
+    value = value * 6 + 39;
+    value = value * 7 + 40;
+    return value; // Last line of compute.
+}
+
+int main (int argc, char const *argv[])
+{
+    printf ("%d\n", compute (other (argc)));
+    return 0;
+}
@@ -0,0 +1,43 @@
+"""
+Test that the Patmos instruction emulator follows delayed branches through
+their delay slots, the way stepping over a branch uses it.
+"""
+
+import os, time
+import unittest2
+import lldb
+from lldbtest import *
+
+class PatmosEmulationTestCase(TestBase):
+    
+    mydir = "patmos_emulation"
+
+    def test_delayed_branch_emulations (self):
+        current_dir = os.getcwd();
+        test_dir = os.path.join (current_dir, "new-test-files")
+        files = os.listdir (test_dir)
+        patmos_files = list()
+        for f in files:
+            if '-patmos.dat' in f:
+                patmos_files.append (f)
+                
+        for f in patmos_files:
+            test_file = os.path.join (test_dir, f)
+            self.run_a_single_test (test_file)
+
+    def run_a_single_test (self, filename):
+        insn = lldb.SBInstruction ();
+        stream = lldb.SBStream ();
+        success = insn.TestEmulation (stream, filename);
+        output = stream.GetData();
+        if self.TraceOn():
+            print '\nRunning test ' + os.path.basename(filename)
+            print output
+
+        self.assertTrue (success, 'Emulation test succeeded.')
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
@@ -0,0 +1,113 @@
+"""
+Test SBValue.GetChildrenAtIndexRange on an array with more elements than a
+value keeps in its dense children vector, against GetChildAtIndex.
+"""
+
+import os
+import unittest2
+import lldb, lldbutil
+from lldbtest import *
+
+class ValueChildrenRangeTestCase(TestBase):
+
+    mydir = os.path.join("python_api", "value", "children_range")
+
+    # ValueObject::ChildrenManager keeps the children below this index in a
+    # vector and the ones above it in a map
+    max_dense_children = 64 * 1024
+    num_elements = 70000
+
+    @unittest2.skipUnless(sys.platform.startswith("darwin"), "requires Darwin")
+    @python_api_test
+    @dsym_test
+    def test_with_dsym(self):
+        """Test fetching ranges of children across the dense children limit."""
+        self.buildDsym()
+        self.children_range()
+
+    @python_api_test
+    @dwarf_test
+    def test_with_dwarf(self):
+        """Test fetching ranges of children across the dense children limit."""
+        self.buildDwarf()
+        self.children_range()
+
+    def setUp(self):
+        # Call super's setUp().
+        TestBase.setUp(self)
+        self.line = line_number('main.c', '// Stop here and fetch the children')
+
+    def check_child(self, child, idx):
+        self.assertTrue(child.IsValid(), "Child %d is valid" % idx)
+        self.assertTrue(child.GetName() == "[%d]" % idx, "Child %d is named [%d], got %s" % (idx, idx, child.GetName()))
+        self.assertTrue(child.GetValueAsSigned() == idx * 3, "Child %d is %d, got %d" % (idx, idx * 3, child.GetValueAsSigned()))
+
+    def check_range(self, ranged_value, indexed_value, idx, count):
+        """Fetch [idx, idx + count) of ranged_value in one go and compare them with indexed_value's children fetched one by one."""
+        children = ranged_value.GetChildrenAtIndexRange(idx, count)
+        expected_size = max(0, min(count, self.num_elements - idx))
+        self.assertTrue(children.GetSize() == expected_size,
+                        "[%d, %d) has %d children, got %d" % (idx, idx + count, expected_size, children.GetSize()))
+        for i in range(children.GetSize()):
+            child = children.GetValueAtIndex(i)
+            self.check_child(child, idx + i)
+            indexed = indexed_value.GetChildAtIndex(idx + i)
+            self.check_child(indexed, idx + i)
+            self.assertTrue(child.GetLoadAddress() == indexed.GetLoadAddress(),
+                            "Child %d is at the same address" % (idx + i))
+            # Asking the same value for the child again gives the one the
+            # range created
+            again = ranged_value.GetChildAtIndex(idx + i)
+            self.check_child(again, idx + i)
+            self.assertTrue(again.GetLoadAddress() == child.GetLoadAddress(),
+                            "Child %d is the same when fetched again" % (idx + i))
+
+    def children_range(self):
+        exe = os.path.join(os.getcwd(), "a.out")
+        target = self.dbg.CreateTarget(exe)
+        self.assertTrue(target, VALID_TARGET)
+
+        breakpoint = target.BreakpointCreateByLocation('main.c', self.line)
+        self.assertTrue(breakpoint, VALID_BREAKPOINT)
+
+        process = target.LaunchSimple(None, None, os.getcwd())
+        self.assertTrue(process, PROCESS_IS_VALID)
+
+        threads = lldbutil.get_threads_stopped_at_breakpoint(process, breakpoint)
+        self.assertTrue(len(threads) == 1)
+        frame = threads[0].GetFrameAtIndex(0)
+
+        large = frame.FindVariable("g_large")
+        self.assertTrue(large.IsValid(), "Found g_large")
+        self.assertTrue(large.GetNumChildren() == self.num_elements, "g_large has %d children" % self.num_elements)
+
+        # A second value of the same array with children of its own, which
+        # are only ever fetched one at a time
+        indexed = large.CreateValueFromAddress("g_large_indexed", large.GetLoadAddress(), large.GetType())
+        self.assertTrue(indexed.IsValid(), "Created a second value for g_large")
+        self.assertTrue(indexed.GetNumChildren() == self.num_elements, "The second value has %d children" % self.num_elements)
+
+        dense_limit = self.max_dense_children
+
+        # The start, across the dense limit and the end of the array
+        self.check_range(large, indexed, 0, 16)
+        self.check_range(large, indexed, dense_limit - 8, 16)
+        self.check_range(large, indexed, self.num_elements - 16, 16)
+
+        # Ranges overlapping children that already exist on both sides of
+        # the limit, some created one by one
+        self.check_child(large.GetChildAtIndex(dense_limit - 20), dense_limit - 20)
+        self.check_child(large.GetChildAtIndex(dense_limit + 20), dense_limit + 20)
+        self.check_range(large, indexed, dense_limit - 24, 48)
+
+        # A range running past the end is cut short, one starting past the
+        # end is empty
+        self.check_range(large, indexed, self.num_elements - 5, 10)
+        self.check_range(large, indexed, self.num_elements, 10)
+
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
@@ -0,0 +1,15 @@
+#include <stdio.h>
+
+// More elements than a value keeps in its dense children vector
+#define NUM_ELEMENTS 70000
+
+int g_large[NUM_ELEMENTS];
+
+int main (int argc, char const *argv[])
+{
+    int i;
+    for (i = 0; i < NUM_ELEMENTS; ++i)
+        g_large[i] = i * 3;
+    printf ("%d\n", g_large[NUM_ELEMENTS - 1]); // Stop here and fetch the children
+    return 0;
+}
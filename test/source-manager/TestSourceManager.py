@@ -7,6 +7,10 @@ o test_display_source_python:
   Test display of source using the SBSourceManager API.
 o test_modify_source_file_while_debugging:
   Test the caching mechanism of the source manager.
+o test_lazy_line_index:
+  Test displaying lines past the part of a file that has been indexed.
+o test_truncate_large_source_file:
+  Test a large file that shrinks on disk after it was displayed.
 """
 
 import unittest2
@@ -41,6 +45,90 @@ class SourceManagerTestCase(TestBase):
         self.buildDefault()
         self.modify_source_file_while_debugging()
 
+    @python_api_test
+    def test_lazy_line_index(self):
+        """Test displaying lines past the part of a file that has been indexed."""
+        self.lazy_line_index()
+
+    @python_api_test
+    def test_truncate_large_source_file(self):
+        """Test a large file that shrinks on disk after it was displayed."""
+        self.truncate_large_source_file()
+
+    def write_source_file(self, path, lines, mtime_offset=0):
+        """Write 'lines' to path without a newline after the last one."""
+        with open(path, 'w') as f:
+            f.write("\n".join(lines))
+        # Make sure the change isn't lost in the time stamp resolution.
+        if mtime_offset:
+            mtime = os.path.getmtime(path) + mtime_offset
+            os.utime(path, (mtime, mtime))
+
+    def displayed_lines(self, path, line, context_before, context_after):
+        """Display lines of path with the SBSourceManager API and return them as a dictionary of line number to text."""
+        stream = lldb.SBStream()
+        self.dbg.GetSourceManager().DisplaySourceLinesWithLineNumbers(lldb.SBFileSpec(path, False),
+                                                                      line,
+                                                                      context_before,
+                                                                      context_after,
+                                                                      "=>",
+                                                                      stream)
+        lines = {}
+        for output_line in stream.GetData().splitlines():
+            m = re.match(r'^(=>)?\s*(\d+)\s*\t(.*)$', output_line)
+            if m:
+                lines[int(m.group(2))] = m.group(3)
+        if self.TraceOn():
+            print "line %d of %s: %s" % (line, path, sorted(lines.items()))
+        return lines
+
+    def lazy_line_index(self):
+        """Test displaying lines past the part of a file that has been indexed."""
+        path = os.path.join(os.getcwd(), "lazy-index.txt")
+        self.addTearDownHook(lambda: os.remove(path))
+        self.write_source_file(path, ["line %d" % i for i in range(1, 101)])
+
+        # Only the start of the file has been indexed after this
+        self.assertTrue(self.displayed_lines(path, 3, 1, 1) == {2: "line 2", 3: "line 3", 4: "line 4"},
+                        "Lines at the start of the file")
+
+        # A range past the indexed lines
+        self.assertTrue(self.displayed_lines(path, 60, 2, 2) == dict((i, "line %d" % i) for i in range(58, 63)),
+                        "Lines past the indexed part")
+
+        # The last line has no newline after it, and nothing comes after it
+        self.assertTrue(self.displayed_lines(path, 100, 1, 3) == {99: "line 99", 100: "line 100"},
+                        "The last line without a trailing newline")
+        self.assertTrue(self.displayed_lines(path, 101, 0, 0) == {},
+                        "No line after the last one")
+
+        # A changed file is indexed anew
+        self.write_source_file(path, ["changed %d" % i for i in range(1, 51)], mtime_offset=2)
+        self.assertTrue(self.displayed_lines(path, 50, 1, 1) == {49: "changed 49", 50: "changed 50"},
+                        "The changed file is displayed")
+        self.assertTrue(self.displayed_lines(path, 60, 0, 0) == {},
+                        "Lines of the old contents are gone")
+
+    def truncate_large_source_file(self):
+        """Test a large file that shrinks on disk after it was displayed."""
+        # Big enough for the source manager to map it instead of reading it
+        num_lines = 40000
+        path = os.path.join(os.getcwd(), "large-source.txt")
+        self.addTearDownHook(lambda: os.remove(path))
+        self.write_source_file(path, ["line %d %s" % (i, "x" * 40) for i in range(1, num_lines + 1)])
+        self.assertTrue(os.path.getsize(path) > 1024 * 1024, "The file is larger than 1MB")
+
+        self.assertTrue(self.displayed_lines(path, num_lines, 0, 0) == {num_lines: "line %d %s" % (num_lines, "x" * 40)},
+                        "The last line of the large file")
+
+        # Reading the pages of the old contents past the new end of the file
+        # would crash if the file wasn't loaded again
+        self.write_source_file(path, ["short %d" % i for i in range(1, 11)], mtime_offset=2)
+        self.assertTrue(self.displayed_lines(path, num_lines, 0, 0) == {},
+                        "Lines past the end of the truncated file")
+        self.assertTrue(self.displayed_lines(path, 10, 1, 0) == {9: "short 9", 10: "short 10"},
+                        "The truncated file is displayed")
+
     def display_source_python(self):
         """Display source using the SBSourceManager API."""
         exe = os.path.join(os.getcwd(), "a.out")
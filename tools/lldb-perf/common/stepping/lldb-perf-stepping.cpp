@@ -1,11 +1,10 @@
-#include <CoreFoundation/CoreFoundation.h>
-
 #include "lldb-perf/lib/Timer.h"
 #include "lldb-perf/lib/Metric.h"
 #include "lldb-perf/lib/Measurement.h"
 #include "lldb-perf/lib/TestCase.h"
 #include "lldb-perf/lib/Xcode.h"
 
+#include <string.h>
 #include <unistd.h>
 #include <string>
 #include <getopt.h>
@@ -11,15 +11,21 @@
 #include "lldb/lldb-forward.h"
 #include <assert.h>
 #include <cmath>
+#if defined(__APPLE__)
 #include <mach/mach.h>
 #include <mach/task.h>
 #include <mach/mach_traps.h>
+#elif defined(__linux__)
+#include <stdio.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
 
 using namespace lldb_perf;
 
-MemoryStats::MemoryStats (mach_vm_size_t virtual_size,
-                          mach_vm_size_t resident_size,
-                          mach_vm_size_t max_resident_size) :
+MemoryStats::MemoryStats (uint64_t virtual_size,
+                          uint64_t resident_size,
+                          uint64_t max_resident_size) :
     m_virtual_size (virtual_size),
     m_resident_size (resident_size),
     m_max_resident_size (max_resident_size)
@@ -101,6 +107,7 @@ MemoryStats::GetResult (const char *name, const char *description) const
 MemoryGauge::ValueType
 MemoryGauge::Now ()
 {
+#if defined(__APPLE__)
     task_t task = mach_task_self();
     mach_task_basic_info_data_t taskBasicInfo;
     mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
@@ -108,6 +115,26 @@ MemoryGauge::Now ()
     if (task_info_ret == KERN_SUCCESS) {
         return MemoryStats(taskBasicInfo.virtual_size, taskBasicInfo.resident_size, taskBasicInfo.resident_size_max);
     }
+#elif defined(__linux__)
+    // /proc/self/statm reports the sizes in pages, ru_maxrss is in kilobytes
+    unsigned long long virtual_pages = 0;
+    unsigned long long resident_pages = 0;
+    FILE *statm = fopen ("/proc/self/statm", "r");
+    if (statm)
+    {
+        const int num_fields = fscanf (statm, "%llu %llu", &virtual_pages, &resident_pages);
+        fclose (statm);
+        if (num_fields == 2)
+        {
+            const uint64_t page_size = sysconf (_SC_PAGESIZE);
+            uint64_t max_resident_size = 0;
+            struct rusage usage;
+            if (getrusage (RUSAGE_SELF, &usage) == 0)
+                max_resident_size = (uint64_t)usage.ru_maxrss * 1024;
+            return MemoryStats(virtual_pages * page_size, resident_pages * page_size, max_resident_size);
+        }
+    }
+#endif
     return 0;
 }
 
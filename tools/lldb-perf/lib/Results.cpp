@@ -15,10 +15,15 @@
 #include "CFCMutableDictionary.h"
 #include "CFCReleaser.h"
 #include "CFCString.h"
+#else
+#include <inttypes.h>
+#include <stdio.h>
+#include <cmath>
 #endif
 
 using namespace lldb_perf;
 
+#ifdef __APPLE__
 static void
 AddResultToArray (CFCMutableArray &array, Results::Result *result);
 
@@ -154,6 +159,118 @@ AddResultToDictionary (CFCMutableDictionary &parent_dict, const char *key, Resul
         break;
     }
 }
+#else
+
+static void
+WriteJSONString (FILE *out, const char *s)
+{
+    fputc ('"', out);
+    for (; s && *s; ++s)
+    {
+        const unsigned char ch = *s;
+        switch (ch)
+        {
+        case '"':   fputs ("\\\"", out); break;
+        case '\\':  fputs ("\\\\", out); break;
+        case '\n':  fputs ("\\n", out); break;
+        case '\r':  fputs ("\\r", out); break;
+        case '\t':  fputs ("\\t", out); break;
+        default:
+            if (ch < 0x20)
+                fprintf (out, "\\u%4.4x", ch);
+            else
+                fputc (ch, out);
+            break;
+        }
+    }
+    fputc ('"', out);
+}
+
+static void
+WriteJSONIndent (FILE *out, int indent)
+{
+    fprintf (out, "%*s", indent * 2, "");
+}
+
+static void
+WriteResultAsJSON (FILE *out, Results::Result *result, int indent)
+{
+    switch (result->GetType())
+    {
+    case Results::Result::Type::Invalid:
+        fputs ("null", out);
+        break;
+
+    case Results::Result::Type::Array:
+        {
+            bool first = true;
+            fputs ("[", out);
+            result->GetAsArray()->ForEach([out, indent, &first](const Results::ResultSP &value_sp) -> bool
+                                          {
+                                              fputs (first ? "\n" : ",\n", out);
+                                              first = false;
+                                              WriteJSONIndent (out, indent + 1);
+                                              WriteResultAsJSON (out, value_sp.get(), indent + 1);
+                                              return true;
+                                          });
+            fputs ("\n", out);
+            WriteJSONIndent (out, indent);
+            fputs ("]", out);
+        }
+        break;
+
+    case Results::Result::Type::Dictionary:
+        {
+            bool first = true;
+            fputs ("{", out);
+            result->GetAsDictionary()->ForEach([out, indent, &first](const std::string &key, const Results::ResultSP &value_sp) -> bool
+                                               {
+                                                   fputs (first ? "\n" : ",\n", out);
+                                                   first = false;
+                                                   WriteJSONIndent (out, indent + 1);
+                                                   WriteJSONString (out, key.c_str());
+                                                   fputs (": ", out);
+                                                   WriteResultAsJSON (out, value_sp.get(), indent + 1);
+                                                   return true;
+                                               });
+            if (result->GetDescription())
+            {
+                fputs (first ? "\n" : ",\n", out);
+                first = false;
+                WriteJSONIndent (out, indent + 1);
+                fputs ("\"description\": ", out);
+                WriteJSONString (out, result->GetDescription());
+            }
+            if (!first)
+            {
+                fputs ("\n", out);
+                WriteJSONIndent (out, indent);
+            }
+            fputs ("}", out);
+        }
+        break;
+
+    case Results::Result::Type::Double:
+        {
+            const double value = result->GetAsDouble()->GetValue();
+            if (std::isfinite (value))
+                fprintf (out, "%.17g", value);
+            else
+                fputs ("null", out);
+        }
+        break;
+
+    case Results::Result::Type::String:
+        WriteJSONString (out, result->GetAsString()->GetValue());
+        break;
+
+    case Results::Result::Type::Unsigned:
+        fprintf (out, "%" PRIu64, result->GetAsUnsigned()->GetValue());
+        break;
+    }
+}
+#endif
+
 void
 Results::Write (const char *out_path)
 {
@@ -173,6 +290,18 @@ Results::Write (const char *out_path)
     CFURLRef file = CFURLCreateFromFileSystemRepresentation(NULL, (const UInt8*)out_path, strlen(out_path), FALSE);
     
     CFURLWriteDataAndPropertiesToResource(file, xmlData, NULL, NULL);
+#else
+    // Write JSON everywhere else so results can be collected by scripts
+    FILE *out = out_path ? fopen (out_path, "w") : stdout;
+    if (out == NULL)
+    {
+        fprintf (stderr, "error: unable to open '%s' for writing\n", out_path);
+        return;
+    }
+    WriteResultAsJSON (out, &m_results, 0);
+    fputs ("\n", out);
+    if (out != stdout)
+        fclose (out);
 #endif
 }
 
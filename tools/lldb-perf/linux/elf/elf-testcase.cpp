@@ -0,0 +1,84 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <map>
+#include <string>
+#include <vector>
+
+struct Sample
+{
+    int id;
+    double weight;
+    char tag[16];
+};
+
+struct LargeStruct
+{
+    int header[64];
+    Sample samples[256];
+    std::vector<Sample> sample_vector;
+    std::map<int, std::string> names;
+    struct
+    {
+        uint64_t counters[32];
+        const char *label;
+    } stats;
+};
+
+static int g_depth_reached = 0;
+
+static int
+compute (LargeStruct &large, int value)
+{
+    int result = value;
+    for (int i = 0; i < 64; ++i)
+        result += large.header[i] * (i + 1);
+    result += (int)large.samples[value % 256].weight;
+    return result;
+}
+
+static int
+stop_here (LargeStruct &large, int depth)
+{
+    int total = compute (large, depth);         // Stop here to take the measurements.
+    total += compute (large, depth + 1);
+    total += compute (large, depth + 2);
+    total += compute (large, depth + 3);
+    total += compute (large, depth + 4);
+    total += compute (large, depth + 5);
+    total += compute (large, depth + 6);
+    total += compute (large, depth + 7);
+    total += compute (large, depth + 8);
+    total += compute (large, depth + 9);
+    return total;
+}
+
+static int
+recurse (LargeStruct &large, int depth)
+{
+    g_depth_reached = depth;
+    if (depth == 0)
+        return stop_here (large, depth);
+    return recurse (large, depth - 1) + 1;
+}
+
+int main (int argc, char const *argv[])
+{
+    static LargeStruct large;
+    for (int i = 0; i < 64; ++i)
+        large.header[i] = i * argc;
+    for (int i = 0; i < 256; ++i)
+    {
+        large.samples[i].id = i;
+        large.samples[i].weight = i * 0.5;
+        snprintf (large.samples[i].tag, sizeof(large.samples[i].tag), "sample-%d", i);
+        large.sample_vector.push_back (large.samples[i]);
+        large.names[i] = large.samples[i].tag;
+    }
+    for (int i = 0; i < 32; ++i)
+        large.stats.counters[i] = (uint64_t)i << 32;
+    large.stats.label = argv[0];
+
+    int result = recurse (large, 64);
+    printf ("result = %d, depth = %d\n", result, g_depth_reached);
+    return 0;
+}
@@ -0,0 +1,460 @@
+//===-- lldb-perf-elf.cpp ---------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "lldb-perf/lib/Timer.h"
+#include "lldb-perf/lib/Metric.h"
+#include "lldb-perf/lib/Measurement.h"
+#include "lldb-perf/lib/Results.h"
+#include "lldb-perf/lib/TestCase.h"
+#include "lldb-perf/lib/Xcode.h"
+
+#include <stdlib.h>
+#include <unistd.h>
+#include <string>
+#include <getopt.h>
+
+using namespace lldb_perf;
+
+// Measures the latency of the commands an IDE issues at every stop against
+// an ELF inferior (see elf-testcase.cpp). The inferior is either launched
+// locally or reached through a gdb-remote stub given with --connect.
+class ElfTest : public TestCase
+{
+public:
+    ElfTest () :
+        TestCase(),
+        m_time_create_target ([this] () -> void
+                              {
+                                  m_memory_change_create_target.Start();
+                                  m_target = m_debugger.CreateTarget(m_exe_path.c_str());
+                                  m_memory_change_create_target.Stop();
+                              }, "time-create-target", "The time it takes to create a target."),
+        m_time_break_by_name ([this] () -> void
+                              {
+                                  m_target.BreakpointCreateByName("stop_here");
+                              }, "time-break-by-name", "The time it takes to resolve the first breakpoint, set by function name."),
+        m_time_break_source_regex ([this] () -> void
+                                   {
+                                       m_target.BreakpointCreateBySourceRegex("Stop here to take the measurements", SBFileSpec("elf-testcase.cpp", false));
+                                   }, "time-break-source-regex", "The time it takes to set a breakpoint by source regular expression."),
+        m_time_backtrace ([this] () -> void
+                          {
+                              Xcode::RunCommand(m_debugger, "bt", GetVerbose());
+                          }, "time-bt", "The time it takes to run 'bt' on a deep stack."),
+        m_time_frame_variable ([this] () -> void
+                               {
+                                   Xcode::RunCommand(m_debugger, "frame variable large", GetVerbose());
+                               }, "time-frame-variable", "The time it takes to display a large structure with 'frame variable'."),
+        m_expr_first_evaluate ([this] (SBFrame frame) -> void
+                               {
+                                   frame.EvaluateExpression("large.samples[10].weight + depth").GetError();
+                               }, "time-expr-first", "The time it takes to evaluate an expression for the first time."),
+        m_expr_evaluate ([this] (SBFrame frame) -> void
+                         {
+                             frame.EvaluateExpression("large.samples[10].weight + depth").GetError();
+                         }, "time-expr", "The time it takes to evaluate an expression after the first one."),
+        m_time_step ([] () -> void {}, "time-step", "The time it takes to step over one source line."),
+        m_memory_change_create_target (),
+        m_memory_total (),
+        m_time_launch_stop (),
+        m_time_total (),
+        m_exe_path (),
+        m_out_path (),
+        m_connect_url (),
+        m_num_iterations (5),
+        m_num_steps (10),
+        m_steps_taken (0),
+        m_phase (Phase::eStart)
+    {
+    }
+
+    virtual
+    ~ElfTest ()
+    {
+    }
+
+    virtual bool
+    Setup (int& argc, const char**& argv)
+    {
+        if (m_exe_path.empty())
+            return false;
+        m_launch_args.clear();
+        for (int i = 0; i < argc; ++i)
+            m_launch_args.push_back (argv[i]);
+        m_launch_args.push_back (NULL);
+        return true;
+    }
+
+    virtual void
+    TestStep (int counter, ActionWanted &next_action)
+    {
+        switch (m_phase)
+        {
+        case Phase::eStart:
+            m_memory_total.Start();
+            m_time_total.Start();
+
+            m_time_create_target();
+            if (!m_target.IsValid())
+            {
+                fprintf (stderr, "error: unable to create a target for '%s'\n", m_exe_path.c_str());
+                exit (1);
+            }
+            m_time_break_by_name();
+            m_time_break_source_regex();
+
+            m_time_launch_stop.Start();
+            if (!StartProcess())
+                exit (1);
+            m_phase = Phase::eWaitForBreakpoint;
+            break;
+
+        case Phase::eWaitForBreakpoint:
+            // A gdb-remote stub usually reports a stop at the entry point
+            // first, keep going until we reach our breakpoint.
+            if (!m_thread.IsValid() || m_thread.GetStopReason() != eStopReasonBreakpoint)
+            {
+                next_action.Continue();
+                break;
+            }
+            m_time_launch_stop.Stop();
+            MeasureCommands();
+
+            m_phase = Phase::eStepping;
+            m_time_step.Start();
+            next_action.StepOver(m_thread);
+            break;
+
+        case Phase::eStepping:
+            m_time_step.Stop();
+            if (++m_steps_taken < m_num_steps)
+            {
+                m_time_step.Start();
+                next_action.StepOver(m_thread);
+                break;
+            }
+            m_time_total.Stop();
+            m_memory_total.Stop();
+            m_phase = Phase::eDone;
+            next_action.Kill();
+            break;
+
+        case Phase::eDone:
+            next_action.Kill();
+            break;
+        }
+    }
+
+    void
+    WriteResults (Results &results)
+    {
+        Results::Dictionary& results_dict = results.GetDictionary();
+
+        results_dict.AddString ("executable", "The inferior that was debugged.", m_exe_path.c_str());
+        results_dict.AddString ("connection",
+                                "How the inferior was started, 'launch' or the gdb-remote URL.",
+                                m_connect_url.empty() ? "launch" : m_connect_url.c_str());
+
+        m_time_create_target.WriteAverageAndStandardDeviation(results);
+        results_dict.Add ("memory-change-create-target",
+                          "Memory increase that occurs due to creating the target.",
+                          m_memory_change_create_target.GetDeltaValue().GetResult(NULL, NULL));
+        m_time_break_by_name.WriteAverageAndStandardDeviation(results);
+        m_time_break_source_regex.WriteAverageAndStandardDeviation(results);
+        results_dict.AddDouble ("time-launch-stop",
+                                "The time it takes to start the inferior and stop at the first breakpoint.",
+                                m_time_launch_stop.GetDeltaValue());
+        m_time_backtrace.WriteAverageAndStandardDeviation(results);
+        m_time_frame_variable.WriteAverageAndStandardDeviation(results);
+        m_expr_first_evaluate.WriteAverageAndStandardDeviation(results);
+        m_expr_evaluate.WriteAverageAndStandardDeviation(results);
+        m_time_step.WriteAverageAndStandardDeviation(results);
+        results_dict.Add ("memory-total",
+                          "The total memory that the debugger is using at the end of the test.",
+                          m_memory_total.GetStopValue().GetResult(NULL, NULL));
+        results_dict.AddDouble ("time-total",
+                                "The time it takes to run the whole test.",
+                                m_time_total.GetDeltaValue());
+        results.Write(GetResultFilePath());
+    }
+
+    const char *
+    GetExecutablePath () const
+    {
+        if (m_exe_path.empty())
+            return NULL;
+        return m_exe_path.c_str();
+    }
+
+    const char *
+    GetResultFilePath () const
+    {
+        if (m_out_path.empty())
+            return NULL;
+        return m_out_path.c_str();
+    }
+
+    void
+    SetExecutablePath (const char *path)
+    {
+        if (path && path[0])
+            m_exe_path = path;
+        else
+            m_exe_path.clear();
+    }
+
+    void
+    SetResultFilePath (const char *path)
+    {
+        if (path && path[0])
+            m_out_path = path;
+        else
+            m_out_path.clear();
+    }
+
+    void
+    SetConnectURL (const char *url)
+    {
+        if (url && url[0])
+            m_connect_url = url;
+        else
+            m_connect_url.clear();
+    }
+
+    void
+    SetNumIterations (uint32_t num_iterations)
+    {
+        m_num_iterations = num_iterations > 0 ? num_iterations : 1;
+    }
+
+    void
+    SetNumSteps (uint32_t num_steps)
+    {
+        m_num_steps = num_steps > 0 ? num_steps : 1;
+    }
+
+private:
+    enum class Phase
+    {
+        eStart,
+        eWaitForBreakpoint,
+        eStepping,
+        eDone
+    };
+
+    bool
+    StartProcess ()
+    {
+        if (m_connect_url.empty())
+        {
+            SBLaunchInfo launch_info (&m_launch_args[0]);
+            return Launch (launch_info);
+        }
+
+        SBError error;
+        m_process = m_target.ConnectRemote (m_listener, m_connect_url.c_str(), "gdb-remote", error);
+        if (!error.Success())
+            fprintf (stderr, "error: %s\n", error.GetCString());
+        if (!m_process.IsValid())
+            return false;
+        m_process.GetBroadcaster().AddListener(m_listener, SBProcess::eBroadcastBitStateChanged | SBProcess::eBroadcastBitInterrupt);
+        return true;
+    }
+
+    void
+    MeasureCommands ()
+    {
+        SBFrame frame (m_thread.GetFrameAtIndex(0));
+        m_expr_first_evaluate(frame);
+        for (uint32_t i = 0; i < m_num_iterations; ++i)
+        {
+            m_time_backtrace();
+            m_time_frame_variable();
+            m_expr_evaluate(frame);
+        }
+    }
+
+    TimeMeasurement<std::function<void()>> m_time_create_target;
+    TimeMeasurement<std::function<void()>> m_time_break_by_name;
+    TimeMeasurement<std::function<void()>> m_time_break_source_regex;
+    TimeMeasurement<std::function<void()>> m_time_backtrace;
+    TimeMeasurement<std::function<void()>> m_time_frame_variable;
+    TimeMeasurement<std::function<void(SBFrame)>> m_expr_first_evaluate;
+    TimeMeasurement<std::function<void(SBFrame)>> m_expr_evaluate;
+    TimeMeasurement<std::function<void()>> m_time_step;
+    MemoryGauge m_memory_change_create_target;
+    MemoryGauge m_memory_total;
+    TimeGauge m_time_launch_stop;
+    TimeGauge m_time_total;
+    std::string m_exe_path;
+    std::string m_out_path;
+    std::string m_connect_url;
+    std::vector<const char *> m_launch_args;
+    uint32_t m_num_iterations;
+    uint32_t m_num_steps;
+    uint32_t m_steps_taken;
+    Phase m_phase;
+};
+
+static struct option g_long_options[] = {
+    { "help",       no_argument,            NULL, 'h' },
+    { "verbose",    no_argument,            NULL, 'v' },
+    { "test-file",  required_argument,      NULL, 't' },
+    { "out-file",   required_argument,      NULL, 'o' },
+    { "connect",    required_argument,      NULL, 'c' },
+    { "iterations", required_argument,      NULL, 'i' },
+    { "steps",      required_argument,      NULL, 's' },
+    { NULL,         0,                      NULL,  0  }
+};
+
+
+std::string
+GetShortOptionString (struct option *long_options)
+{
+    std::string option_string;
+    for (int i = 0; long_options[i].name != NULL; ++i)
+    {
+        if (long_options[i].flag == NULL)
+        {
+            option_string.push_back ((char) long_options[i].val);
+            switch (long_options[i].has_arg)
+            {
+                default:
+                case no_argument:
+                    break;
+                case required_argument:
+                    option_string.push_back (':');
+                    break;
+                case optional_argument:
+                    option_string.append (2, ':');
+                    break;
+            }
+        }
+    }
+    return option_string;
+}
+
+int main(int argc, const char * argv[])
+{
+    // Prepare for & make calls to getopt_long_only.
+    std::string short_option_string (GetShortOptionString(g_long_options));
+
+    ElfTest test;
+
+    bool verbose = false;
+    bool error = false;
+    bool print_help = false;
+    bool done = false;
+
+#if __GLIBC__
+    optind = 0;
+#else
+    optreset = 1;
+    optind = 1;
+#endif
+    while (!done)
+    {
+        int long_options_index = -1;
+        const int short_option = ::getopt_long_only (argc,
+                                                     const_cast<char **>(argv),
+                                                     short_option_string.c_str(),
+                                                     g_long_options,
+                                                     &long_options_index);
+
+        switch (short_option)
+        {
+            case 0:
+                // Already handled
+                break;
+
+            case -1:
+                done = true;
+                break;
+
+            case '?':
+            case 'h':
+                print_help = true;
+                break;
+
+            case 'v':
+                verbose = true;
+                break;
+
+            case 't':
+                {
+                    SBFileSpec file(optarg);
+                    if (file.Exists())
+                        test.SetExecutablePath(optarg);
+                    else
+                        fprintf(stderr, "error: file specified in --test-file (-t) option doesn't exist: '%s'\n", optarg);
+                }
+                break;
+
+            case 'o':
+                test.SetResultFilePath(optarg);
+                break;
+
+            case 'c':
+                test.SetConnectURL(optarg);
+                break;
+
+            case 'i':
+                test.SetNumIterations(strtoul(optarg, NULL, 0));
+                break;
+
+            case 's':
+                test.SetNumSteps(strtoul(optarg, NULL, 0));
+                break;
+
+            default:
+                error = true;
+                print_help = true;
+                fprintf (stderr, "error: unrecognized option %c\n", short_option);
+                break;
+        }
+    }
+
+    if (print_help)
+    {
+        puts(R"(
+NAME
+    lldb-perf-elf -- a tool that measures LLDB startup and per-command latency
+    against an ELF inferior.
+
+SYNOPSIS
+    lldb-perf-elf --test-file=FILE [--out-file=PATH --connect=URL
+                  --iterations=N --steps=N --verbose] [-- ARGS]
+
+DESCRIPTION
+    Creates a target for FILE (normally the lldb-perf-elf-inferior program),
+    resolves breakpoints, runs to the breakpoint in stop_here() and times
+    'bt', 'frame variable', expression evaluation and stepping. With
+    --connect the inferior is reached through a gdb-remote stub listening at
+    URL (for example connect://localhost:1234) instead of being launched,
+    or through the in-process simulator with sim://FILE?latency=USEC.
+    Results are written as JSON to --out-file, or to stdout.
+)");
+        exit(error ? 1 : 0);
+    }
+    if (error)
+        exit(1);
+
+    if (test.GetExecutablePath() == NULL)
+    {
+        fprintf (stderr, "error: the '--test-file=PATH' option is mandatory\n");
+        exit(1);
+    }
+
+    // Update argc and argv after parsing options
+    argc -= optind;
+    argv += optind;
+
+    test.SetVerbose(verbose);
+    return TestCase::Run(test, argc, argv);
+}